@@ -0,0 +1,143 @@
+/**
+@file       KenoBench.cpp
+@brief      Implementation of the microbenchmark harness
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <atomic>
+#include <ctime>
+#include <new>
+#include "KenoBench.h"
+
+
+volatile double g_fBenchSink = 0.0;
+
+static std::atomic<QWORD> g_qwAllocCount (0);
+static std::atomic<QWORD> g_qwAllocBytes (0);
+
+
+/**
+  The global allocation functions of the benchmark executable count every
+  heap allocation made by the code under test.
+*/
+void* operator new (size_t cbSize)
+{
+    g_qwAllocCount.fetch_add (1, std::memory_order_relaxed);
+    g_qwAllocBytes.fetch_add (cbSize, std::memory_order_relaxed);
+
+    void* pMemory = malloc (cbSize ? cbSize : 1);
+    if ( pMemory == nullptr )
+        throw std::bad_alloc ( );
+
+    return pMemory;
+}
+
+void* operator new[] (size_t cbSize)
+{
+    return operator new (cbSize);
+}
+
+void operator delete (void* pMemory) noexcept
+{
+    free (pMemory);
+}
+
+void operator delete[] (void* pMemory) noexcept
+{
+    free (pMemory);
+}
+
+void operator delete (void* pMemory, size_t) noexcept
+{
+    free (pMemory);
+}
+
+void operator delete[] (void* pMemory, size_t) noexcept
+{
+    free (pMemory);
+}
+
+void getAllocationCount (QWORD& qwCount, QWORD& qwBytes)
+{
+    qwCount = g_qwAllocCount.load (std::memory_order_relaxed);
+    qwBytes = g_qwAllocBytes.load (std::memory_order_relaxed);
+}
+
+/// the benchmark names and labels are plain identifiers, only quotes and backslashes need escaping
+void writeJsonString (FILE* pFile, const char* szValue)
+{
+    fputc ('"', pFile);
+
+    for ( const char* p = szValue; *p != '\0'; p++ )
+    {
+        if ( (*p == '"') || (*p == '\\') )
+            fputc ('\\', pFile);
+        fputc (*p, pFile);
+    }
+
+    fputc ('"', pFile);
+}
+
+void writeJsonOptional (FILE* pFile, const char* szKey, double fValue)
+{
+    if ( fValue >= 0.0 )
+        fprintf (pFile, "\"%s\": %.4f, ", szKey, fValue);
+    else
+        fprintf (pFile, "\"%s\": null, ", szKey);
+}
+
+bool writeBenchmarkJson (FILE* pFile, const char* szLabel, const char* szCounters,
+                         const std::vector<KenoBenchResult>& rgResults)
+{
+#if defined(_MSC_VER)
+    const char* szCompiler = "msvc";
+#elif defined(__clang__)
+    const char* szCompiler = "clang";
+#elif defined(__GNUC__)
+    const char* szCompiler = "gcc";
+#else
+    const char* szCompiler = "unknown";
+#endif
+
+#ifdef _DEBUG
+    const char* szBuild = "debug";
+#else
+    const char* szBuild = "release";
+#endif
+
+    fprintf (pFile, "{\n  \"suite\": \"KenoBench\",\n  \"format\": 1,\n  \"label\": ");
+    writeJsonString (pFile, szLabel);
+    fprintf (pFile, ",\n  \"time\": %lld,\n  \"compiler\": \"%s\",\n  \"build\": \"%s\",\n",
+             static_cast<long long>(time (nullptr)), szCompiler, szBuild);
+    fprintf (pFile, "  \"counters\": ");
+    writeJsonString (pFile, szCounters);
+    fprintf (pFile, ",\n  \"repetitions\": %u,\n  \"results\": [\n", g_dwBenchRepetitions);
+
+    for ( size_t i = 0; i < rgResults.size ( ); i++ )
+    {
+        const KenoBenchResult& result = rgResults[i];
+
+        fprintf (pFile, "    { \"name\": ");
+        writeJsonString (pFile, result.szName);
+        fprintf (pFile, ", \"group\": ");
+        writeJsonString (pFile, result.szGroup);
+        fprintf (pFile, ", \"iterations\": %llu, \"ns_per_op\": %.4f, \"ns_per_op_min\": %.4f, ",
+                 result.qwIterations, result.fNsPerOp, result.fNsPerOpMin);
+
+        writeJsonOptional (pFile, "cycles_per_op",         result.fCyclesPerOp);
+        writeJsonOptional (pFile, "instructions_per_op",   result.fInstructionsPerOp);
+        writeJsonOptional (pFile, "ipc",                   result.fIPC);
+        writeJsonOptional (pFile, "cache_misses_per_op",   result.fCacheMissesPerOp);
+        writeJsonOptional (pFile, "branch_misses_per_op",  result.fBranchMissesPerOp);
+
+        fprintf (pFile, "\"allocs_per_op\": %.6f, \"bytes_per_op\": %.4f }%s\n",
+                 result.fAllocsPerOp, result.fBytesPerOp, (i + 1 < rgResults.size ( )) ? "," : "");
+    }
+
+    fprintf (pFile, "  ]\n}\n");
+
+    return ferror (pFile) == 0;
+}
@@ -0,0 +1,197 @@
+/**
+@file       KenoBench.h
+@brief      Microbenchmark harness declarations
+
+  A benchmark is a callable invoked once per operation with the operation
+  index.  The harness calibrates the iteration count to a minimum run time,
+  repeats the measurement and reports the median and best ns/op, the time
+  stamp counter cycles/op and the heap allocations per operation, counted
+  by the global operator new of the benchmark executable.  Given open
+  hardware counters (KenoPerfCounters.h), it adds the instructions, IPC,
+  cache misses and branch misses per operation.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_BENCH_H__
+#define __KENO_BENCH_H__
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "KenoPerfCounters.h"
+#include "KenoProbability.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define KENO_BENCH_HAS_TSC  1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define KENO_BENCH_HAS_TSC  1
+#else
+    #define KENO_BENCH_HAS_TSC  0
+#endif
+
+constexpr const DWORD g_dwBenchRepetitions     = 5;     //< measurements per benchmark
+constexpr const DWORD g_dwBenchMinMilliseconds = 100;   //< minimum duration of one measurement
+
+struct KenoBenchResult
+{
+    const char* szName;
+    const char* szGroup;            //< the operation the benchmark implements
+    QWORD       qwIterations;       //< operations per measurement
+    double      fNsPerOp;           //< median over the repetitions
+    double      fNsPerOpMin;
+    double      fCyclesPerOp;       //< time stamp counter cycles, negative if unavailable
+    double      fAllocsPerOp;
+    double      fBytesPerOp;
+    double      fInstructionsPerOp;     //< the hardware counter results are negative if unavailable
+    double      fIPC;
+    double      fCacheMissesPerOp;
+    double      fBranchMissesPerOp;
+};
+
+/// keeps benchmarked results alive without the cost of a volatile store per operation
+extern volatile double g_fBenchSink;
+
+/**
+  @brief readCycleCounter
+
+  @retval QWORD             time stamp counter, or 0 if the platform has none
+*/
+inline QWORD readCycleCounter (void)
+{
+#if KENO_BENCH_HAS_TSC
+    return __rdtsc ( );
+#else
+    return 0;
+#endif
+}
+
+/**
+  @brief returns the number and the total size of the heap allocations so far
+*/
+void getAllocationCount (QWORD& qwCount, QWORD& qwBytes);
+
+/**
+  @brief runBenchmark
+
+  @param [in]  szName       benchmark name
+  @param [in]  szGroup      name of the operation, shared by its implementations
+  @param [in]  fnOp         callable 'double (QWORD i)' performing operation 'i'
+  @param [in]  pCounters    open hardware counters, or nullptr
+  @param [out] result       measurement
+*/
+template <typename TOp>
+void runBenchmark (const char* szName, const char* szGroup, TOp fnOp, KenoPerfCounters* pCounters,
+                   KenoBenchResult& result)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // grow the iteration count until one measurement lasts long enough
+    QWORD qwIterations = 1;
+
+    for ( ;; )
+    {
+        double fSum = 0.0;
+
+        const auto tpStart = Clock::now ( );
+        for ( QWORD i = 0; i < qwIterations; i++ )
+            fSum += fnOp (i);
+        const auto tpStop  = Clock::now ( );
+
+        g_fBenchSink = fSum;
+
+        if ( (tpStop - tpStart >= std::chrono::milliseconds (g_dwBenchMinMilliseconds)) ||
+             (qwIterations >= (1ULL << 40)) )
+            break;
+
+        qwIterations *= 2;
+    }
+
+    std::vector<double> rgNsPerOp;
+    double              fCyclesPerOp = 0.0;
+    QWORD               qwAllocs     = 0;
+    QWORD               qwBytes      = 0;
+    KenoPerfSample      sample;
+
+    if ( pCounters != nullptr )
+        pCounters->start ( );
+
+    for ( DWORD r = 0; r < g_dwBenchRepetitions; r++ )
+    {
+        double fSum = 0.0;
+        QWORD  qwAllocsBefore, qwBytesBefore, qwAllocsAfter, qwBytesAfter;
+
+        getAllocationCount (qwAllocsBefore, qwBytesBefore);
+
+        const auto  tpStart = Clock::now ( );
+        const QWORD qwStart = readCycleCounter ( );
+        for ( QWORD i = 0; i < qwIterations; i++ )
+            fSum += fnOp (i);
+        const QWORD qwStop  = readCycleCounter ( );
+        const auto  tpStop  = Clock::now ( );
+
+        getAllocationCount (qwAllocsAfter, qwBytesAfter);
+
+        g_fBenchSink = fSum;
+
+        rgNsPerOp.push_back (std::chrono::duration<double, std::nano> (tpStop - tpStart).count ( ) / qwIterations);
+
+        fCyclesPerOp += static_cast<double>(qwStop - qwStart) / qwIterations;
+        qwAllocs     += qwAllocsAfter - qwAllocsBefore;
+        qwBytes      += qwBytesAfter  - qwBytesBefore;
+    }
+
+    if ( pCounters != nullptr )
+        pCounters->stop (sample);
+    else
+        for ( auto& fCount : sample.rgCount )
+            fCount = -1.0;
+
+    std::sort (rgNsPerOp.begin ( ), rgNsPerOp.end ( ));
+
+    const double fOps = static_cast<double>(qwIterations) * g_dwBenchRepetitions;
+
+    result.szName       = szName;
+    result.szGroup      = szGroup;
+    result.qwIterations = qwIterations;
+    result.fNsPerOp     = rgNsPerOp[rgNsPerOp.size ( ) / 2];
+    result.fNsPerOpMin  = rgNsPerOp[0];
+    result.fCyclesPerOp = KENO_BENCH_HAS_TSC ? fCyclesPerOp / g_dwBenchRepetitions : -1.0;
+    result.fAllocsPerOp = qwAllocs / fOps;
+    result.fBytesPerOp  = qwBytes  / fOps;
+
+    result.fInstructionsPerOp = calcPerfRatio (sample.rgCount[KENO_PERF_INSTRUCTIONS],  fOps);
+    result.fIPC               = calcPerfRatio (sample.rgCount[KENO_PERF_INSTRUCTIONS],  sample.rgCount[KENO_PERF_CYCLES]);
+    result.fCacheMissesPerOp  = calcPerfRatio (sample.rgCount[KENO_PERF_CACHE_MISSES],  fOps);
+    result.fBranchMissesPerOp = calcPerfRatio (sample.rgCount[KENO_PERF_BRANCH_MISSES], fOps);
+}
+
+/**
+  @brief writes a quoted JSON string, escaping quotes and backslashes
+*/
+void writeJsonString (FILE* pFile, const char* szValue);
+
+/**
+  @brief writes '"szKey": value, ' with a null value if it is negative (unavailable)
+*/
+void writeJsonOptional (FILE* pFile, const char* szKey, double fValue);
+
+/**
+  @brief writeBenchmarkJson
+
+  Writes the results as a JSON document so they can be compared across commits.
+
+  @param [in] pFile         destination
+  @param [in] szLabel       free form label of the run, e.g. the commit id
+  @param [in] szCounters    status of the hardware counters
+  @param [in] rgResults     results to write
+
+  @retval bool              true on success
+*/
+bool writeBenchmarkJson (FILE* pFile, const char* szLabel, const char* szCounters,
+                         const std::vector<KenoBenchResult>& rgResults);
+
+#endif
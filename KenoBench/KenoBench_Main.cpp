@@ -0,0 +1,1082 @@
+/**
+@file       KenoBench_Main.cpp
+@brief      Microbenchmarks of the Keno probability kernel
+
+  Measures every implementation of the kernel operations, i.e. the original
+  factorial based functions, the table lookup, the log-gamma and the exact
+  integer replacements, the log-factorial table kernel of
+  KenoLogProbability.h, the complete table builds run by KenoProject and
+  the mapping of a table cache file (KenoTableCache.h).
+
+  With -throughput it runs the end-to-end draw and settlement benchmark of
+  KenoThroughput.h instead, with 1 .. all worker threads.  It reports how
+  many distinct masks the tickets play; -favourites gives 'percent' of the
+  tickets one of a few favourite masks, and with -aggregate it settles each
+  distinct mask once (KenoTicketAggregate) and pays out every winning ticket.
+
+  With -service it measures the query service of KenoService.h instead: a
+  client on the loopback interface sends frames of 1 .. 4096 queries and
+  reports queries/s and the p50/p99 frame round trip.
+
+  With -export it writes a histogram of 'rows' rows as a columnar file
+  (KenoColumnar.h), plain and delta coded, and reports the write and read
+  bandwidth and the compression ratio, then as CSV and TSV (KenoDelimited.h)
+  and reports the text bandwidth and rows/s.
+
+  With -ingest it pushes 'tickets' tickets through the ingestion queue of
+  KenoIngest.h from 'producers' threads into a settlement store drained by
+  the main thread, and reports tickets/s and the per producer counts.
+
+  With -journal the 'producers' threads append the tickets to a ticket
+  journal (KenoJournal.h) in the working directory instead, which is then
+  replayed into a settlement store; it reports tickets/s, tickets per group
+  commit and the replay bandwidth, and removes the journal.
+
+  With -archive it writes the tickets and 'draws' draws as compressed
+  archives (KenoArchive.h) in the working directory, one ticket in 8
+  playing one of 32 favourite masks, and reports the compression ratio,
+  the encode and decode bandwidth and tickets/s replayed into a settlement
+  store, then removes the archives.
+
+  With -perf it also reads the hardware performance counters of
+  KenoPerfCounters.h; unavailable counters are reported and left out.
+
+  usage: KenoBench [-perf] [-filter text] [-json file] [-label text]
+         KenoBench -throughput [-aggregate] [-favourites percent] [-perf] [-tickets n] [-draws n]
+                               [-json file] [-label text]
+         KenoBench -service
+         KenoBench -export [-rows n]
+         KenoBench -ingest [-producers n] [-tickets n]
+         KenoBench -journal [-producers n] [-tickets n]
+         KenoBench -archive [-tickets n] [-draws n]
+
+    -aggregate  settles each distinct mask once in -throughput
+    -favourites percent of the -throughput tickets playing a favourite mask, 0 by default
+    -perf       reads the cycles, instructions, cache and branch miss counters
+    -filter     only runs the benchmarks whose name contains 'text'
+    -json       writes the results as JSON to 'file' ('-' for stdout)
+    -label      label stored with the JSON results, e.g. the commit id
+    -tickets    number of tickets settled per draw, or pushed by -ingest and -journal,
+                or archived by -archive
+    -producers  producer threads of -ingest and -journal
+    -draws      number of draws, or draws archived by -archive
+    -rows       number of histogram rows exported
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "KenoArchive.h"
+#include "KenoBatch.h"
+#include "KenoBench.h"
+#include "KenoColumnar.h"
+#include "KenoDelimited.h"
+#include "KenoFormat.h"
+#include "KenoIngest.h"
+#include "KenoJournal.h"
+#include "KenoLogProbability.h"
+#include "KenoPerfCounters.h"
+#include "KenoProbability.h"
+#include "KenoService.h"
+#include "KenoSimulator.h"
+#include "KenoTableCache.h"
+#include "KenoThroughput.h"
+#include "KenoTicketWire.h"
+#include "KenoVariants.h"
+
+
+/// Default histogram rows of '-export'
+constexpr const QWORD g_qwDefaultExportRows = 50000000;
+
+/// Producer threads of '-ingest', like the terminal connections of a busy sales window
+constexpr const DWORD g_dwDefaultIngestProducers = 16;
+
+/// Tickets of '-archive' in every 'n' that play a favourite mask, and the number of favourites
+constexpr const size_t g_nArchiveFavouriteEvery = 8;
+constexpr const size_t g_nArchiveFavourites     = 32;
+
+/// Records per block of the '-batch' benchmarks
+constexpr const DWORD g_dwBenchBatchRecords = 4096;
+
+/// Every (spots marked, catch) pair of the probability table, repeated to a power of 2
+struct KenoBenchArgs
+{
+    static constexpr const DWORD s_dwSize = 256;
+
+    DWORD rgNumMarked[s_dwSize];
+    DWORD rgCatch    [s_dwSize];
+};
+
+static KenoBenchArgs g_benchArgs;
+
+static void initBenchArgs (void)
+{
+    DWORD n = 0;
+
+    while ( n < KenoBenchArgs::s_dwSize )
+    {
+        for ( DWORD m = 1; (m <= g_MAX_SELECTABLE_BALLS) && (n < KenoBenchArgs::s_dwSize); m++ )
+        {
+            for ( DWORD c = 0; (c <= m) && (n < KenoBenchArgs::s_dwSize); c++, n++ )
+            {
+                g_benchArgs.rgNumMarked[n] = m;
+                g_benchArgs.rgCatch[n]     = c;
+            }
+        }
+    }
+}
+
+/// narrows an ASCII command line argument
+static void toNarrow (const TCHAR* szValue, char* szNarrow, size_t cchNarrow)
+{
+    size_t i = 0;
+
+    for ( ; (szValue[i] != 0) && (i + 1 < cchNarrow); i++ )
+        szNarrow[i] = static_cast<char>(szValue[i]);
+
+    szNarrow[i] = '\0';
+}
+
+/// prints a hardware counter result, or '-' if it is unavailable
+static void printPerfValue (const char* szFormat, double fValue)
+{
+    if ( fValue >= 0.0 )
+        printf (szFormat, fValue);
+    else
+        printf (" %9s", "-");
+}
+
+struct KenoBenchRunner
+{
+    const char*                  szFilter;
+    KenoPerfCounters*            pCounters;     //< nullptr without -perf
+    std::vector<KenoBenchResult> rgResults;
+
+    template <typename TOp>
+    void run (const char* szName, const char* szGroup, TOp fnOp)
+    {
+        if ( (szFilter[0] != '\0') && (strstr (szName, szFilter) == nullptr) )
+            return;
+
+        KenoBenchResult result;
+        runBenchmark (szName, szGroup, fnOp, pCounters, result);
+
+        printf ("%-38s %12.2f ns/op %10.1f cycles/op %8.3f allocs/op %12llu iterations",
+                result.szName, result.fNsPerOp, result.fCyclesPerOp, result.fAllocsPerOp, result.qwIterations);
+
+        if ( pCounters != nullptr )
+        {
+            printPerfValue (" %9.1f", result.fInstructionsPerOp);
+            printPerfValue (" %9.2f", result.fIPC);
+            printPerfValue (" %9.4f", result.fCacheMissesPerOp);
+            printPerfValue (" %9.4f", result.fBranchMissesPerOp);
+        }
+
+        printf ("\n");
+
+        rgResults.push_back (result);
+    }
+};
+
+static void runKernelBenchmarks (KenoBenchRunner& runner)
+{
+    const DWORD  dwMask = KenoBenchArgs::s_dwSize - 1;
+    const DWORD* rgM    = g_benchArgs.rgNumMarked;
+    const DWORD* rgC    = g_benchArgs.rgCatch;
+
+    runner.run ("calcFactorial", "factorial", [&] (QWORD i)
+    {
+        return static_cast<double>(calcFactorial (static_cast<WORD>(rgM[i & dwMask])));
+    });
+
+    runner.run ("calcPartialFactorial", "partial_factorial", [&] (QWORD i)
+    {
+        return calcPartialFactorial (static_cast<WORD>(g_TOTAL_BALLS), static_cast<WORD>(rgC[i & dwMask]));
+    });
+
+    runner.run ("calcCombinations", "combinations", [&] (QWORD i)
+    {
+        return static_cast<double>(calcCombinations (rgM[i & dwMask], rgC[i & dwMask]));
+    });
+
+    runner.run ("calcCombinationsExact", "combinations", [&] (QWORD i)
+    {
+        return static_cast<double>(calcCombinationsExact (rgM[i & dwMask], rgC[i & dwMask]));
+    });
+
+    runner.run ("calcCombinationsExact(80,R)", "combinations_80", [&] (QWORD i)
+    {
+        return static_cast<double>(calcCombinationsExact (g_TOTAL_BALLS, rgC[i & dwMask]));
+    });
+
+    runner.run ("calcKenoProbability", "keno_probability", [&] (QWORD i)
+    {
+        return calcKenoProbability (rgM[i & dwMask], rgC[i & dwMask]);
+    });
+
+    runner.run ("getKenoProbability", "keno_probability", [&] (QWORD i)
+    {
+        return getKenoProbability (rgM[i & dwMask], rgC[i & dwMask]);
+    });
+
+    runner.run ("calcKenoProbabilityLogGamma", "keno_probability", [&] (QWORD i)
+    {
+        return calcKenoProbabilityLogGamma (rgM[i & dwMask], rgC[i & dwMask]);
+    });
+
+    runner.run ("calcKenoProbabilityExact", "keno_probability", [&] (QWORD i)
+    {
+        return calcKenoProbabilityExact (rgM[i & dwMask], rgC[i & dwMask]);
+    });
+
+    runner.run ("calcKenoProbabilityLogTable", "keno_probability", [&] (QWORD i)
+    {
+        return calcKenoProbabilityLogTable (g_kenoGeometry, rgM[i & dwMask], rgC[i & dwMask]);
+    });
+
+    runner.run ("buildLogFactorialTable", "log_factorial_table", [&] (QWORD)
+    {
+        buildLogFactorialTable ( );
+        return g_rgLogFactorial[g_MAX_LOG_FACTORIAL];
+    });
+
+    runner.run ("buildProbabilityTable", "probability_table", [&] (QWORD)
+    {
+        buildProbabilityTable ( );
+        return g_rgProbability[g_MAX_ROWS - 1][g_MAX_COLS - 1];
+    });
+
+    // the same table from each replacement kernel
+    static double rgTable[g_MAX_ROWS][g_MAX_COLS];
+
+    runner.run ("buildProbabilityTable/LogGamma", "probability_table", [&] (QWORD)
+    {
+        for ( DWORD m = 1; m <= g_MAX_ROWS; m++ )
+            for ( DWORD c = 0; c <= m; c++ )
+                rgTable[m - 1][c] = calcKenoProbabilityLogGamma (m, c);
+        return rgTable[g_MAX_ROWS - 1][g_MAX_COLS - 1];
+    });
+
+    runner.run ("buildProbabilityTable/Exact", "probability_table", [&] (QWORD)
+    {
+        for ( DWORD m = 1; m <= g_MAX_ROWS; m++ )
+            for ( DWORD c = 0; c <= m; c++ )
+                rgTable[m - 1][c] = calcKenoProbabilityExact (m, c);
+        return rgTable[g_MAX_ROWS - 1][g_MAX_COLS - 1];
+    });
+
+    runner.run ("buildProbabilityTable/LogTable", "probability_table", [&] (QWORD)
+    {
+        for ( DWORD m = 1; m <= g_MAX_ROWS; m++ )
+            calcKenoProbabilityRow (g_kenoGeometry, m, rgTable[m - 1], nullptr);
+        return rgTable[g_MAX_ROWS - 1][g_MAX_COLS - 1];
+    });
+
+    // the same 20 rows of a 10,000 ball pool drawing 1,000
+    const KenoGeometry largePool = { g_MAX_LOG_FACTORIAL, 1000 };
+
+    runner.run ("buildProbabilityTable/LogTable(10000)", "probability_table_10000", [&] (QWORD)
+    {
+        for ( DWORD m = 1; m <= g_MAX_ROWS; m++ )
+            calcKenoProbabilityRow (largePool, m, rgTable[m - 1], nullptr);
+        return rgTable[g_MAX_ROWS - 1][g_MAX_COLS - 1];
+    });
+
+    // the same table mapped from its cache file, written once to the working directory
+    KenoTableCache cache;
+
+    runner.run ("KenoTableCache::open(10000)", "probability_table_10000", [&] (QWORD)
+    {
+        cache.open (_T (""), largePool);
+        return cache.getRow (g_MAX_ROWS)[g_MAX_COLS - 1];
+    });
+
+    runner.run ("buildExpectedValueTable", "expected_value_table", [&] (QWORD)
+    {
+        buildExpectedValueTable ( );
+        return g_rgExpectedValue[g_MAX_SPOTS_MARKED - 1];
+    });
+
+    runner.run ("formatDouble", "format", [&] (QWORD i)
+    {
+        char szBuffer[g_cchMaxFormattedDouble];
+        return static_cast<double>(formatDouble (g_rgProbability[rgM[i & dwMask] - 1][rgC[i & dwMask]], szBuffer));
+    });
+
+    // '-batch' records, answered a block at a time
+    static KenoModel model;
+    buildKenoModel (g_rgPayTableCatalog, g_nPayTableCatalogSize, 1, model);
+
+    KenoBatchAnswers answers;
+    answers.build (model);
+
+    std::string            strRecords;
+    std::vector<KenoQuery> rgQueries (g_dwBenchBatchRecords);
+
+    for ( DWORD i = 0; i < g_dwBenchBatchRecords; i++ )
+    {
+        const DWORD dwSpots = 1 + i % g_MAX_SPOTS_MARKED;
+        const DWORD dwCatch = i % (dwSpots + 1);
+
+        strRecords += std::to_string (dwSpots) + "," + std::to_string (dwCatch) + "," +
+                      std::to_string (i % g_nPayTableCatalogSize) + "\n";
+        rgQueries[i] = { KENO_QUERY_PAY_OUT, static_cast<BYTE>(i % g_nPayTableCatalogSize),
+                         static_cast<BYTE>(dwSpots), static_cast<BYTE>(dwCatch) };
+    }
+
+    std::vector<char>   rgText (g_dwBenchBatchRecords * g_cbMaxBatchAnswer);
+    std::vector<double> rgResults (g_dwBenchBatchRecords);
+
+    runner.run ("KenoBatchAnswers::answerText(4096)", "batch_queries", [&] (QWORD)
+    {
+        size_t cbWritten = 0;
+        QWORD  qwRecords = 0;
+
+        answers.answerText (strRecords.data ( ), strRecords.size ( ), true, rgText.data ( ), rgText.size ( ),
+                            cbWritten, qwRecords);
+        return static_cast<double>(cbWritten);
+    });
+
+    runner.run ("answerQueries(4096)", "batch_queries", [&] (QWORD)
+    {
+        answerQueries (model, rgQueries.data ( ), g_dwBenchBatchRecords, rgResults.data ( ));
+        return rgResults[g_dwBenchBatchRecords - 1];
+    });
+
+    // terminal ticket lines of 1 .. 10 distinct spots
+    const KenoTicketDefaults      defaults   = { 100, 1, 1, 1 };
+    std::string                   strTickets;
+    std::vector<KenoTicketRecord> rgRecords (g_dwBenchBatchRecords);
+    QWORD                         qwState    = 0x5449434BULL;
+
+    for ( DWORD i = 0; i < g_dwBenchBatchRecords; i++ )
+    {
+        const DWORD dwSpots = 1 + i % 10;
+        QWORD       qwMask[2] = { 0, 0 };
+
+        for ( DWORD s = 0; s < dwSpots; )
+        {
+            const DWORD dwBit = static_cast<DWORD>(splitMix64 (qwState) % g_TOTAL_BALLS);
+
+            if ( (qwMask[dwBit >> 6] & (1ULL << (dwBit & 63))) != 0 )
+                continue;
+
+            qwMask[dwBit >> 6] |= 1ULL << (dwBit & 63);
+            strTickets         += ((s++ != 0) ? "," : "") + std::to_string (dwBit + 1);
+        }
+
+        strTickets += "\n";
+    }
+
+    runner.run ("KenoTicketParser::parse(4096)", "ticket_parse", [&] (QWORD)
+    {
+        KenoTicketParser parser (defaults);
+        size_t           nRecords = 0;
+
+        parser.parse (strTickets.data ( ), strTickets.size ( ), true, rgRecords.data ( ), rgRecords.size ( ), nRecords);
+        return static_cast<double>(nRecords);
+    });
+}
+
+/**
+  @brief runs the throughput benchmark for 1, 2, 4 .. and all worker threads
+*/
+static void runThroughputBenchmarks (QWORD qwNumTickets, DWORD dwNumDraws, DWORD dwFavourites, KenoPerfCounters* pCounters,
+                                     bool bAggregate, std::vector<KenoThroughputResult>& rgResults, QWORD& qwNumMasks)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    KenoTicketStore     store;
+    KenoTicketAggregate aggregate;
+    KenoPayLookup       lookup;
+
+    generateTickets (g_qwThroughputTicketSeed, qwNumTickets, store);
+    playFavourites (g_qwThroughputTicketSeed, dwFavourites, store);
+    buildPayLookup (g_rgPayTableCatalog[0], lookup);
+
+    const auto tpAggregate = Clock::now ( );
+    aggregateTickets (store, aggregate);
+    const double fAggregateMs = std::chrono::duration<double, std::milli> (Clock::now ( ) - tpAggregate).count ( );
+
+    const DWORD dwMaxThreads = getWorkerThreadCount ( );
+
+    qwNumMasks = aggregate.getNumMasks ( );
+
+    printf ("%llu tickets, %u draws\n", qwNumTickets, dwNumDraws);
+    printf ("%zu distinct masks, %.3f tickets per mask, aggregated in %.1f ms%s\n", aggregate.getNumMasks ( ),
+            aggregate.getDuplication ( ), fAggregateMs, bAggregate ? "; settling the distinct masks" : "");
+    printf ("threads     draws/s      tickets/s    p50 us    p99 us  efficiency     liability%s\n",
+            (pCounters != nullptr) ? "       IPC  instr/tk  cmiss/tk  bmiss/tk" : "");
+
+    for ( DWORD dwNumThreads = 1; ; dwNumThreads = (2 * dwNumThreads < dwMaxThreads) ? 2 * dwNumThreads : dwMaxThreads )
+    {
+        KenoThroughputResult result;
+        runThroughput (store, lookup, dwNumDraws, g_qwThroughputDrawSeed, dwNumThreads, pCounters, result,
+                       bAggregate ? &aggregate : nullptr);
+
+        const double fSingle = rgResults.empty ( ) ? result.fTicketsPerSecond : rgResults[0].fTicketsPerSecond;
+        result.fEfficiency = result.fTicketsPerSecond / (dwNumThreads * fSingle);
+
+        printf ("%7u %11.1f %14.0f %9.1f %9.1f %11.3f %13.0f", result.dwNumThreads, result.fDrawsPerSecond,
+                result.fTicketsPerSecond, result.fLatencyP50Us, result.fLatencyP99Us, result.fEfficiency,
+                result.fLiability);
+
+        if ( pCounters != nullptr )
+        {
+            printPerfValue (" %9.2f", result.fIPC);
+            printPerfValue (" %9.1f", result.fInstructionsPerTicket);
+            printPerfValue (" %9.4f", result.fCacheMissesPerTicket);
+            printPerfValue (" %9.4f", result.fBranchMissesPerTicket);
+        }
+
+        printf ("\n");
+
+        rgResults.push_back (result);
+
+        if ( dwNumThreads >= dwMaxThreads )
+            break;
+    }
+
+    if ( bAggregate && !rgResults.empty ( ) )
+        printf ("%.0f winning tickets paid out per draw\n", rgResults.back ( ).fWinnersPerDraw);
+
+    printf ("peak RSS %.1f MB\n", getPeakResidentBytes ( ) / (1024.0 * 1024.0));
+}
+
+/**
+  @brief measures the query service with one client and 1 .. 4096 queries per
+         frame, while a publisher swaps in a new model every millisecond
+*/
+static int runServiceBenchmarks (void)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    KenoModelRegistry registry;
+    std::unique_ptr<KenoModel> pModel (new KenoModel);
+
+    buildKenoModel (g_rgPayTableCatalog, g_nPayTableCatalogSize, 1, *pModel);
+    registry.publish (std::move (pModel));
+
+    KenoService       service;
+    KenoServiceClient client;
+
+    if ( !service.start (nullptr, 0, &registry) || !client.connect (nullptr, service.getPort ( )) )
+    {
+        fprintf (stderr, "Cannot start the query service\n");
+        return 1;
+    }
+
+    // the models are built up front, so the publisher measures only the swaps
+    std::atomic<bool>   bStop (false);
+    std::vector<double> rgSwapUs;
+
+    std::thread publisher ([&registry, &bStop, &rgSwapUs] ( )
+    {
+        KenoModel model;
+        buildKenoModel (g_rgPayTableCatalog, g_nPayTableCatalogSize, 1, model);
+
+        for ( DWORD dwVersion = 2; !bStop; dwVersion++ )
+        {
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+
+            model.dwVersion = dwVersion;
+            registry.publish (std::unique_ptr<KenoModel> (new KenoModel (model)));
+            rgSwapUs.push_back (registry.getLastSwapUs ( ));
+        }
+    });
+
+    printf ("  batch      queries/s    p50 us    p99 us\n");
+
+    for ( DWORD dwBatch = 1; dwBatch <= g_dwMaxQueriesPerFrame; dwBatch *= 16 )
+    {
+        std::vector<KenoQuery> rgQueries (dwBatch);
+        std::vector<double>    rgResults (dwBatch);
+        std::vector<double>    rgLatencyUs;
+
+        // every query type, spread over the rows
+        for ( DWORD i = 0; i < dwBatch; i++ )
+            rgQueries[i] = { static_cast<BYTE>(i % KENO_QUERY_TYPE_COUNT), 0, static_cast<BYTE>(1 + i % g_MAX_SPOTS_MARKED),
+                             static_cast<BYTE>(i % 2) };
+
+        const auto tpStart = Clock::now ( );
+        auto       tpNow   = tpStart;
+
+        while ( tpNow - tpStart < std::chrono::milliseconds (5 * g_dwBenchMinMilliseconds) )
+        {
+            if ( !client.query (rgQueries.data ( ), dwBatch, rgResults.data ( )) )
+            {
+                fprintf (stderr, "Query failed\n");
+                bStop = true;
+                publisher.join ( );
+                return 1;
+            }
+
+            const auto tpDone = Clock::now ( );
+            rgLatencyUs.push_back (std::chrono::duration<double, std::micro> (tpDone - tpNow).count ( ));
+            tpNow = tpDone;
+        }
+
+        const double fSeconds = std::chrono::duration<double> (tpNow - tpStart).count ( );
+
+        std::sort (rgLatencyUs.begin ( ), rgLatencyUs.end ( ));
+
+        printf ("%7u %14.0f %9.1f %9.1f\n", dwBatch, rgLatencyUs.size ( ) * dwBatch / fSeconds,
+                rgLatencyUs[rgLatencyUs.size ( ) / 2], rgLatencyUs[(rgLatencyUs.size ( ) * 99) / 100]);
+    }
+
+    bStop = true;
+    publisher.join ( );
+
+    std::sort (rgSwapUs.begin ( ), rgSwapUs.end ( ));
+
+    if ( !rgSwapUs.empty ( ) )
+        printf ("%u model swaps, p50 %.1f us, p99 %.1f us, max %.1f us\n", registry.getNumSwaps ( ),
+                rgSwapUs[rgSwapUs.size ( ) / 2], rgSwapUs[(rgSwapUs.size ( ) * 99) / 100], registry.getMaxSwapUs ( ));
+
+    return 0;
+}
+
+/**
+  @brief writes a histogram of 'qwNumRows' rows as a columnar file, plain and
+         delta coded, and maps and reads it back, then writes it as CSV and TSV
+*/
+static int runExportBenchmarks (QWORD qwNumRows)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const TCHAR* szPath = _T ("KenoBenchExport.kcol");
+
+    // a sorted key and geometric counts, like a histogram of catch sequences
+    KenoExportTable table;
+    table.qwNumRows = qwNumRows;
+
+    QWORD* rgKey   = table.addColumn<QWORD> ("key",   KENO_COLUMN_U64);
+    QWORD* rgCount = table.addColumn<QWORD> ("count", KENO_COLUMN_U64);
+    QWORD  qwState = 0x4B454E4FULL;
+
+    for ( QWORD r = 0; r < qwNumRows; r++ )
+    {
+        rgKey[r]   = r * 3;
+        rgCount[r] = countBits (splitMix64 (qwState) & 0xFFFF);
+    }
+
+    const double       fMegabytes = 2.0 * qwNumRows * sizeof (QWORD) / (1024.0 * 1024.0);
+    std::vector<QWORD> rgRead (static_cast<size_t>(qwNumRows));
+
+    printf ("  codec          write MB/s   file MB   ratio   read MB/s\n");
+
+    for ( KenoColumnCodec eCodec : { KENO_CODEC_NONE, KENO_CODEC_DELTA_VARINT } )
+    {
+        const auto tpStart = Clock::now ( );
+
+        if ( !writeColumnarTable (szPath, table, eCodec) )
+        {
+            fprintf (stderr, "Cannot write the columnar file\n");
+            return 1;
+        }
+
+        const auto tpWritten = Clock::now ( );
+
+        KenoColumnarFile file;
+        bool             bRead = file.open (szPath);
+
+        for ( int c = 0; bRead && (c < file.getNumColumns ( )); c++ )
+            bRead = file.readColumn (c, rgRead.data ( )) && (memcmp (rgRead.data ( ), table.rgColumns[c].pData, rgRead.size ( ) * sizeof (QWORD)) == 0);
+
+        const auto   tpRead  = Clock::now ( );
+        const double fFileMB = file.isOpen ( ) ? file.getFileSize ( ) / (1024.0 * 1024.0) : 0.0;
+
+        file.close ( );
+        _tremove (szPath);
+
+        if ( !bRead )
+        {
+            fprintf (stderr, "The columnar file does not read back\n");
+            return 1;
+        }
+
+        printf ("  %-12s %12.0f %9.1f %7.2f %11.0f\n", (eCodec == KENO_CODEC_NONE) ? "none" : "delta_varint",
+                fMegabytes / std::chrono::duration<double> (tpWritten - tpStart).count ( ), fFileMB, fMegabytes / fFileMB,
+                fMegabytes / std::chrono::duration<double> (tpRead - tpWritten).count ( ));
+    }
+
+    const TCHAR*        szTextPath = _T ("KenoBenchExport.txt");
+    KenoDelimitedWriter writer;
+
+    printf ("\n  format         write MB/s   file MB     Mrows/s\n");
+
+    for ( KenoDelimitedFormat eFormat : { KENO_DELIMITED_CSV, KENO_DELIMITED_TSV } )
+    {
+        const auto tpStart = Clock::now ( );
+
+        if ( !writer.write (szTextPath, table, eFormat) )
+        {
+            fprintf (stderr, "Cannot write the text file\n");
+            return 1;
+        }
+
+        const double fSeconds = std::chrono::duration<double> (Clock::now ( ) - tpStart).count ( );
+
+        KenoMappedFile file;
+        const double   fFileMB = file.open (szTextPath) ? file.getSize ( ) / (1024.0 * 1024.0) : 0.0;
+
+        file.close ( );
+        _tremove (szTextPath);
+
+        printf ("  %-12s %12.0f %9.1f %11.1f\n", (eFormat == KENO_DELIMITED_CSV) ? "csv" : "tsv",
+                fFileMB / fSeconds, fFileMB, qwNumRows / fSeconds / 1e6);
+    }
+
+    return 0;
+}
+
+/**
+  @brief the seeded ticket population of -throughput as wire records, with
+         sequential ticket ids
+*/
+static void generateTicketRecords (QWORD qwNumTickets, std::vector<KenoTicketRecord>& rgRecords)
+{
+    KenoTicketStore source;
+    generateTickets (g_qwThroughputTicketSeed, qwNumTickets, source);
+
+    rgRecords.resize (source.size ( ));
+
+    for ( size_t i = 0; i < source.size ( ); i++ )
+    {
+        KenoTicketRecord& record = rgRecords[i];
+
+        memset (&record, 0, sizeof (record));
+        record.qwMaskLo   = source.rgMaskLo[i];
+        record.qwMaskHi   = source.rgMaskHi[i];
+        record.qwTicketId = i;
+        record.dwWager    = static_cast<DWORD>(source.rgWager[i] * g_fWagerCentsPerUnit + 0.5);
+        record.wNumDraws  = 1;
+        record.bySpots    = source.rgSpots[i];
+    }
+}
+
+/**
+  @brief pushes 'qwNumTickets' tickets from 'dwNumProducers' threads in 64
+         ticket batches while the calling thread drains them into a
+         settlement store, and reports tickets/s and every producer's counts
+*/
+static int runIngestBenchmark (QWORD qwNumTickets, DWORD dwNumProducers)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    if ( (dwNumProducers == 0) || (dwNumProducers > static_cast<DWORD>(g_MAX_INGEST_PRODUCERS)) )
+    {
+        fprintf (stderr, "-producers must be 1 .. %d\n", g_MAX_INGEST_PRODUCERS);
+        return 1;
+    }
+
+    std::vector<KenoTicketRecord> rgRecords;
+    generateTicketRecords (qwNumTickets, rgRecords);
+
+    KenoIngestQueue          queue;
+    KenoTicketStore          store;
+    std::vector<int>         rgSlots (dwNumProducers);
+    std::vector<std::thread> rgProducers;
+    std::atomic<bool>        bGo (false);
+
+    store.reserve (rgRecords.size ( ));
+
+    for ( DWORD p = 0; p < dwNumProducers; p++ )
+        rgSlots[p] = queue.registerProducer ( );
+
+    for ( DWORD p = 0; p < dwNumProducers; p++ )
+    {
+        const size_t nBegin = rgRecords.size ( ) * p / dwNumProducers;
+        const size_t nEnd   = rgRecords.size ( ) * (p + 1) / dwNumProducers;
+        const int    nSlot  = rgSlots[p];
+
+        rgProducers.emplace_back ([&queue, &rgRecords, &bGo, nBegin, nEnd, nSlot] ( )
+        {
+            while ( !bGo.load (std::memory_order_acquire) )
+                std::this_thread::yield ( );
+
+            for ( size_t i = nBegin; i < nEnd; i += g_nMaxIngestClaim )
+                queue.push (nSlot, &rgRecords[i], ((nEnd - i) < g_nMaxIngestClaim) ? (nEnd - i) : g_nMaxIngestClaim);
+        });
+    }
+
+    const auto tpStart = Clock::now ( );
+    bGo.store (true, std::memory_order_release);
+
+    for ( QWORD qwDrained = 0; qwDrained < rgRecords.size ( ); )
+    {
+        const size_t nDrained = queue.drain (store, queue.getCapacity ( ));
+
+        if ( nDrained == 0 )
+            std::this_thread::yield ( );
+
+        qwDrained += nDrained;
+    }
+
+    const double fSeconds = std::chrono::duration<double> (Clock::now ( ) - tpStart).count ( );
+
+    for ( std::thread& producer : rgProducers )
+        producer.join ( );
+
+    printf ("%u producers, %zu tickets, %.2f M tickets/s, %llu refused\n", dwNumProducers, store.size ( ),
+            rgRecords.size ( ) / fSeconds / 1e6, queue.getNumRefused ( ));
+    printf ("  producer     tickets    batches       full  contended\n");
+
+    for ( DWORD p = 0; p < dwNumProducers; p++ )
+    {
+        KenoIngestStats stats;
+        queue.getProducerStats (rgSlots[p], stats);
+        queue.unregisterProducer (rgSlots[p]);
+
+        printf ("  %8u %11llu %10llu %10llu %10llu\n", p, stats.qwTickets, stats.qwBatches, stats.qwFull, stats.qwContended);
+    }
+
+    return 0;
+}
+
+/**
+  @brief removes the journal segments of the working directory
+*/
+static void removeJournalSegments (void)
+{
+    TCHAR szPath[_MAX_PATH] = { 0 };
+
+    for ( QWORD q = 0; getJournalSegmentPath (_T (""), q, szPath, _countof (szPath)) && (_tremove (szPath) == 0); q++ )
+        ;
+}
+
+/**
+  @brief appends 'qwNumTickets' tickets to a journal in the working directory
+         from 'dwNumProducers' threads, 64 tickets per append, then rebuilds
+         a settlement store from it, and reports tickets/s, tickets per
+         group commit and the replay bandwidth
+*/
+static int runJournalBenchmark (QWORD qwNumTickets, DWORD dwNumProducers)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    if ( dwNumProducers == 0 )
+    {
+        fprintf (stderr, "-producers must be at least 1\n");
+        return 1;
+    }
+
+    std::vector<KenoTicketRecord> rgRecords;
+    generateTicketRecords (qwNumTickets, rgRecords);
+
+    removeJournalSegments ( );
+
+    KenoJournalWriter writer;
+
+    if ( !writer.open (_T ("")) )
+    {
+        fprintf (stderr, "cannot create a journal segment in the working directory\n");
+        return 1;
+    }
+
+    std::vector<std::thread> rgProducers;
+    std::atomic<bool>        bFailed (false);
+
+    const auto tpStart = Clock::now ( );
+
+    for ( DWORD p = 0; p < dwNumProducers; p++ )
+    {
+        const size_t nBegin = rgRecords.size ( ) * p / dwNumProducers;
+        const size_t nEnd   = rgRecords.size ( ) * (p + 1) / dwNumProducers;
+
+        rgProducers.emplace_back ([&writer, &rgRecords, &bFailed, nBegin, nEnd] ( )
+        {
+            for ( size_t i = nBegin; i < nEnd; i += g_nMaxIngestClaim )
+            {
+                if ( !writer.append (&rgRecords[i], ((nEnd - i) < g_nMaxIngestClaim) ? (nEnd - i) : g_nMaxIngestClaim) )
+                    bFailed.store (true);
+            }
+        });
+    }
+
+    for ( std::thread& producer : rgProducers )
+        producer.join ( );
+
+    const double fAppendSeconds = std::chrono::duration<double> (Clock::now ( ) - tpStart).count ( );
+    const QWORD  qwBatches      = writer.getNumBatches ( );
+
+    writer.close ( );
+
+    KenoTicketStore   store;
+    KenoJournalReplay replay;
+
+    const auto tpReplay = Clock::now ( );
+    const bool bReplayed = replayJournal (_T (""), store, replay);
+    const double fReplaySeconds = std::chrono::duration<double> (Clock::now ( ) - tpReplay).count ( );
+
+    removeJournalSegments ( );
+
+    if ( bFailed.load ( ) || !bReplayed || (replay.qwRecords != rgRecords.size ( )) )
+    {
+        fprintf (stderr, "the journal lost tickets: %llu of %zu replayed\n", replay.qwRecords, rgRecords.size ( ));
+        return 1;
+    }
+
+    printf ("%u producers, %zu tickets, %.2f M tickets/s appended, %llu group commits, %.1f tickets per commit\n",
+            dwNumProducers, rgRecords.size ( ), rgRecords.size ( ) / fAppendSeconds / 1e6, qwBatches,
+            static_cast<double>(rgRecords.size ( )) / qwBatches);
+    printf ("replay: %llu segments, %.1f MB, %.3f s, %.0f MB/s, %.2f M tickets/s\n", replay.qwSegments,
+            replay.qwBytes / 1e6, fReplaySeconds, replay.qwBytes / fReplaySeconds / 1e6,
+            replay.qwRecords / fReplaySeconds / 1e6);
+
+    return 0;
+}
+
+/**
+  @brief writes 'qwNumTickets' tickets and 'dwNumDraws' draws as archives in
+         the working directory, reads them back and replays the tickets into
+         a settlement store, and reports the compression ratios, the encode
+         and decode bandwidth of the uncompressed records and tickets/s
+*/
+static int runArchiveBenchmark (QWORD qwNumTickets, DWORD dwNumDraws)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const TCHAR* szTicketPath = _T ("KenoBench_Tickets.kar");
+    const TCHAR* szDrawPath   = _T ("KenoBench_Draws.kar");
+
+    std::vector<KenoTicketRecord> rgRecords;
+    generateTicketRecords (qwNumTickets, rgRecords);
+
+    // favourite numbers, played over and over
+    for ( size_t i = 0; i < rgRecords.size ( ); i += g_nArchiveFavouriteEvery )
+    {
+        const KenoTicketRecord& favourite = rgRecords[(i / g_nArchiveFavouriteEvery) % g_nArchiveFavourites];
+
+        rgRecords[i].qwMaskLo = favourite.qwMaskLo;
+        rgRecords[i].qwMaskHi = favourite.qwMaskHi;
+        rgRecords[i].bySpots  = favourite.bySpots;
+    }
+
+    std::vector<KenoDraw> rgDraws (dwNumDraws);
+    KenoRng               rng;
+
+    rng.seed (g_qwThroughputDrawSeed);
+
+    for ( KenoDraw& draw : rgDraws )
+        drawKenoBalls (rng, draw);
+
+    KenoArchiveWriter writer;
+
+    const auto tpStart = Clock::now ( );
+    bool       bResult = writer.open (szTicketPath, KENO_ARCHIVE_TICKETS) &&
+                         writer.appendTickets (rgRecords.data ( ), rgRecords.size ( )) && writer.close ( );
+    const double fEncodeSeconds = std::chrono::duration<double> (Clock::now ( ) - tpStart).count ( );
+
+    bResult = bResult && writer.open (szDrawPath, KENO_ARCHIVE_DRAWS) &&
+              writer.appendDraws (rgDraws.data ( ), rgDraws.size ( )) && writer.close ( );
+
+    KenoArchiveFile               tickets;
+    KenoArchiveFile               draws;
+    std::vector<KenoTicketRecord> rgRead;
+    std::vector<KenoDraw>         rgReadDraws;
+    KenoTicketStore               store;
+    QWORD                         qwRefused = 0;
+
+    bResult = bResult && tickets.open (szTicketPath) && draws.open (szDrawPath);
+
+    rgRead.reserve (rgRecords.size ( ));
+    store.reserve (rgRecords.size ( ));
+
+    double fDecodeSeconds = 0.0;
+
+    // the best of 3, the first one also paying for the page faults
+    for ( int nPass = 0; bResult && (nPass < 3); nPass++ )
+    {
+        rgRead.clear ( );
+
+        const auto tpDecode = Clock::now ( );
+        bResult = tickets.readTickets (rgRead);
+        const double fSeconds = std::chrono::duration<double> (Clock::now ( ) - tpDecode).count ( );
+
+        fDecodeSeconds = ((nPass == 0) || (fSeconds < fDecodeSeconds)) ? fSeconds : fDecodeSeconds;
+    }
+
+    const auto   tpReplay       = Clock::now ( );
+    bResult = bResult && tickets.replayTickets (store, qwRefused);
+    const double fReplaySeconds = std::chrono::duration<double> (Clock::now ( ) - tpReplay).count ( );
+
+    const auto   tpDraws        = Clock::now ( );
+    bResult = bResult && draws.readDraws (rgReadDraws);
+    const double fDrawSeconds   = std::chrono::duration<double> (Clock::now ( ) - tpDraws).count ( );
+
+    const QWORD cbTickets = tickets.getFileSize ( );
+    const QWORD cbDraws   = draws.getFileSize ( );
+
+    tickets.close ( );
+    draws.close ( );
+    _tremove (szTicketPath);
+    _tremove (szDrawPath);
+
+    if ( !bResult || (rgRead.size ( ) != rgRecords.size ( )) || (rgReadDraws.size ( ) != rgDraws.size ( )) ||
+         (memcmp (rgRead.data ( ), rgRecords.data ( ), rgRecords.size ( ) * sizeof (KenoTicketRecord)) != 0) )
+    {
+        fprintf (stderr, "the archives do not read back the tickets and draws written\n");
+        return 1;
+    }
+
+    for ( size_t i = 0; i < rgDraws.size ( ); i++ )
+    {
+        if ( (rgReadDraws[i].qwMaskLo != rgDraws[i].qwMaskLo) || (rgReadDraws[i].qwMaskHi != rgDraws[i].qwMaskHi) ||
+             (rgReadDraws[i].rgBalls[g_BALLS_DRAWN - 1] != rgDraws[i].rgBalls[g_BALLS_DRAWN - 1]) )
+        {
+            fprintf (stderr, "draw %zu does not read back as written\n", i);
+            return 1;
+        }
+    }
+
+    const double fRecordBytes = static_cast<double>(rgRecords.size ( )) * sizeof (KenoTicketRecord);
+
+    printf ("tickets: %zu, %.1f MB as records, %.1f MB archived, ratio %.2f, %.1f bytes/ticket\n", rgRecords.size ( ),
+            fRecordBytes / 1e6, cbTickets / 1e6, fRecordBytes / cbTickets, static_cast<double>(cbTickets) / rgRecords.size ( ));
+    printf ("  encode %.0f MB/s, decode %.2f GB/s, replay %.2f M tickets/s, %llu refused\n",
+            fRecordBytes / fEncodeSeconds / 1e6, fRecordBytes / fDecodeSeconds / 1e9,
+            store.size ( ) / fReplaySeconds / 1e6, qwRefused);
+    printf ("draws: %zu, %.2f bytes/draw, ratio %.2f, decode %.2f M draws/s\n", rgDraws.size ( ),
+            static_cast<double>(cbDraws) / rgDraws.size ( ), static_cast<double>(rgDraws.size ( )) * sizeof (KenoDraw) / cbDraws,
+            rgDraws.size ( ) / fDrawSeconds / 1e6);
+
+    return 0;
+}
+
+int _tmain (int argc, _TCHAR* argv[])
+{
+    char         szFilter[64]  = { 0 };
+    char         szLabel[128]  = { 0 };
+    const TCHAR* szJsonPath    = nullptr;
+    bool         bThroughput   = false;
+    bool         bPerf         = false;
+    bool         bAggregate    = false;
+    bool         bService      = false;
+    bool         bExport       = false;
+    bool         bIngest       = false;
+    bool         bJournal      = false;
+    bool         bArchive      = false;
+    DWORD        dwProducers   = g_dwDefaultIngestProducers;
+    QWORD        qwNumRows     = g_qwDefaultExportRows;
+    QWORD        qwNumTickets  = g_qwDefaultThroughputTickets;
+    DWORD        dwNumDraws    = g_dwDefaultThroughputDraws;
+    DWORD        dwFavourites  = 0;
+
+    for ( int i = 1; i < argc; i++ )
+    {
+        const bool bHasValue = (i + 1 < argc);
+
+        if ( _tcscmp (argv[i], _T ("-throughput")) == 0 )
+            bThroughput = true;
+        else if ( _tcscmp (argv[i], _T ("-perf")) == 0 )
+            bPerf = true;
+        else if ( _tcscmp (argv[i], _T ("-aggregate")) == 0 )
+            bAggregate = true;
+        else if ( _tcscmp (argv[i], _T ("-service")) == 0 )
+            bService = true;
+        else if ( _tcscmp (argv[i], _T ("-export")) == 0 )
+            bExport = true;
+        else if ( _tcscmp (argv[i], _T ("-ingest")) == 0 )
+            bIngest = true;
+        else if ( _tcscmp (argv[i], _T ("-journal")) == 0 )
+            bJournal = true;
+        else if ( _tcscmp (argv[i], _T ("-archive")) == 0 )
+            bArchive = true;
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-producers")) == 0) )
+            dwProducers = static_cast<DWORD>(_tcstoul (argv[++i], nullptr, 10));
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-rows")) == 0) )
+            qwNumRows = _tcstoui64 (argv[++i], nullptr, 10);
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-filter")) == 0) )
+            toNarrow (argv[++i], szFilter, _countof (szFilter));
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-label")) == 0) )
+            toNarrow (argv[++i], szLabel, _countof (szLabel));
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-json")) == 0) )
+            szJsonPath = argv[++i];
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-tickets")) == 0) )
+            qwNumTickets = _tcstoui64 (argv[++i], nullptr, 10);
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-draws")) == 0) )
+            dwNumDraws = static_cast<DWORD>(_tcstoul (argv[++i], nullptr, 10));
+        else if ( bHasValue && (_tcscmp (argv[i], _T ("-favourites")) == 0) )
+            dwFavourites = static_cast<DWORD>(_tcstoul (argv[++i], nullptr, 10));
+    }
+
+    // the lookup and the expected value benchmarks need the tables in place
+    initBenchArgs ( );
+    buildLogFactorialTable ( );
+    buildProbabilityTable ( );
+    buildExpectedValueTable ( );
+
+    if ( bService )
+        return runServiceBenchmarks ( );
+
+    if ( bExport )
+        return runExportBenchmarks (qwNumRows);
+
+    if ( bIngest )
+        return runIngestBenchmark (qwNumTickets, dwProducers);
+
+    if ( bJournal )
+        return runJournalBenchmark (qwNumTickets, dwProducers);
+
+    if ( bArchive )
+        return runArchiveBenchmark (qwNumTickets, dwNumDraws);
+
+    // opened before any worker thread is created, so the workers inherit them
+    KenoPerfCounters counters;
+    const char*      szCounters = "disabled";
+
+    if ( bPerf )
+    {
+        counters.open ( );
+        szCounters = counters.getStatus ( );
+
+        printf ("hardware counters: %s\n", szCounters);
+    }
+
+    KenoBenchRunner                   runner;
+    std::vector<KenoThroughputResult> rgThroughput;
+    QWORD                             qwNumMasks = 0;
+    KenoPerfCounters*                 pCounters = (counters.getNumAvailable ( ) > 0) ? &counters : nullptr;
+
+    runner.szFilter  = szFilter;
+    runner.pCounters = pCounters;
+
+    if ( bThroughput )
+        runThroughputBenchmarks (qwNumTickets, dwNumDraws, dwFavourites, pCounters, bAggregate, rgThroughput, qwNumMasks);
+    else
+        runKernelBenchmarks (runner);
+
+    if ( szJsonPath != nullptr )
+    {
+        const bool bStdout = (_tcscmp (szJsonPath, _T ("-")) == 0);
+
+        FILE* pFile = bStdout ? stdout : _tfopen (szJsonPath, _T ("w"));
+        if ( pFile == nullptr )
+        {
+            _ftprintf (stderr, _T ("Cannot open '%s'\n"), szJsonPath);
+            return 1;
+        }
+
+        const bool bWritten = bThroughput ?
+            writeThroughputJson (pFile, szLabel, szCounters, qwNumTickets, dwNumDraws, getPeakResidentBytes ( ),
+                                 rgThroughput, qwNumMasks, dwFavourites, bAggregate) :
+            writeBenchmarkJson (pFile, szLabel, szCounters, runner.rgResults);
+
+        if ( !bStdout )
+            fclose (pFile);
+
+        if ( !bWritten )
+            return 1;
+    }
+
+    return 0;
+}
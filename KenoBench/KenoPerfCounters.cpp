@@ -0,0 +1,165 @@
+/**
+@file       KenoPerfCounters.cpp
+@brief      Implementation of the hardware performance counter access
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include "KenoPerfCounters.h"
+
+#ifdef __linux__
+    #include <errno.h>
+    #include <string.h>
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <linux/perf_event.h>
+#endif
+
+
+KenoPerfCounters::KenoPerfCounters ( )
+    : m_nAvailable (0),
+      m_szStatus   ("not opened")
+{
+    for ( auto& iFd : m_rgFd )
+        iFd = -1;
+}
+
+KenoPerfCounters::~KenoPerfCounters ( )
+{
+    close ( );
+}
+
+#ifdef __linux__
+
+/// the generic hardware events, in KenoPerfCounter order
+static const unsigned long long g_rgPerfEventConfig[KENO_PERF_COUNTER_COUNT] =
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/// value read from a counter opened with the time enabled / running read format
+struct KenoPerfReading
+{
+    unsigned long long qwValue;
+    unsigned long long qwTimeEnabled;
+    unsigned long long qwTimeRunning;
+};
+
+int KenoPerfCounters::open (void)
+{
+    close ( );
+
+    int iLastError = 0;
+
+    for ( int c = 0; c < KENO_PERF_COUNTER_COUNT; c++ )
+    {
+        struct perf_event_attr attr;
+        memset (&attr, 0, sizeof (attr));
+
+        attr.size           = sizeof (attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = g_rgPerfEventConfig[c];
+        attr.disabled       = 1;
+        attr.inherit        = 1;    // count the worker threads created while counting
+        attr.exclude_kernel = 1;    // user mode only, allowed up to perf_event_paranoid 2
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        m_rgFd[c] = static_cast<int>(syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0));
+
+        if ( m_rgFd[c] >= 0 )
+            m_nAvailable++;
+        else
+            iLastError = errno;
+    }
+
+    if ( m_nAvailable == KENO_PERF_COUNTER_COUNT )
+        m_szStatus = "available";
+    else if ( m_nAvailable > 0 )
+        m_szStatus = "partially available";
+    else if ( (iLastError == EACCES) || (iLastError == EPERM) )
+        m_szStatus = "not permitted (see /proc/sys/kernel/perf_event_paranoid)";
+    else if ( iLastError == ENOSYS )
+        m_szStatus = "perf_event_open not supported";
+    else
+        m_szStatus = "no hardware counters (container or virtual machine)";
+
+    return m_nAvailable;
+}
+
+void KenoPerfCounters::close (void)
+{
+    for ( auto& iFd : m_rgFd )
+    {
+        if ( iFd >= 0 )
+            ::close (iFd);
+        iFd = -1;
+    }
+
+    m_nAvailable = 0;
+}
+
+void KenoPerfCounters::start (void)
+{
+    for ( int iFd : m_rgFd )
+    {
+        if ( iFd >= 0 )
+        {
+            ioctl (iFd, PERF_EVENT_IOC_RESET, 0);
+            ioctl (iFd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void KenoPerfCounters::stop (KenoPerfSample& sample)
+{
+    for ( int c = 0; c < KENO_PERF_COUNTER_COUNT; c++ )
+    {
+        sample.rgCount[c] = -1.0;
+
+        if ( m_rgFd[c] < 0 )
+            continue;
+
+        ioctl (m_rgFd[c], PERF_EVENT_IOC_DISABLE, 0);
+
+        KenoPerfReading reading;
+
+        if ( (read (m_rgFd[c], &reading, sizeof (reading)) == sizeof (reading)) && (reading.qwTimeRunning > 0) )
+        {
+            // scale up a counter that shared the PMU with others
+            sample.rgCount[c] = static_cast<double>(reading.qwValue) *
+                                (static_cast<double>(reading.qwTimeEnabled) / reading.qwTimeRunning);
+        }
+    }
+}
+
+#else
+
+int KenoPerfCounters::open (void)
+{
+    m_szStatus = "only supported on Linux";
+    return 0;
+}
+
+void KenoPerfCounters::close (void)
+{
+    m_nAvailable = 0;
+}
+
+void KenoPerfCounters::start (void)
+{
+}
+
+void KenoPerfCounters::stop (KenoPerfSample& sample)
+{
+    for ( auto& fCount : sample.rgCount )
+        fCount = -1.0;
+}
+
+#endif
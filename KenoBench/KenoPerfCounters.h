@@ -0,0 +1,86 @@
+/**
+@file       KenoPerfCounters.h
+@brief      Hardware performance counter access for the benchmarks
+
+  On Linux the counters are read through perf_event_open: CPU cycles,
+  retired instructions, last level cache misses and mispredicted branches,
+  counted in user mode for the calling thread and every thread it creates
+  while counting.  Any counter the kernel refuses (no PMU in a container or
+  virtual machine, perf_event_paranoid, seccomp) is reported as unavailable
+  and the benchmarks carry on without it; on other platforms none is.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_PERF_COUNTERS_H__
+#define __KENO_PERF_COUNTERS_H__
+
+#include "KenoProbability.h"
+
+enum KenoPerfCounter
+{
+    KENO_PERF_CYCLES = 0,
+    KENO_PERF_INSTRUCTIONS,
+    KENO_PERF_CACHE_MISSES,
+    KENO_PERF_BRANCH_MISSES,
+    KENO_PERF_COUNTER_COUNT
+};
+
+/**
+  Counts of one measured region; a count is negative if the counter is
+  unavailable.  Counts are scaled up if the kernel multiplexed the counter.
+*/
+struct KenoPerfSample
+{
+    double rgCount[KENO_PERF_COUNTER_COUNT];
+
+    bool   isValid (KenoPerfCounter eCounter) const { return rgCount[eCounter] >= 0.0; }
+};
+
+class KenoPerfCounters
+{
+public:
+    KenoPerfCounters  ( );
+    ~KenoPerfCounters ( );
+
+    /**
+      @brief opens every counter the platform allows
+
+      @retval int           number of available counters, 0 if none
+    */
+    int  open  (void);
+    void close (void);
+
+    /**
+      @brief resets and starts the available counters
+    */
+    void start (void);
+
+    /**
+      @brief stops the counters and returns the counts since start
+    */
+    void stop  (KenoPerfSample& sample);
+
+    int  getNumAvailable (void) const { return m_nAvailable; }
+
+    /**
+      @brief why no counter could be opened, for the benchmark report
+    */
+    const char* getStatus (void) const { return m_szStatus; }
+
+private:
+    int         m_rgFd[KENO_PERF_COUNTER_COUNT];
+    int         m_nAvailable;
+    const char* m_szStatus;
+};
+
+/**
+  @brief ratio of two counts, or -1 if either is unavailable
+*/
+inline double calcPerfRatio (double fNumerator, double fDenominator)
+{
+    return ((fNumerator >= 0.0) && (fDenominator > 0.0)) ? fNumerator / fDenominator : -1.0;
+}
+
+#endif
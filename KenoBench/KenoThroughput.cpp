@@ -0,0 +1,333 @@
+/**
+@file       KenoThroughput.cpp
+@brief      Implementation of the throughput benchmark
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include "KenoBench.h"
+#include "KenoThroughput.h"
+
+#ifdef _WIN32
+    #include <Psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+
+/// share of the tickets, in 1/1000, by spots marked 1 .. 9
+static const DWORD g_rgThroughputSpotMix[g_MAX_SPOTS_MARKED] = { 40, 80, 120, 150, 160, 140, 120, 100, 90 };
+
+struct KenoWagerShare
+{
+    double fWager;
+    DWORD  dwShare;             //< in 1/1000
+};
+
+static const KenoWagerShare g_rgThroughputWagerMix[] = { { 1.0, 600 }, { 2.0, 250 }, { 5.0, 100 }, { 10.0, 50 } };
+
+
+/// uniform integer in 0 .. dwRange - 1 from the upper 32 bits of a random value
+static inline DWORD uniformBelow (KenoRng& rng, DWORD dwRange)
+{
+    return static_cast<DWORD>(((rng.next ( ) >> 32) * dwRange) >> 32);
+}
+
+void generateTickets (QWORD qwSeed, QWORD qwNumTickets, KenoTicketStore& store)
+{
+    KenoRng rng;
+    rng.seed (qwSeed);
+
+    store.clear ( );
+    store.reserve (static_cast<size_t>(qwNumTickets));
+
+    for ( QWORD t = 0; t < qwNumTickets; t++ )
+    {
+        KenoTicket ticket = { };
+
+        DWORD dwPick = uniformBelow (rng, 1000);
+        ticket.dwSpots = 1;
+        while ( dwPick >= g_rgThroughputSpotMix[ticket.dwSpots - 1] )
+            dwPick -= g_rgThroughputSpotMix[ticket.dwSpots++ - 1];
+
+        dwPick = uniformBelow (rng, 1000);
+        int w = 0;
+        while ( dwPick >= g_rgThroughputWagerMix[w].dwShare )
+            dwPick -= g_rgThroughputWagerMix[w++].dwShare;
+        ticket.fWager = g_rgThroughputWagerMix[w].fWager;
+
+        for ( DWORD n = 0; n < ticket.dwSpots; )
+        {
+            const DWORD dwBall = uniformBelow (rng, g_TOTAL_BALLS);
+            QWORD&      qwMask = (dwBall < 64) ? ticket.qwMaskLo : ticket.qwMaskHi;
+            const QWORD qwBit  = 1ULL << (dwBall & 63);
+
+            if ( (qwMask & qwBit) == 0 )
+            {
+                qwMask |= qwBit;
+                n++;
+            }
+        }
+
+        store.add (ticket);
+    }
+}
+
+void playFavourites (QWORD qwSeed, DWORD dwPercent, KenoTicketStore& store)
+{
+    const size_t nFavourites = (store.size ( ) < g_dwThroughputFavourites) ? store.size ( ) : g_dwThroughputFavourites;
+
+    KenoRng rng;
+    rng.seed (qwSeed);
+
+    for ( size_t i = nFavourites; i < store.size ( ); i++ )
+    {
+        if ( uniformBelow (rng, 100) >= dwPercent )
+            continue;
+
+        const size_t f = uniformBelow (rng, static_cast<DWORD>(nFavourites));
+
+        store.rgMaskLo[i] = store.rgMaskLo[f];
+        store.rgMaskHi[i] = store.rgMaskHi[f];
+        store.rgSpots[i]  = store.rgSpots[f];
+    }
+}
+
+
+/// hands each draw to the workers and waits for them to settle their share
+struct ThroughputPool
+{
+    const KenoTicketStore*                      pStore;
+    const KenoTicketAggregate*                  pAggregate;     //< settled instead of pStore if not nullptr
+    const KenoPayLookup*                        pLookup;
+    DWORD                                       dwNumThreads;
+    KenoDraw                                    draw;
+    QWORD                                       qwGeneration;   //< incremented for every draw
+    DWORD                                       dwPending;      //< workers still settling the current draw
+    bool                                        bStop;
+    std::vector<double>                         rgPayOut;       //< per thread share of the current draw
+    std::vector<std::vector<KenoTicketPayOut>>  rgWinners;      //< per thread winners of the current draw
+    std::mutex                                  lock;
+    std::condition_variable                     cvDraw;
+    std::condition_variable                     cvDone;
+};
+
+static void settleShare (ThroughputPool& pool, DWORD t)
+{
+    if ( pool.pAggregate != nullptr )
+    {
+        const size_t nMasks = pool.pAggregate->getNumMasks ( );
+        const size_t nBegin = nMasks * t / pool.dwNumThreads;
+        const size_t nEnd   = nMasks * (t + 1) / pool.dwNumThreads;
+
+        pool.rgWinners[t].clear ( );
+        pool.rgPayOut[t] = settleAggregateWinners (*pool.pAggregate, *pool.pStore, *pool.pLookup, pool.draw,
+                                                   nBegin, nEnd, pool.rgWinners[t]);
+        return;
+    }
+
+    const size_t nTickets = pool.pStore->size ( );
+    const size_t nBegin   = nTickets * t / pool.dwNumThreads;
+    const size_t nEnd     = nTickets * (t + 1) / pool.dwNumThreads;
+
+    pool.rgPayOut[t] = settleTickets (*pool.pStore, *pool.pLookup, pool.draw, nBegin, nEnd);
+}
+
+static void throughputWorker (ThroughputPool& pool, DWORD t)
+{
+    QWORD qwSeen = 0;
+
+    std::unique_lock<std::mutex> guard (pool.lock);
+
+    for ( ;; )
+    {
+        pool.cvDraw.wait (guard, [&] { return pool.bStop || (pool.qwGeneration != qwSeen); });
+
+        if ( pool.bStop )
+            break;
+
+        qwSeen = pool.qwGeneration;
+
+        guard.unlock ( );
+        settleShare (pool, t);
+        guard.lock ( );
+
+        if ( --pool.dwPending == 0 )
+            pool.cvDone.notify_one ( );
+    }
+}
+
+void runThroughput (const KenoTicketStore& store, const KenoPayLookup& lookup, DWORD dwNumDraws, QWORD qwSeed,
+                    DWORD dwNumThreads, KenoPerfCounters* pCounters, KenoThroughputResult& result,
+                    const KenoTicketAggregate* pAggregate)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    ThroughputPool pool;
+
+    pool.pStore       = &store;
+    pool.pAggregate   = pAggregate;
+    pool.pLookup      = &lookup;
+    pool.dwNumThreads = dwNumThreads;
+    pool.qwGeneration = 0;
+    pool.dwPending    = 0;
+    pool.bStop        = false;
+    pool.rgPayOut.assign (dwNumThreads, 0.0);
+    pool.rgWinners.resize (dwNumThreads);
+
+    // the calling thread settles share 0
+    std::vector<std::thread> rgThreads;
+    for ( DWORD t = 1; t < dwNumThreads; t++ )
+        rgThreads.emplace_back (throughputWorker, std::ref (pool), t);
+
+    KenoRng rng;
+    rng.seed (qwSeed);
+
+    std::vector<double> rgLatencyUs;
+    rgLatencyUs.reserve (dwNumDraws);
+
+    double         fLiability = 0.0;
+    QWORD          qwWinners  = 0;
+    KenoPerfSample sample;
+
+    // the workers were created after the counters were opened, so they
+    // inherit them and the counts include every settlement thread
+    if ( pCounters != nullptr )
+        pCounters->start ( );
+
+    const auto tpStart = Clock::now ( );
+
+    for ( DWORD d = 0; d < dwNumDraws; d++ )
+    {
+        const auto tpDraw = Clock::now ( );
+
+        {
+            std::lock_guard<std::mutex> guard (pool.lock);
+
+            drawKenoBalls (rng, pool.draw);
+            pool.dwPending = dwNumThreads - 1;
+            pool.qwGeneration++;
+        }
+        pool.cvDraw.notify_all ( );
+
+        settleShare (pool, 0);
+
+        {
+            std::unique_lock<std::mutex> guard (pool.lock);
+            pool.cvDone.wait (guard, [&] { return pool.dwPending == 0; });
+        }
+
+        // every pay out is a whole number of dollars, so the sum is exact
+        // and identical for every thread count
+        for ( double fPayOut : pool.rgPayOut )
+            fLiability += fPayOut;
+
+        for ( const auto& rgWinners : pool.rgWinners )
+            qwWinners += rgWinners.size ( );
+
+        rgLatencyUs.push_back (std::chrono::duration<double, std::micro> (Clock::now ( ) - tpDraw).count ( ));
+    }
+
+    const double fSeconds = std::chrono::duration<double> (Clock::now ( ) - tpStart).count ( );
+
+    if ( pCounters != nullptr )
+        pCounters->stop (sample);
+    else
+        for ( auto& fCount : sample.rgCount )
+            fCount = -1.0;
+
+    {
+        std::lock_guard<std::mutex> guard (pool.lock);
+        pool.bStop = true;
+    }
+    pool.cvDraw.notify_all ( );
+
+    for ( auto& thread : rgThreads )
+        thread.join ( );
+
+    std::sort (rgLatencyUs.begin ( ), rgLatencyUs.end ( ));
+
+    result.dwNumThreads      = dwNumThreads;
+    result.fSeconds          = fSeconds;
+    result.fDrawsPerSecond   = dwNumDraws / fSeconds;
+    result.fTicketsPerSecond = static_cast<double>(dwNumDraws) * store.size ( ) / fSeconds;
+    result.fLatencyP50Us     = rgLatencyUs.empty ( ) ? 0.0 : rgLatencyUs[rgLatencyUs.size ( ) / 2];
+    result.fLatencyP99Us     = rgLatencyUs.empty ( ) ? 0.0 : rgLatencyUs[(rgLatencyUs.size ( ) * 99) / 100];
+    result.fEfficiency       = 0.0;
+    result.fLiability        = fLiability;
+    result.fWinnersPerDraw   = (pAggregate != nullptr) ? static_cast<double>(qwWinners) / dwNumDraws : 0.0;
+
+    const double fSettled = static_cast<double>(dwNumDraws) * store.size ( );
+
+    result.fIPC                   = calcPerfRatio (sample.rgCount[KENO_PERF_INSTRUCTIONS],  sample.rgCount[KENO_PERF_CYCLES]);
+    result.fInstructionsPerTicket = calcPerfRatio (sample.rgCount[KENO_PERF_INSTRUCTIONS],  fSettled);
+    result.fCacheMissesPerTicket  = calcPerfRatio (sample.rgCount[KENO_PERF_CACHE_MISSES],  fSettled);
+    result.fBranchMissesPerTicket = calcPerfRatio (sample.rgCount[KENO_PERF_BRANCH_MISSES], fSettled);
+}
+
+QWORD getPeakResidentBytes (void)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = { };
+
+    if ( ::GetProcessMemoryInfo (::GetCurrentProcess ( ), &counters, sizeof (counters)) )
+        return counters.PeakWorkingSetSize;
+
+    return 0;
+#else
+    struct rusage usage = { };
+
+    // ru_maxrss is in kilobytes on Linux
+    if ( getrusage (RUSAGE_SELF, &usage) == 0 )
+        return static_cast<QWORD>(usage.ru_maxrss) * 1024;
+
+    return 0;
+#endif
+}
+
+bool writeThroughputJson (FILE* pFile, const char* szLabel, const char* szCounters, QWORD qwNumTickets,
+                          DWORD dwNumDraws, QWORD qwPeakResidentBytes, const std::vector<KenoThroughputResult>& rgResults,
+                          QWORD qwNumMasks, DWORD dwFavourites, bool bAggregated)
+{
+    fprintf (pFile, "{\n  \"suite\": \"KenoThroughput\",\n  \"format\": 1,\n  \"label\": ");
+    writeJsonString (pFile, szLabel);
+    fprintf (pFile, ",\n  \"counters\": ");
+    writeJsonString (pFile, szCounters);
+    fprintf (pFile, ",\n  \"time\": %lld,\n  \"tickets\": %llu,\n  \"draws\": %u,\n  \"peak_rss_bytes\": %llu,\n",
+             static_cast<long long>(time (nullptr)), qwNumTickets, dwNumDraws, qwPeakResidentBytes);
+    fprintf (pFile, "  \"favourites_percent\": %u,\n  \"distinct_masks\": %llu,\n  \"tickets_per_mask\": %.4f,\n"
+                    "  \"aggregated\": %s,\n", dwFavourites, qwNumMasks,
+             qwNumMasks ? static_cast<double>(qwNumTickets) / qwNumMasks : 0.0, bAggregated ? "true" : "false");
+    fprintf (pFile, "  \"results\": [\n");
+
+    for ( size_t i = 0; i < rgResults.size ( ); i++ )
+    {
+        const KenoThroughputResult& result = rgResults[i];
+
+        fprintf (pFile, "    { \"threads\": %u, \"seconds\": %.6f, \"draws_per_second\": %.3f, "
+                        "\"tickets_per_second\": %.1f, \"latency_p50_us\": %.3f, \"latency_p99_us\": %.3f, "
+                        "\"efficiency\": %.4f, ",
+                 result.dwNumThreads, result.fSeconds, result.fDrawsPerSecond, result.fTicketsPerSecond,
+                 result.fLatencyP50Us, result.fLatencyP99Us, result.fEfficiency);
+
+        writeJsonOptional (pFile, "ipc",                      result.fIPC);
+        writeJsonOptional (pFile, "instructions_per_ticket",  result.fInstructionsPerTicket);
+        writeJsonOptional (pFile, "cache_misses_per_ticket",  result.fCacheMissesPerTicket);
+        writeJsonOptional (pFile, "branch_misses_per_ticket", result.fBranchMissesPerTicket);
+
+        fprintf (pFile, "\"liability\": %.2f, \"winners_per_draw\": %.1f }%s\n", result.fLiability,
+                 result.fWinnersPerDraw, (i + 1 < rgResults.size ( )) ? "," : "");
+    }
+
+    fprintf (pFile, "  ]\n}\n");
+
+    return ferror (pFile) == 0;
+}
@@ -0,0 +1,89 @@
+/**
+@file       KenoThroughput.h
+@brief      End-to-end simulation and settlement throughput benchmark
+
+  Generates a fixed, seeded population of tickets with a realistic spot
+  count and wager mix, then draws and settles a fixed, seeded sequence of
+  games with 1 .. all worker threads.  Each game is drawn by the calling
+  thread and its tickets are split evenly across the workers, so the per
+  draw latency is the time until the whole population is settled.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_THROUGHPUT_H__
+#define __KENO_THROUGHPUT_H__
+
+#include <vector>
+#include "KenoPerfCounters.h"
+#include "KenoSettlement.h"
+
+constexpr const QWORD g_qwDefaultThroughputTickets = 1000000;
+constexpr const DWORD g_dwDefaultThroughputDraws   = 200;
+constexpr const QWORD g_qwThroughputTicketSeed     = 0x5449434B45545321ULL;
+constexpr const QWORD g_qwThroughputDrawSeed       = 0x4452415753212121ULL;
+constexpr const DWORD g_dwThroughputFavourites     = 256;      //< popular masks of playFavourites
+
+struct KenoThroughputResult
+{
+    DWORD  dwNumThreads;
+    double fSeconds;
+    double fDrawsPerSecond;
+    double fTicketsPerSecond;       //< ticket settlements per second
+    double fLatencyP50Us;           //< per draw latency, draw to fully settled
+    double fLatencyP99Us;
+    double fEfficiency;             //< throughput / (threads * single thread throughput)
+    double fLiability;              //< total pay out of every draw
+    double fWinnersPerDraw;         //< tickets paid out per draw when aggregated, else 0
+    double fIPC;                    //< the hardware counter results are negative if unavailable
+    double fInstructionsPerTicket;
+    double fCacheMissesPerTicket;
+    double fBranchMissesPerTicket;
+};
+
+/**
+  @brief generates 'qwNumTickets' tickets of the house pay table with the
+         spot count and wager mix of g_rgThroughputSpotMix / g_rgThroughputWagerMix
+*/
+void generateTickets (QWORD qwSeed, QWORD qwNumTickets, KenoTicketStore& store);
+
+/**
+  @brief gives 'dwPercent' percent of the tickets of 'store', picked at
+         random, the mask of one of its first g_dwThroughputFavourites
+         tickets, as favourite numbers and repeated quick picks do
+*/
+void playFavourites (QWORD qwSeed, DWORD dwPercent, KenoTicketStore& store);
+
+/**
+  @brief runThroughput
+
+  @param [in]  store            tickets to settle
+  @param [in]  lookup           pay out lookup of the tickets
+  @param [in]  dwNumDraws       games to draw and settle
+  @param [in]  qwSeed           seed of the draws
+  @param [in]  dwNumThreads     settlement threads, including the calling thread
+  @param [in]  pCounters        open hardware counters, or nullptr; they count
+                                the draw loop of every settlement thread
+  @param [out] result           measurement; fEfficiency is left to the caller
+  @param [in]  pAggregate       distinct masks of 'store', or nullptr; when given
+                                they are settled instead of the tickets, and the
+                                pay out of every winning ticket is fanned out
+*/
+void runThroughput (const KenoTicketStore& store, const KenoPayLookup& lookup, DWORD dwNumDraws, QWORD qwSeed,
+                    DWORD dwNumThreads, KenoPerfCounters* pCounters, KenoThroughputResult& result,
+                    const KenoTicketAggregate* pAggregate = nullptr);
+
+/**
+  @brief peak resident set size of the process in bytes, 0 if unknown
+*/
+QWORD getPeakResidentBytes (void);
+
+/**
+  @brief writes the throughput results as JSON
+*/
+bool writeThroughputJson (FILE* pFile, const char* szLabel, const char* szCounters, QWORD qwNumTickets,
+                          DWORD dwNumDraws, QWORD qwPeakResidentBytes, const std::vector<KenoThroughputResult>& rgResults,
+                          QWORD qwNumMasks, DWORD dwFavourites, bool bAggregated);
+
+#endif
@@ -0,0 +1,218 @@
+/**
+@file       KenoLib.cpp
+@brief      Implementation of the C interface of the Keno engine library
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <cmath>
+#include <new>
+#include <string.h>
+#include "KenoLib.h"
+#include "KenoModel.h"
+#include "KenoProbability.h"
+#include "KenoSettlement.h"
+
+static_assert (KENO_TOTAL_BALLS      == g_TOTAL_BALLS,     "ball count of the C interface");
+static_assert (KENO_BALLS_DRAWN      == g_BALLS_DRAWN,     "draw size of the C interface");
+static_assert (KENO_MAX_SPOTS        == g_MAX_ROWS,        "probability rows of the C interface");
+static_assert (KENO_PAY_TABLE_SPOTS  == g_MAX_PAYOUT_ROWS, "pay table rows of the C interface");
+static_assert (KENO_PAY_TABLE_VALUES == g_MAX_PAYOUT_ROWS * g_MAX_PAYOUT_COLS, "pay table size of the C interface");
+static_assert (sizeof (uint64_t) == sizeof (QWORD), "ticket masks are 64 bit");
+
+constexpr const DWORD g_dwKenoEngineMagic = 0x454E474B;    //< 'KGNE'
+
+/// Everything an engine answers from; nothing is shared between engines
+struct KenoEngine
+{
+    DWORD             dwMagic;                          //< g_dwKenoEngineMagic while the handle is valid
+    double            rgProbability[g_MAX_ROWS][g_MAX_COLS];
+    KenoPayOutRow     rgPayOut[g_MAX_PAYOUT_ROWS];
+    KenoPayLookup     lookup;
+    KenoModelPayTable metrics;
+};
+
+static inline bool isValidEngine (HKENO hEngine)
+{
+    return (hEngine != nullptr) && (hEngine->dwMagic == g_dwKenoEngineMagic);
+}
+
+/// rebuilds the lookup and metrics of the engine's pay table
+static void updatePayTable (KenoEngine& engine)
+{
+    const KenoPayTable payTable = { _T ("libkeno"), engine.rgPayOut };
+
+    buildPayLookup   (payTable, engine.lookup);
+    evaluatePayTable (engine.rgProbability, engine.rgPayOut, engine.metrics);
+}
+
+
+KENO_API uint32_t KENO_CALL kenoGetApiVersion (void)
+{
+    return KENO_API_VERSION;
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoCreateEngine (HKENO* phEngine)
+{
+    if ( phEngine == nullptr )
+        return KENO_E_INVALIDARG;
+
+    *phEngine = nullptr;
+
+    KenoEngine* pEngine = new (std::nothrow) KenoEngine;
+    if ( pEngine == nullptr )
+        return KENO_E_OUTOFMEMORY;
+
+    memset (pEngine, 0, sizeof (KenoEngine));
+
+    for ( DWORD s = 1; s <= g_MAX_ROWS; s++ )
+    {
+        for ( DWORD c = 0; c < g_MAX_COLS; c++ )
+            pEngine->rgProbability[s - 1][c] = calcKenoProbabilityExact (s, c);
+    }
+
+    memcpy (pEngine->rgPayOut, g_rgPayTableCatalog[0].rgPayOut, sizeof (pEngine->rgPayOut));
+    updatePayTable (*pEngine);
+
+    pEngine->dwMagic = g_dwKenoEngineMagic;
+    *phEngine        = pEngine;
+
+    return KENO_OK;
+}
+
+KENO_API void KENO_CALL kenoDestroyEngine (HKENO hEngine)
+{
+    if ( isValidEngine (hEngine) )
+    {
+        hEngine->dwMagic = 0;
+        delete hEngine;
+    }
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoSetPayTable (HKENO hEngine, const double* rgPayOuts)
+{
+    if ( !isValidEngine (hEngine) || (rgPayOuts == nullptr) )
+        return KENO_E_INVALIDARG;
+
+    for ( int i = 0; i < KENO_PAY_TABLE_VALUES; i++ )
+    {
+        if ( !std::isfinite (rgPayOuts[i]) || (rgPayOuts[i] < 0.0) )
+            return KENO_E_INVALIDARG;
+    }
+
+    memcpy (hEngine->rgPayOut, rgPayOuts, sizeof (hEngine->rgPayOut));
+    updatePayTable (*hEngine);
+
+    return KENO_OK;
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoGetPayTable (HKENO hEngine, double* rgPayOuts)
+{
+    if ( !isValidEngine (hEngine) || (rgPayOuts == nullptr) )
+        return KENO_E_INVALIDARG;
+
+    memcpy (rgPayOuts, hEngine->rgPayOut, sizeof (hEngine->rgPayOut));
+
+    return KENO_OK;
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoGetPayTableMetrics (HKENO hEngine, double* rgRTP, double* rgHitRate, double* rgStdDev)
+{
+    if ( !isValidEngine (hEngine) )
+        return KENO_E_INVALIDARG;
+
+    if ( rgRTP != nullptr )
+        memcpy (rgRTP,     hEngine->metrics.rgRTP,     sizeof (hEngine->metrics.rgRTP));
+    if ( rgHitRate != nullptr )
+        memcpy (rgHitRate, hEngine->metrics.rgHitRate, sizeof (hEngine->metrics.rgHitRate));
+    if ( rgStdDev != nullptr )
+        memcpy (rgStdDev,  hEngine->metrics.rgStdDev,  sizeof (hEngine->metrics.rgStdDev));
+
+    return KENO_OK;
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoGetProbabilities (HKENO hEngine, const uint8_t* rgSpots, const uint8_t* rgCatch,
+                                                     size_t nCount, double* rgProbability)
+{
+    if ( !isValidEngine (hEngine) || (((rgSpots == nullptr) || (rgCatch == nullptr) || (rgProbability == nullptr)) && (nCount > 0)) )
+        return KENO_E_INVALIDARG;
+
+    for ( size_t i = 0; i < nCount; i++ )
+    {
+        // spots 0 wraps to an invalid row; catch > spots is 0 in the matrix
+        const DWORD dwRow   = static_cast<DWORD>(rgSpots[i]) - 1;
+        const DWORD dwCatch = rgCatch[i];
+
+        rgProbability[i] = ((dwRow < static_cast<DWORD>(g_MAX_ROWS)) && (dwCatch < static_cast<DWORD>(g_MAX_COLS)))
+                           ? hEngine->rgProbability[dwRow][dwCatch] : 0.0;
+    }
+
+    return KENO_OK;
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoGetPayOuts (HKENO hEngine, const uint8_t* rgSpots, const uint8_t* rgCatch,
+                                               size_t nCount, double* rgPayOut)
+{
+    if ( !isValidEngine (hEngine) || (((rgSpots == nullptr) || (rgCatch == nullptr) || (rgPayOut == nullptr)) && (nCount > 0)) )
+        return KENO_E_INVALIDARG;
+
+    for ( size_t i = 0; i < nCount; i++ )
+    {
+        // the lookup is 0 for spots 0, catch 0 and catch > spots
+        const DWORD dwSpots = rgSpots[i];
+        const DWORD dwCatch = rgCatch[i];
+
+        rgPayOut[i] = ((dwSpots <= static_cast<DWORD>(g_MAX_SPOTS_MARKED)) && (dwCatch < static_cast<DWORD>(g_MAX_COLS)))
+                      ? hEngine->lookup.rgPay[dwSpots][dwCatch] : 0.0;
+    }
+
+    return KENO_OK;
+}
+
+KENO_API KENO_STATUS KENO_CALL kenoSettle (HKENO hEngine, const uint8_t* rgBalls,
+                                           const uint64_t* rgMaskLo, const uint64_t* rgMaskHi,
+                                           const uint8_t* rgSpots, const double* rgWager, size_t nTickets,
+                                           double* rgPayOut, double* pfTotal)
+{
+    if ( !isValidEngine (hEngine) || (rgBalls == nullptr) ||
+         (((rgMaskLo == nullptr) || (rgMaskHi == nullptr) || (rgSpots == nullptr) || (rgWager == nullptr)) && (nTickets > 0)) )
+        return KENO_E_INVALIDARG;
+
+    KenoDraw draw = { };
+
+    for ( int b = 0; b < g_BALLS_DRAWN; b++ )
+    {
+        const DWORD dwBit = static_cast<DWORD>(rgBalls[b]) - 1;
+
+        if ( dwBit >= static_cast<DWORD>(g_TOTAL_BALLS) )
+            return KENO_E_INVALIDARG;
+
+        QWORD&      qwMask = (dwBit < 64) ? draw.qwMaskLo : draw.qwMaskHi;
+        const QWORD qwBall = 1ULL << (dwBit & 63);
+
+        if ( (qwMask & qwBall) != 0 )
+            return KENO_E_INVALIDARG;
+
+        qwMask              |= qwBall;
+        draw.rgBalls[b]      = rgBalls[b];
+    }
+
+    // the spot count indexes the lookup, so it is checked before anything is settled
+    DWORD dwInvalid = 0;
+
+    for ( size_t i = 0; i < nTickets; i++ )
+        dwInvalid |= (static_cast<DWORD>(rgSpots[i]) - 1 >= static_cast<DWORD>(g_MAX_SPOTS_MARKED)) ? 1 : 0;
+
+    if ( dwInvalid != 0 )
+        return KENO_E_INVALIDARG;
+
+    const double fTotal = settleTicketArrays (reinterpret_cast<const QWORD*>(rgMaskLo), reinterpret_cast<const QWORD*>(rgMaskHi),
+                                              rgSpots, rgWager, nTickets, hEngine->lookup, draw, rgPayOut);
+
+    if ( pfTotal != nullptr )
+        *pfTotal = fTotal;
+
+    return KENO_OK;
+}
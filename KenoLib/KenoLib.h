@@ -0,0 +1,156 @@
+/**
+@file       KenoLib.h
+@brief      C interface of the Keno engine library (libkeno)
+
+  A flat C API for terminal servers and settlement backends that embed the
+  probability model, the pay tables and the settlement kernel in process.
+
+  - Every engine is an opaque HKENO handle that owns its probability matrix
+    and pay table; the library keeps no global state, so any number of
+    engines may be created, and calls on different handles never interact.
+  - Calls are batch oriented: caller owned arrays in, caller owned arrays
+    out.  Only kenoCreateEngine allocates; no other call allocates memory.
+  - Functions return a KENO_STATUS; outputs are unspecified on failure.
+  - Only fixed width scalars and pointers cross the interface, so the ABI
+    stays stable as the engine changes; KENO_API_VERSION is incremented
+    only when a function is added.
+  - Calls that only read an engine may run concurrently on the same handle;
+    kenoSetPayTable must not run concurrently with any other call on it.
+
+  Balls are numbered 1 .. 80; ball 'n' maps to bit 'n - 1' of a ticket
+  mask, balls 1 .. 64 in the low word and 65 .. 80 in the high word.  Pay
+  tables are 9 rows (1 .. 9 spots marked) of 9 pay outs (catch 1 .. 9) of a
+  1 unit wager, row major.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_LIB_H__
+#define __KENO_LIB_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #ifdef KENO_EXPORTS
+        #define KENO_API __declspec(dllexport)
+    #else
+        #define KENO_API __declspec(dllimport)
+    #endif
+    #define KENO_CALL __cdecl
+#else
+    #define KENO_API __attribute__ ((visibility ("default")))
+    #define KENO_CALL
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KENO_API_VERSION        1
+
+#define KENO_TOTAL_BALLS        80
+#define KENO_BALLS_DRAWN        20
+#define KENO_MAX_SPOTS          20      /**< rows of the probability matrix */
+#define KENO_MAX_CATCH          20
+#define KENO_PAY_TABLE_SPOTS    9       /**< rows of a pay table */
+#define KENO_PAY_TABLE_VALUES   81      /**< pay outs of a pay table */
+
+typedef struct KenoEngine* HKENO;
+
+typedef int32_t KENO_STATUS;
+
+#define KENO_OK                 0
+#define KENO_E_INVALIDARG       (-1)    /**< null pointer, bad handle or value out of range */
+#define KENO_E_OUTOFMEMORY      (-2)
+
+/**
+  @brief version of the interface implemented by the library
+*/
+KENO_API uint32_t    KENO_CALL kenoGetApiVersion  (void);
+
+/**
+  @brief creates an engine with its own probability matrix and the house
+         pay table
+
+  @param [out] phEngine     receives the handle
+*/
+KENO_API KENO_STATUS KENO_CALL kenoCreateEngine   (HKENO* phEngine);
+
+/**
+  @brief frees an engine; a null handle is ignored
+*/
+KENO_API void        KENO_CALL kenoDestroyEngine  (HKENO hEngine);
+
+/**
+  @brief replaces the pay table of an engine
+
+  @param [in] rgPayOuts     KENO_PAY_TABLE_VALUES pay outs, finite and >= 0
+*/
+KENO_API KENO_STATUS KENO_CALL kenoSetPayTable    (HKENO hEngine, const double* rgPayOuts);
+
+/**
+  @brief copies the pay table of an engine
+
+  @param [out] rgPayOuts    receives KENO_PAY_TABLE_VALUES pay outs
+*/
+KENO_API KENO_STATUS KENO_CALL kenoGetPayTable    (HKENO hEngine, double* rgPayOuts);
+
+/**
+  @brief return to player, hit rate and standard deviation of the pay out
+         of a 1 unit wager, per row of the pay table
+
+  @param [out] rgRTP        KENO_PAY_TABLE_SPOTS values, or NULL
+  @param [out] rgHitRate    KENO_PAY_TABLE_SPOTS values, or NULL
+  @param [out] rgStdDev     KENO_PAY_TABLE_SPOTS values, or NULL
+*/
+KENO_API KENO_STATUS KENO_CALL kenoGetPayTableMetrics (HKENO hEngine, double* rgRTP, double* rgHitRate, double* rgStdDev);
+
+/**
+  @brief probabilities of catching rgCatch[i] of rgSpots[i] marked balls
+
+  A spot count outside 1 .. KENO_MAX_SPOTS or a catch above the spot count
+  has probability 0.
+
+  @param [in]  rgSpots          spots marked of every query
+  @param [in]  rgCatch          catch of every query
+  @param [in]  nCount           number of queries
+  @param [out] rgProbability    receives nCount probabilities
+*/
+KENO_API KENO_STATUS KENO_CALL kenoGetProbabilities (HKENO hEngine, const uint8_t* rgSpots, const uint8_t* rgCatch,
+                                                     size_t nCount, double* rgProbability);
+
+/**
+  @brief pay outs of a 1 unit wager catching rgCatch[i] of rgSpots[i];
+         0 outside the pay table
+*/
+KENO_API KENO_STATUS KENO_CALL kenoGetPayOuts     (HKENO hEngine, const uint8_t* rgSpots, const uint8_t* rgCatch,
+                                                   size_t nCount, double* rgPayOut);
+
+/**
+  @brief settles tickets against a draw
+
+  @param [in]  rgBalls      the KENO_BALLS_DRAWN distinct balls of the draw
+  @param [in]  rgMaskLo     balls 1 .. 64 of every ticket
+  @param [in]  rgMaskHi     balls 65 .. 80 of every ticket
+  @param [in]  rgSpots      spots marked of every ticket, 1 .. KENO_PAY_TABLE_SPOTS,
+                            the number of balls in its mask
+  @param [in]  rgWager      wager of every ticket
+  @param [in]  nTickets     number of tickets
+  @param [out] rgPayOut     receives the pay out of every ticket, or NULL
+  @param [out] pfTotal      receives the total pay out, or NULL
+
+  @retval KENO_STATUS       KENO_E_INVALIDARG if the draw is invalid or a
+                            spot count is out of range
+*/
+KENO_API KENO_STATUS KENO_CALL kenoSettle (HKENO hEngine, const uint8_t* rgBalls,
+                                           const uint64_t* rgMaskLo, const uint64_t* rgMaskHi,
+                                           const uint8_t* rgSpots, const double* rgWager, size_t nTickets,
+                                           double* rgPayOut, double* pfTotal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,30 +9,9 @@
 #include "stdafx.h"
 
 #include "stdlib.h"
-#include "stdarg.h"
 #include "Windows.h"
 #include "DebugUtility.h"
 
-#ifdef _DEBUG
-    std::ofstream dbg;
-#endif
-
-int DebugTrace (const TCHAR* szFmt, ...)
-{
-    TCHAR szDebugMsg[512] = { 0 };
-
-    va_list	vaArgs;
-    va_start (vaArgs, szFmt);
-
-    // use the format string and arguments to construct the debug output string
-    const int iReturnVal = _vsntprintf (szDebugMsg, _countof (szDebugMsg) - 1, szFmt, vaArgs);
-    va_end (vaArgs);
-
-    ::OutputDebugString (szDebugMsg);
-    return iReturnVal;
-
-}
-
 TCHAR* GetModulePath (TCHAR* szModulePath, size_t cchLen)
 {
       // Get the executable file path
@@ -18,16 +18,6 @@
     #include "tchar.h"
 #endif 
 
-/**
-  Function used for debugging and tracing diagnostics
-  with output directed to the IDE output window
-
-  @param [in] szMsg     format string
-
-  @return the number of characters written
-*/
-int DebugTrace (const TCHAR* szMsg, ...);
-
 /**
     Function retrieves the current executable directory
 
@@ -42,13 +32,4 @@ TCHAR* GetModulePath(TCHAR* szModulePath, size_t cchLen);
 
 
 
-#ifdef _DEBUG
-
-    #ifndef _FSTREAM_
-        #include <fstream>
-    #endif
-
-    extern std::ofstream dbg;
-#endif
-
 #endif
\ No newline at end of file
@@ -0,0 +1,341 @@
+/**
+@file       KenoAdaptive.cpp
+@brief      Implementation of the adaptive Monte Carlo simulation
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "KenoAdaptive.h"
+#include "KenoSimulator.h"
+#include "KenoCheckpoint.h"
+#include "KenoTrace.h"
+
+
+/// catch histogram of one batch
+struct AdaptiveBatch
+{
+    QWORD qwNumDraws;
+    QWORD rgCatchCount[g_MAX_COLS];
+};
+
+/// scheduling state of one scenario, guarded by AdaptiveScheduler::lock
+struct AdaptiveScenarioControl
+{
+    QWORD                          qwSeed;
+    QWORD                          qwNextBatch;         //< next batch index to hand out
+    QWORD                          qwRemainingDraws;    //< estimated draws still needed
+    std::map<QWORD, AdaptiveBatch> mapPending;          //< finished batches waiting for their predecessors
+};
+
+struct AdaptiveScheduler
+{
+    const KenoAdaptiveScenario*           rgScenarios;
+    int                                   nScenarios;
+    std::vector<KenoAdaptiveState>*       pStates;
+    std::vector<AdaptiveScenarioControl>  rgControl;
+    std::mutex                            lock;
+    std::condition_variable               cvMerged;
+    KenoCheckpointWriter*                 pCheckpoint;
+    std::chrono::steady_clock::duration   durCheckpoint;
+    std::chrono::steady_clock::time_point tpLastCheckpoint;
+};
+
+
+bool isAdaptiveCellReachable (const KenoAdaptiveScenario& scenario, DWORD dwCatch)
+{
+    const double fP     = calcKenoProbabilityExact (scenario.dwNumMarked, dwCatch);
+    const double fError = scenario.fRelativeError;
+
+    // within half the limit, so sampling noise cannot carry a cell past it
+    return (fP > 0.0) && (2.0 * (1.0 - fP) <= fP * fError * fError * static_cast<double>(scenario.qwMaxDraws));
+}
+
+void calcAdaptiveResult (const KenoAdaptiveScenario& scenario, const KenoAdaptiveState& state,
+                         KenoAdaptiveResult& result)
+{
+    const double fN = static_cast<double>(state.qwNumDraws);
+
+    result.qwNumDraws    = state.qwNumDraws;
+    result.dwTargetCells = 0;
+
+    double fMean   = 0.0;
+    double fMeanSq = 0.0;
+    double fWorstCellError = 0.0;
+
+    for ( int c = 0; c < g_MAX_COLS; c++ )
+    {
+        const double fP = (fN > 0.0) ? state.rgCatchCount[c] / fN : 0.0;
+
+        result.rgProbability[c]         = fP;
+        result.rgProbabilityStdError[c] = (fN > 0.0) ? std::sqrt (fP * (1.0 - fP) / fN) : 0.0;
+
+        if ( (static_cast<DWORD>(c) <= scenario.dwNumMarked) && isAdaptiveCellReachable (scenario, c) )
+        {
+            result.dwTargetCells++;
+
+            // a catch size that has not been observed yet has an unbounded relative error
+            const double fCellError = (fP > 0.0) ? result.rgProbabilityStdError[c] / fP : HUGE_VAL;
+            if ( fCellError > fWorstCellError )
+                fWorstCellError = fCellError;
+        }
+
+        if ( (c > 0) && (c <= g_MAX_PAYOUT_COLS) )
+        {
+            const double fPay = scenario.pPayTable->rgPayOut[scenario.dwNumMarked - 1][c - 1];
+
+            fMean   += fP * fPay;
+            fMeanSq += fP * fPay * fPay;
+        }
+    }
+
+    const double fVariance = fMeanSq - fMean * fMean;
+
+    result.fRTP         = fMean;
+    result.fRTPStdError = ((fN > 0.0) && (fVariance > 0.0)) ? std::sqrt (fVariance / fN) : 0.0;
+
+    if ( scenario.eTarget == KENO_TARGET_RTP )
+        result.fAchievedRelativeError = (fMean > 0.0) ? result.fRTPStdError / fMean : HUGE_VAL;
+    else
+        result.fAchievedRelativeError = fWorstCellError;
+
+    result.bConverged = (state.qwNumDraws > 0) && (result.fAchievedRelativeError <= scenario.fRelativeError);
+}
+
+/**
+  @brief estimates the draws a scenario still needs, given that the relative
+         error shrinks with the square root of the number of draws
+*/
+static QWORD estimateRemainingDraws (const KenoAdaptiveScenario& scenario, const KenoAdaptiveState& state)
+{
+    if ( state.bFinished )
+        return 0;
+
+    const QWORD qwLimitLeft = scenario.qwMaxDraws - state.qwNumDraws;
+
+    if ( state.qwNumDraws == 0 )
+        return (g_qwAdaptiveBatchDraws < qwLimitLeft) ? g_qwAdaptiveBatchDraws : qwLimitLeft;
+
+    KenoAdaptiveResult result;
+    calcAdaptiveResult (scenario, state, result);
+
+    // unobserved catch sizes: at least double the draws
+    double fNeeded = static_cast<double>(state.qwNumDraws);
+
+    if ( result.fAchievedRelativeError < HUGE_VAL )
+    {
+        const double fRatio = result.fAchievedRelativeError / scenario.fRelativeError;
+        fNeeded = state.qwNumDraws * (fRatio * fRatio - 1.0);
+    }
+
+    QWORD qwNeeded = (fNeeded < static_cast<double>(qwLimitLeft)) ? static_cast<QWORD>(fNeeded) : qwLimitLeft;
+
+    // a scenario that has not converged always needs at least one more batch
+    if ( qwNeeded < g_qwAdaptiveBatchDraws )
+        qwNeeded = (g_qwAdaptiveBatchDraws < qwLimitLeft) ? g_qwAdaptiveBatchDraws : qwLimitLeft;
+
+    return qwNeeded;
+}
+
+/**
+  @brief simulates batch 'qwBatch' of a scenario from the batch's own stream
+*/
+static void runAdaptiveBatch (const KenoAdaptiveScenario& scenario, QWORD qwScenarioSeed, QWORD qwBatch,
+                              AdaptiveBatch& batch)
+{
+    QWORD qwStreamSeed = qwScenarioSeed + qwBatch * 0xD1B54A32D192ED03ULL;
+
+    KenoRng  rng;
+    KenoDraw draw;
+
+    rng.seed (splitMix64 (qwStreamSeed));
+
+    for ( auto& qwCount : batch.rgCatchCount )
+        qwCount = 0;
+
+    const QWORD qwTicket = (2ULL << (scenario.dwNumMarked - 1)) - 1;
+
+    for ( QWORD n = 0; n < batch.qwNumDraws; n++ )
+    {
+        drawKenoBalls (rng, draw);
+        batch.rgCatchCount[countBits (draw.qwMaskLo & qwTicket)]++;
+    }
+}
+
+/**
+  @brief merges every consecutive finished batch of scenario 's' in order,
+         and finishes the scenario once it converges or reaches its limit
+*/
+static void mergePendingBatches (AdaptiveScheduler& scheduler, int s)
+{
+    const KenoAdaptiveScenario& scenario = scheduler.rgScenarios[s];
+    AdaptiveScenarioControl&    control  = scheduler.rgControl[s];
+    KenoAdaptiveState&          state    = (*scheduler.pStates)[s];
+
+    for ( auto it = control.mapPending.find (state.qwMergedBatches);
+          (it != control.mapPending.end ( )) && !state.bFinished;
+          it = control.mapPending.find (state.qwMergedBatches) )
+    {
+        for ( int c = 0; c < g_MAX_COLS; c++ )
+            state.rgCatchCount[c] += it->second.rgCatchCount[c];
+
+        state.qwNumDraws += it->second.qwNumDraws;
+        state.qwMergedBatches++;
+        control.mapPending.erase (it);
+
+        KenoAdaptiveResult result;
+        calcAdaptiveResult (scenario, state, result);
+
+        state.bFinished = (result.bConverged || (state.qwNumDraws >= scenario.qwMaxDraws)) ? TRUE : FALSE;
+
+        if ( state.bFinished )
+            KENO_TRACE_INFO (_T ("Adaptive scenario [%d] finished after %llu draws, relative error %g"),
+                             s, state.qwNumDraws, result.fAchievedRelativeError);
+    }
+
+    // batches handed out past the point of convergence are discarded
+    if ( state.bFinished )
+        control.mapPending.clear ( );
+
+    control.qwRemainingDraws = estimateRemainingDraws (scenario, state);
+}
+
+static void adaptiveWorker (AdaptiveScheduler& scheduler)
+{
+    std::unique_lock<std::mutex> guard (scheduler.lock);
+
+    for ( ;; )
+    {
+        // pick the scenario with the most estimated work not yet handed out
+        int   iBest       = -1;
+        QWORD qwBestWork  = 0;
+        bool  bAnyRunning = false;
+
+        for ( int s = 0; s < scheduler.nScenarios; s++ )
+        {
+            const KenoAdaptiveScenario&    scenario = scheduler.rgScenarios[s];
+            const AdaptiveScenarioControl& control  = scheduler.rgControl[s];
+            const KenoAdaptiveState&       state    = (*scheduler.pStates)[s];
+
+            if ( state.bFinished )
+                continue;
+
+            bAnyRunning = true;
+
+            const QWORD qwIssuedDraws = control.qwNextBatch * g_qwAdaptiveBatchDraws;
+            const QWORD qwInFlight    = qwIssuedDraws - state.qwNumDraws;
+
+            if ( (qwIssuedDraws < scenario.qwMaxDraws) && (control.qwRemainingDraws > qwInFlight) &&
+                 (control.qwRemainingDraws - qwInFlight > qwBestWork) )
+            {
+                iBest      = s;
+                qwBestWork = control.qwRemainingDraws - qwInFlight;
+            }
+        }
+
+        if ( !bAnyRunning )
+            break;
+
+        if ( iBest < 0 )
+        {
+            // everything left is already in flight; wait for a merge to re-estimate
+            scheduler.cvMerged.wait (guard);
+            continue;
+        }
+
+        const KenoAdaptiveScenario& scenario = scheduler.rgScenarios[iBest];
+        AdaptiveScenarioControl&    control  = scheduler.rgControl[iBest];
+
+        const QWORD qwBatch = control.qwNextBatch++;
+        const QWORD qwFirst = qwBatch * g_qwAdaptiveBatchDraws;
+
+        AdaptiveBatch batch;
+        batch.qwNumDraws = (scenario.qwMaxDraws - qwFirst < g_qwAdaptiveBatchDraws) ?
+                           scenario.qwMaxDraws - qwFirst : g_qwAdaptiveBatchDraws;
+
+        guard.unlock ( );
+        runAdaptiveBatch (scenario, control.qwSeed, qwBatch, batch);
+        guard.lock ( );
+
+        if ( !(*scheduler.pStates)[iBest].bFinished )
+        {
+            control.mapPending[qwBatch] = batch;
+            mergePendingBatches (scheduler, iBest);
+        }
+
+        // hand a snapshot of the merged states to the background writer
+        if ( scheduler.pCheckpoint != nullptr )
+        {
+            const auto tpNow = std::chrono::steady_clock::now ( );
+
+            if ( tpNow - scheduler.tpLastCheckpoint >= scheduler.durCheckpoint )
+            {
+                scheduler.pCheckpoint->post (*scheduler.pStates);
+                scheduler.tpLastCheckpoint = tpNow;
+            }
+        }
+
+        scheduler.cvMerged.notify_all ( );
+    }
+
+    scheduler.cvMerged.notify_all ( );
+}
+
+void runAdaptiveSimulation (const KenoAdaptiveScenario* rgScenarios, int nScenarios, QWORD qwSeed,
+                            std::vector<KenoAdaptiveState>& rgStates,
+                            std::vector<KenoAdaptiveResult>& rgResults,
+                            KenoCheckpointWriter* pCheckpoint, DWORD dwCheckpointSeconds)
+{
+    if ( rgStates.size ( ) != static_cast<size_t>(nScenarios) )
+        rgStates.assign (nScenarios, KenoAdaptiveState ( ));
+
+    AdaptiveScheduler scheduler;
+
+    scheduler.rgScenarios = rgScenarios;
+    scheduler.nScenarios  = nScenarios;
+    scheduler.pStates     = &rgStates;
+    scheduler.rgControl.resize (nScenarios);
+    scheduler.pCheckpoint      = pCheckpoint;
+    scheduler.durCheckpoint    = std::chrono::seconds (dwCheckpointSeconds);
+    scheduler.tpLastCheckpoint = std::chrono::steady_clock::now ( );
+
+    for ( int s = 0; s < nScenarios; s++ )
+    {
+        AdaptiveScenarioControl& control = scheduler.rgControl[s];
+
+        // resume right after the last merged batch
+        control.qwSeed           = splitMix64 (qwSeed);
+        control.qwNextBatch      = rgStates[s].qwMergedBatches;
+
+        if ( rgStates[s].qwNumDraws >= rgScenarios[s].qwMaxDraws )
+            rgStates[s].bFinished = TRUE;
+
+        control.qwRemainingDraws = estimateRemainingDraws (rgScenarios[s], rgStates[s]);
+    }
+
+    std::vector<std::thread> rgThreads;
+
+    for ( DWORD t = 0; t < getWorkerThreadCount ( ); t++ )
+        rgThreads.emplace_back (adaptiveWorker, std::ref (scheduler));
+
+    for ( auto& thread : rgThreads )
+        thread.join ( );
+
+    if ( pCheckpoint != nullptr )
+    {
+        pCheckpoint->post  (rgStates);
+        pCheckpoint->flush ( );
+    }
+
+    rgResults.resize (nScenarios);
+
+    for ( int s = 0; s < nScenarios; s++ )
+        calcAdaptiveResult (rgScenarios[s], rgStates[s], rgResults[s]);
+}
@@ -0,0 +1,115 @@
+/**
+@file       KenoAdaptive.h
+@brief      Adaptive Monte Carlo simulation declarations
+
+  Rather than a fixed number of draws, every scenario is simulated in fixed
+  size batches until the requested relative error on its return to player,
+  or on every cell of its probability row, is reached.  Threads always pick
+  up a batch of the scenario with the most work left, so the threads freed
+  by easy scenarios move on to the ones that have not converged yet.
+
+  Batch 'k' of a scenario draws from its own random number stream and the
+  batches are merged strictly in order, so the results, including the draw
+  at which a scenario converged, do not depend on the number of threads.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_ADAPTIVE_H__
+#define __KENO_ADAPTIVE_H__
+
+#include <vector>
+#include "KenoProbability.h"
+
+class KenoCheckpointWriter;
+
+constexpr const QWORD g_qwAdaptiveBatchDraws = 65536;  //< draws per batch
+
+enum KenoAdaptiveTarget
+{
+    KENO_TARGET_RTP = 0,        //< relative standard error of the simulated RTP
+    KENO_TARGET_PROBABILITY     //< relative standard error of every catch probability reachable
+                                //< within qwMaxDraws, see isAdaptiveCellReachable
+};
+
+struct KenoAdaptiveScenario
+{
+    const KenoPayTable* pPayTable;
+    DWORD               dwNumMarked;        //< 1 .. g_MAX_SPOTS_MARKED, the ticket plays the balls 1 .. dwNumMarked
+    KenoAdaptiveTarget  eTarget;
+    double              fRelativeError;     //< requested relative standard error
+    QWORD               qwMaxDraws;         //< stop regardless of the error after this many draws
+};
+
+struct KenoAdaptiveResult
+{
+    QWORD  qwNumDraws;                          //< draws merged into the result
+    bool   bConverged;                          //< true if the target was met before qwMaxDraws
+    double fAchievedRelativeError;              //< relative error of the target when stopped
+    DWORD  dwTargetCells;                       //< catch sizes held to a KENO_TARGET_PROBABILITY target
+    double fRTP;                                //< simulated return of a $1 bet
+    double fRTPStdError;
+    double rgProbability        [g_MAX_COLS];   //< simulated catch probabilities
+    double rgProbabilityStdError[g_MAX_COLS];
+};
+
+/**
+  @brief the catch histogram and counters of a scenario, i.e. everything
+         needed to derive its result or to continue its simulation
+*/
+struct KenoAdaptiveState
+{
+    QWORD qwMergedBatches;                      //< batches 0 .. qwMergedBatches - 1 are merged
+    QWORD qwNumDraws;
+    QWORD rgCatchCount[g_MAX_COLS];
+    BOOL  bFinished;
+    DWORD dwReserved;                           //< keeps the state free of padding, see KenoCheckpoint.h
+};
+
+/**
+  @brief isAdaptiveCellReachable
+
+  A catch probability 'p' reaches the relative standard error 'e' after
+  (1 - p) / (p * e^2) draws, 5.5e10 for 9 of 9 at 0.005.  Catch sizes that
+  cannot reach the requested error within half the draw limit of the
+  scenario, which leaves room for sampling noise, are left out of its
+  KENO_TARGET_PROBABILITY target, rather than keeping the scenario running
+  to its limit without ever converging.
+
+  @retval bool              true if catching 'dwCatch' of the scenario's
+                            balls is held to its target
+*/
+bool isAdaptiveCellReachable (const KenoAdaptiveScenario& scenario, DWORD dwCatch);
+
+/**
+  @brief calcAdaptiveResult
+
+  Derives the probability and RTP estimates, and their standard errors, of a
+  scenario from its catch histogram; since the pay out is a function of the
+  catch size, the histogram holds the complete running variance of each cell.
+*/
+void calcAdaptiveResult (const KenoAdaptiveScenario& scenario, const KenoAdaptiveState& state,
+                         KenoAdaptiveResult& result);
+
+/**
+  @brief runAdaptiveSimulation
+
+  Simulates every scenario until it converges or reaches its draw limit.
+
+  @param [in]     rgScenarios   scenarios to simulate
+  @param [in]     nScenarios    number of scenarios
+  @param [in]     qwSeed        base seed, scenario 's' uses streams derived from it
+  @param [in,out] rgStates      per scenario state; empty to start from scratch, or
+                                the state of an earlier, interrupted run to resume it
+  @param [out]    rgResults     receives 'nScenarios' results
+  @param [in]     pCheckpoint   optional background writer that receives a snapshot of
+                                'rgStates' every 'dwCheckpointSeconds' and when finished
+  @param [in]     dwCheckpointSeconds   interval between checkpoints
+*/
+void runAdaptiveSimulation (const KenoAdaptiveScenario* rgScenarios, int nScenarios, QWORD qwSeed,
+                            std::vector<KenoAdaptiveState>& rgStates,
+                            std::vector<KenoAdaptiveResult>& rgResults,
+                            KenoCheckpointWriter* pCheckpoint = nullptr, DWORD dwCheckpointSeconds = 0);
+
+#endif
@@ -0,0 +1,1067 @@
+/**
+@file       KenoArchive.cpp
+@brief      Implementation of the ticket and draw archives
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <string.h>
+#include "KenoArchive.h"
+#include "KenoCrc32.h"
+#include "KenoSimulator.h"
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+constexpr const size_t g_nArchiveScratch = 6 * g_nArchiveBlockItems;  //< unpacked values of a ticket block
+
+/// a ticket's balls, as kept in the mask dictionary of a block
+struct KenoBallMask
+{
+    QWORD qwMaskLo;
+    QWORD qwMaskHi;
+
+    bool operator== (const KenoBallMask& other) const { return (qwMaskLo == other.qwMaskLo) && (qwMaskHi == other.qwMaskHi); }
+    bool operator<  (const KenoBallMask& other) const
+    {
+        return (qwMaskHi < other.qwMaskHi) || ((qwMaskHi == other.qwMaskHi) && (qwMaskLo < other.qwMaskLo));
+    }
+};
+
+/// the mask of each ball index 0 .. 79, and none for 80 .. 127
+struct KenoBallMaskTable
+{
+    KenoBallMask rgMasks[128];
+
+    KenoBallMaskTable ( )
+    {
+        for ( int i = 0; i < 128; i++ )
+        {
+            rgMasks[i].qwMaskLo = (i < 64) ? (1ULL << i) : 0;
+            rgMasks[i].qwMaskHi = ((i >= 64) && (i < g_TOTAL_BALLS)) ? (1ULL << (i - 64)) : 0;
+        }
+    }
+};
+
+static const KenoBallMaskTable g_ballMasks;
+
+/// bits needed to hold 'qwValue'
+static DWORD getBitWidth (QWORD qwValue)
+{
+    DWORD dwWidth = 0;
+
+    for ( ; qwValue != 0; qwValue >>= 1 )
+        dwWidth++;
+
+    return dwWidth;
+}
+
+/**
+  @brief bytes of 'nValues' values of 'dwWidth' bits: whole words, and one
+         more word so every value can be loaded with a single 64 bit read
+*/
+static size_t getPackedSize (size_t nValues, DWORD dwWidth)
+{
+    return ((nValues * dwWidth + 63) / 64) * 8 + 8;
+}
+
+/**
+  @brief appends 'nValues' values of 'dwWidth' bits to 'rgOut'
+*/
+static void appendBits (const QWORD* rgValues, size_t nValues, DWORD dwWidth, std::vector<BYTE>& rgOut)
+{
+    const size_t cbOffset = rgOut.size ( );
+
+    rgOut.resize (cbOffset + getPackedSize (nValues, dwWidth), 0);
+
+    BYTE* pBits = rgOut.data ( ) + cbOffset;
+
+    for ( size_t i = 0; (i < nValues) && (dwWidth > 0); i++ )
+    {
+        const QWORD qwBit   = static_cast<QWORD>(i) * dwWidth;
+        const DWORD dwShift = static_cast<DWORD>(qwBit & 7);
+        BYTE*       pWord   = pBits + (qwBit >> 3);
+        QWORD       qwWord;
+
+        memcpy (&qwWord, pWord, sizeof (qwWord));
+        qwWord |= rgValues[i] << dwShift;
+        memcpy (pWord, &qwWord, sizeof (qwWord));
+
+        // the top bits of a value wider than 64 - dwShift
+        if ( dwShift + dwWidth > 64 )
+            pWord[8] |= static_cast<BYTE>(rgValues[i] >> (64 - dwShift));
+    }
+}
+
+/**
+  @brief packColumn
+
+  Appends 'nValues' values as a KenoPackedColumn, relative to their smallest
+  value or, if allowed, as indices into their distinct values, whichever is
+  smaller.
+*/
+static void packColumn (const QWORD* rgValues, size_t nValues, std::vector<BYTE>& rgOut, bool bAllowDictionary = true)
+{
+    QWORD qwMin = (nValues > 0) ? rgValues[0] : 0;
+    QWORD qwMax = qwMin;
+
+    for ( size_t i = 1; i < nValues; i++ )
+    {
+        qwMin = (rgValues[i] < qwMin) ? rgValues[i] : qwMin;
+        qwMax = (rgValues[i] > qwMax) ? rgValues[i] : qwMax;
+    }
+
+    std::vector<QWORD> rgDict;
+
+    if ( bAllowDictionary )
+    {
+        rgDict.assign (rgValues, rgValues + nValues);
+        std::sort (rgDict.begin ( ), rgDict.end ( ));
+        rgDict.erase (std::unique (rgDict.begin ( ), rgDict.end ( )), rgDict.end ( ));
+    }
+
+    const DWORD  dwOffsetWidth = getBitWidth (qwMax - qwMin);
+    const DWORD  dwDictWidth   = (rgDict.size ( ) > 1) ? getBitWidth (rgDict.size ( ) - 1) : 0;
+    const size_t cbDict        = rgDict.size ( ) * sizeof (QWORD) + getPackedSize (nValues, dwDictWidth);
+    const bool   bDictionary   = !rgDict.empty ( ) && (rgDict.size ( ) <= 0xFFFF) &&
+                                 (cbDict < getPackedSize (nValues, dwOffsetWidth));
+
+    KenoPackedColumn column = { };
+
+    column.dwNumValues = static_cast<DWORD>(nValues);
+    column.byWidth     = static_cast<BYTE>(bDictionary ? dwDictWidth : dwOffsetWidth);
+    column.byCodec     = static_cast<BYTE>(bDictionary ? KENO_PACK_DICTIONARY : KENO_PACK_OFFSET);
+    column.wDictSize   = static_cast<WORD>(bDictionary ? rgDict.size ( ) : 0);
+    column.qwBase      = bDictionary ? 0 : qwMin;
+
+    rgOut.insert (rgOut.end ( ), reinterpret_cast<const BYTE*>(&column), reinterpret_cast<const BYTE*>(&column + 1));
+
+    std::vector<QWORD> rgCodes (nValues);
+
+    if ( bDictionary )
+    {
+        rgOut.insert (rgOut.end ( ), reinterpret_cast<const BYTE*>(rgDict.data ( )),
+                      reinterpret_cast<const BYTE*>(rgDict.data ( ) + rgDict.size ( )));
+
+        for ( size_t i = 0; i < nValues; i++ )
+            rgCodes[i] = std::lower_bound (rgDict.begin ( ), rgDict.end ( ), rgValues[i]) - rgDict.begin ( );
+    }
+    else
+    {
+        for ( size_t i = 0; i < nValues; i++ )
+            rgCodes[i] = rgValues[i] - qwMin;
+    }
+
+    appendBits (rgCodes.data ( ), nValues, column.byWidth, rgOut);
+}
+
+/**
+  @brief openColumn
+
+  Checks the header of the column at 'p', which must hold 'nValues' values.
+
+  @retval const BYTE*       its dictionary, followed by its bits; nullptr if
+                            the column is malformed or runs past 'pEnd'
+*/
+static const BYTE* openColumn (const BYTE* p, const BYTE* pEnd, size_t nValues, KenoPackedColumn& column)
+{
+    if ( static_cast<size_t>(pEnd - p) < sizeof (column) )
+        return nullptr;
+
+    memcpy (&column, p, sizeof (column));
+    p += sizeof (column);
+
+    const bool bDictionary = (column.byCodec == KENO_PACK_DICTIONARY);
+
+    if ( (column.dwNumValues != nValues) || (column.byWidth > 64) || (column.byCodec > KENO_PACK_DICTIONARY) ||
+         (bDictionary != (column.wDictSize > 0)) ||
+         (static_cast<size_t>(pEnd - p) < column.wDictSize * sizeof (QWORD) + getPackedSize (nValues, column.byWidth)) )
+        return nullptr;
+
+    return p;
+}
+
+/**
+  @brief unpackColumn
+
+  Unpacks the column at 'p', which must hold 'nValues' values.
+
+  @retval const BYTE*       the byte after the column, nullptr if the column
+                            is malformed or runs past 'pEnd'
+*/
+static const BYTE* unpackColumn (const BYTE* p, const BYTE* pEnd, size_t nValues, QWORD* rgValues)
+{
+    KenoPackedColumn column;
+
+    if ( (p = openColumn (p, pEnd, nValues, column)) == nullptr )
+        return nullptr;
+
+    // payloads and dictionaries are 8 byte aligned in the file
+    const QWORD* rgDict  = reinterpret_cast<const QWORD*>(p);
+    const BYTE*  pBits   = p + column.wDictSize * sizeof (QWORD);
+    const DWORD  dwWidth = column.byWidth;
+    const QWORD  qwMask  = (dwWidth == 64) ? ~0ULL : ((1ULL << dwWidth) - 1);
+
+    if ( dwWidth == 0 )
+    {
+        // a constant column, e.g. the first draw of a day's tickets
+        const QWORD qwValue = (column.byCodec == KENO_PACK_DICTIONARY) ? rgDict[0] : column.qwBase;
+
+        for ( size_t i = 0; i < nValues; i++ )
+            rgValues[i] = qwValue;
+
+        return pBits + getPackedSize (nValues, dwWidth);
+    }
+
+    // one load, shift and mask per value; a value starting in the last bits
+    // of its load only fits when it is 57 bits or narrower
+    if ( (column.byCodec == KENO_PACK_OFFSET) && (dwWidth <= 57) )
+    {
+        for ( size_t i = 0; i < nValues; i++ )
+        {
+            const QWORD qwBit = static_cast<QWORD>(i) * dwWidth;
+            QWORD       qwWord;
+
+            memcpy (&qwWord, pBits + (qwBit >> 3), sizeof (qwWord));
+            rgValues[i] = column.qwBase + ((qwWord >> (qwBit & 7)) & qwMask);
+        }
+
+        return pBits + getPackedSize (nValues, dwWidth);
+    }
+
+    for ( size_t i = 0; i < nValues; i++ )
+    {
+        const QWORD qwBit   = static_cast<QWORD>(i) * dwWidth;
+        const DWORD dwShift = static_cast<DWORD>(qwBit & 7);
+        QWORD       qwWord;
+
+        memcpy (&qwWord, pBits + (qwBit >> 3), sizeof (qwWord));
+        rgValues[i] = qwWord >> dwShift;
+    }
+
+    if ( dwWidth > 57 )
+    {
+        for ( size_t i = 0; i < nValues; i++ )
+        {
+            const QWORD qwBit   = static_cast<QWORD>(i) * dwWidth;
+            const DWORD dwShift = static_cast<DWORD>(qwBit & 7);
+
+            if ( dwShift != 0 )
+                rgValues[i] |= static_cast<QWORD>(pBits[(qwBit >> 3) + 8]) << (64 - dwShift);
+        }
+    }
+
+    if ( column.byCodec == KENO_PACK_DICTIONARY )
+    {
+        QWORD qwMaxIndex = 0;
+
+        for ( size_t i = 0; i < nValues; i++ )
+        {
+            const QWORD qwIndex = rgValues[i] & qwMask;
+
+            qwMaxIndex  = (qwIndex > qwMaxIndex) ? qwIndex : qwMaxIndex;
+            rgValues[i] = rgDict[(qwIndex < column.wDictSize) ? qwIndex : 0];
+        }
+
+        if ( qwMaxIndex >= column.wDictSize )
+            return nullptr;
+    }
+    else
+    {
+        for ( size_t i = 0; i < nValues; i++ )
+            rgValues[i] = column.qwBase + (rgValues[i] & qwMask);
+    }
+
+    return pBits + getPackedSize (nValues, dwWidth);
+}
+
+/**
+  Binomial coefficients C (n, k) of the colex rank of a draw
+*/
+struct KenoRankTable
+{
+    QWORD rgChoose[g_TOTAL_BALLS + 1][g_BALLS_DRAWN + 1];
+
+    KenoRankTable ( )
+    {
+        memset (rgChoose, 0, sizeof (rgChoose));
+
+        for ( int n = 0; n <= g_TOTAL_BALLS; n++ )
+        {
+            rgChoose[n][0] = 1;
+
+            for ( int k = 1; (k <= g_BALLS_DRAWN) && (k <= n); k++ )
+                rgChoose[n][k] = rgChoose[n - 1][k - 1] + ((k < n) ? rgChoose[n - 1][k] : 0);
+        }
+    }
+};
+
+static const KenoRankTable g_rankTable;
+
+/**
+  @brief the colex rank of a draw, sum C (ball, i) over its balls 0 .. 79 in
+         ascending order, i = 1 .. 20, and the position of its last ball
+*/
+static void rankDraw (const KenoDraw& draw, QWORD& qwRank, QWORD& qwLastPosition)
+{
+    const DWORD dwLastBall = static_cast<DWORD>(draw.rgBalls[g_BALLS_DRAWN - 1]) - 1;
+    QWORD       rgqwMask[2] = { draw.qwMaskLo, draw.qwMaskHi };
+    int         i           = 1;
+
+    qwRank         = 0;
+    qwLastPosition = 0;
+
+    for ( DWORD w = 0; w < 2; w++ )
+    {
+        for ( ; rgqwMask[w] != 0; rgqwMask[w] &= rgqwMask[w] - 1, i++ )
+        {
+            const DWORD dwBall = w * 64 + countTrailingZeros (rgqwMask[w]);
+
+            qwRank += g_rankTable.rgChoose[dwBall][i];
+
+            if ( dwBall == dwLastBall )
+                qwLastPosition = i - 1;
+        }
+    }
+}
+
+/**
+  @brief the draw of a colex rank, its balls ascending but for the last
+         ball drawn at the end
+
+  @retval bool              false if the rank or position is out of range
+*/
+static bool unrankDraw (QWORD qwRank, QWORD qwLastPosition, KenoDraw& draw)
+{
+    if ( (qwRank >= g_rankTable.rgChoose[g_TOTAL_BALLS][g_BALLS_DRAWN]) || (qwLastPosition >= g_BALLS_DRAWN) )
+        return false;
+
+    BYTE rgSorted[g_BALLS_DRAWN];
+    int  n = g_TOTAL_BALLS - 1;
+
+    draw.qwMaskLo = 0;
+    draw.qwMaskHi = 0;
+
+    // the balls fall from the top, so the search for them walks down once
+    for ( int i = g_BALLS_DRAWN; i >= 1; i-- )
+    {
+        while ( g_rankTable.rgChoose[n][i] > qwRank )
+            n--;
+
+        qwRank -= g_rankTable.rgChoose[n][i];
+
+        const QWORD qwBit = 1ULL << (n & 63);
+
+        draw.qwMaskLo   |= (n < 64)  ? qwBit : 0;
+        draw.qwMaskHi   |= (n >= 64) ? qwBit : 0;
+        rgSorted[i - 1]  = static_cast<BYTE>(n + 1);
+        n--;
+    }
+
+    int j = 0;
+
+    for ( int i = 0; i < g_BALLS_DRAWN; i++ )
+    {
+        if ( i != static_cast<int>(qwLastPosition) )
+            draw.rgBalls[j++] = rgSorted[i];
+    }
+
+    draw.rgBalls[g_BALLS_DRAWN - 1] = rgSorted[qwLastPosition];
+
+    return true;
+}
+
+/// masks played g_nMinArchiveMaskUses times or more, sorted
+static void buildMaskDictionary (const KenoTicketRecord* rgRecords, size_t nRecords, std::vector<KenoBallMask>& rgDict)
+{
+    std::vector<KenoBallMask> rgMasks (nRecords);
+
+    for ( size_t i = 0; i < nRecords; i++ )
+        rgMasks[i] = { rgRecords[i].qwMaskLo, rgRecords[i].qwMaskHi };
+
+    std::sort (rgMasks.begin ( ), rgMasks.end ( ));
+    rgDict.clear ( );
+
+    for ( size_t i = 0; i < nRecords; )
+    {
+        size_t j = i + 1;
+
+        while ( (j < nRecords) && (rgMasks[j] == rgMasks[i]) )
+            j++;
+
+        if ( j - i >= g_nMinArchiveMaskUses )
+            rgDict.push_back (rgMasks[i]);
+
+        i = j;
+    }
+}
+
+/// appends the payload of a ticket block, see KenoArchive.h
+static void encodeTicketBlock (const KenoTicketRecord* rgRecords, size_t nRecords, std::vector<BYTE>& rgOut)
+{
+    std::vector<QWORD>        rgValues (nRecords);
+    std::vector<QWORD>        rgEntries;
+    std::vector<QWORD>        rgGaps;
+    std::vector<KenoBallMask> rgDict;
+
+    const QWORD qwFirstId = rgRecords[0].qwTicketId;
+    rgOut.insert (rgOut.end ( ), reinterpret_cast<const BYTE*>(&qwFirstId), reinterpret_cast<const BYTE*>(&qwFirstId + 1));
+
+    // relative to the id after the previous one, so consecutive ids take no bits
+    QWORD qwPrevious = qwFirstId - 1;
+
+    for ( size_t i = 0; i < nRecords; i++ )
+    {
+        const QWORD qwDelta = rgRecords[i].qwTicketId - qwPrevious - 1;
+
+        rgValues[i] = (qwDelta << 1) ^ static_cast<QWORD>(static_cast<long long>(qwDelta) >> 63);
+        qwPrevious  = rgRecords[i].qwTicketId;
+    }
+
+    packColumn (rgValues.data ( ), nRecords, rgOut);
+
+    for ( size_t i = 0; i < nRecords; i++ )
+        rgValues[i] = rgRecords[i].dwFirstDraw;
+
+    packColumn (rgValues.data ( ), nRecords, rgOut);
+
+    for ( size_t i = 0; i < nRecords; i++ )
+        rgValues[i] = rgRecords[i].dwWager;
+
+    packColumn (rgValues.data ( ), nRecords, rgOut);
+
+    for ( size_t i = 0; i < nRecords; i++ )
+        rgValues[i] = rgRecords[i].wNumDraws;
+
+    packColumn (rgValues.data ( ), nRecords, rgOut);
+
+    buildMaskDictionary (rgRecords, nRecords, rgDict);
+
+    const QWORD qwDictSize = rgDict.size ( );
+    rgOut.insert (rgOut.end ( ), reinterpret_cast<const BYTE*>(&qwDictSize), reinterpret_cast<const BYTE*>(&qwDictSize + 1));
+    rgOut.insert (rgOut.end ( ), reinterpret_cast<const BYTE*>(rgDict.data ( )),
+                  reinterpret_cast<const BYTE*>(rgDict.data ( ) + rgDict.size ( )));
+
+    // the spots of every ticket, 0 for a dictionary mask
+    for ( size_t i = 0; i < nRecords; i++ )
+    {
+        const KenoBallMask mask = { rgRecords[i].qwMaskLo, rgRecords[i].qwMaskHi };
+        const auto         it   = std::lower_bound (rgDict.begin ( ), rgDict.end ( ), mask);
+
+        if ( (it != rgDict.end ( )) && (*it == mask) )
+        {
+            rgValues[i] = 0;
+            rgEntries.push_back (static_cast<QWORD>(it - rgDict.begin ( )));
+        }
+        else
+        {
+            rgValues[i] = rgRecords[i].bySpots;     // the writer checked it is the number of balls
+        }
+    }
+
+    packColumn (rgValues.data ( ), nRecords, rgOut);
+    packColumn (rgEntries.data ( ), rgEntries.size ( ), rgOut);
+
+    // the spot lists, grouped by spot count so the decoder's loop over a
+    // list always runs the same number of times
+    for ( DWORD dwSpots = 1; dwSpots <= static_cast<DWORD>(g_MAX_SELECTABLE_BALLS); dwSpots++ )
+    {
+        rgGaps.clear ( );
+
+        for ( size_t i = 0; i < nRecords; i++ )
+        {
+            if ( rgValues[i] != dwSpots )
+                continue;
+
+            QWORD rgqwMask[2] = { rgRecords[i].qwMaskLo, rgRecords[i].qwMaskHi };
+            DWORD dwNext      = 0;      // the lowest ball the next gap counts from
+
+            for ( DWORD w = 0; w < 2; w++ )
+            {
+                for ( ; rgqwMask[w] != 0; rgqwMask[w] &= rgqwMask[w] - 1 )
+                {
+                    const DWORD dwBall = w * 64 + countTrailingZeros (rgqwMask[w]);
+
+                    rgGaps.push_back (dwBall - dwNext);
+                    dwNext = dwBall + 1;
+                }
+            }
+        }
+
+        if ( !rgGaps.empty ( ) )
+            packColumn (rgGaps.data ( ), rgGaps.size ( ), rgOut, false);
+    }
+}
+
+/**
+  @brief decodeTicketBlock
+
+  @param [in]  pPayload     payload of the block
+  @param [in]  cbPayload    bytes of the payload
+  @param [in]  nRecords     tickets in the block
+  @param [out] rgRecords    receives the tickets
+  @param [in]  rgScratch    room for g_nArchiveScratch values
+
+  @retval bool              false if the payload is malformed
+*/
+static bool decodeTicketBlock (const BYTE* pPayload, size_t cbPayload, size_t nRecords,
+                               KenoTicketRecord* rgRecords, QWORD* rgScratch)
+{
+    const BYTE* p    = pPayload;
+    const BYTE* pEnd = pPayload + cbPayload;
+
+    QWORD* rgIds        = rgScratch;
+    QWORD* rgFirstDraws = rgIds        + g_nArchiveBlockItems;
+    QWORD* rgWagers     = rgFirstDraws + g_nArchiveBlockItems;
+    QWORD* rgNumDraws   = rgWagers     + g_nArchiveBlockItems;
+    QWORD* rgSpots      = rgNumDraws   + g_nArchiveBlockItems;
+    QWORD* rgEntries    = rgSpots      + g_nArchiveBlockItems;
+    WORD   rgOrder[g_nArchiveBlockItems];
+    size_t rgnStart[g_MAX_SELECTABLE_BALLS + 2] = { 0 };
+    size_t rgnNext[g_MAX_SELECTABLE_BALLS + 1];
+    QWORD  qwPrevious;
+    QWORD  qwDictSize;
+
+    if ( (nRecords == 0) || (nRecords > g_nArchiveBlockItems) || (cbPayload < sizeof (qwPrevious)) )
+        return false;
+
+    memcpy (&qwPrevious, p, sizeof (qwPrevious));
+    p += sizeof (qwPrevious);
+    qwPrevious--;
+
+    if ( ((p = unpackColumn (p, pEnd, nRecords, rgIds))        == nullptr) ||
+         ((p = unpackColumn (p, pEnd, nRecords, rgFirstDraws)) == nullptr) ||
+         ((p = unpackColumn (p, pEnd, nRecords, rgWagers))     == nullptr) ||
+         ((p = unpackColumn (p, pEnd, nRecords, rgNumDraws))   == nullptr) ||
+         (static_cast<size_t>(pEnd - p) < sizeof (qwDictSize)) )
+        return false;
+
+    memcpy (&qwDictSize, p, sizeof (qwDictSize));
+    p += sizeof (qwDictSize);
+
+    if ( qwDictSize > static_cast<size_t>(pEnd - p) / sizeof (KenoBallMask) )
+        return false;
+
+    const KenoBallMask* rgDict = reinterpret_cast<const KenoBallMask*>(p);
+    p += qwDictSize * sizeof (KenoBallMask);
+
+    if ( (p = unpackColumn (p, pEnd, nRecords, rgSpots)) == nullptr )
+        return false;
+
+    // order the tickets by spot count, dictionary masks first, each group in
+    // ticket order like its spot lists
+    for ( size_t i = 0; i < nRecords; i++ )
+    {
+        if ( rgSpots[i] > static_cast<QWORD>(g_MAX_SELECTABLE_BALLS) )
+            return false;
+
+        rgnStart[rgSpots[i] + 1]++;
+    }
+
+    for ( int k = 1; k <= g_MAX_SELECTABLE_BALLS + 1; k++ )
+        rgnStart[k] += rgnStart[k - 1];
+
+    memcpy (rgnNext, rgnStart, sizeof (rgnNext));
+
+    for ( size_t i = 0; i < nRecords; i++ )
+        rgOrder[rgnNext[rgSpots[i]]++] = static_cast<WORD>(i);
+
+    if ( (p = unpackColumn (p, pEnd, rgnStart[1], rgEntries)) == nullptr )
+        return false;
+
+    QWORD qwBad = 0;
+
+    for ( size_t j = 0; j < rgnStart[1]; j++ )
+    {
+        KenoTicketRecord&   record = rgRecords[rgOrder[j]];
+        const QWORD         qwEntry = rgEntries[j];
+        const KenoBallMask& mask    = rgDict[(qwEntry < qwDictSize) ? qwEntry : 0];
+
+        qwBad |= (qwEntry >= qwDictSize) ? 1 : 0;
+
+        record.qwMaskLo = mask.qwMaskLo;
+        record.qwMaskHi = mask.qwMaskHi;
+        record.bySpots  = static_cast<BYTE>(countBits (mask.qwMaskLo) + countBits (mask.qwMaskHi));
+    }
+
+    for ( DWORD dwSpots = 1; dwSpots <= static_cast<DWORD>(g_MAX_SELECTABLE_BALLS); dwSpots++ )
+    {
+        const size_t nTickets = rgnStart[dwSpots + 1] - rgnStart[dwSpots];
+
+        if ( nTickets == 0 )
+            continue;
+
+        KenoPackedColumn column;
+
+        if ( ((p = openColumn (p, pEnd, nTickets * dwSpots, column)) == nullptr) ||
+             (column.byCodec != KENO_PACK_OFFSET) || (column.byWidth > 57) ||
+             (column.qwBase >= static_cast<QWORD>(g_TOTAL_BALLS)) )
+            return false;
+
+        const BYTE*  pBits   = p;
+        const DWORD  dwWidth = column.byWidth;
+        const QWORD  qwMask  = (1ULL << dwWidth) - 1;
+        const WORD*  pOrder  = rgOrder + rgnStart[dwSpots];
+        const QWORD  qwStep  = column.qwBase + 1;
+        QWORD        qwBit   = 0;
+
+        for ( size_t j = 0; j < nTickets; j++ )
+        {
+            KenoTicketRecord& record = rgRecords[pOrder[j]];
+            QWORD             qwLo   = 0;
+            QWORD             qwHi   = 0;
+            QWORD             qwNext = column.qwBase;  // one past the previous ball, plus qwBase
+
+            for ( DWORD s = 0; s < dwSpots; s++ )
+            {
+                QWORD qwWord;
+                memcpy (&qwWord, pBits + (qwBit >> 3), sizeof (qwWord));
+
+                const QWORD         qwIndex = qwNext + ((qwWord >> (qwBit & 7)) & qwMask);
+                const KenoBallMask& ball    = g_ballMasks.rgMasks[qwIndex & 127];
+
+                qwLo   |= ball.qwMaskLo;
+                qwHi   |= ball.qwMaskHi;
+                qwNext  = qwIndex + qwStep;
+                qwBit  += dwWidth;
+            }
+
+            // the balls ascend, so only the last one can be out of range
+            qwBad |= (qwNext - column.qwBase > static_cast<QWORD>(g_TOTAL_BALLS)) ? 1 : 0;
+
+            record.qwMaskLo = qwLo;
+            record.qwMaskHi = qwHi;
+            record.bySpots  = static_cast<BYTE>(dwSpots);
+        }
+
+        p = pBits + getPackedSize (nTickets * dwSpots, dwWidth);
+    }
+
+    for ( size_t i = 0; i < nRecords; i++ )
+    {
+        KenoTicketRecord& record   = rgRecords[i];
+        const QWORD       qwZigzag = rgIds[i];
+
+        qwPrevious += 1 + ((qwZigzag >> 1) ^ (0 - (qwZigzag & 1)));
+
+        record.qwTicketId  = qwPrevious;
+        record.dwFirstDraw = static_cast<DWORD>(rgFirstDraws[i]);
+        record.dwWager     = static_cast<DWORD>(rgWagers[i]);
+        record.wNumDraws   = static_cast<WORD>(rgNumDraws[i]);
+        record.byReserved  = 0;
+        record.dwReserved  = 0;
+    }
+
+    return qwBad == 0;
+}
+
+
+static void encodeDrawBlock (const KenoDraw* rgDraws, size_t nDraws, std::vector<BYTE>& rgOut)
+{
+    std::vector<QWORD> rgRanks     (nDraws);
+    std::vector<QWORD> rgPositions (nDraws);
+
+    for ( size_t i = 0; i < nDraws; i++ )
+        rankDraw (rgDraws[i], rgRanks[i], rgPositions[i]);
+
+    packColumn (rgRanks.data ( ),     nDraws, rgOut);
+    packColumn (rgPositions.data ( ), nDraws, rgOut);
+}
+
+static bool decodeDrawBlock (const BYTE* pPayload, size_t cbPayload, size_t nDraws, KenoDraw* rgDraws, QWORD* rgScratch)
+{
+    const BYTE* p           = pPayload;
+    const BYTE* pEnd        = pPayload + cbPayload;
+    QWORD*      rgRanks     = rgScratch;
+    QWORD*      rgPositions = rgScratch + g_nArchiveBlockItems;
+
+    if ( (nDraws == 0) || (nDraws > g_nArchiveBlockItems) ||
+         ((p = unpackColumn (p, pEnd, nDraws, rgRanks))     == nullptr) ||
+         ((p = unpackColumn (p, pEnd, nDraws, rgPositions)) == nullptr) )
+        return false;
+
+    for ( size_t i = 0; i < nDraws; i++ )
+    {
+        if ( !unrankDraw (rgRanks[i], rgPositions[i], rgDraws[i]) )
+            return false;
+    }
+
+    return true;
+}
+
+
+KenoArchiveWriter::KenoArchiveWriter ( )
+    : m_pFile       (nullptr),
+      m_eKind       (KENO_ARCHIVE_TICKETS),
+      m_qwNumItems  (0),
+      m_qwNumBlocks (0),
+      m_qwOffset    (0),
+      m_bFailed     (false)
+{
+    m_szPath[0]     = _T('\0');
+    m_szTempPath[0] = _T('\0');
+}
+
+KenoArchiveWriter::~KenoArchiveWriter ( )
+{
+    abandon ( );
+}
+
+bool KenoArchiveWriter::open (const TCHAR* szPath, KenoArchiveKind eKind)
+{
+    abandon ( );
+
+#ifdef _WIN32
+    const DWORD dwProcessId = ::GetCurrentProcessId ( );
+#else
+    const DWORD dwProcessId = static_cast<DWORD>(getpid ( ));
+#endif
+
+    _tcsncpy (m_szPath, szPath, _countof (m_szPath) - 1);
+    _sntprintf (m_szTempPath, _countof (m_szTempPath) - 1, _T ("%s.%u.tmp"), szPath, dwProcessId);
+
+    m_pFile = _tfopen (m_szTempPath, _T ("wb"));
+    if ( m_pFile == nullptr )
+        return false;
+
+    m_eKind       = eKind;
+    m_qwNumItems  = 0;
+    m_qwNumBlocks = 0;
+    m_qwOffset    = 0;
+    m_bFailed     = false;
+
+    m_rgTickets.clear ( );
+    m_rgDraws.clear ( );
+    m_rgTickets.reserve (g_nArchiveBlockItems);
+    m_rgDraws.reserve (g_nArchiveBlockItems);
+    m_rgBuffer.clear ( );
+    m_rgBuffer.reserve (g_cbArchiveChunk + g_cbArchiveChunk / 2);
+
+    // the header is rewritten by close () once the counts are known
+    m_rgBuffer.resize (sizeof (KenoArchiveHeader), 0);
+
+    return true;
+}
+
+bool KenoArchiveWriter::appendTickets (const KenoTicketRecord* rgRecords, size_t nRecords)
+{
+    if ( (m_pFile == nullptr) || (m_eKind != KENO_ARCHIVE_TICKETS) )
+        return false;
+
+    // balls 81 .. 128 do not exist
+    const QWORD qwValidHi = (1ULL << (g_TOTAL_BALLS - 64)) - 1;
+
+    // validate every ticket first, so a rejected call appends nothing
+    for ( size_t i = 0; i < nRecords; i++ )
+    {
+        const KenoTicketRecord& record = rgRecords[i];
+
+        if ( (record.bySpots < 1) || (record.bySpots > g_MAX_SELECTABLE_BALLS) || ((record.qwMaskHi & ~qwValidHi) != 0) ||
+             (countBits (record.qwMaskLo) + countBits (record.qwMaskHi) != record.bySpots) )
+            return false;
+    }
+
+    for ( size_t i = 0; i < nRecords; i++ )
+    {
+        m_rgTickets.push_back (rgRecords[i]);
+
+        if ( m_rgTickets.size ( ) == g_nArchiveBlockItems )
+            encodeBlock ( );
+    }
+
+    return !m_bFailed;
+}
+
+bool KenoArchiveWriter::appendDraws (const KenoDraw* rgDraws, size_t nDraws)
+{
+    if ( (m_pFile == nullptr) || (m_eKind != KENO_ARCHIVE_DRAWS) )
+        return false;
+
+    // balls 81 .. 128 do not exist
+    const QWORD qwValidHi = (1ULL << (g_TOTAL_BALLS - 64)) - 1;
+
+    // validate every draw first, so a rejected call appends nothing; the
+    // colex rank needs 20 balls of 1 .. 80 and the last ball among them
+    for ( size_t i = 0; i < nDraws; i++ )
+    {
+        const KenoDraw& draw       = rgDraws[i];
+        const DWORD     dwLastBall = static_cast<DWORD>(draw.rgBalls[g_BALLS_DRAWN - 1]) - 1;
+
+        if ( ((draw.qwMaskHi & ~qwValidHi) != 0) ||
+             (countBits (draw.qwMaskLo) + countBits (draw.qwMaskHi) != static_cast<DWORD>(g_BALLS_DRAWN)) ||
+             (dwLastBall >= static_cast<DWORD>(g_TOTAL_BALLS)) ||
+             (((((dwLastBall < 64) ? draw.qwMaskLo : draw.qwMaskHi) >> (dwLastBall & 63)) & 1) == 0) )
+            return false;
+    }
+
+    for ( size_t i = 0; i < nDraws; i++ )
+    {
+        m_rgDraws.push_back (rgDraws[i]);
+
+        if ( m_rgDraws.size ( ) == g_nArchiveBlockItems )
+            encodeBlock ( );
+    }
+
+    return !m_bFailed;
+}
+
+void KenoArchiveWriter::encodeBlock (void)
+{
+    const size_t nItems = (m_eKind == KENO_ARCHIVE_TICKETS) ? m_rgTickets.size ( ) : m_rgDraws.size ( );
+
+    if ( nItems == 0 )
+        return;
+
+    const size_t cbHeader = m_rgBuffer.size ( );
+
+    m_rgBuffer.resize (cbHeader + sizeof (KenoArchiveBlockHeader), 0);
+
+    if ( m_eKind == KENO_ARCHIVE_TICKETS )
+        encodeTicketBlock (m_rgTickets.data ( ), nItems, m_rgBuffer);
+    else
+        encodeDrawBlock (m_rgDraws.data ( ), nItems, m_rgBuffer);
+
+    const size_t cbPayload = m_rgBuffer.size ( ) - cbHeader - sizeof (KenoArchiveBlockHeader);
+
+    KenoArchiveBlockHeader header = { };
+
+    header.dwNumItems = static_cast<DWORD>(nItems);
+    header.cbPayload  = static_cast<DWORD>(cbPayload);
+    header.dwCrc      = calcCrc32c (m_rgBuffer.data ( ) + cbHeader + sizeof (header), cbPayload);
+
+    memcpy (m_rgBuffer.data ( ) + cbHeader, &header, sizeof (header));
+
+    m_qwNumItems += nItems;
+    m_qwNumBlocks++;
+
+    m_rgTickets.clear ( );
+    m_rgDraws.clear ( );
+
+    if ( (m_rgBuffer.size ( ) >= g_cbArchiveChunk) && !flush ( ) )
+        m_bFailed = true;
+}
+
+bool KenoArchiveWriter::flush (void)
+{
+    if ( !m_rgBuffer.empty ( ) && (fwrite (m_rgBuffer.data ( ), m_rgBuffer.size ( ), 1, m_pFile) != 1) )
+        return false;
+
+    m_qwOffset += m_rgBuffer.size ( );
+    m_rgBuffer.clear ( );
+
+    return true;
+}
+
+bool KenoArchiveWriter::close (void)
+{
+    if ( m_pFile == nullptr )
+        return false;
+
+    encodeBlock ( );
+
+    KenoArchiveHeader header = { };
+
+    header.dwMagic      = g_dwArchiveMagic;
+    header.dwVersion    = g_dwArchiveVersion;
+    header.dwHeaderSize = sizeof (KenoArchiveHeader);
+    header.dwKind       = m_eKind;
+    header.qwNumItems   = m_qwNumItems;
+    header.qwNumBlocks  = m_qwNumBlocks;
+    header.qwFileSize   = m_qwOffset + m_rgBuffer.size ( );
+    header.dwHeaderCrc  = calcCrc32c (&header, sizeof (header));
+
+    bool bResult = !m_bFailed && flush ( ) && (fseek (m_pFile, 0, SEEK_SET) == 0) &&
+                   (fwrite (&header, sizeof (header), 1, m_pFile) == 1);
+
+    bResult = (fclose (m_pFile) == 0) && bResult;
+    m_pFile = nullptr;
+
+    if ( bResult )
+    {
+#ifdef _WIN32
+        bResult = ::MoveFileEx (m_szTempPath, m_szPath, MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+        bResult = _trename (m_szTempPath, m_szPath) == 0;
+#endif
+    }
+
+    if ( !bResult )
+        _tremove (m_szTempPath);
+
+    return bResult;
+}
+
+void KenoArchiveWriter::abandon (void)
+{
+    if ( m_pFile != nullptr )
+    {
+        fclose (m_pFile);
+        m_pFile = nullptr;
+
+        _tremove (m_szTempPath);
+    }
+}
+
+
+/**
+  @brief visitArchiveBlocks
+
+  Calls visit (nItems, pPayload, cbPayload) for every block of a mapped
+  archive whose payload checksum matches, in order.
+
+  @retval bool              false if a block is damaged, 'visit' returns
+                            false, or the blocks do not add up to the header
+*/
+template <typename Visitor>
+static bool visitArchiveBlocks (const KenoMappedFile& file, const KenoArchiveHeader& header, Visitor visit)
+{
+    const BYTE* pData    = static_cast<const BYTE*>(file.getData ( ));
+    size_t      cbOffset = sizeof (KenoArchiveHeader);
+    QWORD       qwItems  = 0;
+
+    for ( QWORD b = 0; b < header.qwNumBlocks; b++ )
+    {
+        KenoArchiveBlockHeader block;
+
+        if ( file.getSize ( ) - cbOffset < sizeof (block) )
+            return false;
+
+        memcpy (&block, pData + cbOffset, sizeof (block));
+        cbOffset += sizeof (block);
+
+        const BYTE* pPayload = pData + cbOffset;
+
+        if ( ((block.cbPayload % 8) != 0) || (file.getSize ( ) - cbOffset < block.cbPayload) ||
+             (block.dwCrc != calcCrc32c (pPayload, block.cbPayload)) ||
+             !visit (static_cast<size_t>(block.dwNumItems), pPayload, static_cast<size_t>(block.cbPayload)) )
+            return false;
+
+        cbOffset += block.cbPayload;
+        qwItems  += block.dwNumItems;
+    }
+
+    return (cbOffset == header.qwFileSize) && (qwItems == header.qwNumItems);
+}
+
+KenoArchiveFile::KenoArchiveFile ( )
+{
+    memset (&m_header, 0, sizeof (m_header));
+}
+
+bool KenoArchiveFile::open (const TCHAR* szPath)
+{
+    close ( );
+
+    if ( !m_file.open (szPath) || (m_file.getSize ( ) < sizeof (KenoArchiveHeader)) )
+    {
+        close ( );
+        return false;
+    }
+
+    KenoArchiveHeader header;
+    memcpy (&header, m_file.getData ( ), sizeof (header));
+
+    const DWORD dwHeaderCrc = header.dwHeaderCrc;
+    header.dwHeaderCrc = 0;
+
+    if ( (header.dwMagic != g_dwArchiveMagic) || (header.dwVersion != g_dwArchiveVersion) ||
+         (header.dwHeaderSize != sizeof (KenoArchiveHeader)) ||
+         ((header.dwKind != KENO_ARCHIVE_TICKETS) && (header.dwKind != KENO_ARCHIVE_DRAWS)) ||
+         (header.qwFileSize != m_file.getSize ( )) || (dwHeaderCrc != calcCrc32c (&header, sizeof (header))) )
+    {
+        close ( );
+        return false;
+    }
+
+    header.dwHeaderCrc = dwHeaderCrc;
+    m_header           = header;
+
+    return true;
+}
+
+void KenoArchiveFile::close (void)
+{
+    m_file.close ( );
+    memset (&m_header, 0, sizeof (m_header));
+}
+
+bool KenoArchiveFile::readTickets (std::vector<KenoTicketRecord>& rgRecords) const
+{
+    if ( m_header.dwKind != KENO_ARCHIVE_TICKETS )
+        return false;
+
+    std::vector<QWORD> rgScratch (g_nArchiveScratch);
+    size_t             nRecords = rgRecords.size ( );
+
+    rgRecords.resize (nRecords + static_cast<size_t>(m_header.qwNumItems));
+
+    const bool bResult = visitArchiveBlocks (m_file, m_header, [&] (size_t nItems, const BYTE* pPayload, size_t cbPayload)
+    {
+        if ( rgRecords.size ( ) - nRecords < nItems )
+            return false;
+
+        // decoded in place, so the records are written once
+        if ( !decodeTicketBlock (pPayload, cbPayload, nItems, &rgRecords[nRecords], rgScratch.data ( )) )
+            return false;
+
+        nRecords += nItems;
+        return true;
+    });
+
+    rgRecords.resize (nRecords);
+
+    return bResult;
+}
+
+bool KenoArchiveFile::readDraws (std::vector<KenoDraw>& rgDraws) const
+{
+    if ( m_header.dwKind != KENO_ARCHIVE_DRAWS )
+        return false;
+
+    std::vector<QWORD> rgScratch (2 * g_nArchiveBlockItems);
+    size_t             nDraws = rgDraws.size ( );
+
+    rgDraws.resize (nDraws + static_cast<size_t>(m_header.qwNumItems));
+
+    const bool bResult = visitArchiveBlocks (m_file, m_header, [&] (size_t nItems, const BYTE* pPayload, size_t cbPayload)
+    {
+        if ( (rgDraws.size ( ) - nDraws < nItems) ||
+             !decodeDrawBlock (pPayload, cbPayload, nItems, &rgDraws[nDraws], rgScratch.data ( )) )
+            return false;
+
+        nDraws += nItems;
+        return true;
+    });
+
+    rgDraws.resize (nDraws);
+
+    return bResult;
+}
+
+bool KenoArchiveFile::replayTickets (KenoTicketStore& store, QWORD& qwRefused) const
+{
+    qwRefused = 0;
+
+    if ( m_header.dwKind != KENO_ARCHIVE_TICKETS )
+        return false;
+
+    std::vector<QWORD>            rgScratch (g_nArchiveScratch);
+    std::vector<KenoTicketRecord> rgRecords (g_nArchiveBlockItems);
+
+    store.reserve (store.size ( ) + static_cast<size_t>(m_header.qwNumItems));
+
+    return visitArchiveBlocks (m_file, m_header, [&] (size_t nItems, const BYTE* pPayload, size_t cbPayload)
+    {
+        if ( !decodeTicketBlock (pPayload, cbPayload, nItems, rgRecords.data ( ), rgScratch.data ( )) )
+            return false;
+
+        for ( size_t i = 0; i < nItems; i++ )
+            qwRefused += store.add (toKenoTicket (rgRecords[i])) ? 0 : 1;
+
+        return true;
+    });
+}
@@ -0,0 +1,231 @@
+/**
+@file       KenoArchive.h
+@brief      Compressed archives of tickets and draws
+
+  Years of tickets are kept as archives of bit packed blocks rather than as
+  40 byte KenoTicketRecords.  Layout (little endian):
+
+      KenoArchiveHeader                       64 bytes at offset 0
+      KenoArchiveBlockHeader + payload        g_nArchiveBlockItems tickets or
+      KenoArchiveBlockHeader + payload        draws per block, the last one
+      ..                                      possibly fewer
+
+  Every payload is a sequence of packed columns, each one a KenoPackedColumn
+  followed by its dictionary and its bits.  A column stores n values of the
+  block in 'width' bits each, either as the offset from the smallest value
+  of the block (frame of reference) or as the index into a dictionary of
+  its distinct values, whichever is smaller; a column whose values are all
+  the same takes no bits at all.
+
+  A ticket block holds its first ticket id and the columns
+
+      ticket id - previous ticket id - 1      zigzag mapped, so consecutive
+                                              ids take no bits
+      first draw
+      wager
+      number of draws
+      spots                                   0 for a mask of the dictionary
+      dictionary entry                        of every dictionary mask
+      ball gaps of the 1 spot tickets         of every other mask: its balls
+      ball gaps of the 2 spot tickets         in ascending order, each as
+      ..                                      ball - previous ball - 1
+      ball gaps of the 20 spot tickets
+
+  The mask dictionary, between the number of draws and the spots, holds
+  the masks a block plays at least g_nMinArchiveMaskUses times: favourite
+  numbers and repeated quick picks cost a few bits each.  Every other mask
+  is its spot list, about 7 bits per spot, in the gap column of its spot
+  count; a gap column is left out when no ticket of the block plays that
+  many spots.  The reserved fields of a record are not kept.
+
+  A draw block holds the colex rank of the 20 balls drawn, the exact 62 bit
+  number of the combination, and the position of the last ball drawn among
+  the sorted balls, which the last ball variants pay on.  A decoded draw
+  lists its balls in ascending order with the last ball drawn at the end.
+
+  Decoding unpacks a column at a time with unaligned 64 bit loads, one
+  shift and mask per value and no branches.  Grouping the spot lists by
+  spot count keeps the loop over a list at the same trip count for a whole
+  column, where a loop over lists of mixed lengths would mispredict at the
+  end of nearly every one.  Every payload carries its CRC-32C (KenoCrc32.h).
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_ARCHIVE_H__
+#define __KENO_ARCHIVE_H__
+
+#include <vector>
+#include "KenoMappedFile.h"
+#include "KenoSettlement.h"
+#include "KenoSimulator.h"
+#include "KenoTicketWire.h"
+
+constexpr const DWORD  g_dwArchiveMagic       = 0x52414E4B;   //< 'KNAR'
+constexpr const DWORD  g_dwArchiveVersion     = 1;
+constexpr const size_t g_nArchiveBlockItems   = 1024;         //< tickets or draws per block
+constexpr const size_t g_nMinArchiveMaskUses  = 3;            //< uses of a mask in a block that earn it a dictionary entry
+constexpr const size_t g_cbArchiveChunk       = 4 << 20;      //< bytes per write
+
+enum KenoArchiveKind
+{
+    KENO_ARCHIVE_TICKETS = 1,
+    KENO_ARCHIVE_DRAWS
+};
+
+enum KenoPackCodec
+{
+    KENO_PACK_OFFSET = 0,       //< value - qwBase
+    KENO_PACK_DICTIONARY        //< index into the wDictSize values after the column header
+};
+
+struct KenoArchiveHeader
+{
+    DWORD dwMagic;
+    DWORD dwVersion;
+    DWORD dwHeaderSize;         //< sizeof (KenoArchiveHeader)
+    DWORD dwKind;               //< KenoArchiveKind
+    QWORD qwNumItems;           //< tickets or draws
+    QWORD qwNumBlocks;
+    QWORD qwFileSize;
+    DWORD dwHeaderCrc;          //< CRC-32C of the header, this field 0
+    DWORD dwReserved;
+    QWORD rgqwReserved[2];
+};
+
+static_assert (sizeof (KenoArchiveHeader) == 64, "the archive header is 64 bytes");
+
+struct KenoArchiveBlockHeader
+{
+    DWORD dwNumItems;
+    DWORD cbPayload;            //< a multiple of 8
+    DWORD dwCrc;                //< CRC-32C of the payload
+    DWORD dwReserved;
+};
+
+static_assert (sizeof (KenoArchiveBlockHeader) == 16, "the archive block header is 16 bytes");
+
+struct KenoPackedColumn
+{
+    DWORD dwNumValues;
+    BYTE  byWidth;              //< bits per value, 0 .. 64
+    BYTE  byCodec;              //< KenoPackCodec
+    WORD  wDictSize;            //< values of the dictionary, 0 for KENO_PACK_OFFSET
+    QWORD qwBase;               //< smallest value, 0 for KENO_PACK_DICTIONARY
+};
+
+static_assert (sizeof (KenoPackedColumn) == 16, "a packed column header is 16 bytes");
+
+/**
+  Writes an archive a block at a time, so the tickets need not be held in
+  memory whole.  The file is written to a temporary file that replaces the
+  target when it is complete.
+*/
+class KenoArchiveWriter
+{
+public:
+    KenoArchiveWriter  ( );
+    ~KenoArchiveWriter ( );             //< abandons an unfinished file
+
+    KenoArchiveWriter            (const KenoArchiveWriter&) = delete;
+    KenoArchiveWriter& operator= (const KenoArchiveWriter&) = delete;
+
+    bool open          (const TCHAR* szPath, KenoArchiveKind eKind);
+
+    /**
+      @brief appends tickets to a KENO_ARCHIVE_TICKETS archive
+
+      @retval bool      false if a write failed, or if any ticket's spot
+                        count does not match its mask, in which case none
+                        of the tickets is appended
+    */
+    bool appendTickets (const KenoTicketRecord* rgRecords, size_t nRecords);
+
+    /**
+      @brief appends draws to a KENO_ARCHIVE_DRAWS archive
+
+      @retval bool      false if a write failed, or if any draw does not
+                        hold exactly g_BALLS_DRAWN balls of 1 .. g_TOTAL_BALLS
+                        with its last ball drawn among them, in which case
+                        none of the draws is appended
+    */
+    bool appendDraws   (const KenoDraw* rgDraws, size_t nDraws);
+
+    /**
+      @brief completes the file and moves it into place
+
+      @retval bool      false if a write failed
+    */
+    bool close         (void);
+
+    QWORD getNumBytes  (void) const { return m_qwOffset + m_rgBuffer.size ( ); }
+
+private:
+    void encodeBlock   (void);
+    bool flush         (void);
+    void abandon       (void);
+
+    FILE*                         m_pFile;
+    TCHAR                         m_szPath[_MAX_PATH];
+    TCHAR                         m_szTempPath[_MAX_PATH];
+    KenoArchiveKind               m_eKind;
+    QWORD                         m_qwNumItems;
+    QWORD                         m_qwNumBlocks;
+    QWORD                         m_qwOffset;          //< bytes written to the file
+    bool                          m_bFailed;
+    std::vector<KenoTicketRecord> m_rgTickets;         //< of the block being filled
+    std::vector<KenoDraw>         m_rgDraws;           //< of the block being filled
+    std::vector<BYTE>             m_rgBuffer;          //< encoded blocks, written in g_cbArchiveChunk chunks
+};
+
+/**
+  A mapped archive.
+*/
+class KenoArchiveFile
+{
+public:
+    KenoArchiveFile ( );
+
+    /**
+      @brief maps 'szPath' and checks its header
+
+      @retval bool          false if the file is not a complete archive
+    */
+    bool open  (const TCHAR* szPath);
+    void close (void);
+
+    KenoArchiveKind getKind     (void) const { return static_cast<KenoArchiveKind>(m_header.dwKind); }
+    QWORD           getNumItems (void) const { return m_header.qwNumItems; }
+    QWORD           getFileSize (void) const { return m_header.qwFileSize; }
+
+    /**
+      @brief appends every ticket of a ticket archive to 'rgRecords'
+
+      @retval bool          false if this is not a ticket archive or a block is damaged
+    */
+    bool readTickets   (std::vector<KenoTicketRecord>& rgRecords) const;
+
+    /**
+      @brief appends every draw of a draw archive to 'rgDraws'
+
+      @retval bool          false if this is not a draw archive or a block is damaged
+    */
+    bool readDraws     (std::vector<KenoDraw>& rgDraws) const;
+
+    /**
+      @brief adds every ticket of a ticket archive to 'store'
+
+      @param [out] store        receives the tickets; not cleared first
+      @param [out] qwRefused    tickets the store refused
+
+      @retval bool              false if this is not a ticket archive or a block is damaged
+    */
+    bool replayTickets (KenoTicketStore& store, QWORD& qwRefused) const;
+
+private:
+    KenoMappedFile    m_file;
+    KenoArchiveHeader m_header;
+};
+
+#endif
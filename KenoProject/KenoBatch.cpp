@@ -0,0 +1,266 @@
+/**
+@file       KenoBatch.cpp
+@brief      Implementation of the streaming batch queries
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <limits>
+#include <string.h>
+#include "KenoBatch.h"
+#include "KenoFileIO.h"
+#include "KenoFormat.h"
+#include "KenoService.h"
+
+constexpr const int   g_nBatchFields    = 3;       //< spots, catch, pay table
+constexpr const DWORD g_dwMaxFieldValue = 255;
+
+
+KenoBatchAnswers::KenoBatchAnswers ( )
+    : m_nPayTables (0),
+      m_nInvalid   (0)
+{
+}
+
+void KenoBatchAnswers::build (const KenoModel& model)
+{
+    // every (spots, catch, pay table) in the order of lookup (), then the invalid answer
+    m_nPayTables = (model.nPayTables > 0) ? model.nPayTables : 1;
+    m_nInvalid   = g_MAX_ROWS * g_MAX_COLS * m_nPayTables;
+
+    m_rgText.clear ( );
+    m_rgOffset.clear ( );
+    m_rgOffset.reserve (m_nInvalid + 2);
+
+    char szProbability[g_cchMaxFormattedDouble];
+    char szPayOut[g_cchMaxFormattedDouble];
+
+    for ( DWORD s = 1; s <= g_MAX_ROWS; s++ )
+    {
+        for ( DWORD c = 0; c < g_MAX_COLS; c++ )
+        {
+            const bool   bCatch  = (c <= s);
+            const size_t cchProb = bCatch ? formatDouble (model.rgProbability[s - 1][c], szProbability)
+                                          : formatDouble (std::numeric_limits<double>::quiet_NaN ( ), szProbability);
+
+            for ( int t = 0; t < m_nPayTables; t++ )
+            {
+                const bool   bPayOut = bCatch && (t < model.nPayTables) && (s <= g_MAX_SPOTS_MARKED);
+                const size_t cchPay  = bPayOut ? formatDouble (model.rgPayTables[t].rgPayOut[s - 1][c], szPayOut)
+                                               : formatDouble (std::numeric_limits<double>::quiet_NaN ( ), szPayOut);
+
+                m_rgOffset.push_back (static_cast<DWORD>(m_rgText.size ( )));
+
+                m_rgText.insert (m_rgText.end ( ), szProbability, szProbability + cchProb);
+                m_rgText.push_back (',');
+                m_rgText.insert (m_rgText.end ( ), szPayOut, szPayOut + cchPay);
+                m_rgText.push_back ('\n');
+            }
+        }
+    }
+
+    static const char s_szInvalid[] = "nan,nan\n";
+
+    m_rgOffset.push_back (static_cast<DWORD>(m_rgText.size ( )));
+    m_rgText.insert (m_rgText.end ( ), s_szInvalid, s_szInvalid + sizeof (s_szInvalid) - 1);
+    m_rgOffset.push_back (static_cast<DWORD>(m_rgText.size ( )));
+}
+
+DWORD KenoBatchAnswers::lookup (const char* p, const char* pEnd) const
+{
+    DWORD rgField[g_nBatchFields] = { 0, 0, 0 };
+    int   nFields                 = 0;
+
+    for ( ;; )
+    {
+        while ( (p < pEnd) && ((*p == ',') || (*p == ' ') || (*p == '\t')) )
+            p++;
+
+        if ( p == pEnd )
+            break;
+
+        if ( (nFields == g_nBatchFields) || (static_cast<unsigned>(*p - '0') > 9) )
+            return m_nInvalid;
+
+        DWORD dwValue = 0;
+
+        while ( (p < pEnd) && (static_cast<unsigned>(*p - '0') <= 9) && (dwValue <= g_dwMaxFieldValue) )
+            dwValue = dwValue * 10 + static_cast<DWORD>(*p++ - '0');
+
+        rgField[nFields++] = dwValue;
+    }
+
+    const DWORD dwSpots = rgField[0];
+    const DWORD dwCatch = rgField[1];
+    const DWORD dwTable = rgField[2];
+
+    if ( (nFields < 2) || (dwSpots < 1) || (dwSpots > g_MAX_ROWS) || (dwCatch >= g_MAX_COLS) ||
+         (dwTable >= static_cast<DWORD>(m_nPayTables)) )
+        return m_nInvalid;
+
+    return ((dwSpots - 1) * g_MAX_COLS + dwCatch) * m_nPayTables + dwTable;
+}
+
+size_t KenoBatchAnswers::answerText (const char* pIn, size_t cbIn, bool bFinal, char* pOut, size_t cbOut,
+                                     size_t& cbWritten, QWORD& qwRecords) const
+{
+    const char* p    = pIn;
+    const char* pEnd = pIn + cbIn;
+    char*       q    = pOut;
+
+    while ( (p < pEnd) && (static_cast<size_t>(pOut + cbOut - q) >= g_cbMaxBatchAnswer) )
+    {
+        // memchr is the vectorized scan for the end of the record
+        const char* pNewLine = static_cast<const char*>(memchr (p, '\n', pEnd - p));
+
+        if ( (pNewLine == nullptr) && !bFinal )
+            break;
+
+        const char* pNext = (pNewLine != nullptr) ? pNewLine + 1 : pEnd;
+        const char* pLine = (pNewLine != nullptr) ? pNewLine     : pEnd;
+
+        if ( (pLine > p) && (pLine[-1] == '\r') )
+            pLine--;
+
+        if ( pLine > p )
+        {
+            const DWORD  nAnswer = lookup (p, pLine);
+            const DWORD  dwStart = m_rgOffset[nAnswer];
+            const size_t cbLine  = m_rgOffset[nAnswer + 1] - dwStart;
+
+            memcpy (q, m_rgText.data ( ) + dwStart, cbLine);
+            q += cbLine;
+
+            qwRecords++;
+        }
+
+        p = pNext;
+    }
+
+    cbWritten = q - pOut;
+
+    return p - pIn;
+}
+
+
+/// answers text records a buffer at a time, carrying an incomplete line over
+static bool runTextQueries (const KenoModel& model, FILE* pIn, FILE* pOut, QWORD& qwRecords)
+{
+    KenoBatchAnswers answers;
+    answers.build (model);
+
+    static const char s_szInvalid[] = "nan,nan\n";
+
+    std::vector<char> rgIn  (g_cbBatchBuffer);
+    std::vector<char> rgOut (g_cbBatchBuffer);
+    size_t            cbHave    = 0;
+    bool              bEnd      = false;
+    bool              bSkipLine = false;     //< inside a line longer than the buffer
+
+    while ( !bEnd )
+    {
+        size_t cbRead = 0;
+
+        if ( !readFileChunk (pIn, rgIn.data ( ) + cbHave, rgIn.size ( ) - cbHave, cbRead) )
+            return false;
+
+        cbHave += cbRead;
+        bEnd    = (cbRead == 0);
+
+        if ( bSkipLine )
+        {
+            const char*  pNewLine = static_cast<const char*>(memchr (rgIn.data ( ), '\n', cbHave));
+            const size_t cbSkip   = (pNewLine != nullptr) ? (pNewLine + 1 - rgIn.data ( )) : cbHave;
+
+            memmove (rgIn.data ( ), rgIn.data ( ) + cbSkip, cbHave - cbSkip);
+            cbHave   -= cbSkip;
+            bSkipLine = (pNewLine == nullptr);
+        }
+
+        size_t cbUsed = 0;
+
+        for ( ;; )
+        {
+            size_t       cbWritten = 0;
+            const size_t cbTaken   = answers.answerText (rgIn.data ( ) + cbUsed, cbHave - cbUsed, bEnd,
+                                                         rgOut.data ( ), rgOut.size ( ), cbWritten, qwRecords);
+            cbUsed += cbTaken;
+
+            if ( (cbWritten > 0) && !writeFileChunk (pOut, rgOut.data ( ), cbWritten) )
+                return false;
+
+            if ( cbTaken == 0 )
+                break;
+        }
+
+        // a line longer than the whole buffer is answered as malformed
+        if ( (cbUsed == 0) && (cbHave == rgIn.size ( )) )
+        {
+            if ( !writeFileChunk (pOut, s_szInvalid, sizeof (s_szInvalid) - 1) )
+                return false;
+
+            qwRecords++;
+
+            cbUsed    = cbHave;
+            bSkipLine = true;
+        }
+
+        memmove (rgIn.data ( ), rgIn.data ( ) + cbUsed, cbHave - cbUsed);
+        cbHave -= cbUsed;
+    }
+
+    return true;
+}
+
+/// answers KenoQuery records with answerQueries, a buffer at a time
+static bool runBinaryQueries (const KenoModel& model, FILE* pIn, FILE* pOut, QWORD& qwRecords)
+{
+    const size_t nPerChunk = g_cbBatchBuffer / sizeof (double);
+
+    std::vector<KenoQuery> rgQueries (nPerChunk);
+    std::vector<double>    rgResults (nPerChunk);
+    size_t                 cbHave = 0;
+
+    for ( ;; )
+    {
+        size_t cbRead = 0;
+
+        if ( !readFileChunk (pIn, reinterpret_cast<BYTE*>(rgQueries.data ( )) + cbHave,
+                         nPerChunk * sizeof (KenoQuery) - cbHave, cbRead) )
+            return false;
+
+        // a partial trailing record is an error
+        if ( cbRead == 0 )
+            return cbHave == 0;
+
+        cbHave += cbRead;
+
+        const size_t nQueries = cbHave / sizeof (KenoQuery);
+
+        answerQueries (model, rgQueries.data ( ), static_cast<DWORD>(nQueries), rgResults.data ( ));
+
+        if ( !writeFileChunk (pOut, rgResults.data ( ), nQueries * sizeof (double)) )
+            return false;
+
+        qwRecords += nQueries;
+
+        // keeps the start of an incomplete record
+        const size_t cbUsed = nQueries * sizeof (KenoQuery);
+
+        memmove (rgQueries.data ( ), reinterpret_cast<BYTE*>(rgQueries.data ( )) + cbUsed, cbHave - cbUsed);
+        cbHave -= cbUsed;
+    }
+}
+
+bool runBatchQueries (const KenoModel& model, KenoBatchFormat eFormat, FILE* pIn, FILE* pOut, QWORD& qwRecords)
+{
+    qwRecords = 0;
+
+    // the records bypass the stream buffers from here on
+    fflush (pOut);
+
+    return (eFormat == KENO_BATCH_BINARY) ? runBinaryQueries (model, pIn, pOut, qwRecords)
+                                          : runTextQueries   (model, pIn, pOut, qwRecords);
+}
@@ -0,0 +1,100 @@
+/**
+@file       KenoBatch.h
+@brief      Streaming batch queries from stdin to stdout
+
+  Analytics jobs pipe millions of lookups through one process instead of
+  launching it per table.  Two record formats are read:
+
+      text      one record per line, "spots,catch[,pay table]" (',', ' ' or
+                tab separated, pay table 0 when omitted), answered with the
+                line "probability,pay out" in the canonical formatting of
+                KenoFormat.h; the pay out of more than g_MAX_SPOTS_MARKED
+                spots is "nan", and a malformed record or an unknown pay
+                table answers "nan,nan".  Blank lines are skipped.
+      binary    KenoQuery records (KenoService.h), answered with one little
+                endian double each, NaN for an invalid query.
+
+  Every answer a text record can have is formatted once, when the answers
+  are built from a model, so answering a record is parsing a few digits and
+  copying a string.  Input is read as it becomes available, up to
+  g_cbBatchBuffer bytes at a time, and the answers of a chunk leave in a
+  single write, so a pipe is never held back waiting for a full buffer.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_BATCH_H__
+#define __KENO_BATCH_H__
+
+#include <vector>
+#include "KenoModel.h"
+
+constexpr const size_t g_cbBatchBuffer    = 1 << 20;
+constexpr const size_t g_cbMaxBatchAnswer = 64;        //< longest text answer line
+
+enum KenoBatchFormat
+{
+    KENO_BATCH_TEXT = 0,
+    KENO_BATCH_BINARY
+};
+
+/**
+  The text answers of one model, see the file comment.
+*/
+class KenoBatchAnswers
+{
+public:
+    KenoBatchAnswers ( );
+
+    void build (const KenoModel& model);
+
+    /**
+      @brief answerText
+
+      Answers the complete lines of 'pIn', as long as 'pOut' has room for
+      another g_cbMaxBatchAnswer bytes.
+
+      @param [in]  pIn          text records
+      @param [in]  cbIn         bytes in pIn
+      @param [in]  bFinal       true if pIn ends the input, so a last line
+                                without a newline is complete
+      @param [out] pOut         receives the answer lines
+      @param [in]  cbOut        room in pOut
+      @param [out] cbWritten    bytes written to pOut
+      @param [out] qwRecords    incremented by the records answered
+
+      @retval size_t            bytes of pIn consumed
+    */
+    size_t answerText (const char* pIn, size_t cbIn, bool bFinal, char* pOut, size_t cbOut,
+                       size_t& cbWritten, QWORD& qwRecords) const;
+
+private:
+    /// the answer of a record, m_nInvalid when it is malformed or out of range
+    DWORD lookup (const char* pLine, const char* pEnd) const;
+
+    int                 m_nPayTables;
+    DWORD               m_nInvalid;         //< index of the "nan,nan" answer
+    std::vector<char>   m_rgText;           //< every answer line
+    std::vector<DWORD>  m_rgOffset;         //< start of each answer in m_rgText, one extra at the end
+};
+
+/**
+  @brief runBatchQueries
+
+  Answers every record of 'pIn' from 'model' into 'pOut' until the end of
+  the input.  Both streams must be in binary mode; the records are read
+  and written on their file descriptors, bypassing the stream buffers.
+
+  @param [in]  model        model to answer from
+  @param [in]  eFormat      KenoBatchFormat of the records
+  @param [in]  pIn          input stream, e.g. stdin
+  @param [in]  pOut         output stream, e.g. stdout
+  @param [out] qwRecords    number of records answered
+
+  @retval bool              false on a read or write error or a partial
+                            binary record
+*/
+bool runBatchQueries (const KenoModel& model, KenoBatchFormat eFormat, FILE* pIn, FILE* pOut, QWORD& qwRecords);
+
+#endif
@@ -0,0 +1,240 @@
+/**
+@file       KenoCheckpoint.cpp
+@brief      Implementation of adaptive simulation checkpoints
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <string.h>
+#include "KenoCheckpoint.h"
+#include "KenoTrace.h"
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+
+/**
+  @brief 64 bit FNV-1a hash
+
+  @sa http://www.isthe.com/chongo/tech/comp/fnv/
+*/
+QWORD hashBytes (const void* pData, size_t cbData, QWORD qwHash)
+{
+    const BYTE* pBytes = static_cast<const BYTE*>(pData);
+
+    for ( size_t i = 0; i < cbData; i++ )
+    {
+        qwHash ^= pBytes[i];
+        qwHash *= 0x100000001B3ULL;
+    }
+
+    return qwHash;
+}
+
+QWORD hashAdaptiveScenarios (const KenoAdaptiveScenario* rgScenarios, int nScenarios)
+{
+    QWORD qwHash = hashBytes (&nScenarios, sizeof (nScenarios));
+
+    for ( int s = 0; s < nScenarios; s++ )
+    {
+        const KenoAdaptiveScenario& scenario = rgScenarios[s];
+
+        qwHash = hashBytes (&scenario.dwNumMarked,    sizeof (scenario.dwNumMarked),    qwHash);
+        qwHash = hashBytes (&scenario.eTarget,        sizeof (scenario.eTarget),        qwHash);
+        qwHash = hashBytes (&scenario.fRelativeError, sizeof (scenario.fRelativeError), qwHash);
+        qwHash = hashBytes (&scenario.qwMaxDraws,     sizeof (scenario.qwMaxDraws),     qwHash);
+        qwHash = hashBytes (scenario.pPayTable->rgPayOut, sizeof (KenoPayOutRow) * g_MAX_PAYOUT_ROWS, qwHash);
+    }
+
+    return qwHash;
+}
+
+bool writeAdaptiveCheckpoint (const TCHAR* szPath, QWORD qwSeed, QWORD qwScenarioHash,
+                              const std::vector<KenoAdaptiveState>& rgStates)
+{
+    KenoCheckpointHeader header = { };
+
+    header.dwMagic        = g_dwCheckpointMagic;
+    header.dwVersion      = g_dwCheckpointVersion;
+    header.dwNumScenarios = static_cast<DWORD>(rgStates.size ( ));
+    header.dwStateSize    = sizeof (KenoAdaptiveState);
+    header.qwSeed         = qwSeed;
+    header.qwScenarioHash = qwScenarioHash;
+    header.qwPayloadHash  = hashBytes (rgStates.data ( ), rgStates.size ( ) * sizeof (KenoAdaptiveState));
+
+    TCHAR szTempPath[_MAX_PATH] = { 0 };
+    _sntprintf (szTempPath, _countof (szTempPath) - 1, _T ("%s.tmp"), szPath);
+
+    FILE* pFile = _tfopen (szTempPath, _T ("wb"));
+    if ( pFile == nullptr )
+        return false;
+
+    bool bResult = (fwrite (&header, sizeof (header), 1, pFile) == 1) &&
+                   (fwrite (rgStates.data ( ), sizeof (KenoAdaptiveState), rgStates.size ( ), pFile) == rgStates.size ( ));
+
+    // the contents must be on disk before the rename makes them the checkpoint,
+    // otherwise a crash can leave a renamed but empty or partial file behind
+    bResult = bResult && (fflush (pFile) == 0);
+#ifdef _WIN32
+    bResult = bResult && (_commit (_fileno (pFile)) == 0);
+#else
+    bResult = bResult && (fsync (fileno (pFile)) == 0);
+#endif
+
+    bResult = (fclose (pFile) == 0) && bResult;
+
+    // replace the previous checkpoint only once the new one is complete
+    if ( bResult )
+    {
+#ifdef _WIN32
+        bResult = ::MoveFileEx (szTempPath, szPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+        bResult = _trename (szTempPath, szPath) == 0;
+
+        // as in KenoJournalWriter::startSegment, the renamed directory entry
+        // must survive a crash too
+        if ( bResult )
+        {
+            TCHAR szDirectory[_MAX_PATH] = { 0 };
+            _tcsncpy (szDirectory, szPath, _countof (szDirectory) - 1);
+
+            TCHAR* pSlash = _tcsrchr (szDirectory, _T('/'));
+
+            if ( pSlash == nullptr )
+                _tcsncpy (szDirectory, _T ("."), _countof (szDirectory) - 1);
+            else if ( pSlash == szDirectory )
+                pSlash[1] = _T('\0');
+            else
+                pSlash[0] = _T('\0');
+
+            const int iDirectory = ::open (szDirectory, O_RDONLY);
+
+            if ( iDirectory >= 0 )
+            {
+                fsync (iDirectory);
+                ::close (iDirectory);
+            }
+        }
+#endif
+    }
+
+    return bResult;
+}
+
+bool readAdaptiveCheckpoint (const TCHAR* szPath, QWORD qwSeed, QWORD qwScenarioHash, int nScenarios,
+                             std::vector<KenoAdaptiveState>& rgStates)
+{
+    FILE* pFile = _tfopen (szPath, _T ("rb"));
+    if ( pFile == nullptr )
+        return false;
+
+    KenoCheckpointHeader header = { };
+
+    bool bResult = (fread (&header, sizeof (header), 1, pFile) == 1)  &&
+                   (header.dwMagic        == g_dwCheckpointMagic)      &&
+                   (header.dwVersion      == g_dwCheckpointVersion)    &&
+                   (header.dwNumScenarios == static_cast<DWORD>(nScenarios)) &&
+                   (header.dwStateSize    == sizeof (KenoAdaptiveState)) &&
+                   (header.qwSeed         == qwSeed)                   &&
+                   (header.qwScenarioHash == qwScenarioHash);
+
+    if ( bResult )
+    {
+        std::vector<KenoAdaptiveState> rgRead (nScenarios);
+
+        bResult = (fread (rgRead.data ( ), sizeof (KenoAdaptiveState), nScenarios, pFile) == static_cast<size_t>(nScenarios)) &&
+                  (hashBytes (rgRead.data ( ), rgRead.size ( ) * sizeof (KenoAdaptiveState)) == header.qwPayloadHash);
+
+        if ( bResult )
+            rgStates.swap (rgRead);
+    }
+
+    fclose (pFile);
+
+    return bResult;
+}
+
+
+KenoCheckpointWriter::KenoCheckpointWriter (const TCHAR* szPath, QWORD qwSeed, QWORD qwScenarioHash)
+    : m_szPath         (szPath),
+      m_qwSeed         (qwSeed),
+      m_qwScenarioHash (qwScenarioHash),
+      m_bPending       (false),
+      m_bWriting       (false),
+      m_bStop          (false),
+      m_dwNumWritten   (0)
+{
+    m_thread = std::thread (&KenoCheckpointWriter::run, this);
+}
+
+KenoCheckpointWriter::~KenoCheckpointWriter ( )
+{
+    flush ( );
+
+    {
+        std::lock_guard<std::mutex> guard (m_lock);
+        m_bStop = true;
+    }
+
+    m_cvWork.notify_one ( );
+    m_thread.join ( );
+}
+
+void KenoCheckpointWriter::post (const std::vector<KenoAdaptiveState>& rgStates)
+{
+    {
+        std::lock_guard<std::mutex> guard (m_lock);
+        m_rgPending = rgStates;
+        m_bPending  = true;
+    }
+
+    m_cvWork.notify_one ( );
+}
+
+void KenoCheckpointWriter::flush (void)
+{
+    std::unique_lock<std::mutex> guard (m_lock);
+    m_cvIdle.wait (guard, [this] { return !m_bPending && !m_bWriting; });
+}
+
+DWORD KenoCheckpointWriter::getNumWritten (void) const
+{
+    std::lock_guard<std::mutex> guard (m_lock);
+    return m_dwNumWritten;
+}
+
+void KenoCheckpointWriter::run (void)
+{
+    std::vector<KenoAdaptiveState> rgSnapshot;
+    std::unique_lock<std::mutex>   guard (m_lock);
+
+    for ( ;; )
+    {
+        m_cvWork.wait (guard, [this] { return m_bPending || m_bStop; });
+
+        if ( !m_bPending )
+            break;
+
+        rgSnapshot.swap (m_rgPending);
+        m_bPending = false;
+        m_bWriting = true;
+
+        guard.unlock ( );
+        const bool bWritten = writeAdaptiveCheckpoint (m_szPath, m_qwSeed, m_qwScenarioHash, rgSnapshot);
+        guard.lock ( );
+
+        if ( bWritten )
+            m_dwNumWritten++;
+        else
+            KENO_TRACE_WARNING (_T ("Failed to write checkpoint '%s'"), m_szPath);
+
+        m_bWriting = false;
+        m_cvIdle.notify_all ( );
+    }
+}
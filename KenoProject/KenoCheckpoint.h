@@ -0,0 +1,119 @@
+/**
+@file       KenoCheckpoint.h
+@brief      Checkpoint and resume of adaptive simulations
+
+  A checkpoint holds, per scenario, the number of merged batches (which is
+  the position of the scenario in its sequence of per batch random number
+  streams), the catch histogram and the draw counter.  Resuming from it
+  re-runs exactly the batches that had not been merged, so the final
+  results are bit-identical to those of an uninterrupted run.
+
+  File layout (little endian):
+
+      KenoCheckpointHeader
+      KenoAdaptiveState [nScenarios]
+
+  Checkpoints are written to a temporary file which is flushed to disk and
+  then replaces the previous checkpoint, so a crash while writing never
+  loses the last one.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_CHECKPOINT_H__
+#define __KENO_CHECKPOINT_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "KenoAdaptive.h"
+
+constexpr const DWORD g_dwCheckpointMagic   = 0x50434E4B;  //< 'KNCP'
+constexpr const DWORD g_dwCheckpointVersion = 1;
+
+struct KenoCheckpointHeader
+{
+    DWORD dwMagic;
+    DWORD dwVersion;
+    DWORD dwNumScenarios;
+    DWORD dwStateSize;          //< sizeof (KenoAdaptiveState) of the writer
+    QWORD qwSeed;               //< base seed of the simulation
+    QWORD qwScenarioHash;       //< fingerprint of the scenario definitions
+    QWORD qwPayloadHash;        //< FNV-1a hash of the scenario states
+};
+
+/**
+  @brief 64 bit FNV-1a hash of 'cbData' bytes, continuing from 'qwHash'
+*/
+QWORD hashBytes (const void* pData, size_t cbData, QWORD qwHash = 0xCBF29CE484222325ULL);
+
+/**
+  @brief fingerprints the scenario definitions so a checkpoint is only ever
+         resumed by the simulation that wrote it
+*/
+QWORD hashAdaptiveScenarios (const KenoAdaptiveScenario* rgScenarios, int nScenarios);
+
+/**
+  @brief writeAdaptiveCheckpoint
+
+  @param [in] szPath        checkpoint file path
+  @param [in] qwSeed        base seed of the simulation
+  @param [in] qwScenarioHash fingerprint from hashAdaptiveScenarios
+  @param [in] rgStates      scenario states to save
+
+  @retval bool              true on success
+*/
+bool writeAdaptiveCheckpoint (const TCHAR* szPath, QWORD qwSeed, QWORD qwScenarioHash,
+                              const std::vector<KenoAdaptiveState>& rgStates);
+
+/**
+  @brief readAdaptiveCheckpoint
+
+  @param [in]  szPath           checkpoint file path
+  @param [in]  qwSeed           base seed the checkpoint must have been written with
+  @param [in]  qwScenarioHash   fingerprint the checkpoint must match
+  @param [in]  nScenarios       expected number of scenarios
+  @param [out] rgStates         receives the scenario states
+
+  @retval bool                  true if a valid, matching checkpoint was read
+*/
+bool readAdaptiveCheckpoint (const TCHAR* szPath, QWORD qwSeed, QWORD qwScenarioHash, int nScenarios,
+                             std::vector<KenoAdaptiveState>& rgStates);
+
+/**
+  Writes checkpoints on a background thread.  post() only swaps a snapshot
+  into the writer's mailbox, so the simulation threads never wait for disk
+  I/O; a snapshot that arrives while the previous one is still being written
+  simply replaces any snapshot that has not been picked up yet.
+*/
+class KenoCheckpointWriter
+{
+public:
+    KenoCheckpointWriter  (const TCHAR* szPath, QWORD qwSeed, QWORD qwScenarioHash);
+    ~KenoCheckpointWriter ( );
+
+    void post  (const std::vector<KenoAdaptiveState>& rgStates);
+    void flush (void);          //< waits until the latest posted snapshot is on disk
+
+    DWORD getNumWritten (void) const;   //< number of snapshots written so far
+
+private:
+    void run (void);
+
+    const TCHAR*                   m_szPath;
+    QWORD                          m_qwSeed;
+    QWORD                          m_qwScenarioHash;
+    std::vector<KenoAdaptiveState> m_rgPending;
+    bool                           m_bPending;
+    bool                           m_bWriting;
+    bool                           m_bStop;
+    DWORD                          m_dwNumWritten;
+    mutable std::mutex             m_lock;
+    std::condition_variable        m_cvWork;
+    std::condition_variable        m_cvIdle;
+    std::thread                    m_thread;
+};
+
+#endif
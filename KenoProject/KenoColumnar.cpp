@@ -0,0 +1,443 @@
+/**
+@file       KenoColumnar.cpp
+@brief      Implementation of the columnar binary export
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <string.h>
+#include "KenoColumnar.h"
+#include "KenoCrc32.h"
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+constexpr const size_t g_cbMaxVarint = 10;     //< LEB128 bytes of a 64 bit value
+
+
+/// rounds 'qwOffset' up to the column alignment
+static inline QWORD alignColumnOffset (QWORD qwOffset)
+{
+    return (qwOffset + g_dwColumnarAlignment - 1) & ~static_cast<QWORD>(g_dwColumnarAlignment - 1);
+}
+
+/// value 'i' of an integer column, widened
+static inline QWORD loadInteger (const void* pValues, DWORD dwType, size_t i)
+{
+    switch ( dwType )
+    {
+    case KENO_COLUMN_U8:    return static_cast<const BYTE*>(pValues)[i];
+    case KENO_COLUMN_U32:   return static_cast<const DWORD*>(pValues)[i];
+    default:                return static_cast<const QWORD*>(pValues)[i];
+    }
+}
+
+static inline void storeInteger (void* pValues, DWORD dwType, size_t i, QWORD qwValue)
+{
+    switch ( dwType )
+    {
+    case KENO_COLUMN_U8:    static_cast<BYTE*>(pValues)[i]  = static_cast<BYTE>(qwValue);   break;
+    case KENO_COLUMN_U32:   static_cast<DWORD*>(pValues)[i] = static_cast<DWORD>(qwValue);  break;
+    default:                static_cast<QWORD*>(pValues)[i] = qwValue;                      break;
+    }
+}
+
+
+KenoColumnarWriter::KenoColumnarWriter ( )
+    : m_pFile        (nullptr),
+      m_szPath       { 0 },
+      m_szTempPath   { 0 },
+      m_qwNumRows    (0),
+      m_qwOffset     (0),
+      m_qwColumnRows (0),
+      m_qwPrevious   (0),
+      m_bInColumn    (false),
+      m_bFailed      (false)
+{
+}
+
+KenoColumnarWriter::~KenoColumnarWriter ( )
+{
+    abandon ( );
+}
+
+bool KenoColumnarWriter::open (const TCHAR* szPath, QWORD qwNumRows)
+{
+    abandon ( );
+
+#ifdef _WIN32
+    const DWORD dwProcessId = ::GetCurrentProcessId ( );
+#else
+    const DWORD dwProcessId = static_cast<DWORD>(getpid ( ));
+#endif
+
+    _tcsncpy (m_szPath, szPath, _countof (m_szPath) - 1);
+    _sntprintf (m_szTempPath, _countof (m_szTempPath) - 1, _T ("%s.%u.tmp"), szPath, dwProcessId);
+
+    m_pFile = _tfopen (m_szTempPath, _T ("wb"));
+    if ( m_pFile == nullptr )
+        return false;
+
+    m_qwNumRows    = qwNumRows;
+    m_qwOffset     = 0;
+    m_qwColumnRows = 0;
+    m_bInColumn    = false;
+    m_bFailed      = false;
+
+    m_rgColumns.clear ( );
+    m_rgBuffer.clear ( );
+    m_rgBuffer.reserve (g_cbColumnarChunk + g_cbColumnarChunk / 2);
+
+    // the header is rewritten by close () once the schema is known
+    m_rgBuffer.resize (sizeof (KenoColumnarHeader), 0);
+
+    return true;
+}
+
+bool KenoColumnarWriter::beginColumn (const char* szName, KenoColumnType eType, KenoColumnCodec eCodec)
+{
+    if ( (m_pFile == nullptr) || !endColumn ( ) || (getColumnTypeSize (eType) == 0) )
+        return false;
+
+    // pads the previous column up to the alignment
+    const QWORD qwPosition = m_qwOffset + m_rgBuffer.size ( );
+
+    m_rgBuffer.resize (m_rgBuffer.size ( ) + static_cast<size_t>(alignColumnOffset (qwPosition) - qwPosition), 0);
+
+    KenoColumnDesc desc = { };
+
+    // a name of the full width is stored without its terminator
+    for ( size_t i = 0; (i < sizeof (desc.szName)) && (szName[i] != '\0'); i++ )
+        desc.szName[i] = szName[i];
+
+    desc.dwType   = eType;
+    desc.dwCodec  = (eType == KENO_COLUMN_F64) ? KENO_CODEC_NONE : eCodec;
+    desc.qwOffset = alignColumnOffset (qwPosition);
+
+    m_rgColumns.push_back (desc);
+
+    m_qwColumnRows = 0;
+    m_qwPrevious   = 0;
+    m_bInColumn    = true;
+
+    return true;
+}
+
+bool KenoColumnarWriter::append (const void* pValues, QWORD qwCount)
+{
+    if ( !m_bInColumn || m_bFailed || (m_qwColumnRows + qwCount > m_qwNumRows) )
+        return false;
+
+    KenoColumnDesc& desc   = m_rgColumns.back ( );
+    const size_t    cbType = getColumnTypeSize (desc.dwType);
+
+    m_qwColumnRows += qwCount;
+
+    // a chunk at a time, so the pending buffer never grows past its reservation
+    const size_t nPerChunk = g_cbColumnarChunk / g_cbMaxVarint;
+
+    for ( QWORD qwDone = 0; qwDone < qwCount; )
+    {
+        const size_t nValues = static_cast<size_t>(((qwCount - qwDone) < nPerChunk) ? (qwCount - qwDone) : nPerChunk);
+        const size_t cbStart = m_rgBuffer.size ( );
+
+        if ( desc.dwCodec == KENO_CODEC_NONE )
+        {
+            const BYTE*  pBytes  = static_cast<const BYTE*>(pValues) + qwDone * cbType;
+            const size_t cbBytes = nValues * cbType;
+
+            desc.dwCrc = calcCrc32c (pBytes, cbBytes, desc.dwCrc);
+            qwDone    += nValues;
+
+            // a large plain run goes to the file straight from the caller's memory
+            if ( cbBytes < g_cbColumnarChunk / 2 )
+            {
+                m_rgBuffer.insert (m_rgBuffer.end ( ), pBytes, pBytes + cbBytes);
+            }
+            else if ( !flush ( ) || (fwrite (pBytes, cbBytes, 1, m_pFile) != 1) )
+            {
+                m_bFailed = true;
+                return false;
+            }
+            else
+            {
+                m_qwOffset += cbBytes;
+            }
+        }
+        else
+        {
+            m_rgBuffer.resize (cbStart + nValues * g_cbMaxVarint);
+
+            BYTE* p = m_rgBuffer.data ( ) + cbStart;
+
+            for ( size_t i = 0; i < nValues; i++ )
+            {
+                const QWORD qwValue  = loadInteger (pValues, desc.dwType, static_cast<size_t>(qwDone + i));
+                const QWORD qwDelta  = qwValue - m_qwPrevious;
+                QWORD       qwZigzag = (qwDelta << 1) ^ static_cast<QWORD>(static_cast<long long>(qwDelta) >> 63);
+
+                while ( qwZigzag >= 0x80 )
+                {
+                    *p++       = static_cast<BYTE>(qwZigzag | 0x80);
+                    qwZigzag >>= 7;
+                }
+
+                *p++ = static_cast<BYTE>(qwZigzag);
+
+                m_qwPrevious = qwValue;
+            }
+
+            m_rgBuffer.resize (p - m_rgBuffer.data ( ));
+
+            desc.dwCrc = calcCrc32c (m_rgBuffer.data ( ) + cbStart, m_rgBuffer.size ( ) - cbStart, desc.dwCrc);
+            qwDone    += nValues;
+        }
+
+        if ( (m_rgBuffer.size ( ) >= g_cbColumnarChunk) && !flush ( ) )
+            return false;
+    }
+
+    return true;
+}
+
+bool KenoColumnarWriter::endColumn (void)
+{
+    if ( !m_bInColumn )
+        return true;
+
+    m_bInColumn = false;
+
+    KenoColumnDesc& desc = m_rgColumns.back ( );
+
+    desc.qwStoredSize = m_qwOffset + m_rgBuffer.size ( ) - desc.qwOffset;
+
+    return m_qwColumnRows == m_qwNumRows;
+}
+
+bool KenoColumnarWriter::flush (void)
+{
+    if ( !m_rgBuffer.empty ( ) && (fwrite (m_rgBuffer.data ( ), m_rgBuffer.size ( ), 1, m_pFile) != 1) )
+        m_bFailed = true;
+
+    m_qwOffset += m_rgBuffer.size ( );
+    m_rgBuffer.clear ( );
+
+    return !m_bFailed;
+}
+
+bool KenoColumnarWriter::close (void)
+{
+    if ( m_pFile == nullptr )
+        return false;
+
+    if ( !endColumn ( ) || m_bFailed )
+    {
+        abandon ( );
+        return false;
+    }
+
+    const QWORD  qwPosition = m_qwOffset + m_rgBuffer.size ( );
+    const size_t cbSchema   = m_rgColumns.size ( ) * sizeof (KenoColumnDesc);
+
+    KenoColumnarHeader header = { };
+
+    header.dwMagic        = g_dwColumnarMagic;
+    header.dwVersion      = g_dwColumnarVersion;
+    header.dwHeaderSize   = sizeof (KenoColumnarHeader);
+    header.dwAlignment    = g_dwColumnarAlignment;
+    header.qwNumRows      = m_qwNumRows;
+    header.dwNumColumns   = static_cast<DWORD>(m_rgColumns.size ( ));
+    header.dwDescSize     = sizeof (KenoColumnDesc);
+    header.qwSchemaOffset = alignColumnOffset (qwPosition);
+    header.qwFileSize     = header.qwSchemaOffset + cbSchema;
+    header.dwSchemaCrc    = calcCrc32c (m_rgColumns.data ( ), cbSchema);
+
+    m_rgBuffer.resize (m_rgBuffer.size ( ) + static_cast<size_t>(header.qwSchemaOffset - qwPosition), 0);
+    m_rgBuffer.insert (m_rgBuffer.end ( ), reinterpret_cast<const BYTE*>(m_rgColumns.data ( )),
+                       reinterpret_cast<const BYTE*>(m_rgColumns.data ( )) + cbSchema);
+
+    bool bResult = flush ( ) && (fseek (m_pFile, 0, SEEK_SET) == 0) &&
+                   (fwrite (&header, sizeof (header), 1, m_pFile) == 1);
+
+    bResult = (fclose (m_pFile) == 0) && bResult;
+    m_pFile = nullptr;
+
+    if ( bResult )
+    {
+#ifdef _WIN32
+        bResult = ::MoveFileEx (m_szTempPath, m_szPath, MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+        bResult = _trename (m_szTempPath, m_szPath) == 0;
+#endif
+    }
+
+    if ( !bResult )
+        _tremove (m_szTempPath);
+
+    return bResult;
+}
+
+void KenoColumnarWriter::abandon (void)
+{
+    if ( m_pFile != nullptr )
+    {
+        fclose (m_pFile);
+        m_pFile = nullptr;
+
+        _tremove (m_szTempPath);
+    }
+
+    m_rgBuffer.clear ( );
+    m_rgColumns.clear ( );
+    m_bInColumn = false;
+}
+
+bool writeColumnarTable (const TCHAR* szPath, const KenoExportTable& table, KenoColumnCodec eCodec)
+{
+    KenoColumnarWriter writer;
+
+    if ( !writer.open (szPath, table.qwNumRows) )
+        return false;
+
+    for ( const auto& column : table.rgColumns )
+    {
+        if ( !writer.beginColumn (column.szName, column.eType, eCodec) || !writer.append (column.pData, table.qwNumRows) )
+            return false;
+    }
+
+    return writer.close ( );
+}
+
+
+KenoColumnarFile::KenoColumnarFile ( )
+    : m_header { }
+{
+}
+
+bool KenoColumnarFile::open (const TCHAR* szPath)
+{
+    close ( );
+
+    if ( !m_file.open (szPath) || (m_file.getSize ( ) < sizeof (KenoColumnarHeader)) )
+    {
+        close ( );
+        return false;
+    }
+
+    const BYTE* pBytes = static_cast<const BYTE*>(m_file.getData ( ));
+    const QWORD qwSize = m_file.getSize ( );
+
+    memcpy (&m_header, pBytes, sizeof (m_header));
+
+    bool bValid = (m_header.dwMagic        == g_dwColumnarMagic)               &&
+                  (m_header.dwVersion      == g_dwColumnarVersion)             &&
+                  (m_header.dwHeaderSize   == sizeof (KenoColumnarHeader))     &&
+                  (m_header.dwAlignment    == g_dwColumnarAlignment)           &&
+                  (m_header.dwDescSize     == sizeof (KenoColumnDesc))         &&
+                  (m_header.qwFileSize     == qwSize)                          &&
+                  (m_header.qwSchemaOffset <= qwSize)                          &&
+                  (qwSize - m_header.qwSchemaOffset == m_header.dwNumColumns * static_cast<QWORD>(sizeof (KenoColumnDesc))) &&
+                  (calcCrc32c (pBytes + m_header.qwSchemaOffset, static_cast<size_t>(qwSize - m_header.qwSchemaOffset)) == m_header.dwSchemaCrc);
+
+    if ( bValid )
+    {
+        m_rgColumns.resize (m_header.dwNumColumns);
+        memcpy (m_rgColumns.data ( ), pBytes + m_header.qwSchemaOffset, m_rgColumns.size ( ) * sizeof (KenoColumnDesc));
+
+        for ( const auto& desc : m_rgColumns )
+        {
+            const QWORD qwPlainSize = m_header.qwNumRows * getColumnTypeSize (desc.dwType);
+
+            bValid = bValid && (getColumnTypeSize (desc.dwType) != 0)                           &&
+                     ((desc.dwCodec == KENO_CODEC_NONE) || (desc.dwCodec == KENO_CODEC_DELTA_VARINT)) &&
+                     ((desc.dwCodec == KENO_CODEC_NONE) || (desc.dwType != KENO_COLUMN_F64))     &&
+                     (desc.qwOffset == alignColumnOffset (desc.qwOffset))                        &&
+                     (desc.qwOffset >= sizeof (KenoColumnarHeader))                              &&
+                     (desc.qwOffset <= m_header.qwSchemaOffset)                                  &&
+                     (desc.qwStoredSize <= m_header.qwSchemaOffset - desc.qwOffset)              &&
+                     ((desc.dwCodec != KENO_CODEC_NONE) || (desc.qwStoredSize == qwPlainSize));
+        }
+    }
+
+    if ( !bValid )
+        close ( );
+
+    return bValid;
+}
+
+void KenoColumnarFile::close (void)
+{
+    m_file.close ( );
+    m_rgColumns.clear ( );
+
+    m_header = KenoColumnarHeader ( );
+}
+
+int KenoColumnarFile::findColumn (const char* szName) const
+{
+    for ( size_t i = 0; i < m_rgColumns.size ( ); i++ )
+    {
+        if ( strncmp (m_rgColumns[i].szName, szName, sizeof (m_rgColumns[i].szName)) == 0 )
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+const void* KenoColumnarFile::getColumnData (int nColumn) const
+{
+    const KenoColumnDesc& desc = m_rgColumns[nColumn];
+
+    if ( desc.dwCodec != KENO_CODEC_NONE )
+        return nullptr;
+
+    return static_cast<const BYTE*>(m_file.getData ( )) + desc.qwOffset;
+}
+
+bool KenoColumnarFile::readColumn (int nColumn, void* pValues) const
+{
+    const KenoColumnDesc& desc    = m_rgColumns[nColumn];
+    const BYTE*           pStored = static_cast<const BYTE*>(m_file.getData ( )) + desc.qwOffset;
+
+    if ( calcCrc32c (pStored, static_cast<size_t>(desc.qwStoredSize)) != desc.dwCrc )
+        return false;
+
+    if ( desc.dwCodec == KENO_CODEC_NONE )
+    {
+        memcpy (pValues, pStored, static_cast<size_t>(desc.qwStoredSize));
+        return true;
+    }
+
+    const BYTE* p       = pStored;
+    const BYTE* pEnd    = pStored + desc.qwStoredSize;
+    QWORD       qwValue = 0;
+
+    for ( QWORD r = 0; r < m_header.qwNumRows; r++ )
+    {
+        QWORD qwZigzag = 0;
+        DWORD dwShift  = 0;
+
+        for ( ;; )
+        {
+            if ( (p == pEnd) || (dwShift >= 64) )
+                return false;
+
+            const BYTE b = *p++;
+
+            qwZigzag |= static_cast<QWORD>(b & 0x7F) << dwShift;
+            dwShift  += 7;
+
+            if ( (b & 0x80) == 0 )
+                break;
+        }
+
+        qwValue += (qwZigzag >> 1) ^ (0 - (qwZigzag & 1));
+
+        storeInteger (pValues, desc.dwType, static_cast<size_t>(r), qwValue);
+    }
+
+    return p == pEnd;
+}
@@ -0,0 +1,177 @@
+/**
+@file       KenoColumnar.h
+@brief      Columnar binary export of KenoExportTable tables
+
+  A self-describing file that downstream tools can map and read a column at
+  a time, written at disk bandwidth.  Layout (little endian):
+
+      KenoColumnarHeader                      64 bytes at offset 0
+      column data                             each column starts on a
+                                              g_dwColumnarAlignment boundary
+      KenoColumnDesc [dwNumColumns]           the schema, after the data
+
+  An uncompressed column is the plain array of its values, so a reader of
+  a mapped file uses it in place.  An integer column may instead be stored
+  with KENO_CODEC_DELTA_VARINT: the difference to the previous value
+  (wrapping, 0 before the first), zigzag mapped and written as LEB128
+  varints, which shrinks histograms and sorted keys several times; double
+  columns are always stored plain.  Every stored column carries the CRC-32C
+  of its bytes (KenoCrc32.h).
+
+  The file is written to a temporary file that replaces the target when it
+  is complete, so a reader never sees a partial export.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_COLUMNAR_H__
+#define __KENO_COLUMNAR_H__
+
+#include <vector>
+#include "KenoExport.h"
+#include "KenoMappedFile.h"
+
+constexpr const DWORD  g_dwColumnarMagic     = 0x46434E4B;   //< 'KNCF'
+constexpr const DWORD  g_dwColumnarVersion   = 1;
+constexpr const DWORD  g_dwColumnarAlignment = 64;
+constexpr const size_t g_cchColumnName       = 32;
+constexpr const size_t g_cbColumnarChunk     = 4 << 20;      //< bytes per write
+
+enum KenoColumnCodec
+{
+    KENO_CODEC_NONE = 0,
+    KENO_CODEC_DELTA_VARINT
+};
+
+struct KenoColumnarHeader
+{
+    DWORD dwMagic;
+    DWORD dwVersion;
+    DWORD dwHeaderSize;             //< sizeof (KenoColumnarHeader)
+    DWORD dwAlignment;              //< of every column
+    QWORD qwNumRows;
+    DWORD dwNumColumns;
+    DWORD dwDescSize;               //< sizeof (KenoColumnDesc)
+    QWORD qwSchemaOffset;           //< of the KenoColumnDesc array
+    QWORD qwFileSize;
+    DWORD dwSchemaCrc;              //< CRC-32C of the KenoColumnDesc array
+    DWORD dwReserved;
+    QWORD qwReserved;
+};
+
+static_assert (sizeof (KenoColumnarHeader) == 64, "the columnar header is 64 bytes");
+
+struct KenoColumnDesc
+{
+    char  szName[g_cchColumnName];  //< zero padded, not necessarily terminated
+    DWORD dwType;                   //< KenoColumnType
+    DWORD dwCodec;                  //< KenoColumnCodec
+    QWORD qwOffset;                 //< of the stored column, aligned
+    QWORD qwStoredSize;             //< bytes stored
+    DWORD dwCrc;                    //< CRC-32C of the stored bytes
+    DWORD dwReserved;
+};
+
+static_assert (sizeof (KenoColumnDesc) == 64, "a columnar column descriptor is 64 bytes");
+
+/**
+  Writes a columnar file one column after the other.  A column is appended
+  in chunks of any size, so a histogram need not be held in memory whole.
+*/
+class KenoColumnarWriter
+{
+public:
+    KenoColumnarWriter  ( );
+    ~KenoColumnarWriter ( );                //< abandons an unfinished file
+
+    /**
+      @brief starts a file of 'qwNumRows' rows per column
+    */
+    bool open         (const TCHAR* szPath, QWORD qwNumRows);
+
+    /**
+      @brief starts the next column; 'eCodec' is ignored for double columns
+    */
+    bool beginColumn  (const char* szName, KenoColumnType eType, KenoColumnCodec eCodec);
+
+    /**
+      @brief appends 'qwCount' values of the type of the current column
+    */
+    bool append       (const void* pValues, QWORD qwCount);
+
+    /**
+      @brief completes the file and moves it into place
+
+      @retval bool      false if a column is short of rows or a write failed
+    */
+    bool close        (void);
+
+private:
+    bool endColumn    (void);
+    bool flush        (void);
+    void abandon      (void);
+
+    FILE*                         m_pFile;
+    TCHAR                         m_szPath[_MAX_PATH];
+    TCHAR                         m_szTempPath[_MAX_PATH];
+    QWORD                         m_qwNumRows;
+    QWORD                         m_qwOffset;          //< of the end of the written data
+    QWORD                         m_qwColumnRows;      //< rows appended to the current column
+    QWORD                         m_qwPrevious;        //< last value of a delta coded column
+    bool                          m_bInColumn;
+    bool                          m_bFailed;
+    std::vector<BYTE>             m_rgBuffer;          //< pending bytes, written in g_cbColumnarChunk chunks
+    std::vector<KenoColumnDesc>   m_rgColumns;
+};
+
+/**
+  @brief writeColumnarTable
+
+  Writes every column of 'table' with 'eCodec'.
+
+  @retval bool          true on success
+*/
+bool writeColumnarTable (const TCHAR* szPath, const KenoExportTable& table, KenoColumnCodec eCodec);
+
+/**
+  A mapped columnar file.
+*/
+class KenoColumnarFile
+{
+public:
+    KenoColumnarFile ( );
+
+    /**
+      @brief maps and validates the header and schema of 'szPath'
+    */
+    bool open  (const TCHAR* szPath);
+    void close (void);
+
+    bool                  isOpen        (void) const { return m_file.isOpen ( ); }
+    QWORD                 getFileSize   (void) const { return m_file.getSize ( ); }
+    QWORD                 getNumRows    (void) const { return m_header.qwNumRows; }
+    int                   getNumColumns (void) const { return static_cast<int>(m_rgColumns.size ( )); }
+    const KenoColumnDesc& getColumn     (int nColumn) const { return m_rgColumns[nColumn]; }
+
+    /// index of the column named 'szName', -1 if none
+    int         findColumn    (const char* szName) const;
+
+    /// the values of an uncompressed column in place, nullptr if it is coded
+    const void* getColumnData (int nColumn) const;
+
+    /**
+      @brief decodes a column into 'pValues', getNumRows values of its type,
+             after checking its CRC
+
+      @retval bool      false if the column is damaged
+    */
+    bool        readColumn    (int nColumn, void* pValues) const;
+
+private:
+    KenoMappedFile                m_file;
+    KenoColumnarHeader            m_header;
+    std::vector<KenoColumnDesc>   m_rgColumns;
+};
+
+#endif
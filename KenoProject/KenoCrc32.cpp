@@ -0,0 +1,128 @@
+/**
+@file       KenoCrc32.cpp
+@brief      Slicing-by-8 implementation of CRC-32C
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <string.h>
+#include "KenoProbability.h"
+#include "KenoCrc32.h"
+
+// the SSE 4.2 crc32 instruction computes CRC-32C, selected at run time
+#if defined(_M_X64) || defined(__x86_64__)
+    #define KENO_CRC32_HAS_SSE42  1
+    #include <nmmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define KENO_TARGET_SSE42
+    #else
+        #define KENO_TARGET_SSE42  __attribute__ ((target ("sse4.2")))
+    #endif
+#else
+    #define KENO_CRC32_HAS_SSE42  0
+#endif
+
+constexpr const DWORD g_dwCrc32cPolynomial = 0x82F63B78;   //< reflected Castagnoli polynomial
+
+/// rgTable[k][b] is the CRC of byte b followed by k zero bytes
+struct KenoCrc32Tables
+{
+    DWORD rgTable[8][256];
+
+    KenoCrc32Tables ( )
+    {
+        for ( DWORD b = 0; b < 256; b++ )
+        {
+            DWORD dwCrc = b;
+
+            for ( int k = 0; k < 8; k++ )
+                dwCrc = (dwCrc >> 1) ^ ((dwCrc & 1) ? g_dwCrc32cPolynomial : 0);
+
+            rgTable[0][b] = dwCrc;
+        }
+
+        for ( DWORD b = 0; b < 256; b++ )
+        {
+            for ( int k = 1; k < 8; k++ )
+                rgTable[k][b] = (rgTable[k - 1][b] >> 8) ^ rgTable[0][rgTable[k - 1][b] & 0xFF];
+        }
+    }
+};
+
+#if KENO_CRC32_HAS_SSE42
+
+static bool hasSse42 (void)
+{
+#ifdef _MSC_VER
+    int rgInfo[4] = { 0 };
+    __cpuid (rgInfo, 1);
+
+    return (rgInfo[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports ("sse4.2") != 0;
+#endif
+}
+
+KENO_TARGET_SSE42
+static DWORD calcCrc32cSse42 (const BYTE* p, size_t cbData, DWORD dwCrc)
+{
+    QWORD qwCrc = ~dwCrc;
+
+    for ( ; cbData >= 8; cbData -= 8, p += 8 )
+    {
+        QWORD qwValue;
+        memcpy (&qwValue, p, sizeof (qwValue));
+
+        qwCrc = _mm_crc32_u64 (qwCrc, qwValue);
+    }
+
+    DWORD dwValue = static_cast<DWORD>(qwCrc);
+
+    for ( ; cbData > 0; cbData--, p++ )
+        dwValue = _mm_crc32_u8 (dwValue, *p);
+
+    return ~dwValue;
+}
+
+#endif
+
+DWORD calcCrc32c (const void* pData, size_t cbData, DWORD dwCrc)
+{
+#if KENO_CRC32_HAS_SSE42
+    static const bool s_bSse42 = hasSse42 ( );
+
+    if ( s_bSse42 )
+        return calcCrc32cSse42 (static_cast<const BYTE*>(pData), cbData, dwCrc);
+#endif
+
+    // built once, on first use
+    static const KenoCrc32Tables s_tables;
+
+    const auto& T = s_tables.rgTable;
+    const BYTE* p = static_cast<const BYTE*>(pData);
+
+    dwCrc = ~dwCrc;
+
+    for ( ; cbData >= 8; cbData -= 8, p += 8 )
+    {
+        DWORD dwLo;
+        DWORD dwHi;
+
+        // little endian, as every platform the project builds for
+        memcpy (&dwLo, p,     sizeof (dwLo));
+        memcpy (&dwHi, p + 4, sizeof (dwHi));
+
+        dwLo ^= dwCrc;
+
+        dwCrc = T[7][dwLo & 0xFF] ^ T[6][(dwLo >> 8) & 0xFF] ^ T[5][(dwLo >> 16) & 0xFF] ^ T[4][dwLo >> 24] ^
+                T[3][dwHi & 0xFF] ^ T[2][(dwHi >> 8) & 0xFF] ^ T[1][(dwHi >> 16) & 0xFF] ^ T[0][dwHi >> 24];
+    }
+
+    for ( ; cbData > 0; cbData--, p++ )
+        dwCrc = (dwCrc >> 8) ^ T[0][(dwCrc ^ *p) & 0xFF];
+
+    return ~dwCrc;
+}
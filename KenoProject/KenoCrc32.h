@@ -0,0 +1,29 @@
+/**
+@file       KenoCrc32.h
+@brief      CRC-32C (Castagnoli) checksum of bulk data
+
+  Checks the integrity of the large binary files (columnar exports, ticket
+  journal), which the byte at a time FNV-1a hash of the small checkpoint
+  and cache headers could not keep up with.  x64 processors with SSE 4.2
+  compute it with the crc32 instruction, others by slicing-by-8, eight
+  bytes per table round.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_CRC32_H__
+#define __KENO_CRC32_H__
+
+/**
+  @brief calcCrc32c
+
+  @param [in] pData         bytes to checksum
+  @param [in] cbData        number of bytes
+  @param [in] dwCrc         CRC of the preceding bytes, 0 to start
+
+  @retval DWORD             CRC-32C of the preceding bytes followed by pData
+*/
+DWORD calcCrc32c (const void* pData, size_t cbData, DWORD dwCrc = 0);
+
+#endif
@@ -0,0 +1,114 @@
+/**
+@file       KenoDelimited.cpp
+@brief      Implementation of the CSV and TSV export
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <string.h>
+#include "KenoDelimited.h"
+#include "KenoFileIO.h"
+#include "KenoFormat.h"
+
+
+bool KenoDelimitedWriter::write (FILE* pFile, const KenoExportTable& table, KenoDelimitedFormat eFormat)
+{
+    const char   chSeparator = (eFormat == KENO_DELIMITED_TSV) ? '\t' : ',';
+    const size_t nColumns    = table.rgColumns.size ( );
+
+    if ( nColumns == 0 )
+        return true;
+
+    // room for a row: every value, its separator or newline and the terminator of the last one
+    const size_t cbMaxRow = nColumns * g_cchMaxFormattedDouble + 1;
+
+    size_t cbBuffer = (cbMaxRow > g_cbDelimitedChunk) ? cbMaxRow : g_cbDelimitedChunk;
+    size_t cbHeader = 0;
+
+    for ( const KenoExportColumn& column : table.rgColumns )
+        cbHeader += strlen (column.szName) + 1;
+
+    if ( cbHeader > cbBuffer )
+        cbBuffer = cbHeader;
+
+    m_rgBuffer.resize (cbBuffer);
+
+    char* const pStart = m_rgBuffer.data ( );
+    char* const pEnd   = pStart + m_rgBuffer.size ( );
+    char*       q      = pStart;
+
+    for ( const KenoExportColumn& column : table.rgColumns )
+    {
+        const size_t cchName = strlen (column.szName);
+
+        memcpy (q, column.szName, cchName);
+        q   += cchName;
+        *q++ = chSeparator;
+    }
+
+    q[-1] = '\n';
+
+    for ( QWORD r = 0; r < table.qwNumRows; r++ )
+    {
+        if ( static_cast<size_t>(pEnd - q) < cbMaxRow )
+        {
+            if ( !writeFileChunk (pFile, pStart, q - pStart) )
+                return false;
+
+            q = pStart;
+        }
+
+        for ( const KenoExportColumn& column : table.rgColumns )
+        {
+            switch ( column.eType )
+            {
+            case KENO_COLUMN_U8:
+                q += formatQword (static_cast<const BYTE*>(column.pData)[r], q);
+                break;
+            case KENO_COLUMN_U32:
+                q += formatQword (static_cast<const DWORD*>(column.pData)[r], q);
+                break;
+            case KENO_COLUMN_U64:
+                q += formatQword (static_cast<const QWORD*>(column.pData)[r], q);
+                break;
+            case KENO_COLUMN_F64:
+                q += formatDouble (static_cast<const double*>(column.pData)[r], q);
+                break;
+            }
+
+            *q++ = chSeparator;
+        }
+
+        q[-1] = '\n';
+    }
+
+    return (q == pStart) || writeFileChunk (pFile, pStart, q - pStart);
+}
+
+bool KenoDelimitedWriter::write (const TCHAR* szPath, const KenoExportTable& table, KenoDelimitedFormat eFormat)
+{
+    FILE* pFile = _tfopen (szPath, _T ("wb"));
+
+    if ( pFile == nullptr )
+        return false;
+
+    const bool bWritten = write (pFile, table, eFormat);
+    const bool bClosed  = (fclose (pFile) == 0);
+
+    if ( !bWritten || !bClosed )
+    {
+        _tremove (szPath);
+        return false;
+    }
+
+    return true;
+}
+
+bool writeDelimitedTable (const TCHAR* szPath, const KenoExportTable& table, KenoDelimitedFormat eFormat)
+{
+    KenoDelimitedWriter writer;
+
+    return writer.write (szPath, table, eFormat);
+}
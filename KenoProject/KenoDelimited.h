@@ -0,0 +1,68 @@
+/**
+@file       KenoDelimited.h
+@brief      CSV and TSV export of KenoExportTable tables
+
+  The text form of an export table for consumers that only read plain
+  text: a header line of the column names, then one line per row, fields
+  separated by ',' (CSV) or a tab (TSV) and lines ended by '\n' on every
+  platform.  Integers are written in decimal and doubles in the canonical
+  shortest round trip formatting of KenoFormat.h, so the same table is
+  byte-identical wherever it is written.  Column names are identifiers and
+  values never contain a separator, so no field is quoted.
+
+  Rows are formatted straight into a g_cbDelimitedChunk buffer that is
+  kept for the next table, and every full buffer leaves in a single write.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_DELIMITED_H__
+#define __KENO_DELIMITED_H__
+
+#include <vector>
+#include "KenoExport.h"
+
+constexpr const size_t g_cbDelimitedChunk = 4 << 20;    //< bytes per write
+
+enum KenoDelimitedFormat
+{
+    KENO_DELIMITED_CSV = 0,
+    KENO_DELIMITED_TSV
+};
+
+/**
+  Writes tables as CSV or TSV, reusing its buffer from table to table.
+*/
+class KenoDelimitedWriter
+{
+public:
+    /**
+      @brief writes 'table' to 'pFile', which must be in binary mode; the
+             stream buffer is bypassed
+
+      @retval bool      false on a write error
+    */
+    bool write (FILE* pFile, const KenoExportTable& table, KenoDelimitedFormat eFormat);
+
+    /**
+      @brief writes 'table' to a new file 'szPath'
+
+      @retval bool      false if the file cannot be written; it is removed
+    */
+    bool write (const TCHAR* szPath, const KenoExportTable& table, KenoDelimitedFormat eFormat);
+
+private:
+    std::vector<char> m_rgBuffer;
+};
+
+/**
+  @brief writeDelimitedTable
+
+  Writes 'table' to 'szPath' as CSV or TSV.
+
+  @retval bool          true on success
+*/
+bool writeDelimitedTable (const TCHAR* szPath, const KenoExportTable& table, KenoDelimitedFormat eFormat);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+@file       KenoExport.cpp
+@brief      Implementation of the export table builders
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include "KenoExport.h"
+
+
+bool makeExportPath (const TCHAR* szDirectory, const TCHAR* szFileName, TCHAR* szPath, size_t cchPath)
+{
+#ifdef _WIN32
+    const TCHAR chSeparator = _T('\\');
+#else
+    const TCHAR chSeparator = _T('/');
+#endif
+
+    const size_t nLen     = _tcslen (szDirectory);
+    const TCHAR  szSep[2] = { ((nLen > 0) && (szDirectory[nLen - 1] != chSeparator)) ? chSeparator : _T('\0'), _T('\0') };
+
+    const int nWritten = _sntprintf (szPath, cchPath, _T ("%s%s%s"), szDirectory, szSep, szFileName);
+
+    return (nWritten > 0) && (static_cast<size_t>(nWritten) < cchPath);
+}
+
+void buildProbabilityExport (KenoExportTable& table)
+{
+    table = KenoExportTable ( );
+    table.qwNumRows = g_MAX_ROWS * (g_MAX_ROWS + 3) / 2;    // catch 0 .. spots for spots 1 .. g_MAX_ROWS
+
+    BYTE*   rgSpots       = table.addColumn<BYTE>   ("spots",       KENO_COLUMN_U8);
+    BYTE*   rgCatch       = table.addColumn<BYTE>   ("catch",       KENO_COLUMN_U8);
+    double* rgProbability = table.addColumn<double> ("probability", KENO_COLUMN_F64);
+
+    size_t r = 0;
+
+    for ( DWORD s = 1; s <= g_MAX_ROWS; s++ )
+    {
+        for ( DWORD c = 0; c <= s; c++, r++ )
+        {
+            rgSpots[r]       = static_cast<BYTE>(s);
+            rgCatch[r]       = static_cast<BYTE>(c);
+            rgProbability[r] = g_rgProbability[s - 1][c];
+        }
+    }
+}
+
+void buildExpectedValueExport (KenoExportTable& table)
+{
+    table = KenoExportTable ( );
+    table.qwNumRows = g_MAX_SPOTS_MARKED;
+
+    BYTE*   rgSpots         = table.addColumn<BYTE>   ("spots",          KENO_COLUMN_U8);
+    double* rgExpectedValue = table.addColumn<double> ("expected_value", KENO_COLUMN_F64);
+
+    for ( DWORD s = 1; s <= g_MAX_SPOTS_MARKED; s++ )
+    {
+        rgSpots[s - 1]         = static_cast<BYTE>(s);
+        rgExpectedValue[s - 1] = g_rgExpectedValue[s - 1];
+    }
+}
+
+void buildAdaptiveExport (const KenoAdaptiveScenario* rgScenarios, const KenoAdaptiveState* rgStates,
+                          int nScenarios, KenoExportTable& table)
+{
+    table = KenoExportTable ( );
+    table.qwNumRows = static_cast<QWORD>(nScenarios) * g_MAX_COLS;
+
+    DWORD* rgScenario = table.addColumn<DWORD> ("scenario",  KENO_COLUMN_U32);
+    DWORD* rgPayTable = table.addColumn<DWORD> ("pay_table", KENO_COLUMN_U32);
+    BYTE*  rgSpots    = table.addColumn<BYTE>  ("spots",     KENO_COLUMN_U8);
+    BYTE*  rgTarget   = table.addColumn<BYTE>  ("target",    KENO_COLUMN_U8);
+    BYTE*  rgCatch    = table.addColumn<BYTE>  ("catch",     KENO_COLUMN_U8);
+    QWORD* rgCount    = table.addColumn<QWORD> ("count",     KENO_COLUMN_U64);
+
+    size_t r = 0;
+
+    for ( int i = 0; i < nScenarios; i++ )
+    {
+        const KenoAdaptiveScenario& scenario = rgScenarios[i];
+
+        for ( DWORD c = 0; c < g_MAX_COLS; c++, r++ )
+        {
+            rgScenario[r] = static_cast<DWORD>(i);
+            rgPayTable[r] = static_cast<DWORD>(scenario.pPayTable - g_rgPayTableCatalog);
+            rgSpots[r]    = static_cast<BYTE>(scenario.dwNumMarked);
+            rgTarget[r]   = static_cast<BYTE>(scenario.eTarget);
+            rgCatch[r]    = static_cast<BYTE>(c);
+            rgCount[r]    = rgStates[i].rgCatchCount[c];
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/**
+@file       KenoExport.h
+@brief      Tables of the probability and simulation outputs, as columns
+
+  Every exporter other than the Excel workbook writes a KenoExportTable: a
+  row count and a list of named, typed columns, each a contiguous array.
+  The builders below turn the probability matrix, the expected value
+  vector and the simulation histograms into such tables.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_EXPORT_H__
+#define __KENO_EXPORT_H__
+
+#include <vector>
+#include "KenoAdaptive.h"
+
+enum KenoColumnType
+{
+    KENO_COLUMN_U8 = 1,
+    KENO_COLUMN_U32,
+    KENO_COLUMN_U64,
+    KENO_COLUMN_F64
+};
+
+/// bytes per value of a KenoColumnType, 0 if unknown
+inline size_t getColumnTypeSize (DWORD dwType)
+{
+    switch ( dwType )
+    {
+    case KENO_COLUMN_U8:    return sizeof (BYTE);
+    case KENO_COLUMN_U32:   return sizeof (DWORD);
+    case KENO_COLUMN_U64:   return sizeof (QWORD);
+    case KENO_COLUMN_F64:   return sizeof (double);
+    default:                return 0;
+    }
+}
+
+struct KenoExportColumn
+{
+    const char*     szName;
+    KenoColumnType  eType;
+    const void*     pData;          //< qwNumRows values of eType
+};
+
+struct KenoExportTable
+{
+    QWORD                           qwNumRows;
+    std::vector<KenoExportColumn>   rgColumns;
+    std::vector<std::vector<BYTE>>  rgStorage;      //< the columns built by the table builders
+
+    KenoExportTable ( ) : qwNumRows (0) { }
+
+    /// adds a column of qwNumRows values owned by the table
+    template <typename T>
+    T* addColumn (const char* szName, KenoColumnType eType)
+    {
+        rgStorage.emplace_back (static_cast<size_t>(qwNumRows * sizeof (T)));
+        rgColumns.push_back ({ szName, eType, rgStorage.back ( ).data ( ) });
+
+        return reinterpret_cast<T*>(rgStorage.back ( ).data ( ));
+    }
+};
+
+/**
+  @brief joins 'szDirectory' ("" for the working directory) and 'szFileName'
+
+  @retval bool                  false if the path does not fit in 'cchPath'
+*/
+bool makeExportPath (const TCHAR* szDirectory, const TCHAR* szFileName, TCHAR* szPath, size_t cchPath);
+
+/**
+  @brief every (spots, catch) cell of g_rgProbability with catch <= spots,
+         columns spots, catch, probability
+*/
+void buildProbabilityExport   (KenoExportTable& table);
+
+/**
+  @brief g_rgExpectedValue, columns spots, expected_value
+*/
+void buildExpectedValueExport (KenoExportTable& table);
+
+/**
+  @brief the catch histograms of adaptive simulation scenarios, one row per
+         (scenario, catch), columns scenario, pay_table (index into
+         g_rgPayTableCatalog), spots, target, catch, count
+*/
+void buildAdaptiveExport      (const KenoAdaptiveScenario* rgScenarios, const KenoAdaptiveState* rgStates,
+                               int nScenarios, KenoExportTable& table);
+
+#endif
@@ -0,0 +1,62 @@
+/**
+@file       KenoFileIO.cpp
+@brief      Implementation of the unbuffered chunk reads and writes
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include "KenoFileIO.h"
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <errno.h>
+    #include <unistd.h>
+#endif
+
+/// reads what is available, so answers are not held back on a pipe
+bool readFileChunk (FILE* pFile, void* pBuffer, size_t cb, size_t& cbRead)
+{
+#ifdef _WIN32
+    const int iRead = _read (_fileno (pFile), pBuffer, static_cast<unsigned int>(cb));
+#else
+    ssize_t iRead;
+
+    do
+    {
+        iRead = ::read (fileno (pFile), pBuffer, cb);
+    } while ( (iRead < 0) && (errno == EINTR) );
+#endif
+
+    cbRead = (iRead > 0) ? static_cast<size_t>(iRead) : 0;
+
+    return iRead >= 0;
+}
+
+/// one write per chunk, repeated only when the pipe takes less
+bool writeFileChunk (FILE* pFile, const void* pBuffer, size_t cb)
+{
+    const BYTE* p = static_cast<const BYTE*>(pBuffer);
+
+    while ( cb > 0 )
+    {
+#ifdef _WIN32
+        const int iWritten = _write (_fileno (pFile), p, static_cast<unsigned int>(cb));
+#else
+        const ssize_t iWritten = ::write (fileno (pFile), p, cb);
+
+        if ( (iWritten < 0) && (errno == EINTR) )
+            continue;
+#endif
+
+        if ( iWritten <= 0 )
+            return false;
+
+        p  += iWritten;
+        cb -= iWritten;
+    }
+
+    return true;
+}
@@ -0,0 +1,38 @@
+/**
+@file       KenoFileIO.h
+@brief      Unbuffered chunk reads and writes on the descriptor of a stream
+
+  The batch queries and the delimited exporter move their data in large
+  chunks of their own, so they read and write the file descriptor of the
+  stream directly rather than copying through the stream buffer.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_FILE_IO_H__
+#define __KENO_FILE_IO_H__
+
+/**
+  @brief readFileChunk
+
+  Reads what the file descriptor of 'pFile' has available, up to 'cb'
+  bytes, bypassing the stream buffer.
+
+  @param [out] cbRead       bytes read, 0 at the end of the input
+
+  @retval bool              false on a read error
+*/
+bool readFileChunk  (FILE* pFile, void* pBuffer, size_t cb, size_t& cbRead);
+
+/**
+  @brief writeFileChunk
+
+  Writes 'cb' bytes on the file descriptor of 'pFile' in a single write,
+  repeated only when the descriptor takes less, bypassing the stream buffer.
+
+  @retval bool              false on a write error
+*/
+bool writeFileChunk (FILE* pFile, const void* pBuffer, size_t cb);
+
+#endif
@@ -0,0 +1,154 @@
+/**
+@file       KenoFormat.cpp
+@brief      Implementation of the canonical number formatting
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <cmath>
+#include <stdlib.h>
+#include <string.h>
+#include "KenoFormat.h"
+
+constexpr const int g_nMaxSignificantDigits = 17;   //< always enough for a double to round trip
+constexpr const int g_nMinFixedExponent     = -5;
+constexpr const int g_nMaxFixedExponent     = 16;
+
+
+size_t formatQword (QWORD qwValue, char* szBuffer)
+{
+    char   szDigits[g_cchMaxFormattedQword];
+    size_t cchDigits = 0;
+
+    do
+    {
+        szDigits[cchDigits++] = static_cast<char>('0' + qwValue % 10);
+        qwValue /= 10;
+    } while ( qwValue != 0 );
+
+    for ( size_t i = 0; i < cchDigits; i++ )
+        szBuffer[i] = szDigits[cchDigits - 1 - i];
+
+    szBuffer[cchDigits] = '\0';
+
+    return cchDigits;
+}
+
+size_t formatDouble (double fValue, char* szBuffer)
+{
+    char* p = szBuffer;
+
+    if ( std::isnan (fValue) )
+    {
+        strcpy (szBuffer, "nan");
+        return 3;
+    }
+
+    if ( std::signbit (fValue) )
+        *p++ = '-';
+
+    if ( std::isinf (fValue) )
+    {
+        strcpy (p, "inf");
+        return (p - szBuffer) + 3;
+    }
+
+    if ( fValue == 0.0 )
+    {
+        strcpy (p, "0");
+        return (p - szBuffer) + 1;
+    }
+
+    // pay outs and histogram counts are integers, which need no search
+    if ( (std::fabs (fValue) < 1e16) && (std::floor (fValue) == fValue) )
+    {
+        return (p - szBuffer) + formatQword (static_cast<QWORD>(std::fabs (fValue)), p);
+    }
+
+    // round tripping is monotonic in the precision, so the shortest is found by bisection
+    char szScientific[g_cchMaxFormattedDouble];
+    int  nLow  = 1;
+    int  nHigh = g_nMaxSignificantDigits;
+
+    while ( nLow < nHigh )
+    {
+        const int nDigits = (nLow + nHigh) / 2;
+
+        snprintf (szScientific, sizeof (szScientific), "%.*e", nDigits - 1, std::fabs (fValue));
+
+        if ( strtod (szScientific, nullptr) == std::fabs (fValue) )
+            nHigh = nDigits;
+        else
+            nLow  = nDigits + 1;
+    }
+
+    snprintf (szScientific, sizeof (szScientific), "%.*e", nLow - 1, std::fabs (fValue));
+
+    // "d.ddde[+-]xx" into the significant digits and the decimal exponent
+    char        szDigits[g_nMaxSignificantDigits + 1];
+    int         nDigits = 0;
+    const char* s       = szScientific;
+
+    for ( ; *s != 'e'; s++ )
+    {
+        if ( *s != '.' )
+            szDigits[nDigits++] = *s;
+    }
+
+    const int nExponent = atoi (s + 1);
+
+    while ( (nDigits > 1) && (szDigits[nDigits - 1] == '0') )
+        nDigits--;
+
+    if ( (nExponent < g_nMinFixedExponent) || (nExponent > g_nMaxFixedExponent) )
+    {
+        *p++ = szDigits[0];
+
+        if ( nDigits > 1 )
+        {
+            *p++ = '.';
+            memcpy (p, szDigits + 1, nDigits - 1);
+            p += nDigits - 1;
+        }
+
+        const int nMagnitude = (nExponent < 0) ? -nExponent : nExponent;
+
+        *p++ = 'e';
+        *p++ = (nExponent < 0) ? '-' : '+';
+
+        if ( nMagnitude >= 100 )
+            *p++ = static_cast<char>('0' + nMagnitude / 100);
+
+        *p++ = static_cast<char>('0' + (nMagnitude / 10) % 10);
+        *p++ = static_cast<char>('0' + nMagnitude % 10);
+    }
+    else if ( nExponent < 0 )
+    {
+        *p++ = '0';
+        *p++ = '.';
+
+        for ( int i = -1; i > nExponent; i-- )
+            *p++ = '0';
+
+        memcpy (p, szDigits, nDigits);
+        p += nDigits;
+    }
+    else
+    {
+        for ( int i = 0; i <= nExponent; i++ )
+            *p++ = (i < nDigits) ? szDigits[i] : '0';
+
+        if ( nDigits > nExponent + 1 )
+        {
+            *p++ = '.';
+            memcpy (p, szDigits + nExponent + 1, nDigits - nExponent - 1);
+            p += nDigits - nExponent - 1;
+        }
+    }
+
+    *p = '\0';
+
+    return p - szBuffer;
+}
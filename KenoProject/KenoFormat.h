@@ -0,0 +1,49 @@
+/**
+@file       KenoFormat.h
+@brief      Canonical number formatting for text outputs
+
+  Numbers written by the text outputs must parse back to the same double
+  and must be byte-identical across C runtimes, which disagree on exponent
+  digits and on the spelling of infinities and NaN.  formatDouble therefore
+  only takes the shortest round trip digits from the runtime and lays them
+  out itself:
+
+      fixed notation        for decimal exponents -5 .. 16, e.g. 0.0123, 2500
+      scientific notation   otherwise, e.g. 1.5e-20, 4e+17
+      nan, inf, -inf
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_FORMAT_H__
+#define __KENO_FORMAT_H__
+
+#include "KenoProbability.h"
+
+constexpr const size_t g_cchMaxFormattedDouble = 32;   //< longest formatDouble output, with the terminator
+constexpr const size_t g_cchMaxFormattedQword  = 21;   //< longest formatQword output, with the terminator
+
+/**
+  @brief formatDouble
+
+  Writes the shortest decimal string that reads back as 'fValue'.
+
+  @param [in]  fValue       value to format
+  @param [out] szBuffer     receives the string, at least g_cchMaxFormattedDouble chars
+
+  @retval size_t            length of the string, without the terminator
+*/
+size_t formatDouble (double fValue, char* szBuffer);
+
+/**
+  @brief formatQword
+
+  @param [in]  qwValue      value to format
+  @param [out] szBuffer     receives the decimal digits, at least g_cchMaxFormattedQword chars
+
+  @retval size_t            number of digits, without the terminator
+*/
+size_t formatQword  (QWORD qwValue, char* szBuffer);
+
+#endif
@@ -0,0 +1,238 @@
+/**
+@file       KenoIngest.cpp
+@brief      Implementation of the ticket ingestion queue
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <stdlib.h>
+#include <new>
+#include <thread>
+#include "KenoIngest.h"
+
+static_assert (sizeof (KenoIngestQueue) % g_cbIngestCacheLine == 0, "the producer slots fill whole cache lines");
+
+void* KenoIngestQueue::operator new (size_t cbSize)
+{
+#ifdef _WIN32
+    void* pMemory = _aligned_malloc (cbSize, alignof (KenoIngestQueue));
+#else
+    void* pMemory = nullptr;
+    if ( posix_memalign (&pMemory, alignof (KenoIngestQueue), cbSize) != 0 )
+        pMemory = nullptr;
+#endif
+
+    if ( pMemory == nullptr )
+        throw std::bad_alloc ( );
+
+    return pMemory;
+}
+
+void KenoIngestQueue::operator delete (void* pMemory) noexcept
+{
+#ifdef _WIN32
+    _aligned_free (pMemory);
+#else
+    free (pMemory);
+#endif
+}
+
+KenoIngestQueue::KenoIngestQueue (size_t nCapacity)
+    : m_nMask     (0),
+      m_qwTail    (0),
+      m_qwHead    (0),
+      m_qwRefused (0)
+{
+    size_t nSize = 2;
+
+    while ( nSize < nCapacity )
+        nSize <<= 1;
+
+    m_rgCells.reset (new KenoIngestCell[nSize]);
+    m_nMask = nSize - 1;
+
+    // every cell starts free for the first lap
+    for ( size_t i = 0; i < nSize; i++ )
+        m_rgCells[i].qwSequence.store (i, std::memory_order_relaxed);
+
+    for ( int p = 0; p < g_MAX_INGEST_PRODUCERS; p++ )
+    {
+        m_rgProducers[p].qwTickets.store   (0, std::memory_order_relaxed);
+        m_rgProducers[p].qwBatches.store   (0, std::memory_order_relaxed);
+        m_rgProducers[p].qwFull.store      (0, std::memory_order_relaxed);
+        m_rgProducers[p].qwContended.store (0, std::memory_order_relaxed);
+        m_rgProducers[p].bInUse.store      (false, std::memory_order_relaxed);
+    }
+}
+
+KenoIngestQueue::~KenoIngestQueue ( )
+{
+}
+
+int KenoIngestQueue::registerProducer (void)
+{
+    for ( int p = 0; p < g_MAX_INGEST_PRODUCERS; p++ )
+    {
+        bool bExpected = false;
+
+        if ( m_rgProducers[p].bInUse.compare_exchange_strong (bExpected, true) )
+        {
+            m_rgProducers[p].qwTickets.store   (0, std::memory_order_relaxed);
+            m_rgProducers[p].qwBatches.store   (0, std::memory_order_relaxed);
+            m_rgProducers[p].qwFull.store      (0, std::memory_order_relaxed);
+            m_rgProducers[p].qwContended.store (0, std::memory_order_relaxed);
+            return p;
+        }
+    }
+
+    return -1;
+}
+
+void KenoIngestQueue::unregisterProducer (int nProducer)
+{
+    m_rgProducers[nProducer].bInUse.store (false, std::memory_order_release);
+}
+
+size_t KenoIngestQueue::tryPush (int nProducer, const KenoTicketRecord* rgRecords, size_t nRecords)
+{
+    KenoProducerSlot& slot    = m_rgProducers[nProducer];
+    QWORD             qwPos   = m_qwTail.load (std::memory_order_relaxed);
+    QWORD             qwLost  = 0;
+    size_t            nPushed = 0;
+
+    while ( nPushed < nRecords )
+    {
+        size_t nClaim = nRecords - nPushed;
+
+        if ( nClaim > g_nMaxIngestClaim )
+            nClaim = g_nMaxIngestClaim;
+
+        // the last cell of the claim must be free for this lap; halve the
+        // claim while the consumer has not freed it yet
+        while ( nClaim > 0 )
+        {
+            const QWORD     qwLast = qwPos + nClaim - 1;
+            const long long iDiff  = static_cast<long long>(m_rgCells[qwLast & m_nMask].qwSequence.load (std::memory_order_acquire) - qwLast);
+
+            if ( iDiff == 0 )
+                break;
+
+            if ( iDiff > 0 )
+            {
+                // claimed by another producer since qwPos was read
+                qwPos = m_qwTail.load (std::memory_order_relaxed);
+                qwLost++;
+                continue;
+            }
+
+            nClaim >>= 1;
+        }
+
+        if ( nClaim == 0 )
+        {
+            addStat (slot.qwFull, 1);
+            break;
+        }
+
+        // on failure qwPos receives the current tail
+        if ( !m_qwTail.compare_exchange_weak (qwPos, qwPos + nClaim, std::memory_order_relaxed) )
+        {
+            qwLost++;
+            continue;
+        }
+
+        for ( size_t i = 0; i < nClaim; i++ )
+        {
+            KenoIngestCell& cell = m_rgCells[(qwPos + i) & m_nMask];
+
+            cell.record = rgRecords[nPushed + i];
+            cell.qwSequence.store (qwPos + i + 1, std::memory_order_release);
+        }
+
+        addStat (slot.qwBatches, 1);
+
+        nPushed += nClaim;
+        qwPos   += nClaim;
+    }
+
+    addStat (slot.qwTickets,   nPushed);
+    addStat (slot.qwContended, qwLost);
+
+    return nPushed;
+}
+
+void KenoIngestQueue::push (int nProducer, const KenoTicketRecord* rgRecords, size_t nRecords)
+{
+    size_t nPushed = tryPush (nProducer, rgRecords, nRecords);
+
+    while ( nPushed < nRecords )
+    {
+        std::this_thread::yield ( );
+        nPushed += tryPush (nProducer, rgRecords + nPushed, nRecords - nPushed);
+    }
+}
+
+size_t KenoIngestQueue::pop (KenoTicketRecord* rgRecords, size_t nMaxRecords)
+{
+    QWORD  qwHead   = m_qwHead.load (std::memory_order_relaxed);
+    size_t nRecords = 0;
+
+    while ( nRecords < nMaxRecords )
+    {
+        KenoIngestCell& cell = m_rgCells[qwHead & m_nMask];
+
+        if ( cell.qwSequence.load (std::memory_order_acquire) != qwHead + 1 )
+            break;
+
+        rgRecords[nRecords++] = cell.record;
+
+        // free for the next lap
+        cell.qwSequence.store (qwHead + m_nMask + 1, std::memory_order_release);
+        qwHead++;
+    }
+
+    m_qwHead.store (qwHead, std::memory_order_relaxed);
+
+    return nRecords;
+}
+
+size_t KenoIngestQueue::drain (KenoTicketStore& store, size_t nMaxRecords)
+{
+    QWORD  qwHead   = m_qwHead.load (std::memory_order_relaxed);
+    QWORD  qwBad    = 0;
+    size_t nRecords = 0;
+
+    while ( nRecords < nMaxRecords )
+    {
+        KenoIngestCell& cell = m_rgCells[qwHead & m_nMask];
+
+        if ( cell.qwSequence.load (std::memory_order_acquire) != qwHead + 1 )
+            break;
+
+        if ( !store.add (toKenoTicket (cell.record)) )
+            qwBad++;
+
+        cell.qwSequence.store (qwHead + m_nMask + 1, std::memory_order_release);
+        qwHead++;
+        nRecords++;
+    }
+
+    m_qwHead.store (qwHead, std::memory_order_relaxed);
+
+    if ( qwBad != 0 )
+        addStat (m_qwRefused, qwBad);
+
+    return nRecords;
+}
+
+void KenoIngestQueue::getProducerStats (int nProducer, KenoIngestStats& stats) const
+{
+    const KenoProducerSlot& slot = m_rgProducers[nProducer];
+
+    stats.qwTickets   = slot.qwTickets.load   (std::memory_order_relaxed);
+    stats.qwBatches   = slot.qwBatches.load   (std::memory_order_relaxed);
+    stats.qwFull      = slot.qwFull.load      (std::memory_order_relaxed);
+    stats.qwContended = slot.qwContended.load (std::memory_order_relaxed);
+}
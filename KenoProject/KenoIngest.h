@@ -0,0 +1,154 @@
+/**
+@file       KenoIngest.h
+@brief      Lock-free ticket ingestion queue of the sales window
+
+  Terminal connections push tickets from any number of threads while a
+  single consumer moves them into the structure of arrays settlement store.
+  The queue is a bounded ring of KenoTicketRecord cells, each with a
+  sequence number (D. Vyukov's bounded queue):
+
+    - a cell at ring position 'p' is free for position 'p' when its
+      sequence is 'p', and holds the ticket of 'p' when it is 'p + 1';
+    - a producer claims a whole batch of 'n' cells with one compare and swap
+      of the tail, once the last cell of the batch is free; the consumer
+      frees cells in order, so every cell before it is free too;
+    - the producer fills its cells and publishes each one with a release
+      store of its sequence; the consumer reads the cells in order and
+      frees each one for the next lap of the ring.
+
+  Claiming a batch per compare and swap keeps the shared tail off the
+  critical path: with 64 ticket batches, 16 producers touch it once per 64
+  tickets each.  The tail, the head and every producer's statistics live on
+  separate cache lines; the queue allocates itself 64 byte aligned, so this
+  holds for a queue on the heap too.
+
+  A full ring is back-pressure: tryPush accepts what fits and returns,
+  push waits for the consumer, and both count the event in the producer's
+  statistics so a slow consumer is visible per connection.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_INGEST_H__
+#define __KENO_INGEST_H__
+
+#include <atomic>
+#include <memory>
+#include "KenoSettlement.h"
+#include "KenoTicketWire.h"
+
+constexpr const int    g_MAX_INGEST_PRODUCERS   = 64;       //< concurrent producer threads of a queue
+constexpr const size_t g_nDefaultIngestCapacity = 1 << 16;  //< tickets
+constexpr const size_t g_nMaxIngestClaim        = 64;       //< cells claimed per compare and swap
+constexpr const size_t g_cbIngestCacheLine      = 64;
+
+/// what a producer has pushed, read without stopping it
+struct KenoIngestStats
+{
+    QWORD qwTickets;            //< tickets accepted
+    QWORD qwBatches;            //< successful claims
+    QWORD qwFull;               //< claims refused because the ring was full
+    QWORD qwContended;          //< claims lost to another producer
+};
+
+class alignas (g_cbIngestCacheLine) KenoIngestQueue
+{
+public:
+    /**
+      @param [in] nCapacity     tickets the ring holds, rounded up to a power of 2
+    */
+    explicit KenoIngestQueue (size_t nCapacity = g_nDefaultIngestCapacity);
+    ~KenoIngestQueue ( );
+
+    // operator new need not honour alignas before C++17
+    static void* operator new    (size_t cbSize);
+    static void  operator delete (void* pMemory) noexcept;
+
+    /**
+      @brief claims a producer slot for the calling thread
+
+      @retval int           slot index, or -1 if all g_MAX_INGEST_PRODUCERS are taken
+    */
+    int    registerProducer   (void);
+    void   unregisterProducer (int nProducer);
+
+    /**
+      @brief tryPush
+
+      Appends as many of the tickets as the ring has room for, in order.
+
+      @param [in] nProducer     slot of the calling thread
+      @param [in] rgRecords     tickets to append
+      @param [in] nRecords      number of tickets
+
+      @retval size_t            tickets accepted; fewer than nRecords if the
+                                ring filled up
+    */
+    size_t tryPush (int nProducer, const KenoTicketRecord* rgRecords, size_t nRecords);
+
+    /**
+      @brief appends every ticket, yielding while the ring is full
+    */
+    void   push    (int nProducer, const KenoTicketRecord* rgRecords, size_t nRecords);
+
+    /**
+      @brief pop
+
+      Removes up to nMaxRecords tickets in ring order; consumer thread only.
+
+      @retval size_t            tickets removed, 0 if the ring is empty
+    */
+    size_t pop     (KenoTicketRecord* rgRecords, size_t nMaxRecords);
+
+    /**
+      @brief drain
+
+      Moves up to nMaxRecords tickets into 'store'; consumer thread only.
+      Tickets the settlement store refuses (more than g_MAX_SPOTS_MARKED
+      spots) are dropped and counted.
+
+      @retval size_t            tickets removed from the ring
+    */
+    size_t drain   (KenoTicketStore& store, size_t nMaxRecords);
+
+    void   getProducerStats (int nProducer, KenoIngestStats& stats) const;
+
+    size_t getCapacity    (void) const { return m_nMask + 1; }
+    QWORD  getNumConsumed (void) const { return m_qwHead.load (std::memory_order_relaxed); }
+    QWORD  getNumRefused  (void) const { return m_qwRefused.load (std::memory_order_relaxed); }
+
+private:
+    struct KenoIngestCell
+    {
+        std::atomic<QWORD> qwSequence;
+        KenoTicketRecord   record;
+    };
+
+    /// one cache line per producer; only its producer writes it
+    struct alignas (g_cbIngestCacheLine) KenoProducerSlot
+    {
+        std::atomic<QWORD> qwTickets;
+        std::atomic<QWORD> qwBatches;
+        std::atomic<QWORD> qwFull;
+        std::atomic<QWORD> qwContended;
+        std::atomic<bool>  bInUse;
+    };
+
+    KenoIngestQueue (const KenoIngestQueue&) = delete;
+    KenoIngestQueue& operator= (const KenoIngestQueue&) = delete;
+
+    static void addStat (std::atomic<QWORD>& qwStat, QWORD qwValue)
+    {
+        qwStat.store (qwStat.load (std::memory_order_relaxed) + qwValue, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<KenoIngestCell[]>                    m_rgCells;
+    size_t                                               m_nMask;
+    alignas (g_cbIngestCacheLine) std::atomic<QWORD>     m_qwTail;         //< next position claimed by a producer
+    alignas (g_cbIngestCacheLine) std::atomic<QWORD>     m_qwHead;         //< next position read by the consumer
+    std::atomic<QWORD>                                   m_qwRefused;
+    KenoProducerSlot                                     m_rgProducers[g_MAX_INGEST_PRODUCERS];
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+@file       KenoJackpot.cpp
+@brief      Implementation of the progressive jackpot liability simulator
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "KenoJackpot.h"
+#include "KenoSimulator.h"
+
+
+/// The progressive jackpots currently offered
+const KenoJackpotScenario g_rgJackpotScenarios[] =
+{
+//    name                      M  C   tickets/day  std dev  draws/day wager  rate   seed     years runs
+    { _T("9 Spot, 9 Catch"),    9, 9,   40000.0,    8000.0,  288,      1.0,   0.05,  25000.0, 10,   200 },
+    { _T("8 Spot, 8 Catch"),    8, 8,   40000.0,    8000.0,  288,      1.0,   0.05,  20000.0, 10,   200 },
+    { _T("9 Spot, 9 Catch x2"), 9, 9,   80000.0,   16000.0,  288,      1.0,   0.05,  25000.0, 10,   200 },
+    { _T("9 Spot, 9 Catch 2%"), 9, 9,   40000.0,    8000.0,  288,      1.0,   0.02,  25000.0, 10,   200 },
+};
+
+const int g_nJackpotScenarioCount = _countof (g_rgJackpotScenarios);
+
+
+/// 53 random bits mapped onto (0, 1]
+static inline double uniformOpen (KenoRng& rng)
+{
+    return (static_cast<double>(rng.next ( ) >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+}
+
+/// standard normal deviate (Box-Muller)
+static inline double normalDeviate (KenoRng& rng)
+{
+    return std::sqrt (-2.0 * std::log (uniformOpen (rng))) * std::cos (6.283185307179586 * uniformOpen (rng));
+}
+
+/**
+  @brief samples the number of losing tickets before the next jackpot catch
+
+  @param [in] fLogMiss      log (1 - p)
+*/
+static inline double sampleTicketsToHit (KenoRng& rng, double fLogMiss)
+{
+    return std::floor (std::log (uniformOpen (rng)) / fLogMiss);
+}
+
+static double percentile (std::vector<double>& rgValues, double fQuantile)
+{
+    if ( rgValues.empty ( ) )
+        return 0.0;
+
+    const size_t nIndex = static_cast<size_t>(fQuantile * (rgValues.size ( ) - 1));
+
+    std::nth_element (rgValues.begin ( ), rgValues.begin ( ) + nIndex, rgValues.end ( ));
+    return rgValues[nIndex];
+}
+
+void simulateJackpot (const KenoJackpotScenario& scenario, QWORD qwSeed, KenoJackpotResult& result)
+{
+    const double fHitProbability = g_rgProbability[scenario.dwNumMarked - 1][scenario.dwCatch];
+    const double fLogMiss        = std::log1p (-fHitProbability);
+    const double fContribution   = scenario.fWager * scenario.fContributionRate;
+    const DWORD  dwNumDays       = scenario.dwYears * g_DAYS_PER_YEAR;
+
+    KenoRng rng;
+    rng.seed (qwSeed);
+
+    std::vector<double> rgJackpotAtHit;
+    std::vector<double> rgDaysToHit;
+
+    double fTotalPaid    = 0.0;
+    double fTotalWagered = 0.0;
+    double fTotalOpen    = 0.0;
+    QWORD  qwNumWinners  = 0;
+
+    for ( DWORD r = 0; r < scenario.dwNumRuns; r++ )
+    {
+        double fJackpot      = scenario.fSeedValue;
+        double fTicketsToHit = sampleTicketsToHit (rng, fLogMiss);
+        double fResetTime    = 0.0;             // in days
+
+        for ( DWORD d = 0; d < dwNumDays; d++ )
+        {
+            const double fVolume = scenario.fTicketsPerDay + scenario.fTicketsPerDayStdDev * normalDeviate (rng);
+            const double fTicketsPerDraw = std::floor ((fVolume > 0.0 ? fVolume : 0.0) / scenario.dwDrawsPerDay);
+
+            fTotalWagered += fTicketsPerDraw * scenario.dwDrawsPerDay * scenario.fWager;
+
+            double fDrawsLeft = scenario.dwDrawsPerDay;
+
+            // skip straight to the draw holding the next jackpot ticket
+            while ( (fTicketsPerDraw > 0.0) && (fTicketsToHit < fDrawsLeft * fTicketsPerDraw) )
+            {
+                const double fDrawsSkipped = std::floor (fTicketsToHit / fTicketsPerDraw);
+
+                // every other ticket of the winning draw may catch the jackpot as well
+                const double fTicketsBefore = fTicketsToHit - fDrawsSkipped * fTicketsPerDraw;
+                double       fTicketsAfter  = fTicketsPerDraw - fTicketsBefore - 1.0;
+                DWORD        dwWinners      = 1;
+
+                for ( ;; )
+                {
+                    const double fNextHit = sampleTicketsToHit (rng, fLogMiss);
+                    if ( fNextHit >= fTicketsAfter )
+                    {
+                        fTicketsToHit = fNextHit - fTicketsAfter;
+                        break;
+                    }
+                    fTicketsAfter -= fNextHit + 1.0;
+                    dwWinners++;
+                }
+
+                fJackpot += (fDrawsSkipped + 1.0) * fTicketsPerDraw * fContribution;
+
+                const double fHitTime = d + (scenario.dwDrawsPerDay - fDrawsLeft + fDrawsSkipped) / scenario.dwDrawsPerDay;
+
+                rgJackpotAtHit.push_back (fJackpot);
+                rgDaysToHit.push_back (fHitTime - fResetTime);
+
+                // the winners split the jackpot, which is then reset to its seed
+                qwNumWinners += dwWinners;
+                fTotalPaid   += fJackpot;
+                fJackpot      = scenario.fSeedValue;
+                fResetTime    = fHitTime;
+                fDrawsLeft   -= fDrawsSkipped + 1.0;
+            }
+
+            fTicketsToHit -= fDrawsLeft * fTicketsPerDraw;
+            fJackpot      += fDrawsLeft * fTicketsPerDraw * fContribution;
+        }
+
+        fTotalOpen += fJackpot;
+    }
+
+    double fSumJackpot = 0.0;
+    double fMaxJackpot = 0.0;
+    double fSumDays    = 0.0;
+
+    for ( double fValue : rgJackpotAtHit )
+    {
+        fSumJackpot += fValue;
+        fMaxJackpot  = (fValue > fMaxJackpot) ? fValue : fMaxJackpot;
+    }
+
+    for ( double fValue : rgDaysToHit )
+        fSumDays += fValue;
+
+    const double fNumHits = static_cast<double>(rgJackpotAtHit.size ( ));
+
+    result.qwNumHits          = rgJackpotAtHit.size ( );
+    result.qwNumWinners       = qwNumWinners;
+    result.fMeanJackpot       = (fNumHits > 0.0) ? fSumJackpot / fNumHits : 0.0;
+    result.fJackpotP50        = percentile (rgJackpotAtHit, 0.50);
+    result.fJackpotP99        = percentile (rgJackpotAtHit, 0.99);
+    result.fMaxJackpot        = fMaxJackpot;
+    result.fMeanDaysToHit     = (fNumHits > 0.0) ? fSumDays / fNumHits : 0.0;
+    result.fDaysToHitP50      = percentile (rgDaysToHit, 0.50);
+    result.fDaysToHitP99      = percentile (rgDaysToHit, 0.99);
+    result.fMeanOpenLiability = fTotalOpen / scenario.dwNumRuns;
+    result.fPaidPerWager      = (fTotalWagered > 0.0) ? fTotalPaid / fTotalWagered : 0.0;
+}
+
+void simulateJackpotScenarios (const KenoJackpotScenario* rgScenarios, int nScenarios, QWORD qwSeed,
+                               std::vector<KenoJackpotResult>& rgResults)
+{
+    rgResults.assign (nScenarios, KenoJackpotResult ( ));
+
+    // derive every scenario's stream up front so results do not depend on scheduling
+    std::vector<QWORD> rgSeeds (nScenarios);
+    for ( auto& qwScenarioSeed : rgSeeds )
+        qwScenarioSeed = splitMix64 (qwSeed);
+
+    std::atomic<int> iNextScenario (0);
+
+    auto worker = [&] ( )
+    {
+        for ( int s = iNextScenario++; s < nScenarios; s = iNextScenario++ )
+            simulateJackpot (rgScenarios[s], rgSeeds[s], rgResults[s]);
+    };
+
+    DWORD dwNumThreads = getWorkerThreadCount ( );
+    if ( dwNumThreads > static_cast<DWORD>(nScenarios) )
+        dwNumThreads = nScenarios;
+
+    std::vector<std::thread> rgThreads;
+
+    for ( DWORD t = 0; t < dwNumThreads; t++ )
+        rgThreads.emplace_back (worker);
+
+    for ( auto& thread : rgThreads )
+        thread.join ( );
+}
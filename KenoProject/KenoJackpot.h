@@ -0,0 +1,86 @@
+/**
+@file       KenoJackpot.h
+@brief      Progressive jackpot liability simulator declarations
+
+  A progressive prize starts at a seed value and grows by a share of every
+  wager on the jackpot ticket until the jackpot tier is caught, after which
+  it is paid (split among the winners of the draw) and reset.
+
+  Rather than drawing balls for every ticket, the simulator samples the
+  number of tickets until the next jackpot catch directly from the geometric
+  distribution with p = KP(M, C), so a year of draws costs a handful of
+  random numbers per hit.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_JACKPOT_H__
+#define __KENO_JACKPOT_H__
+
+#include <vector>
+#include "KenoProbability.h"
+
+constexpr const int g_DAYS_PER_YEAR = 365;
+
+struct KenoJackpotScenario
+{
+    const TCHAR* szName;
+    DWORD        dwNumMarked;           //< spots marked on the jackpot ticket
+    DWORD        dwCatch;               //< catch size that wins the jackpot
+    double       fTicketsPerDay;        //< mean daily ticket volume
+    double       fTicketsPerDayStdDev;  //< standard deviation of the daily ticket volume
+    DWORD        dwDrawsPerDay;         //< games per day
+    double       fWager;                //< wager per ticket
+    double       fContributionRate;     //< share of every wager added to the jackpot
+    double       fSeedValue;            //< jackpot value after a reset
+    DWORD        dwYears;               //< simulated horizon of one run
+    DWORD        dwNumRuns;             //< independent runs of the horizon
+};
+
+struct KenoJackpotResult
+{
+    QWORD  qwNumHits;               //< jackpot draws over all runs
+    QWORD  qwNumWinners;            //< winning tickets over all runs
+    double fMeanJackpot;            //< mean jackpot value when hit
+    double fJackpotP50;             //< median jackpot value when hit
+    double fJackpotP99;             //< 99th percentile jackpot value when hit
+    double fMaxJackpot;             //< largest jackpot value when hit
+    double fMeanDaysToHit;          //< mean days between resets
+    double fDaysToHitP50;
+    double fDaysToHitP99;
+    double fMeanOpenLiability;      //< mean jackpot value still open at the end of a run
+    double fPaidPerWager;           //< jackpot pay out per $1 wagered on the jackpot ticket
+};
+
+extern const KenoJackpotScenario g_rgJackpotScenarios[];
+extern const int                 g_nJackpotScenarioCount;
+
+/**
+  @brief simulateJackpot
+
+  Runs 'scenario.dwNumRuns' independent histories of 'scenario.dwYears' years.
+
+  @note buildProbabilityTable must have been called beforehand
+
+  @param [in]  scenario     the scenario to simulate
+  @param [in]  qwSeed       seed of the scenario's random number stream
+  @param [out] result       receives the jackpot statistics
+*/
+void simulateJackpot (const KenoJackpotScenario& scenario, QWORD qwSeed, KenoJackpotResult& result);
+
+/**
+  @brief simulateJackpotScenarios
+
+  Simulates every scenario, spreading the scenarios across all hardware
+  threads.  Results do not depend on the number of threads.
+
+  @param [in]  rgScenarios  scenarios to simulate
+  @param [in]  nScenarios   number of scenarios
+  @param [in]  qwSeed       base seed, scenario 's' uses a stream derived from it
+  @param [out] rgResults    receives 'nScenarios' results
+*/
+void simulateJackpotScenarios (const KenoJackpotScenario* rgScenarios, int nScenarios, QWORD qwSeed,
+                               std::vector<KenoJackpotResult>& rgResults);
+
+#endif
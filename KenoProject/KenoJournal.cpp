@@ -0,0 +1,494 @@
+/**
+@file       KenoJournal.cpp
+@brief      Implementation of the ticket journal
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <string.h>
+#include "KenoCrc32.h"
+#include "KenoExport.h"
+#include "KenoJournal.h"
+#include "KenoMappedFile.h"
+
+#ifdef _WIN32
+    static const KenoFileHandle g_hNoSegment = INVALID_HANDLE_VALUE;
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+
+    static const KenoFileHandle g_hNoSegment = -1;
+#endif
+
+
+bool getJournalSegmentPath (const TCHAR* szDirectory, QWORD qwSegment, TCHAR* szPath, size_t cchPath)
+{
+    TCHAR szFileName[32] = { 0 };
+
+    _sntprintf (szFileName, _countof (szFileName) - 1, _T ("KenoJournal_%08llu.kjn"), qwSegment);
+
+    return makeExportPath (szDirectory, szFileName, szPath, cchPath);
+}
+
+/**
+  @brief true if 'szPath' exists, also when it is empty and cannot be mapped
+*/
+static bool fileExists (const TCHAR* szPath)
+{
+    FILE* pFile = _tfopen (szPath, _T ("rb"));
+
+    if ( pFile == nullptr )
+        return false;
+
+    fclose (pFile);
+    return true;
+}
+
+/**
+  @brief the segment number of a file name written by getJournalSegmentPath
+
+  @retval bool          false if 'szName' is not the name of a segment
+*/
+static bool parseJournalSegmentName (const TCHAR* szName, QWORD& qwSegment)
+{
+    const TCHAR  szPrefix[] = _T ("KenoJournal_");
+    const size_t cchPrefix  = _countof (szPrefix) - 1;
+
+    if ( _tcsncmp (szName, szPrefix, cchPrefix) != 0 )
+        return false;
+
+    const TCHAR* pDigits = szName + cchPrefix;
+    TCHAR*       pEnd    = nullptr;
+
+    if ( (*pDigits < _T('0')) || (*pDigits > _T('9')) )
+        return false;
+
+    qwSegment = _tcstoui64 (pDigits, &pEnd, 10);
+
+    return _tcscmp (pEnd, _T (".kjn")) == 0;
+}
+
+/**
+  @brief finds the highest numbered segment file in 'szDirectory'
+
+  @retval bool          false if the directory holds no segment
+*/
+static bool findLastJournalSegment (const TCHAR* szDirectory, QWORD& qwLast)
+{
+    bool  bFound    = false;
+    QWORD qwSegment = 0;
+
+    qwLast = 0;
+
+#ifdef _WIN32
+    TCHAR           szPattern[_MAX_PATH] = { 0 };
+    WIN32_FIND_DATA findData;
+
+    if ( !makeExportPath (szDirectory, _T ("KenoJournal_*.kjn"), szPattern, _countof (szPattern)) )
+        return false;
+
+    HANDLE hFind = ::FindFirstFile (szPattern, &findData);
+    if ( hFind == INVALID_HANDLE_VALUE )
+        return false;
+
+    do
+    {
+        if ( parseJournalSegmentName (findData.cFileName, qwSegment) )
+        {
+            qwLast = (!bFound || (qwSegment > qwLast)) ? qwSegment : qwLast;
+            bFound = true;
+        }
+    } while ( ::FindNextFile (hFind, &findData) );
+
+    ::FindClose (hFind);
+#else
+    DIR* pDirectory = opendir ((szDirectory[0] != _T('\0')) ? szDirectory : ".");
+    if ( pDirectory == nullptr )
+        return false;
+
+    for ( const dirent* pEntry = readdir (pDirectory); pEntry != nullptr; pEntry = readdir (pDirectory) )
+    {
+        if ( parseJournalSegmentName (pEntry->d_name, qwSegment) )
+        {
+            qwLast = (!bFound || (qwSegment > qwLast)) ? qwSegment : qwLast;
+            bFound = true;
+        }
+    }
+
+    closedir (pDirectory);
+#endif
+
+    return bFound;
+}
+
+static DWORD calcSegmentHeaderCrc (const KenoJournalSegmentHeader& header)
+{
+    KenoJournalSegmentHeader copy = header;
+
+    copy.dwHeaderCrc = 0;
+    return calcCrc32c (&copy, sizeof (copy));
+}
+
+static DWORD calcBatchCrc (const KenoJournalBatchHeader& header, const KenoTicketRecord* rgRecords)
+{
+    KenoJournalBatchHeader copy = header;
+
+    copy.dwCrc = 0;
+    return calcCrc32c (rgRecords, header.dwNumRecords * sizeof (KenoTicketRecord), calcCrc32c (&copy, sizeof (copy)));
+}
+
+bool replayJournal (const TCHAR* szDirectory, KenoTicketStore& store, KenoJournalReplay& replay)
+{
+    TCHAR szPath[_MAX_PATH] = { 0 };
+    QWORD cbJournal         = 0;
+
+    memset (&replay, 0, sizeof (replay));
+
+    // size the store once rather than growing it a segment at a time
+    for ( QWORD q = 0; getJournalSegmentPath (szDirectory, q, szPath, _countof (szPath)) && fileExists (szPath); q++ )
+    {
+        KenoMappedFile file;
+
+        if ( file.open (szPath) )
+            cbJournal += file.getSize ( );
+    }
+
+    store.reserve (store.size ( ) + static_cast<size_t>(cbJournal / sizeof (KenoTicketRecord)));
+
+    for ( QWORD q = 0; getJournalSegmentPath (szDirectory, q, szPath, _countof (szPath)) && fileExists (szPath); q++ )
+    {
+        KenoMappedFile file;
+
+        replay.qwSegments++;
+
+        if ( !file.open (szPath) || (file.getSize ( ) < sizeof (KenoJournalSegmentHeader)) )
+        {
+            // a crash while the segment was created
+            replay.qwTornTails++;
+            continue;
+        }
+
+        const BYTE*              pBytes = static_cast<const BYTE*>(file.getData ( ));
+        const size_t             cbFile = file.getSize ( );
+        KenoJournalSegmentHeader header;
+
+        memcpy (&header, pBytes, sizeof (header));
+
+        if ( (header.dwMagic != g_dwJournalMagic) || (header.dwVersion != g_dwJournalVersion) ||
+             (header.dwHeaderSize != sizeof (KenoJournalSegmentHeader)) ||
+             (header.dwRecordSize != sizeof (KenoTicketRecord)) || (header.qwSegment != q) ||
+             (header.dwHeaderCrc != calcSegmentHeaderCrc (header)) )
+            return false;
+
+        // batches acknowledged to a terminal were lost
+        if ( header.qwFirstBatch != replay.qwNextBatch )
+            return false;
+
+        size_t cbOffset = sizeof (header);
+
+        while ( cbOffset + sizeof (KenoJournalBatchHeader) <= cbFile )
+        {
+            KenoJournalBatchHeader batch;
+
+            memcpy (&batch, pBytes + cbOffset, sizeof (batch));
+
+            const size_t nRoom = (cbFile - cbOffset - sizeof (batch)) / sizeof (KenoTicketRecord);
+
+            if ( (batch.dwMagic != g_dwJournalBatchMagic) || (batch.qwBatch != replay.qwNextBatch) ||
+                 (batch.dwNumRecords > nRoom) )
+                break;
+
+            // batches and records are 8 byte aligned in the segment
+            const KenoTicketRecord* rgRecords = reinterpret_cast<const KenoTicketRecord*>(pBytes + cbOffset + sizeof (batch));
+
+            if ( batch.dwCrc != calcBatchCrc (batch, rgRecords) )
+                break;
+
+            for ( DWORD i = 0; i < batch.dwNumRecords; i++ )
+            {
+                if ( store.add (toKenoTicket (rgRecords[i])) )
+                    replay.qwRecords++;
+                else
+                    replay.qwRefused++;
+            }
+
+            const size_t cbBatch = sizeof (batch) + batch.dwNumRecords * sizeof (KenoTicketRecord);
+
+            cbOffset           += cbBatch;
+            replay.qwBytes     += cbBatch;
+            replay.qwBatches++;
+            replay.qwNextBatch++;
+        }
+
+        if ( cbOffset != cbFile )
+            replay.qwTornTails++;
+    }
+
+    // segments are numbered without gaps, so any segment after the first
+    // missing one means a segment was lost
+    QWORD qwLast = 0;
+
+    return !findLastJournalSegment (szDirectory, qwLast) || (qwLast < replay.qwSegments);
+}
+
+KenoJournalWriter::KenoJournalWriter ( )
+    : m_cbSegment      (g_cbDefaultJournalSegment),
+      m_hSegment       (g_hNoSegment),
+      m_qwSegment      (0),
+      m_cbWritten      (0),
+      m_qwNextBatch    (0),
+      m_qwDurableBatch (0),
+      m_qwFirstBatch   (0),
+      m_qwNumRecords   (0),
+      m_bOpen          (false),
+      m_bCommitting    (false),
+      m_bFailed        (false)
+{
+    m_szDirectory[0] = _T('\0');
+}
+
+KenoJournalWriter::~KenoJournalWriter ( )
+{
+    close ( );
+}
+
+bool KenoJournalWriter::open (const TCHAR* szDirectory, QWORD qwNextBatch, QWORD cbSegment)
+{
+    close ( );
+
+    TCHAR szPath[_MAX_PATH] = { 0 };
+
+    _tcsncpy (m_szDirectory, szDirectory, _countof (m_szDirectory) - 1);
+    m_szDirectory[_countof (m_szDirectory) - 1] = _T('\0');
+
+    // never append to a segment a crash may have cut short
+    m_qwSegment = 0;
+
+    while ( getJournalSegmentPath (m_szDirectory, m_qwSegment, szPath, _countof (szPath)) && fileExists (szPath) )
+        m_qwSegment++;
+
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    m_cbSegment      = cbSegment;
+    m_qwNextBatch    = qwNextBatch;
+    m_qwDurableBatch = qwNextBatch;
+    m_qwFirstBatch   = qwNextBatch;
+    m_qwNumRecords   = 0;
+    m_bFailed        = false;
+    m_bCommitting    = false;
+    m_bOpen          = startSegment (qwNextBatch);
+
+    return m_bOpen;
+}
+
+void KenoJournalWriter::close (void)
+{
+    std::unique_lock<std::mutex> lock (m_lock);
+
+    m_cvDurable.wait (lock, [this] ( ) { return !m_bCommitting; });
+
+    closeSegment ( );
+    m_rgPending.clear ( );
+    m_bOpen = false;
+}
+
+bool KenoJournalWriter::append (const KenoTicketRecord* rgRecords, size_t nRecords)
+{
+    std::unique_lock<std::mutex> lock (m_lock);
+
+    if ( !m_bOpen || m_bFailed )
+        return false;
+
+    if ( nRecords == 0 )
+        return true;
+
+    m_rgPending.insert (m_rgPending.end ( ), rgRecords, rgRecords + nRecords);
+
+    const QWORD qwBatch = m_qwNextBatch;
+
+    while ( (m_qwDurableBatch <= qwBatch) && !m_bFailed )
+    {
+        if ( m_bCommitting )
+        {
+            m_cvDurable.wait (lock);
+            continue;
+        }
+
+        // the disk is idle: write everything queued so far as one batch,
+        // while later callers queue behind it
+        m_bCommitting = true;
+        m_rgCommit.swap (m_rgPending);
+
+        const QWORD qwCommit = m_qwNextBatch++;
+
+        lock.unlock ( );
+        const bool bWritten = writeBatch (qwCommit, m_rgCommit);
+        lock.lock ( );
+
+        if ( bWritten )
+        {
+            m_qwDurableBatch = qwCommit + 1;
+            m_qwNumRecords  += m_rgCommit.size ( );
+        }
+        else
+        {
+            m_bFailed = true;
+        }
+
+        m_rgCommit.clear ( );
+        m_bCommitting = false;
+        m_cvDurable.notify_all ( );
+    }
+
+    return m_qwDurableBatch > qwBatch;
+}
+
+QWORD KenoJournalWriter::getNumBatches (void) const
+{
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    return m_qwDurableBatch - m_qwFirstBatch;
+}
+
+QWORD KenoJournalWriter::getNumRecords (void) const
+{
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    return m_qwNumRecords;
+}
+
+bool KenoJournalWriter::writeBatch (QWORD qwBatch, const std::vector<KenoTicketRecord>& rgRecords)
+{
+    const size_t cbRecords = rgRecords.size ( ) * sizeof (KenoTicketRecord);
+    const size_t cbBatch   = sizeof (KenoJournalBatchHeader) + cbRecords;
+
+    if ( (m_cbWritten > sizeof (KenoJournalSegmentHeader)) && (m_cbWritten + cbBatch > m_cbSegment) )
+    {
+        closeSegment ( );
+        m_qwSegment++;
+
+        if ( !startSegment (qwBatch) )
+            return false;
+    }
+
+    KenoJournalBatchHeader header = { };
+
+    header.dwMagic      = g_dwJournalBatchMagic;
+    header.dwNumRecords = static_cast<DWORD>(rgRecords.size ( ));
+    header.qwBatch      = qwBatch;
+    header.dwCrc        = calcBatchCrc (header, rgRecords.data ( ));
+
+    // one write per batch, so a crash tears at most the last batch
+    m_rgBuffer.resize (cbBatch);
+    memcpy (m_rgBuffer.data ( ), &header, sizeof (header));
+    memcpy (m_rgBuffer.data ( ) + sizeof (header), rgRecords.data ( ), cbRecords);
+
+    if ( !writeAll (m_rgBuffer.data ( ), cbBatch) || !sync ( ) )
+        return false;
+
+    m_cbWritten += cbBatch;
+
+    return true;
+}
+
+bool KenoJournalWriter::startSegment (QWORD qwFirstBatch)
+{
+    TCHAR szPath[_MAX_PATH] = { 0 };
+
+    if ( !getJournalSegmentPath (m_szDirectory, m_qwSegment, szPath, _countof (szPath)) )
+        return false;
+
+#ifdef _WIN32
+    m_hSegment = ::CreateFile (szPath, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+    m_hSegment = ::open (szPath, O_WRONLY | O_CREAT | O_EXCL, 0644);
+#endif
+
+    if ( m_hSegment == g_hNoSegment )
+        return false;
+
+    KenoJournalSegmentHeader header = { };
+
+    header.dwMagic      = g_dwJournalMagic;
+    header.dwVersion    = g_dwJournalVersion;
+    header.dwHeaderSize = sizeof (KenoJournalSegmentHeader);
+    header.dwRecordSize = sizeof (KenoTicketRecord);
+    header.qwSegment    = m_qwSegment;
+    header.qwFirstBatch = qwFirstBatch;
+    header.dwHeaderCrc  = calcSegmentHeaderCrc (header);
+
+    if ( !writeAll (&header, sizeof (header)) || !sync ( ) )
+    {
+        closeSegment ( );
+        return false;
+    }
+
+#ifndef _WIN32
+    // the new directory entry must survive a crash too; NTFS journals its
+    // metadata, so Windows needs no counterpart
+    const int iDirectory = ::open ((m_szDirectory[0] != _T('\0')) ? m_szDirectory : ".", O_RDONLY);
+
+    if ( iDirectory >= 0 )
+    {
+        fsync (iDirectory);
+        ::close (iDirectory);
+    }
+#endif
+
+    m_cbWritten = sizeof (header);
+
+    return true;
+}
+
+bool KenoJournalWriter::writeAll (const void* pData, size_t cbData)
+{
+    const BYTE* pBytes = static_cast<const BYTE*>(pData);
+
+    while ( cbData > 0 )
+    {
+#ifdef _WIN32
+        const DWORD cbChunk   = (cbData > 0x40000000) ? 0x40000000 : static_cast<DWORD>(cbData);
+        DWORD       cbWritten = 0;
+
+        if ( !::WriteFile (m_hSegment, pBytes, cbChunk, &cbWritten, nullptr) || (cbWritten == 0) )
+            return false;
+#else
+        const ssize_t cbWritten = ::write (m_hSegment, pBytes, cbData);
+
+        if ( cbWritten <= 0 )
+            return false;
+#endif
+
+        pBytes += cbWritten;
+        cbData -= static_cast<size_t>(cbWritten);
+    }
+
+    return true;
+}
+
+bool KenoJournalWriter::sync (void)
+{
+#ifdef _WIN32
+    return ::FlushFileBuffers (m_hSegment) != FALSE;
+#else
+    return fdatasync (m_hSegment) == 0;
+#endif
+}
+
+void KenoJournalWriter::closeSegment (void)
+{
+    if ( m_hSegment != g_hNoSegment )
+    {
+#ifdef _WIN32
+        ::CloseHandle (m_hSegment);
+#else
+        ::close (m_hSegment);
+#endif
+    }
+
+    m_hSegment  = g_hNoSegment;
+    m_cbWritten = 0;
+}
@@ -0,0 +1,181 @@
+/**
+@file       KenoJournal.h
+@brief      Append-only journal of the accepted tickets
+
+  A ticket is accepted once it is in the journal on disk, so the settlement
+  store of a node that crashed during the sales window is rebuilt from the
+  journal before the draw.  The journal is a directory of segment files,
+  KenoJournal_00000000.kjn, KenoJournal_00000001.kjn .. , each at most about
+  'cbSegment' bytes (little endian):
+
+      KenoJournalSegmentHeader                64 bytes at offset 0
+      batch                                   KenoJournalBatchHeader followed
+      batch                                   by dwNumRecords KenoTicketRecords
+      ..
+
+  Batches are numbered 0, 1, 2 .. across the whole journal and carry the
+  CRC-32C (KenoCrc32.h) of their header and records.
+
+  Group commit: append() queues its tickets behind the batch being written;
+  the first caller to find the disk idle writes everything queued so far as
+  one batch and syncs it, and every caller returns once the batch holding
+  its tickets is durable.  A busy sales window thus pays one sync per batch
+  rather than per ticket, and a lone terminal still waits for one sync only.
+
+  Replay maps the segments read-only and walks their batches in place.  A
+  crash may leave a partial batch at the end of a segment; the writer that
+  resumes the journal starts a new segment with the next batch number, so
+  replay skips a damaged tail as long as no numbered batch is missing.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_JOURNAL_H__
+#define __KENO_JOURNAL_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "KenoSettlement.h"
+#include "KenoTicketWire.h"
+
+constexpr const DWORD g_dwJournalMagic          = 0x4C4A4E4B;   //< 'KNJL'
+constexpr const DWORD g_dwJournalBatchMagic     = 0x424A4E4B;   //< 'KNJB'
+constexpr const DWORD g_dwJournalVersion        = 1;
+constexpr const QWORD g_cbDefaultJournalSegment = 64 << 20;
+
+struct KenoJournalSegmentHeader
+{
+    DWORD dwMagic;
+    DWORD dwVersion;
+    DWORD dwHeaderSize;         //< sizeof (KenoJournalSegmentHeader)
+    DWORD dwRecordSize;         //< sizeof (KenoTicketRecord)
+    QWORD qwSegment;            //< index in the file name
+    QWORD qwFirstBatch;         //< number of the first batch of the segment
+    DWORD dwHeaderCrc;          //< CRC-32C of the header, this field 0
+    DWORD dwReserved;
+    QWORD rgqwReserved[3];
+};
+
+static_assert (sizeof (KenoJournalSegmentHeader) == 64, "the journal segment header is 64 bytes");
+
+struct KenoJournalBatchHeader
+{
+    DWORD dwMagic;
+    DWORD dwNumRecords;
+    QWORD qwBatch;
+    DWORD dwCrc;                //< CRC-32C of the header, this field 0, and the records
+    DWORD dwReserved;
+};
+
+static_assert (sizeof (KenoJournalBatchHeader) == 24, "the journal batch header is 24 bytes");
+
+/// what replayJournal found
+struct KenoJournalReplay
+{
+    QWORD qwSegments;
+    QWORD qwBatches;
+    QWORD qwRecords;            //< tickets added to the store
+    QWORD qwRefused;            //< tickets the store refused
+    QWORD qwBytes;              //< bytes of valid batches
+    QWORD qwTornTails;          //< segments ending in a partial or damaged batch
+    QWORD qwNextBatch;          //< number of the batch a resumed writer starts with
+};
+
+#ifdef _WIN32
+    typedef void* KenoFileHandle;
+#else
+    typedef int   KenoFileHandle;
+#endif
+
+/**
+  @brief joins 'szDirectory' ("" for the working directory) and the name of
+         segment 'qwSegment'
+
+  @retval bool                  false if the path does not fit in 'cchPath'
+*/
+bool getJournalSegmentPath (const TCHAR* szDirectory, QWORD qwSegment, TCHAR* szPath, size_t cchPath);
+
+/**
+  @brief replayJournal
+
+  Adds the tickets of every batch of the journal in 'szDirectory' to 'store',
+  in the order they were appended.
+
+  @param [in]  szDirectory      journal directory
+  @param [out] store            receives the tickets; not cleared first
+  @param [out] replay           what was found, also when false is returned
+
+  @retval bool                  false if a segment is not a journal segment
+                                or a batch or segment is missing; an empty or
+                                missing journal replays successfully
+*/
+bool replayJournal (const TCHAR* szDirectory, KenoTicketStore& store, KenoJournalReplay& replay);
+
+/**
+  Appends ticket batches to a journal, any number of threads at a time.
+*/
+class KenoJournalWriter
+{
+public:
+    KenoJournalWriter  ( );
+    ~KenoJournalWriter ( );
+
+    KenoJournalWriter            (const KenoJournalWriter&) = delete;
+    KenoJournalWriter& operator= (const KenoJournalWriter&) = delete;
+
+    /**
+      @brief starts a new segment after the last segment in 'szDirectory'
+
+      @param [in] szDirectory   journal directory, which must exist
+      @param [in] qwNextBatch   number of the first batch, KenoJournalReplay::qwNextBatch
+                                when resuming a journal
+      @param [in] cbSegment     size after which a new segment is started
+
+      @retval bool              false if the segment cannot be created
+    */
+    bool open   (const TCHAR* szDirectory, QWORD qwNextBatch = 0, QWORD cbSegment = g_cbDefaultJournalSegment);
+    void close  (void);
+
+    /**
+      @brief append
+
+      Adds the tickets to the next batch and waits until it is on disk.
+
+      @retval bool              false if the journal is not open or a write
+                                failed; the journal stays failed until reopened
+    */
+    bool append (const KenoTicketRecord* rgRecords, size_t nRecords);
+
+    QWORD getNumBatches (void) const;
+    QWORD getNumRecords (void) const;
+
+private:
+    bool writeBatch   (QWORD qwBatch, const std::vector<KenoTicketRecord>& rgRecords);
+    bool startSegment (QWORD qwFirstBatch);
+    bool writeAll     (const void* pData, size_t cbData);
+    bool sync         (void);
+    void closeSegment (void);
+
+    TCHAR                         m_szDirectory[_MAX_PATH];
+    QWORD                         m_cbSegment;
+    KenoFileHandle                m_hSegment;
+    QWORD                         m_qwSegment;         //< index of the open segment
+    QWORD                         m_cbWritten;         //< bytes of the open segment
+    std::vector<BYTE>             m_rgBuffer;          //< header and records of the batch being written
+
+    mutable std::mutex            m_lock;
+    std::condition_variable       m_cvDurable;         //< signalled when a batch is written
+    std::vector<KenoTicketRecord> m_rgPending;         //< tickets of the batch m_qwNextBatch
+    std::vector<KenoTicketRecord> m_rgCommit;          //< tickets of the batch being written
+    QWORD                         m_qwNextBatch;
+    QWORD                         m_qwDurableBatch;    //< batches before it are on disk
+    QWORD                         m_qwFirstBatch;      //< first batch of this writer
+    QWORD                         m_qwNumRecords;
+    bool                          m_bOpen;
+    bool                          m_bCommitting;
+    bool                          m_bFailed;
+};
+
+#endif
@@ -0,0 +1,168 @@
+/**
+@file       KenoLogProbability.cpp
+@brief      Implementation of the log-space hypergeometric kernel
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <cmath>
+#include <limits>
+#include "KenoLogProbability.h"
+
+
+double g_rgLogFactorial[g_MAX_LOG_FACTORIAL + 1] = { 0.0 };
+
+/// unit roundoff of a double, 2^-53
+constexpr const double g_fUnitRoundoff = std::numeric_limits<double>::epsilon ( ) / 2.0;
+
+
+/**
+  The running sum is carried in double-double (Knuth's two-sum), so the
+  table error is that of the individual logs, not of 10,000 roundings.
+  Requires IEEE evaluation, i.e. not /fp:fast or -ffast-math.
+*/
+void buildLogFactorialTable (void)
+{
+    double fHi = 0.0;
+    double fLo = 0.0;
+
+    g_rgLogFactorial[0] = 0.0;
+
+    for ( DWORD n = 1; n <= g_MAX_LOG_FACTORIAL; n++ )
+    {
+        const double fTerm  = std::log (static_cast<double>(n));
+        const double fSum   = fHi + fTerm;
+        const double fVirt  = fSum - fHi;
+        const double fError = (fHi - (fSum - fVirt)) + (fTerm - fVirt);
+
+        fLo += fError;
+        fHi  = fSum + fLo;
+        fLo -= fHi - fSum;
+
+        g_rgLogFactorial[n] = fHi;
+    }
+}
+
+bool isValidGeometry (const KenoGeometry& geometry, DWORD dwNumMarked)
+{
+    return (geometry.dwTotalBalls <= g_MAX_LOG_FACTORIAL) &&
+           (geometry.dwBallsDrawn <= geometry.dwTotalBalls) &&
+           (dwNumMarked           <= geometry.dwTotalBalls);
+}
+
+/// catch sizes outside [dwMin, dwMax] are impossible
+static inline void getCatchRange (const KenoGeometry& geometry, DWORD dwNumMarked, DWORD& dwMin, DWORD& dwMax)
+{
+    const DWORD dwUndrawn = geometry.dwTotalBalls - geometry.dwBallsDrawn;
+
+    dwMin = (dwNumMarked > dwUndrawn) ? dwNumMarked - dwUndrawn : 0;
+    dwMax = (dwNumMarked < geometry.dwBallsDrawn) ? dwNumMarked : geometry.dwBallsDrawn;
+}
+
+/// the catch independent terms, ln K! + ln (N - K)! + ln M! + ln (N - M)! - ln N!
+static inline double calcLogRowConstant (const KenoGeometry& geometry, DWORD dwNumMarked)
+{
+    const DWORD dwN = geometry.dwTotalBalls;
+    const DWORD dwK = geometry.dwBallsDrawn;
+
+    return (g_rgLogFactorial[dwK] + g_rgLogFactorial[dwN - dwK]) +
+           (g_rgLogFactorial[dwNumMarked] + g_rgLogFactorial[dwN - dwNumMarked]) - g_rgLogFactorial[dwN];
+}
+
+/// sum of the magnitudes of the nine table terms, see the error bound in KenoLogProbability.h
+static inline double calcLogTermMagnitude (const KenoGeometry& geometry, DWORD dwNumMarked, DWORD dwCatch)
+{
+    const DWORD dwN = geometry.dwTotalBalls;
+    const DWORD dwK = geometry.dwBallsDrawn;
+
+    return g_rgLogFactorial[dwK] + g_rgLogFactorial[dwN - dwK] + g_rgLogFactorial[dwNumMarked] +
+           g_rgLogFactorial[dwN - dwNumMarked] + g_rgLogFactorial[dwN] +
+           g_rgLogFactorial[dwCatch] + g_rgLogFactorial[dwK - dwCatch] + g_rgLogFactorial[dwNumMarked - dwCatch] +
+           g_rgLogFactorial[dwN - dwK - dwNumMarked + dwCatch];
+}
+
+double calcKenoProbabilityLogTable (const KenoGeometry& geometry, DWORD dwNumMarked, DWORD dwCatch)
+{
+    DWORD dwMin, dwMax;
+
+    if ( !isValidGeometry (geometry, dwNumMarked) )
+        return 0.0;
+
+    getCatchRange (geometry, dwNumMarked, dwMin, dwMax);
+
+    if ( (dwCatch < dwMin) || (dwCatch > dwMax) )
+        return 0.0;
+
+    const DWORD dwN = geometry.dwTotalBalls;
+    const DWORD dwK = geometry.dwBallsDrawn;
+
+    return std::exp (calcLogRowConstant (geometry, dwNumMarked) -
+                     ((g_rgLogFactorial[dwCatch] + g_rgLogFactorial[dwK - dwCatch]) +
+                      (g_rgLogFactorial[dwNumMarked - dwCatch] + g_rgLogFactorial[dwN - dwK - dwNumMarked + dwCatch])));
+}
+
+double calcLogProbabilityErrorBound (const KenoGeometry& geometry, DWORD dwNumMarked, DWORD dwCatch)
+{
+    DWORD dwMin, dwMax;
+
+    if ( !isValidGeometry (geometry, dwNumMarked) )
+        return 0.0;
+
+    getCatchRange (geometry, dwNumMarked, dwMin, dwMax);
+
+    // an impossible catch is exactly 0.0
+    if ( (dwCatch < dwMin) || (dwCatch > dwMax) )
+        return 0.0;
+
+    const double fLogError = 12.0 * g_fUnitRoundoff * calcLogTermMagnitude (geometry, dwNumMarked, dwCatch);
+
+    return (std::expm1 (fLogError) + 2.0 * g_fUnitRoundoff) * (1.0 + 4.0 * g_fUnitRoundoff);
+}
+
+bool calcKenoProbabilityRow (const KenoGeometry& geometry, DWORD dwNumMarked, double* rgProbability,
+                             double* pfErrorBound)
+{
+    DWORD dwMin, dwMax;
+
+    if ( !isValidGeometry (geometry, dwNumMarked) )
+        return false;
+
+    getCatchRange (geometry, dwNumMarked, dwMin, dwMax);
+
+    const double  fConstant = calcLogRowConstant (geometry, dwNumMarked);
+    const int     nMin      = static_cast<int>(dwMin);
+    const int     nMax      = static_cast<int>(dwMax);
+
+    // ln C!, ln (K - C)!, ln (M - C)! and ln (N - K - M + C)! are contiguous
+    // in the table, two forwards and two backwards, so both loops vectorize;
+    // N - K - M is negative when every undrawn ball is marked
+    const double* rgLog     = g_rgLogFactorial;
+    const int     nMissed   = static_cast<int>(geometry.dwBallsDrawn);
+    const int     nUnmarked = static_cast<int>(dwNumMarked);
+    const int     nUndrawn  = static_cast<int>(geometry.dwTotalBalls) - nMissed - nUnmarked;
+
+    for ( int c = 0; c < nMin; c++ )
+        rgProbability[c] = 0.0;
+
+    for ( int c = nMin; c <= nMax; c++ )
+        rgProbability[c] = fConstant - ((rgLog[c] + rgLog[nMissed - c]) + (rgLog[nUnmarked - c] + rgLog[nUndrawn + c]));
+
+    for ( int c = nMin; c <= nMax; c++ )
+        rgProbability[c] = std::exp (rgProbability[c]);
+
+    for ( int c = nMax + 1; c <= static_cast<int>(dwNumMarked); c++ )
+        rgProbability[c] = 0.0;
+
+    if ( pfErrorBound != nullptr )
+    {
+        // the term magnitude is largest at one of the ends of the catch range
+        const double fBoundMin = calcLogProbabilityErrorBound (geometry, dwNumMarked, dwMin);
+        const double fBoundMax = calcLogProbabilityErrorBound (geometry, dwNumMarked, dwMax);
+
+        *pfErrorBound = (fBoundMin > fBoundMax) ? fBoundMin : fBoundMax;
+    }
+
+    return true;
+}
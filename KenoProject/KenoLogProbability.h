@@ -0,0 +1,120 @@
+/**
+@file       KenoLogProbability.h
+@brief      Log-space hypergeometric kernel for large ball pools
+
+  The factorial products of KenoProbability.h are exact enough for the 80
+  ball game but overflow, or lose every significant digit, for larger pools
+  (90 and 100 ball variants, aggregate lottery modes).  This kernel works in
+  log space from a table of ln (n!) for pools of up to g_MAX_LOG_FACTORIAL
+  balls:
+
+      ln P (C | N, K, M) = ln C (K, C) + ln C (N - K, M - C) - ln C (N, M)
+
+  where N is the pool, K the balls drawn and M the spots marked.  A whole
+  row (every catch size of M spots marked) is evaluated in two straight
+  loops the compiler vectorizes: the nine table terms, then the exponential.
+
+  Error bound
+  -----------
+  With u = 2^-53 and a std::log faithful to 1 ulp (true of the MSVC, glibc
+  and macOS libraries), each table entry is within 3u * ln (n!) of the exact
+  value: the logs are accumulated in double-double, so only the rounding of
+  each log (<= 2u * ln k) and of the final sum (<= u * ln (n!)) remain.  The
+  nine term sum adds at most 8u * S, where S is the sum of the magnitudes of
+  the terms, so the computed log probability is within 11u * S, rounded up
+  to 12u * S for the second order terms, and
+
+      | P' - P | / P <= (expm1 (12u * S) + 2u) * (1 + 4u)
+
+  including the 1 ulp of std::exp.  calcLogProbabilityErrorBound returns it
+  per cell; it stays below 1e-9 for every pool up to 10,000 balls.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_LOG_PROBABILITY_H__
+#define __KENO_LOG_PROBABILITY_H__
+
+#include "KenoProbability.h"
+
+constexpr const DWORD g_MAX_LOG_FACTORIAL = 10000;  //< largest pool supported by the log-space kernel
+
+/// Version of the kernel's results; bump it whenever they change, so cached tables are rebuilt
+constexpr const DWORD g_dwLogProbabilityEngineVersion = 1;
+
+/// Pool and draw size of a Keno-like game
+struct KenoGeometry
+{
+    DWORD dwTotalBalls;     //< N, the balls in the pool
+    DWORD dwBallsDrawn;     //< K, the balls drawn per game
+};
+
+/// The 80 ball, 20 drawn game of KenoProbability.h
+constexpr const KenoGeometry g_kenoGeometry = { g_TOTAL_BALLS, g_BALLS_DRAWN };
+
+/// g_rgLogFactorial[n] = ln (n!), valid once buildLogFactorialTable has run
+extern double g_rgLogFactorial[g_MAX_LOG_FACTORIAL + 1];
+
+/**
+  @brief Fills g_rgLogFactorial
+*/
+void     buildLogFactorialTable (void);
+
+/**
+  @brief isValidGeometry
+
+  @retval bool          true if 'dwNumMarked' spots of the geometry are
+                        within the log-factorial table
+*/
+bool     isValidGeometry (const KenoGeometry& geometry, DWORD dwNumMarked);
+
+/**
+  @brief ln C (N, R) from the log-factorial table, R <= N <= g_MAX_LOG_FACTORIAL
+*/
+inline double calcLogCombinations (DWORD dwN, DWORD dwR)
+{
+    return g_rgLogFactorial[dwN] - g_rgLogFactorial[dwR] - g_rgLogFactorial[dwN - dwR];
+}
+
+/**
+  @brief calcKenoProbabilityLogTable
+
+  Calculates the probability of catching exactly 'dwCatch' of 'dwNumMarked'
+  spots in 'geometry' from the log-factorial table.
+
+  @param [in] geometry          pool and draw size
+  @param [in] dwNumMarked       number of spots marked
+  @param [in] dwCatch           catch size
+
+  @retval double                the probability, 0.0 if the catch is impossible
+                                or the geometry is invalid
+*/
+double   calcKenoProbabilityLogTable (const KenoGeometry& geometry, DWORD dwNumMarked, DWORD dwCatch);
+
+/**
+  @brief calcLogProbabilityErrorBound
+
+  @retval double                the bound on the relative error of
+                                calcKenoProbabilityLogTable for the same cell
+*/
+double   calcLogProbabilityErrorBound (const KenoGeometry& geometry, DWORD dwNumMarked, DWORD dwCatch);
+
+/**
+  @brief calcKenoProbabilityRow
+
+  Calculates the probability of every catch size 0 .. M of 'dwNumMarked'
+  spots in one vectorized pass.
+
+  @param [in]  geometry         pool and draw size
+  @param [in]  dwNumMarked      number of spots marked, M
+  @param [out] rgProbability    [M + 1] probabilities, indexed by catch size
+  @param [out] pfErrorBound     if not nullptr, the largest relative error
+                                bound of the row
+
+  @retval bool                  false if the geometry is invalid
+*/
+bool     calcKenoProbabilityRow (const KenoGeometry& geometry, DWORD dwNumMarked, double* rgProbability,
+                                 double* pfErrorBound);
+
+#endif
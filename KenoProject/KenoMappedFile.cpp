@@ -0,0 +1,97 @@
+/**
+@file       KenoMappedFile.cpp
+@brief      Implementation of the read-only file mapping
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include "KenoProbability.h"
+#include "KenoMappedFile.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+
+KenoMappedFile::KenoMappedFile ( )
+    : m_pView  (nullptr),
+      m_cbView (0)
+{
+}
+
+KenoMappedFile::~KenoMappedFile ( )
+{
+    close ( );
+}
+
+bool KenoMappedFile::open (const TCHAR* szPath)
+{
+    close ( );
+
+#ifdef _WIN32
+    HANDLE hFile = ::CreateFile (szPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if ( hFile == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER liSize = { };
+
+    if ( ::GetFileSizeEx (hFile, &liSize) && (liSize.QuadPart > 0) )
+    {
+        // the view keeps the mapping, and the mapping the file, alive
+        HANDLE hMapping = ::CreateFileMapping (hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if ( hMapping != nullptr )
+        {
+            m_pView  = ::MapViewOfFile (hMapping, FILE_MAP_READ, 0, 0, 0);
+            m_cbView = (m_pView != nullptr) ? static_cast<size_t>(liSize.QuadPart) : 0;
+
+            ::CloseHandle (hMapping);
+        }
+    }
+
+    ::CloseHandle (hFile);
+#else
+    const int iFd = ::open (szPath, O_RDONLY);
+    if ( iFd < 0 )
+        return false;
+
+    struct stat status = { };
+
+    if ( (fstat (iFd, &status) == 0) && (status.st_size > 0) )
+    {
+        // the mapping stays valid after the descriptor is closed
+        void* pView = mmap (nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, iFd, 0);
+
+        if ( pView != MAP_FAILED )
+        {
+            m_pView  = pView;
+            m_cbView = static_cast<size_t>(status.st_size);
+        }
+    }
+
+    ::close (iFd);
+#endif
+
+    return m_pView != nullptr;
+}
+
+void KenoMappedFile::close (void)
+{
+    if ( m_pView != nullptr )
+    {
+#ifdef _WIN32
+        ::UnmapViewOfFile (m_pView);
+#else
+        munmap (const_cast<void*>(m_pView), m_cbView);
+#endif
+    }
+
+    m_pView  = nullptr;
+    m_cbView = 0;
+}
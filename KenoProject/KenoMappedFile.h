@@ -0,0 +1,41 @@
+/**
+@file       KenoMappedFile.h
+@brief      Read-only memory mapping of a whole file
+
+  Shared by the readers of the binary files (table cache, columnar exports),
+  which validate the mapped image themselves.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_MAPPED_FILE_H__
+#define __KENO_MAPPED_FILE_H__
+
+class KenoMappedFile
+{
+public:
+    KenoMappedFile  ( );
+    ~KenoMappedFile ( );
+
+    KenoMappedFile            (const KenoMappedFile&) = delete;
+    KenoMappedFile& operator= (const KenoMappedFile&) = delete;
+
+    /**
+      @brief maps the whole of 'szPath' read-only
+
+      @retval bool          false if the file is missing, empty or cannot be mapped
+    */
+    bool open  (const TCHAR* szPath);
+    void close (void);
+
+    bool        isOpen  (void) const { return m_pView != nullptr; }
+    const void* getData (void) const { return m_pView; }
+    size_t      getSize (void) const { return m_cbView; }
+
+private:
+    const void* m_pView;
+    size_t      m_cbView;
+};
+
+#endif
@@ -0,0 +1,229 @@
+/**
+@file       KenoModel.cpp
+@brief      Implementation of the query model and its hot reload
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <cmath>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "KenoModel.h"
+#include "KenoTrace.h"
+
+
+void evaluatePayTable (const double (&rgProbability)[g_MAX_ROWS][g_MAX_COLS], const KenoPayOutRow* rgPayOut,
+                       KenoModelPayTable& payTable)
+{
+    memset (&payTable, 0, sizeof (payTable));
+
+    for ( DWORD m = 1; m <= g_MAX_SPOTS_MARKED; m++ )
+    {
+        const double* rgRowProbability = rgProbability[m - 1];
+        double*       rgRowPayOut      = payTable.rgPayOut[m - 1];
+
+        for ( DWORD c = 1; c <= m; c++ )
+            rgRowPayOut[c] = rgPayOut[m - 1][c - 1];
+
+        double fRTP     = 0.0;
+        double fHitRate = 0.0;
+        double fSecond  = 0.0;      // E[pay out ^ 2]
+
+        for ( DWORD c = 0; c <= m; c++ )
+        {
+            fRTP    += rgRowProbability[c] * rgRowPayOut[c];
+            fSecond += rgRowProbability[c] * rgRowPayOut[c] * rgRowPayOut[c];
+
+            if ( rgRowPayOut[c] > 0.0 )
+                fHitRate += rgRowProbability[c];
+        }
+
+        const double fVariance = fSecond - fRTP * fRTP;
+
+        payTable.rgRTP[m - 1]     = fRTP;
+        payTable.rgHitRate[m - 1] = fHitRate;
+        payTable.rgStdDev[m - 1]  = (fVariance > 0.0) ? std::sqrt (fVariance) : 0.0;
+    }
+}
+
+void buildKenoModel (const KenoPayTable* rgPayTables, int nPayTables, DWORD dwVersion, KenoModel& model)
+{
+    memset (&model, 0, sizeof (model));
+
+    model.dwVersion  = dwVersion;
+    model.nPayTables = (nPayTables < g_MAX_MODEL_PAY_TABLES) ? nPayTables : g_MAX_MODEL_PAY_TABLES;
+
+    memcpy (model.rgProbability, g_rgProbability, sizeof (model.rgProbability));
+
+    for ( int t = 0; t < model.nPayTables; t++ )
+        evaluatePayTable (model.rgProbability, rgPayTables[t].rgPayOut, model.rgPayTables[t]);
+}
+
+int readPayTableFile (const TCHAR* szPath, std::vector<double>& rgPayOuts)
+{
+    FILE* pFile = _tfopen (szPath, _T ("r"));
+    if ( pFile == nullptr )
+        return 0;
+
+    std::vector<double> rgValues;
+    char                szLine[1024];
+    bool                bValid = true;
+
+    while ( bValid && (fgets (szLine, sizeof (szLine), pFile) != nullptr) )
+    {
+        char* pComment = strchr (szLine, '#');
+        if ( pComment != nullptr )
+            *pComment = '\0';
+
+        for ( char* p = szLine; ; )
+        {
+            char*        pEnd   = nullptr;
+            const double fValue = strtod (p, &pEnd);
+
+            if ( pEnd == p )
+            {
+                // anything left but white space is malformed
+                while ( (*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n') )
+                    p++;
+
+                bValid = (*p == '\0');
+                break;
+            }
+
+            rgValues.push_back (fValue);
+            p = pEnd;
+        }
+    }
+
+    fclose (pFile);
+
+    const size_t nPerTable = g_MAX_PAYOUT_ROWS * g_MAX_PAYOUT_COLS;
+
+    if ( !bValid || rgValues.empty ( ) || (rgValues.size ( ) % nPerTable != 0) )
+        return 0;
+
+    for ( size_t i = 0; i < rgValues.size ( ); i++ )
+    {
+        const size_t m = (i / g_MAX_PAYOUT_COLS) % g_MAX_PAYOUT_ROWS;
+        const size_t c = i % g_MAX_PAYOUT_COLS;
+
+        // a catch larger than the spots marked cannot pay
+        if ( (rgValues[i] < 0.0) || ((c > m) && (rgValues[i] != 0.0)) )
+            return 0;
+    }
+
+    rgPayOuts.swap (rgValues);
+
+    return static_cast<int>(rgPayOuts.size ( ) / nPerTable);
+}
+
+
+void* KenoModelRegistry::operator new (size_t cbSize)
+{
+#ifdef _WIN32
+    void* pMemory = _aligned_malloc (cbSize, alignof (KenoModelRegistry));
+#else
+    void* pMemory = nullptr;
+    if ( posix_memalign (&pMemory, alignof (KenoModelRegistry), cbSize) != 0 )
+        pMemory = nullptr;
+#endif
+
+    if ( pMemory == nullptr )
+        throw std::bad_alloc ( );
+
+    return pMemory;
+}
+
+void KenoModelRegistry::operator delete (void* pMemory) noexcept
+{
+#ifdef _WIN32
+    _aligned_free (pMemory);
+#else
+    free (pMemory);
+#endif
+}
+
+KenoModelRegistry::KenoModelRegistry ( )
+    : m_pCurrent     (nullptr),
+      m_qwEpoch      (1),
+      m_dwNumSwaps   (0),
+      m_qwLastSwapNs (0),
+      m_qwMaxSwapNs  (0)
+{
+    for ( auto& slot : m_rgReaders )
+    {
+        slot.qwEpoch = 0;
+        slot.bInUse  = false;
+    }
+}
+
+KenoModelRegistry::~KenoModelRegistry ( )
+{
+}
+
+void KenoModelRegistry::publish (std::unique_ptr<KenoModel> pModel)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    std::lock_guard<std::mutex> guard (m_writerLock);
+
+    const auto tpStart = Clock::now ( );
+
+    m_pCurrent.store (pModel.get ( ), std::memory_order_seq_cst);
+
+    // a reader announcing an older epoch may have loaded the previous model
+    const QWORD qwRetire = m_qwEpoch.fetch_add (1, std::memory_order_seq_cst) + 1;
+
+    if ( m_pOwned != nullptr )
+    {
+        for ( auto& slot : m_rgReaders )
+        {
+            for ( ;; )
+            {
+                // seq_cst pairs with the reader's seq_cst announce: either the
+                // reader's epoch is seen here or the reader sees the new model
+                const QWORD qwEpoch = slot.qwEpoch.load (std::memory_order_seq_cst);
+
+                if ( (qwEpoch == 0) || (qwEpoch >= qwRetire) )
+                    break;
+
+                std::this_thread::yield ( );
+            }
+        }
+    }
+
+    m_pOwned = std::move (pModel);
+
+    const QWORD qwSwapNs = static_cast<QWORD>(std::chrono::duration_cast<std::chrono::nanoseconds> (Clock::now ( ) - tpStart).count ( ));
+
+    m_qwLastSwapNs.store (qwSwapNs, std::memory_order_relaxed);
+    if ( qwSwapNs > m_qwMaxSwapNs.load (std::memory_order_relaxed) )
+        m_qwMaxSwapNs.store (qwSwapNs, std::memory_order_relaxed);
+    m_dwNumSwaps.fetch_add (1, std::memory_order_relaxed);
+
+    KENO_TRACE_INFO (_T ("Published model version %u, swap %.1f us"), m_pOwned->dwVersion, qwSwapNs / 1000.0);
+}
+
+int KenoModelRegistry::registerReader (void)
+{
+    for ( int r = 0; r < g_MAX_MODEL_READERS; r++ )
+    {
+        bool bExpected = false;
+
+        if ( m_rgReaders[r].bInUse.compare_exchange_strong (bExpected, true) )
+            return r;
+    }
+
+    return -1;
+}
+
+void KenoModelRegistry::unregisterReader (int nReader)
+{
+    m_rgReaders[nReader].qwEpoch.store (0, std::memory_order_release);
+    m_rgReaders[nReader].bInUse.store (false, std::memory_order_release);
+}
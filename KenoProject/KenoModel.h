@@ -0,0 +1,170 @@
+/**
+@file       KenoModel.h
+@brief      Immutable query model and its epoch based hot reload
+
+  A KenoModel is a snapshot of everything the query service answers from:
+  the probability matrix and every pay table with its derived metrics.  A
+  published model is never modified; operators publish a new one instead,
+  e.g. after editing the pay table file, and KenoModelRegistry swaps it in
+  while the service keeps running.
+
+  Readers never block and never write shared cache lines other than their
+  own slot: a reader announces the current epoch in its slot, loads the
+  model pointer, answers its queries and clears the slot.  The writer
+  exchanges the pointer, advances the epoch and waits until no slot still
+  announces an older epoch; only then can no reader hold the old model,
+  and it is freed.  The time from the start of publish to the reclamation
+  of the old model is the swap latency, kept as a metric.
+
+  Pay table file format: whitespace separated pay outs, '#' starts a
+  comment.  Each pay table is g_MAX_PAYOUT_ROWS rows (1 .. 9 spots marked)
+  of g_MAX_PAYOUT_COLS pay outs (catch 1 .. 9), laid out like
+  g_rgCatchPayOut; a file holds one or more tables.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_MODEL_H__
+#define __KENO_MODEL_H__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "KenoProbability.h"
+
+constexpr const int    g_MAX_MODEL_PAY_TABLES = 16;
+constexpr const int    g_MAX_MODEL_READERS    = 64;   //< concurrent reader threads of a registry
+constexpr const size_t g_cbModelCacheLine     = 64;
+
+/// One pay table of the model with its metrics, indexed by spots marked - 1
+struct KenoModelPayTable
+{
+    double rgPayOut [g_MAX_SPOTS_MARKED][g_MAX_COLS];   //< indexed by catch size, 0 for catch 0
+    double rgRTP    [g_MAX_SPOTS_MARKED];
+    double rgHitRate[g_MAX_SPOTS_MARKED];
+    double rgStdDev [g_MAX_SPOTS_MARKED];
+};
+
+/**
+  Everything a query is answered from.  A model is never modified once it
+  has been published.
+*/
+struct KenoModel
+{
+    DWORD             dwVersion;                        //< increases with every published model
+    int               nPayTables;
+    double            rgProbability[g_MAX_ROWS][g_MAX_COLS];
+    KenoModelPayTable rgPayTables[g_MAX_MODEL_PAY_TABLES];
+};
+
+/**
+  @brief evaluatePayTable
+
+  Fills in the pay outs, RTP, hit rate and standard deviation of every row
+  of one pay table.
+
+  @param [in]  rgProbability    probability matrix, e.g. g_rgProbability
+  @param [in]  rgPayOut         g_MAX_PAYOUT_ROWS rows of the pay table
+  @param [out] payTable         receives the pay table and its metrics
+*/
+void evaluatePayTable (const double (&rgProbability)[g_MAX_ROWS][g_MAX_COLS], const KenoPayOutRow* rgPayOut,
+                       KenoModelPayTable& payTable);
+
+/**
+  @brief buildKenoModel
+
+  Builds a model from g_rgProbability, which must have been built, and the
+  given pay tables (at most g_MAX_MODEL_PAY_TABLES are used).
+
+  @param [in]  rgPayTables      pay tables, e.g. g_rgPayTableCatalog
+  @param [in]  nPayTables       number of pay tables
+  @param [in]  dwVersion        version stamped on the model
+  @param [out] model            receives the model
+*/
+void buildKenoModel (const KenoPayTable* rgPayTables, int nPayTables, DWORD dwVersion, KenoModel& model);
+
+/**
+  @brief readPayTableFile
+
+  @param [in]  szPath           pay table file
+  @param [out] rgPayOuts        receives g_MAX_PAYOUT_ROWS rows of
+                                g_MAX_PAYOUT_COLS pay outs per pay table
+
+  @retval int                   number of pay tables read, 0 if the file is
+                                missing or malformed
+*/
+int  readPayTableFile (const TCHAR* szPath, std::vector<double>& rgPayOuts);
+
+
+/**
+  Publishes models to any number of reader threads, see the file comment.
+*/
+class alignas (g_cbModelCacheLine) KenoModelRegistry
+{
+public:
+    KenoModelRegistry  ( );
+    ~KenoModelRegistry ( );
+
+    // operator new need not honour alignas before C++17
+    static void* operator new    (size_t cbSize);
+    static void  operator delete (void* pMemory) noexcept;
+
+    /**
+      @brief makes 'pModel' current and frees the previous model once no
+             reader can still use it; blocks only the publishing thread
+    */
+    void publish (std::unique_ptr<KenoModel> pModel);
+
+    /**
+      @brief claims a reader slot for the calling thread
+
+      @retval int           slot index, or -1 if all g_MAX_MODEL_READERS are taken
+    */
+    int  registerReader   (void);
+    void unregisterReader (int nReader);
+
+    /**
+      @brief returns the current model, valid until leave (nReader)
+    */
+    const KenoModel* enter (int nReader)
+    {
+        KenoReaderSlot& slot = m_rgReaders[nReader];
+
+        // seq_cst places the epoch load in the same total order as publish's
+        // pointer store and epoch increment: a reader that sees the epoch of
+        // a publish, and so is skipped by its scan, must also see the model
+        // stored before it, or it could load a model that is being freed
+        slot.qwEpoch.store (m_qwEpoch.load (std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return m_pCurrent.load (std::memory_order_seq_cst);
+    }
+
+    void leave (int nReader)
+    {
+        m_rgReaders[nReader].qwEpoch.store (0, std::memory_order_release);
+    }
+
+    DWORD  getNumSwaps      (void) const { return m_dwNumSwaps.load (std::memory_order_relaxed); }
+    double getLastSwapUs    (void) const { return m_qwLastSwapNs.load (std::memory_order_relaxed) / 1000.0; }
+    double getMaxSwapUs     (void) const { return m_qwMaxSwapNs.load (std::memory_order_relaxed) / 1000.0; }
+
+private:
+    /// one cache line per reader, so announcing an epoch never contends
+    struct alignas (g_cbModelCacheLine) KenoReaderSlot
+    {
+        std::atomic<QWORD> qwEpoch;         //< epoch announced while reading, 0 when quiescent
+        std::atomic<bool>  bInUse;
+    };
+
+    KenoReaderSlot                 m_rgReaders[g_MAX_MODEL_READERS];
+    std::atomic<const KenoModel*>  m_pCurrent;
+    std::atomic<QWORD>             m_qwEpoch;
+    std::mutex                     m_writerLock;       //< serializes publishers
+    std::unique_ptr<KenoModel>     m_pOwned;           //< the current model
+    std::atomic<DWORD>             m_dwNumSwaps;
+    std::atomic<QWORD>             m_qwLastSwapNs;
+    std::atomic<QWORD>             m_qwMaxSwapNs;
+};
+
+#endif
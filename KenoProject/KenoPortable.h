@@ -0,0 +1,66 @@
+/**
+@file       KenoPortable.h
+@brief      Win32 types and <tchar.h> mappings for non-Windows builds
+
+  The probability kernel, the simulators and the benchmarks only use the
+  Win32 integer types and the generic text routines, so on other platforms
+  they are mapped onto the standard library here (as the non-Unicode
+  <tchar.h> would) rather than ported file by file.  Included by stdafx.h
+  instead of <tchar.h> when _WIN32 is not defined.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_PORTABLE_H__
+#define __KENO_PORTABLE_H__
+
+#ifndef _WIN32
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t   BYTE;
+typedef uint16_t  WORD;
+typedef uint32_t  DWORD;
+typedef int       BOOL;
+
+#ifndef TRUE
+    #define TRUE    1
+    #define FALSE   0
+#endif
+
+#define _MAX_PATH   260
+
+typedef char TCHAR;
+typedef char _TCHAR;
+
+#define _T(x)       x
+#define _tmain      main
+
+#define _tcscmp     strcmp
+#define _tcslen     strlen
+#define _tcsncmp    strncmp
+#define _tcsncpy    strncpy
+#define _tcsrchr    strrchr
+#define _tcstod     strtod
+#define _tcstoul    strtoul
+#define _tcstoui64  strtoull
+#define _tprintf    printf
+#define _ftprintf   fprintf
+#define _sntprintf  snprintf
+#define _tfopen     fopen
+#define _trename    rename
+#define _tremove    remove
+
+template <typename T, size_t N>
+char (&_countof_helper (T (&)[N]))[N];
+
+#define _countof(a) (sizeof (_countof_helper (a)))
+
+#endif
+
+#endif
@@ -0,0 +1,291 @@
+/**
+@file       KenoProbability.cpp
+@brief      Implementation of the Keno probability kernel and expected value engine
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <cmath>
+#include "KenoProbability.h"
+#include "KenoTrace.h"
+#include "KenoVariants.h"
+
+
+double g_rgProbability[g_MAX_ROWS][g_MAX_COLS] = { 0.0 }; //< array for calculated probability matrix
+
+double g_rgExpectedValue[g_MAX_SPOTS_MARKED] = { 0.0 };
+
+/// The pay out tables currently offered, all of which are validated by '-verify'
+const KenoPayTable g_rgPayTableCatalog[] =
+{
+    { _T("House"), g_rgCatchPayOut },
+};
+
+const int g_nPayTableCatalogSize = _countof (g_rgPayTableCatalog);
+
+
+/**
+  @brief calcFactorial
+
+  A recursive factorial implimentation
+
+  @param [in] wN       value used for factorial operation
+
+  @retval QWORD         containing computed results
+
+  @note the return result can get very big and possibly overflow, 
+        there are not checks for this
+*/
+QWORD calcFactorial (WORD wN)
+{
+    if ( wN > 1 )
+        return wN * calcFactorial ( wN - 1 );
+    else
+        return 1;
+}
+
+/**
+  @brief calcPartialFactorial 
+ 
+  This performs a factorial computation of 'wN' utilizing only a 
+  'wNumTerms' number of the highest valued terms of in traditional 
+  factorial computation.
+
+  For example, calcPartialFactorial(10, 4) would initiate a factorial
+  computation, but would stop after evaluating the top 4 terms as follows:
+    ( 10 * 9 * 7 * 6 )
+
+  If 'wNumTerms' == 0, then a '1' is immediately returned.
+
+  @param [in] wN                initial term
+  @param [in] wNumTerms         number of terms used in partial factorial
+
+  @retval double                containing the calculated partial factorial
+*/
+double calcPartialFactorial (WORD wN, WORD wNumTerms)
+{
+    double fResult = 1.0;
+
+    for ( WORD i = 0; i < wNumTerms; i++ )
+    {
+        fResult = fResult * (wN - i);
+    }
+
+    KENO_TRACE_VERBOSE (_T ("calcPartialFactorial: N[%d] NumTerms[%3d] = %f"), wN, wNumTerms, fResult);
+
+    return fResult;
+}
+
+/**
+  @brief calcCombinations - "N things taken R at a time, without repetition"
+
+  Combination is the quantity of subgroups of a size 'R' that can be formed 
+  out of a group of a size 'N' in which the order is NOT important.  For example
+  given 3 fruits (an apple, an orange and a pear), there are 3 combinations of 2
+  that can be drawn from this set: {apple, pear}, {apple, orange}, {pear, orange}.
+  This expression is often written mathematically as C (N, R) where R is less than 
+  or equal to N, calculated as N! / R!(N-R)! and which is 0 when R > N.
+ 
+  @param [in] dwN           Group Size - number of things to choose from
+  @param [in] dwR           Subgroup Size - number of things chosen
+
+  @retval DWORD  containing the number of 'dwR' sized subgroups that can be 
+                 formed from a set containing 'dwN' number of elements.
+
+  @sa http://en.wikipedia.org/wiki/Combination
+*/
+DWORD calcCombinations (DWORD dwN, DWORD dwR)
+{ 
+    DWORD dwResult = 0;
+
+    if ( dwR <= dwN )
+    {
+        const QWORD qwNFactorial   = calcFactorial ( static_cast<WORD>(dwN) );
+        const QWORD qwRFactorial   = calcFactorial ( static_cast<WORD>(dwR) );
+
+        const QWORD qwDifFactorial = calcFactorial ( static_cast<WORD>(dwN - dwR) );
+
+        dwResult = static_cast<DWORD>(qwNFactorial / (qwRFactorial * qwDifFactorial));
+    }
+
+    KENO_TRACE_VERBOSE (_T ("calcCombinations: N[%u] R[%u] = %u"), dwN, dwR, dwResult);
+
+    return dwResult;
+}
+
+/**
+  @brief calcKenoProbability
+
+  Calulates the probability of a 'dwCaught' sized catch from any set of 
+  'dwNumMarked' number of player picked balls, based on a total of 80 KENO balls
+  with the maximum number of balls selectable being 20.
+
+  @param [in] dwNumMarked       The number of KENO ball spots a player has 'marked' or 
+                                selected 
+  @param [in] dwCaught          The catch size of interest which probability is calculated 
+                                against
+
+  @retval double         containing the calculated probability of a matching a subset of 
+                         potential 'dwCaught' sized number of balls from a set consisting 
+                         of 'dwNumMarked' number of spots from the possible 20 selectable balls.
+*/
+double  calcKenoProbability ( DWORD dwNumMarked, DWORD dwCaught )
+{
+    double fResult = 0.0;
+
+    const DWORD dwNumCombinations = calcCombinations (dwNumMarked, dwCaught);
+    const double qwP1 = calcPartialFactorial ( static_cast<WORD>(g_MAX_SELECTABLE_BALLS), static_cast<WORD>(dwCaught) );
+    const double qwP2 = calcPartialFactorial ( static_cast<WORD>(g_TOTAL_BALLS - g_MAX_SELECTABLE_BALLS), static_cast<WORD>(dwNumMarked - dwCaught) );
+    const double qwP3 = calcPartialFactorial ( static_cast<WORD>(g_TOTAL_BALLS), static_cast<WORD>(dwNumMarked) );
+
+// the actual formula given was C(N, R) * P1 * P2 / P3
+    fResult = static_cast<double>(dwNumCombinations) * qwP1 * qwP2 / qwP3;
+
+    KENO_TRACE_VERBOSE (_T ("calcKenoProbability: NumMarked[%u] Caught[%u] = %.20f"), dwNumMarked, dwCaught, fResult);
+
+    return fResult;
+}
+
+QWORD calcCombinationsExact (DWORD dwN, DWORD dwR)
+{
+    if ( dwR > dwN )
+        return 0;
+
+    if ( dwR > dwN - dwR )
+        dwR = dwN - dwR;
+
+    QWORD qwResult = 1;
+
+    // after step i qwResult = C (N - R + i, i); dividing out the gcd first keeps it in range
+    for ( DWORD i = 1; i <= dwR; i++ )
+    {
+        QWORD qwA = qwResult;
+        QWORD qwB = i;
+
+        while ( qwB != 0 )
+        {
+            const QWORD qwT = qwA % qwB;
+            qwA = qwB;
+            qwB = qwT;
+        }
+
+        qwResult = (qwResult / qwA) * ((dwN - dwR + i) / (i / qwA));
+    }
+
+    return qwResult;
+}
+
+double calcKenoProbabilityExact (DWORD dwNumMarked, DWORD dwCatch)
+{
+    if ( (dwCatch > dwNumMarked) || (dwCatch > g_BALLS_DRAWN) )
+        return 0.0;
+
+    const QWORD qwWays  = calcCombinationsExact (g_BALLS_DRAWN, dwCatch) *
+                          calcCombinationsExact (g_TOTAL_BALLS - g_BALLS_DRAWN, dwNumMarked - dwCatch);
+    const QWORD qwTotal = calcCombinationsExact (g_TOTAL_BALLS, dwNumMarked);
+
+    return static_cast<double>(qwWays) / static_cast<double>(qwTotal);
+}
+
+/// log C (N, R)
+static inline double logCombinations (double fN, double fR)
+{
+    return std::lgamma (fN + 1.0) - std::lgamma (fR + 1.0) - std::lgamma (fN - fR + 1.0);
+}
+
+double calcKenoProbabilityLogGamma (DWORD dwNumMarked, DWORD dwCatch)
+{
+    if ( (dwCatch > dwNumMarked) || (dwCatch > g_BALLS_DRAWN) )
+        return 0.0;
+
+    return std::exp (logCombinations (g_BALLS_DRAWN, dwCatch) +
+                     logCombinations (g_TOTAL_BALLS - g_BALLS_DRAWN, dwNumMarked - dwCatch) -
+                     logCombinations (g_TOTAL_BALLS, dwNumMarked));
+}
+
+void buildProbabilityTable (void)
+{
+    KENO_TRACE_DEBUG (_T ("Calculating Keno Probabilites Value(s)"));
+
+    for ( int i = 0; i < g_MAX_ROWS; i++ )      // i + 1 = '(number of spots 'marked')'
+    {
+        const int iNumSpotsMarked = i + 1;  // this is for readability
+        for ( int j = 0; j < g_MAX_COLS; j++ )  // j = balls caught 
+        {
+            if ( iNumSpotsMarked >= j )
+            { 
+                // Probability of 'j' Ball(s) caught from set of 'i+1' player 'marked' spots or numbers
+                g_rgProbability[i][j] = calcKenoProbability ( iNumSpotsMarked, j );
+
+                KENO_TRACE_DEBUG (_T ("Calculating probability of a catch of [%d] balls out of [%d] 'marked' numbers = %.10g"),
+                                  j, iNumSpotsMarked, g_rgProbability[i][j]);
+            }
+            else
+            {
+                // probability is zero
+            }
+        }
+    }
+}
+
+void buildExpectedValueTable (void)
+{
+    KENO_TRACE_DEBUG (_T ("Calculating Expected Value(s)"));
+
+    /*************************************************************************
+
+    The expected value of a discrete random variable is the probability-weighted 
+    average of all possible values. In other words, each possible value the random 
+    variable can assume is multiplied by its probability of occurring, and the resulting 
+    products are summed to produce the expected value.
+
+    @cite http://en.wikipedia.org/wiki/Expected_value
+
+    GIVEN: "Together with this program specification there is a sheet of payoffs 
+            for between 1 & 9 spots marked.  Calculate for each number of spots 
+            marked the 'expected value' of a $1 bet."
+
+            - The KENO probability of "C" ball(s) getting caught out of "M" spots
+              marked will be denoted as 'KP(M, C)'.
+            - The payout of "C" ball(s) getting caught out of "M" spots marked will
+              be denoted as 'PO(M, C)'.
+
+            The expected $1 value of 9 spots marked is equal to:
+                KP(9, 9) * PO(9, 9) + 
+                KP(9, 8) * PO(9, 8) +
+                KP(9, 7) * PO(9, 7) +
+                       ...          +
+                KP(9, 0) * PO(9, 0)
+
+            The KP(M, C) already sum to 1 over every catch size, so the terms
+            must not be divided by the number of terms as well.
+    */
+    for ( int i = 0; i < g_MAX_SPOTS_MARKED; i++ )        // i + 1 = 'number of spots marked'
+    {
+        // the base table and every variant in g_rgVariantCatalog are evaluated in the same pass
+        double rgVariantEV[g_MAX_VARIANTS] = { 0.0 };
+
+        g_rgExpectedValue[i] = calcVariantExpectedValues (g_rgProbability[i], g_rgCatchPayOut[i], 
+                                                          g_rgVariantCatalog, g_nVariantCatalogSize, rgVariantEV);
+
+        for ( int v = 0; v < g_nVariantCatalogSize; v++ )
+            g_rgVariantExpectedValue[v][i] = rgVariantEV[v];
+
+#if KENO_TRACE_LEVEL >= KENO_TRACE_LEVEL_DEBUG
+        for ( int j = 0; j < g_MAX_PAYOUT_COLS; j++ )     // j + 1 = 'number of balls caught'
+        {
+            if ( g_rgCatchPayOut[i][j] > 0 )
+            {
+                KENO_TRACE_DEBUG (_T ("KP(%d,%d) =%.10g"), i + 1, j + 1, g_rgProbability[i][j + 1]);
+                KENO_TRACE_DEBUG (_T ("PO(%d,%d) =%.10g"), i + 1, j + 1, g_rgCatchPayOut[i][j]);
+            }
+        }
+        KENO_TRACE_DEBUG (_T ("Expected Value of [%d] spots marked %.10g"), i + 1, g_rgExpectedValue[i]);
+
+        for ( int v = 0; v < g_nVariantCatalogSize; v++ )
+            KENO_TRACE_DEBUG (_T ("  Variant [%s] Expected Value %.10g"), g_rgVariantCatalog[v].szName, g_rgVariantExpectedValue[v][i]);
+#endif
+    }
+}
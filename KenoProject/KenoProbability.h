@@ -0,0 +1,115 @@
+/**
+@file       KenoProbability.h
+@brief      Keno probability and expected value declarations
+
+  Shared game geometry, pay out table and the combinatoric probability
+  kernel used by the exporter, the simulator and the verification modes.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_PROBABILITY_H__
+#define __KENO_PROBABILITY_H__
+
+#ifdef _WIN32
+    #ifndef _WINDEF_
+        #include <Windows.h>
+    #endif
+#endif
+
+typedef unsigned long long QWORD;  //< 64 bit unsigned integer  (0 to 18,446,744,073,709,551,615)
+
+
+constexpr const int g_MAX_ROWS             = 20;   //< used to set array bounds where the index = '(number of player 'marked' balls) - 1'
+constexpr const int g_MAX_COLS             = 21;   //< used to set array bounds where the index = to catch size
+constexpr const int g_TOTAL_BALLS          = 80;   //< This is the total of balls (1..80) in the simulation
+constexpr const int g_MAX_SELECTABLE_BALLS = 20;   //< This is the maximum number of player selectable balls allowed.
+constexpr const int g_BALLS_DRAWN          = 20;   //< This is the number of balls the casino machine draws per game
+
+constexpr const int g_MAX_PAYOUT_ROWS  = 9; //< corresponds to 'spot(s) marked + 1'
+constexpr const int g_MAX_PAYOUT_COLS  = 9; //< corresponds to 'number of balls caught + 1'
+constexpr const int g_MAX_SPOTS_MARKED = 9;
+
+/// The entries in the [ith] row assumes that the player has 'marked' i numbers
+/// The entry in the [jth] column is the probability that the player catches j spots out of i possible
+extern double g_rgProbability[g_MAX_ROWS][g_MAX_COLS];
+
+/// A pay out table row is indexed by 'number of balls caught - 1'
+typedef double KenoPayOutRow[g_MAX_PAYOUT_COLS];
+
+constexpr const double g_rgCatchPayOut[g_MAX_PAYOUT_ROWS][g_MAX_PAYOUT_COLS] =
+//Catch  1     2     3     4       5       6       7        8        9
+    { { 3.0,  0.0,  0.0,  0.0,    0.0,    0.0,    0.0,     0.0,     0.0 },   // 1 Spot marked
+      { 0.0, 12.0,  0.0,  0.0,    0.0,    0.0,    0.0,     0.0,     0.0 },   // 2 Spots marked
+      { 0.0,  1.0, 42.0,  0.0,    0.0,    0.0,    0.0,     0.0,     0.0 },   // 3 Spots marked
+      { 0.0,  1.0,  3.0, 120.0,   0.0,    0.0,    0.0,     0.0,     0.0 },   // 4 Spots marked
+      { 0.0,  0.0,  1.0,   9.0, 800.0,    0.0,    0.0,     0.0,     0.0 },   // 5 Spots marked
+      { 0.0,  0.0,  1.0,   4.0,  88.0, 1500.0,    0.0,     0.0,     0.0 },   // 6 Spots marked
+      { 0.0,  0.0,  0.0,   2.0,  20.0,  350.0,  700.0,     0.0,     0.0 },   // 7 Spots marked
+      { 0.0,  0.0,  0.0,   0.0,   9.0,   90.0, 1500.0, 20000.0,     0.0 },   // 8 Spots marked
+      { 0.0,  0.0,  0.0,   0.0,   4.0,   43.0, 3000.0,  4000.0, 25000.0 } }; // 9 Spots marked
+
+/**
+@sa http://en.wikipedia.org/wiki/Expected_value
+*/
+extern double g_rgExpectedValue[g_MAX_SPOTS_MARKED];
+
+/**
+  A named pay out table.  Every table in the catalog is priced by the
+  expected value engine and cross-checked by the simulator.
+*/
+struct KenoPayTable
+{
+    const TCHAR*         szName;      //< display name of the pay table
+    const KenoPayOutRow* rgPayOut;    //< [g_MAX_PAYOUT_ROWS] rows of catch pay outs
+};
+
+extern const KenoPayTable g_rgPayTableCatalog[];
+extern const int          g_nPayTableCatalogSize;
+
+
+QWORD    calcFactorial       (WORD wN);
+double   calcPartialFactorial(WORD wN, WORD wNumTerms);
+DWORD    calcCombinations    (DWORD dwN, DWORD dwR);
+double   calcKenoProbability (DWORD dwNumMarked, DWORD dwCatch);
+
+/**
+  @brief calcCombinationsExact
+
+  Exact C (N, R) in 64 bit integer arithmetic, valid whenever the result
+  fits in a QWORD (e.g. every C (80, R)); unlike calcCombinations it never
+  forms the factorials.
+*/
+QWORD    calcCombinationsExact       (DWORD dwN, DWORD dwR);
+
+/**
+  @brief same as calcKenoProbability, from the exact integer counts
+         C (20, C) * C (60, M - C) / C (80, M), rounded once
+*/
+double   calcKenoProbabilityExact    (DWORD dwNumMarked, DWORD dwCatch);
+
+/**
+  @brief same as calcKenoProbability, evaluated in log space with lgamma
+*/
+double   calcKenoProbabilityLogGamma (DWORD dwNumMarked, DWORD dwCatch);
+
+/**
+  @brief table lookup of calcKenoProbability, valid once buildProbabilityTable has run
+*/
+inline double getKenoProbability (DWORD dwNumMarked, DWORD dwCatch)
+{
+    return g_rgProbability[dwNumMarked - 1][dwCatch];
+}
+
+/**
+  @brief Fills g_rgProbability with the complete probability matrix
+*/
+void     buildProbabilityTable   (void);
+
+/**
+  @brief Fills g_rgExpectedValue from g_rgProbability and g_rgCatchPayOut
+*/
+void     buildExpectedValueTable (void);
+
+#endif
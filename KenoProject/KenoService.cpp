@@ -0,0 +1,533 @@
+/**
+@file       KenoService.cpp
+@brief      Implementation of the local query service
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#ifdef _WIN32
+    // Winsock 2 has to come before anything that includes <Windows.h>
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #include <afunix.h>
+    #pragma comment (lib, "Ws2_32.lib")
+#else
+    #include <errno.h>
+    #include <unistd.h>
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+#include <limits>
+#include <string.h>
+#include "KenoService.h"
+#include "KenoTrace.h"
+
+#ifdef _WIN32
+    typedef int socklen_t;
+
+    constexpr const int        g_iSendFlags     = 0;
+    constexpr const KenoSocket g_hInvalidSocket = INVALID_SOCKET;
+
+    static inline void closeSocket    (KenoSocket hSocket) { ::closesocket (hSocket); }
+    static inline void shutdownSocket (KenoSocket hSocket) { ::shutdown (hSocket, SD_BOTH); }
+#else
+    constexpr const int        g_iSendFlags     = MSG_NOSIGNAL;    // a closed peer is an error, not SIGPIPE
+    constexpr const KenoSocket g_hInvalidSocket = -1;
+
+    static inline void closeSocket    (KenoSocket hSocket) { ::close (hSocket); }
+    static inline void shutdownSocket (KenoSocket hSocket) { ::shutdown (hSocket, SHUT_RDWR); }
+#endif
+
+/// size of a connection's receive buffer, enough for several pipelined frames
+constexpr const size_t g_cbServiceReceiveBuffer = 64 * 1024;
+
+
+/// Winsock must be started once per process; elsewhere this does nothing
+static void initSockets (void)
+{
+#ifdef _WIN32
+    struct KenoWinsock
+    {
+        KenoWinsock  ( ) { WSADATA data; ::WSAStartup (MAKEWORD (2, 2), &data); }
+        ~KenoWinsock ( ) { ::WSACleanup ( ); }
+    };
+
+    static KenoWinsock s_winsock;
+#endif
+}
+
+static bool sendAll (KenoSocket hSocket, const BYTE* pData, size_t cbData)
+{
+    while ( cbData > 0 )
+    {
+        const int cbChunk = (cbData > 0x40000000) ? 0x40000000 : static_cast<int>(cbData);
+        const int cbSent  = ::send (hSocket, reinterpret_cast<const char*>(pData), cbChunk, g_iSendFlags);
+
+        if ( cbSent <= 0 )
+            return false;
+
+        pData  += cbSent;
+        cbData -= cbSent;
+    }
+
+    return true;
+}
+
+static bool recvAll (KenoSocket hSocket, BYTE* pData, size_t cbData)
+{
+    while ( cbData > 0 )
+    {
+        const int cbChunk    = (cbData > 0x40000000) ? 0x40000000 : static_cast<int>(cbData);
+        const int cbReceived = ::recv (hSocket, reinterpret_cast<char*>(pData), cbChunk, 0);
+
+        if ( cbReceived <= 0 )
+            return false;
+
+        pData  += cbReceived;
+        cbData -= cbReceived;
+    }
+
+    return true;
+}
+
+/// the loopback address and 'wPort'
+static sockaddr_in makeLoopbackAddress (WORD wPort)
+{
+    sockaddr_in address = { };
+
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons (wPort);
+    address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+    return address;
+}
+
+static bool makeUnixAddress (const char* szSocketPath, sockaddr_un& address)
+{
+    memset (&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+
+    if ( strlen (szSocketPath) >= sizeof (address.sun_path) )
+        return false;
+
+    strcpy (address.sun_path, szSocketPath);
+
+    return true;
+}
+
+/// requests are answered at once, so Nagle's algorithm would only add latency
+static void setNoDelay (KenoSocket hSocket)
+{
+    int iEnable = 1;
+    ::setsockopt (hSocket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&iEnable), sizeof (iEnable));
+}
+
+
+void answerQueries (const KenoModel& model, const KenoQuery* rgQueries, DWORD dwCount, double* rgResults)
+{
+    const double fInvalid = std::numeric_limits<double>::quiet_NaN ( );
+
+    for ( DWORD i = 0; i < dwCount; i++ )
+    {
+        const KenoQuery& query  = rgQueries[i];
+        const DWORD      dwSpot = query.bSpots;
+        double           fResult = fInvalid;
+
+        // the pay table metrics only exist for the marked spots that pay
+        const bool bPayTable = (query.bPayTable < model.nPayTables) && (dwSpot >= 1) && (dwSpot <= g_MAX_SPOTS_MARKED);
+
+        switch ( query.bType )
+        {
+        case KENO_QUERY_PROBABILITY:
+            if ( (dwSpot >= 1) && (dwSpot <= g_MAX_ROWS) && (query.bCatch <= dwSpot) )
+                fResult = model.rgProbability[dwSpot - 1][query.bCatch];
+            break;
+
+        case KENO_QUERY_PAY_OUT:
+            if ( bPayTable && (query.bCatch <= dwSpot) )
+                fResult = model.rgPayTables[query.bPayTable].rgPayOut[dwSpot - 1][query.bCatch];
+            break;
+
+        case KENO_QUERY_RTP:
+            if ( bPayTable )
+                fResult = model.rgPayTables[query.bPayTable].rgRTP[dwSpot - 1];
+            break;
+
+        case KENO_QUERY_HIT_RATE:
+            if ( bPayTable )
+                fResult = model.rgPayTables[query.bPayTable].rgHitRate[dwSpot - 1];
+            break;
+
+        case KENO_QUERY_STD_DEV:
+            if ( bPayTable )
+                fResult = model.rgPayTables[query.bPayTable].rgStdDev[dwSpot - 1];
+            break;
+
+        default:
+            break;
+        }
+
+        rgResults[i] = fResult;
+    }
+}
+
+
+KenoService::KenoService ( )
+    : m_hListen      (g_hInvalidSocket),
+      m_wPort        (0),
+      m_szSocketPath { 0 },
+      m_pRegistry    (nullptr),
+      m_bStop        (false),
+      m_qwNumQueries (0),
+      m_qwNumFrames  (0)
+{
+}
+
+KenoService::~KenoService ( )
+{
+    stop ( );
+}
+
+bool KenoService::start (const char* szSocketPath, WORD wPort, KenoModelRegistry* pRegistry)
+{
+    stop ( );
+    initSockets ( );
+
+    m_pRegistry = pRegistry;
+    m_bStop     = false;
+
+    if ( szSocketPath != nullptr )
+    {
+        sockaddr_un address;
+
+        if ( !makeUnixAddress (szSocketPath, address) )
+            return false;
+
+        m_hListen = ::socket (AF_UNIX, SOCK_STREAM, 0);
+        if ( m_hListen == g_hInvalidSocket )
+            return false;
+
+        // a socket file left behind by a previous run would fail the bind
+#ifdef _WIN32
+        ::DeleteFileA (szSocketPath);
+#else
+        ::unlink (szSocketPath);
+#endif
+
+        if ( ::bind (m_hListen, reinterpret_cast<const sockaddr*>(&address), sizeof (address)) != 0 )
+        {
+            closeSocket (m_hListen);
+            m_hListen = g_hInvalidSocket;
+            return false;
+        }
+
+        strcpy (m_szSocketPath, szSocketPath);
+    }
+    else
+    {
+        sockaddr_in address = makeLoopbackAddress (wPort);
+
+        m_hListen = ::socket (AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if ( m_hListen == g_hInvalidSocket )
+            return false;
+
+        int iReuse = 1;
+        ::setsockopt (m_hListen, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&iReuse), sizeof (iReuse));
+
+        socklen_t cbAddress = sizeof (address);
+
+        if ( (::bind (m_hListen, reinterpret_cast<const sockaddr*>(&address), sizeof (address)) != 0) ||
+             (::getsockname (m_hListen, reinterpret_cast<sockaddr*>(&address), &cbAddress) != 0) )
+        {
+            closeSocket (m_hListen);
+            m_hListen = g_hInvalidSocket;
+            return false;
+        }
+
+        m_wPort = ntohs (address.sin_port);
+    }
+
+    if ( ::listen (m_hListen, SOMAXCONN) != 0 )
+    {
+        stop ( );
+        return false;
+    }
+
+    m_acceptThread = std::thread (&KenoService::acceptLoop, this);
+
+    KENO_TRACE_INFO (_T ("Query service listening"));
+
+    return true;
+}
+
+void KenoService::stop (void)
+{
+    m_bStop = true;
+
+    if ( m_hListen != g_hInvalidSocket )
+    {
+        // closing wakes accept on Windows, shutting down does elsewhere
+#ifdef _WIN32
+        closeSocket (m_hListen);
+#else
+        shutdownSocket (m_hListen);
+#endif
+    }
+
+    if ( m_acceptThread.joinable ( ) )
+        m_acceptThread.join ( );
+
+#ifndef _WIN32
+    if ( m_hListen != g_hInvalidSocket )
+        closeSocket (m_hListen);
+#endif
+
+    m_hListen = g_hInvalidSocket;
+
+    {
+        std::unique_lock<std::mutex> guard (m_lock);
+
+        // wakes every connection thread blocked in recv
+        for ( KenoSocket hSocket : m_rgConnections )
+            shutdownSocket (hSocket);
+
+        m_cvIdle.wait (guard, [&] { return m_rgConnections.empty ( ); });
+    }
+
+    if ( m_szSocketPath[0] != '\0' )
+    {
+#ifdef _WIN32
+        ::DeleteFileA (m_szSocketPath);
+#else
+        ::unlink (m_szSocketPath);
+#endif
+        m_szSocketPath[0] = '\0';
+    }
+}
+
+void KenoService::acceptLoop (void)
+{
+    while ( !m_bStop )
+    {
+        const KenoSocket hSocket = ::accept (m_hListen, nullptr, nullptr);
+
+        if ( hSocket == g_hInvalidSocket )
+        {
+            if ( m_bStop )
+                break;
+
+#ifndef _WIN32
+            if ( (errno == EINTR) || (errno == ECONNABORTED) )
+                continue;
+#endif
+            KENO_TRACE_ERROR (_T ("Query service accept failed"));
+            break;
+        }
+
+        if ( m_szSocketPath[0] == '\0' )
+            setNoDelay (hSocket);
+
+        std::lock_guard<std::mutex> guard (m_lock);
+
+        if ( m_bStop )
+        {
+            closeSocket (hSocket);
+            break;
+        }
+
+        // a connection thread removes its socket and signals m_cvIdle when it ends
+        m_rgConnections.push_back (hSocket);
+        std::thread (&KenoService::serve, this, hSocket).detach ( );
+    }
+}
+
+/**
+  Serves one connection: answers every complete frame in the receive
+  buffer, sends their responses in one write and only then reads again,
+  so pipelined frames cost one system call each way per buffer.
+*/
+void KenoService::serve (KenoSocket hSocket)
+{
+    std::vector<BYTE> rgIn  (g_cbServiceReceiveBuffer + sizeof (KenoFrameHeader) + g_dwMaxQueriesPerFrame * sizeof (KenoQuery));
+    std::vector<BYTE> rgOut;
+    size_t            cbHave = 0;
+    bool              bOpen  = true;
+
+    rgOut.reserve (sizeof (KenoFrameHeader) + g_dwMaxQueriesPerFrame * sizeof (double));
+
+    const int nReader = m_pRegistry->registerReader ( );
+
+    if ( nReader < 0 )
+    {
+        KENO_TRACE_WARNING (_T ("Query service refusing a connection, all %d model readers are in use"), g_MAX_MODEL_READERS);
+        bOpen = false;
+    }
+
+    while ( bOpen && !m_bStop )
+    {
+        const int cbReceived = ::recv (hSocket, reinterpret_cast<char*>(rgIn.data ( ) + cbHave),
+                                       static_cast<int>(rgIn.size ( ) - cbHave), 0);
+        if ( cbReceived <= 0 )
+            break;
+
+        cbHave += cbReceived;
+
+        size_t cbUsed   = 0;
+        QWORD  qwFrames = 0;
+        QWORD  qwQueries = 0;
+
+        rgOut.clear ( );
+
+        // the whole buffer is answered from one model version
+        const KenoModel* pModel = m_pRegistry->enter (nReader);
+
+        while ( cbHave - cbUsed >= sizeof (KenoFrameHeader) )
+        {
+            KenoFrameHeader header;
+            memcpy (&header, rgIn.data ( ) + cbUsed, sizeof (header));
+
+            if ( (header.dwMagic != g_dwQueryMagic) || (header.dwCount == 0) ||
+                 (header.dwCount > g_dwMaxQueriesPerFrame) )
+            {
+                KENO_TRACE_WARNING (_T ("Query service closing a connection after a malformed frame"));
+                bOpen = false;
+                break;
+            }
+
+            const size_t cbFrame = sizeof (header) + header.dwCount * sizeof (KenoQuery);
+
+            if ( cbHave - cbUsed < cbFrame )
+                break;
+
+            const size_t cbOut = rgOut.size ( );
+            rgOut.resize (cbOut + sizeof (KenoFrameHeader) + header.dwCount * sizeof (double));
+
+            const KenoFrameHeader response = { g_dwResultMagic, header.dwCount };
+            memcpy (rgOut.data ( ) + cbOut, &response, sizeof (response));
+
+            // the frame headers keep every result 8 byte aligned in the output buffer
+            answerQueries (*pModel, reinterpret_cast<const KenoQuery*>(rgIn.data ( ) + cbUsed + sizeof (header)),
+                           header.dwCount, reinterpret_cast<double*>(rgOut.data ( ) + cbOut + sizeof (response)));
+
+            cbUsed    += cbFrame;
+            qwFrames  += 1;
+            qwQueries += header.dwCount;
+        }
+
+        // the results are copied out, so a publisher need not wait for the send
+        m_pRegistry->leave (nReader);
+
+        if ( !rgOut.empty ( ) && !sendAll (hSocket, rgOut.data ( ), rgOut.size ( )) )
+            break;
+
+        m_qwNumFrames.fetch_add  (qwFrames,  std::memory_order_relaxed);
+        m_qwNumQueries.fetch_add (qwQueries, std::memory_order_relaxed);
+
+        // keeps the start of an incomplete frame
+        memmove (rgIn.data ( ), rgIn.data ( ) + cbUsed, cbHave - cbUsed);
+        cbHave -= cbUsed;
+    }
+
+    if ( nReader >= 0 )
+        m_pRegistry->unregisterReader (nReader);
+
+    std::lock_guard<std::mutex> guard (m_lock);
+
+    for ( auto it = m_rgConnections.begin ( ); it != m_rgConnections.end ( ); ++it )
+    {
+        if ( *it == hSocket )
+        {
+            m_rgConnections.erase (it);
+            break;
+        }
+    }
+
+    closeSocket (hSocket);
+
+    m_cvIdle.notify_all ( );
+}
+
+
+KenoServiceClient::KenoServiceClient ( )
+    : m_hSocket (g_hInvalidSocket)
+{
+}
+
+KenoServiceClient::~KenoServiceClient ( )
+{
+    close ( );
+}
+
+bool KenoServiceClient::connect (const char* szSocketPath, WORD wPort)
+{
+    close ( );
+    initSockets ( );
+
+    int iResult = -1;
+
+    if ( szSocketPath != nullptr )
+    {
+        sockaddr_un address;
+
+        if ( !makeUnixAddress (szSocketPath, address) )
+            return false;
+
+        m_hSocket = ::socket (AF_UNIX, SOCK_STREAM, 0);
+
+        if ( m_hSocket != g_hInvalidSocket )
+            iResult = ::connect (m_hSocket, reinterpret_cast<const sockaddr*>(&address), sizeof (address));
+    }
+    else
+    {
+        const sockaddr_in address = makeLoopbackAddress (wPort);
+
+        m_hSocket = ::socket (AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+        if ( m_hSocket != g_hInvalidSocket )
+        {
+            setNoDelay (m_hSocket);
+            iResult = ::connect (m_hSocket, reinterpret_cast<const sockaddr*>(&address), sizeof (address));
+        }
+    }
+
+    if ( iResult != 0 )
+    {
+        close ( );
+        return false;
+    }
+
+    return true;
+}
+
+void KenoServiceClient::close (void)
+{
+    if ( m_hSocket != g_hInvalidSocket )
+        closeSocket (m_hSocket);
+
+    m_hSocket = g_hInvalidSocket;
+}
+
+bool KenoServiceClient::query (const KenoQuery* rgQueries, DWORD dwCount, double* rgResults)
+{
+    if ( (m_hSocket == g_hInvalidSocket) || (dwCount == 0) || (dwCount > g_dwMaxQueriesPerFrame) )
+        return false;
+
+    const KenoFrameHeader header = { g_dwQueryMagic, dwCount };
+
+    m_rgBuffer.resize (sizeof (header) + dwCount * sizeof (KenoQuery));
+    memcpy (m_rgBuffer.data ( ), &header, sizeof (header));
+    memcpy (m_rgBuffer.data ( ) + sizeof (header), rgQueries, dwCount * sizeof (KenoQuery));
+
+    KenoFrameHeader response = { };
+
+    return sendAll (m_hSocket, m_rgBuffer.data ( ), m_rgBuffer.size ( ))                  &&
+           recvAll (m_hSocket, reinterpret_cast<BYTE*>(&response), sizeof (response))      &&
+           (response.dwMagic == g_dwResultMagic) && (response.dwCount == dwCount)          &&
+           recvAll (m_hSocket, reinterpret_cast<BYTE*>(rgResults), dwCount * sizeof (double));
+}
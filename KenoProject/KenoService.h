@@ -0,0 +1,151 @@
+/**
+@file       KenoService.h
+@brief      Local query service for probabilities, pay outs and pay table metrics
+
+  A long-running server answering batched binary queries from the web and
+  terminal backends over a Unix domain socket or a loopback TCP port.  The
+  answers come from the current KenoModel of a KenoModelRegistry, an
+  immutable snapshot of the probability matrix and of every pay table with
+  its derived metrics, so a query is a handful of table lookups.  A new
+  model may be published at any time; every receive buffer is answered
+  from a single model version.
+
+  Protocol (little endian, both directions framed the same way):
+
+      request   KenoFrameHeader { g_dwQueryMagic,  n }  KenoQuery [n]
+      response  KenoFrameHeader { g_dwResultMagic, n }  double    [n]
+
+  with 1 <= n <= g_dwMaxQueriesPerFrame.  Results are in query order; an
+  invalid query (unknown type or pay table, spots or catch out of range)
+  answers NaN.  A client may pipeline frames; a malformed header closes the
+  connection.  Each connection is served by its own thread, which holds one
+  of the g_MAX_MODEL_READERS reader slots of the registry.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_SERVICE_H__
+#define __KENO_SERVICE_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "KenoModel.h"
+
+constexpr const DWORD g_dwQueryMagic          = 0x31514E4B;   //< 'KNQ1'
+constexpr const DWORD g_dwResultMagic         = 0x31524E4B;   //< 'KNR1'
+constexpr const DWORD g_dwMaxQueriesPerFrame  = 4096;
+constexpr const WORD  g_wDefaultServicePort   = 7480;         //< loopback TCP port of '-serve tcp'
+
+#ifdef _WIN32
+    typedef UINT_PTR KenoSocket;
+#else
+    typedef int      KenoSocket;
+#endif
+
+enum KenoQueryType
+{
+    KENO_QUERY_PROBABILITY = 0,     //< P (catch | spots), bPayTable ignored
+    KENO_QUERY_PAY_OUT,             //< pay out of a $1 bet for (spots, catch)
+    KENO_QUERY_RTP,                 //< expected return of a $1 bet for spots
+    KENO_QUERY_HIT_RATE,            //< probability of any pay out for spots
+    KENO_QUERY_STD_DEV,             //< standard deviation of the return of a $1 bet for spots
+    KENO_QUERY_TYPE_COUNT
+};
+
+struct KenoQuery
+{
+    BYTE bType;                     //< KenoQueryType
+    BYTE bPayTable;                 //< index into the model's pay tables
+    BYTE bSpots;                    //< spots marked, 1 .. g_MAX_ROWS (g_MAX_SPOTS_MARKED for pay tables)
+    BYTE bCatch;                    //< catch size, 0 .. spots
+};
+
+struct KenoFrameHeader
+{
+    DWORD dwMagic;
+    DWORD dwCount;
+};
+
+/**
+  @brief answers 'dwCount' queries from 'model' into 'rgResults'
+*/
+void answerQueries (const KenoModel& model, const KenoQuery* rgQueries, DWORD dwCount, double* rgResults);
+
+
+class KenoService
+{
+public:
+    KenoService  ( );
+    ~KenoService ( );
+
+    /**
+      @brief starts listening and serving the models of 'pRegistry'
+
+      @param [in] szSocketPath  Unix domain socket path, or nullptr to listen
+                                on the loopback TCP port 'wPort' instead
+      @param [in] wPort         loopback TCP port, 0 for any free port
+      @param [in] pRegistry     registry with a published model, kept by the caller
+
+      @retval bool              true if the service is listening
+    */
+    bool start (const char* szSocketPath, WORD wPort, KenoModelRegistry* pRegistry);
+
+    /**
+      @brief stops listening, closes every connection and waits for their threads
+    */
+    void stop  (void);
+
+    WORD  getPort         (void) const { return m_wPort; }
+    QWORD getNumQueries   (void) const { return m_qwNumQueries.load (std::memory_order_relaxed); }
+    QWORD getNumFrames    (void) const { return m_qwNumFrames.load (std::memory_order_relaxed); }
+
+private:
+    void acceptLoop (void);
+    void serve      (KenoSocket hSocket);
+
+    KenoSocket                  m_hListen;
+    WORD                        m_wPort;
+    char                        m_szSocketPath[108];
+    KenoModelRegistry*          m_pRegistry;
+    std::atomic<bool>           m_bStop;
+    std::atomic<QWORD>          m_qwNumQueries;
+    std::atomic<QWORD>          m_qwNumFrames;
+    std::thread                 m_acceptThread;
+    std::mutex                  m_lock;             //< guards the connections
+    std::condition_variable     m_cvIdle;           //< signalled when a connection ends
+    std::vector<KenoSocket>     m_rgConnections;    //< one serving thread each
+};
+
+/**
+  A blocking client, used by the benchmarks and by tools.
+*/
+class KenoServiceClient
+{
+public:
+    KenoServiceClient  ( );
+    ~KenoServiceClient ( );
+
+    /**
+      @brief connects to a Unix domain socket, or to the loopback TCP port
+             'wPort' if 'szSocketPath' is nullptr
+    */
+    bool connect (const char* szSocketPath, WORD wPort);
+    void close   (void);
+
+    /**
+      @brief sends one frame of 'dwCount' queries and waits for the results
+
+      @retval bool              false if the connection failed
+    */
+    bool query   (const KenoQuery* rgQueries, DWORD dwCount, double* rgResults);
+
+private:
+    KenoSocket        m_hSocket;
+    std::vector<BYTE> m_rgBuffer;
+};
+
+#endif
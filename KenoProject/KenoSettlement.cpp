@@ -0,0 +1,198 @@
+/**
+@file       KenoSettlement.cpp
+@brief      Implementation of ticket settlement
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include "KenoSettlement.h"
+
+
+void buildPayLookup (const KenoPayTable& payTable, KenoPayLookup& lookup)
+{
+    for ( int m = 0; m <= g_MAX_SPOTS_MARKED; m++ )
+    {
+        for ( int c = 0; c < g_MAX_COLS; c++ )
+        {
+            const bool bPays = (m > 0) && (c > 0) && (c <= m);
+
+            lookup.rgPay[m][c] = bPays ? payTable.rgPayOut[m - 1][c - 1] : 0.0;
+        }
+    }
+}
+
+void KenoTicketStore::reserve (size_t nTickets)
+{
+    rgMaskLo.reserve (nTickets);
+    rgMaskHi.reserve (nTickets);
+    rgSpots.reserve  (nTickets);
+    rgWager.reserve  (nTickets);
+}
+
+void KenoTicketStore::clear (void)
+{
+    rgMaskLo.clear ( );
+    rgMaskHi.clear ( );
+    rgSpots.clear  ( );
+    rgWager.clear  ( );
+}
+
+bool KenoTicketStore::add (const KenoTicket& ticket)
+{
+    // balls 81 .. 128 do not exist
+    const QWORD qwValidHi = (1ULL << (g_TOTAL_BALLS - 64)) - 1;
+
+    if ( (ticket.dwSpots < 1) || (ticket.dwSpots > static_cast<DWORD>(g_MAX_SPOTS_MARKED)) ||
+         ((ticket.qwMaskHi & ~qwValidHi) != 0) ||
+         (countBits (ticket.qwMaskLo) + countBits (ticket.qwMaskHi) != ticket.dwSpots) )
+        return false;
+
+    rgMaskLo.push_back (ticket.qwMaskLo);
+    rgMaskHi.push_back (ticket.qwMaskHi);
+    rgSpots.push_back  (static_cast<BYTE>(ticket.dwSpots));
+    rgWager.push_back  (ticket.fWager);
+
+    return true;
+}
+
+/// slot of a mask in the hash table of aggregateTickets
+static inline size_t hashMask (QWORD qwMaskLo, QWORD qwMaskHi, size_t nSlotMask)
+{
+    QWORD qwHash = (qwMaskLo * 0x9E3779B97F4A7C15ULL) ^ (qwMaskHi * 0xC2B2AE3D27D4EB4FULL);
+
+    qwHash ^= qwHash >> 29;
+
+    return static_cast<size_t>(qwHash) & nSlotMask;
+}
+
+bool aggregateTickets (const KenoTicketStore& store, KenoTicketAggregate& aggregate)
+{
+    const size_t nTickets = store.size ( );
+
+    aggregate.masks.clear ( );
+    aggregate.rgFirstTicket.clear ( );
+    aggregate.rgTickets.clear ( );
+
+    if ( static_cast<QWORD>(nTickets) >= 0xFFFFFFFFULL )
+        return false;
+
+    // at most half full, so a probe rarely passes more than one other mask
+    size_t nSlots = 16;
+
+    while ( nSlots < 2 * nTickets )
+        nSlots <<= 1;
+
+    std::vector<DWORD> rgSlots  (nSlots, 0);    //< distinct mask + 1, 0 for an empty slot
+    std::vector<DWORD> rgMaskOf (nTickets);
+    KenoTicketStore&   masks = aggregate.masks;
+
+    for ( size_t i = 0; i < nTickets; i++ )
+    {
+        const QWORD qwMaskLo = store.rgMaskLo[i];
+        const QWORD qwMaskHi = store.rgMaskHi[i];
+        size_t      nSlot    = hashMask (qwMaskLo, qwMaskHi, nSlots - 1);
+
+        while ( (rgSlots[nSlot] != 0) &&
+                ((masks.rgMaskLo[rgSlots[nSlot] - 1] != qwMaskLo) || (masks.rgMaskHi[rgSlots[nSlot] - 1] != qwMaskHi)) )
+            nSlot = (nSlot + 1) & (nSlots - 1);
+
+        if ( rgSlots[nSlot] == 0 )
+        {
+            masks.rgMaskLo.push_back (qwMaskLo);
+            masks.rgMaskHi.push_back (qwMaskHi);
+            masks.rgSpots.push_back  (store.rgSpots[i]);
+            masks.rgWager.push_back  (0.0);
+
+            rgSlots[nSlot] = static_cast<DWORD>(masks.size ( ));
+        }
+
+        const DWORD dwMask = rgSlots[nSlot] - 1;
+
+        masks.rgWager[dwMask] += store.rgWager[i];
+        rgMaskOf[i]            = dwMask;
+    }
+
+    // the tickets of every mask, in store order
+    aggregate.rgFirstTicket.assign (masks.size ( ) + 1, 0);
+    aggregate.rgTickets.resize (nTickets);
+
+    for ( size_t i = 0; i < nTickets; i++ )
+        aggregate.rgFirstTicket[rgMaskOf[i] + 1]++;
+
+    for ( size_t g = 0; g < masks.size ( ); g++ )
+        aggregate.rgFirstTicket[g + 1] += aggregate.rgFirstTicket[g];
+
+    std::vector<DWORD> rgNext (aggregate.rgFirstTicket.begin ( ), aggregate.rgFirstTicket.end ( ) - 1);
+
+    for ( size_t i = 0; i < nTickets; i++ )
+        aggregate.rgTickets[rgNext[rgMaskOf[i]]++] = static_cast<DWORD>(i);
+
+    return true;
+}
+
+double settleTicketArrays (const QWORD* rgMaskLo, const QWORD* rgMaskHi, const BYTE* rgSpots, const double* rgWager,
+                           size_t nTickets, const KenoPayLookup& lookup, const KenoDraw& draw, double* rgPayOut)
+{
+    double fPayOut = 0.0;
+
+    if ( rgPayOut == nullptr )
+    {
+        for ( size_t i = 0; i < nTickets; i++ )
+        {
+            const DWORD dwCatch = countBits (rgMaskLo[i] & draw.qwMaskLo) + countBits (rgMaskHi[i] & draw.qwMaskHi);
+
+            fPayOut += rgWager[i] * lookup.rgPay[rgSpots[i]][dwCatch];
+        }
+    }
+    else
+    {
+        for ( size_t i = 0; i < nTickets; i++ )
+        {
+            const DWORD dwCatch = countBits (rgMaskLo[i] & draw.qwMaskLo) + countBits (rgMaskHi[i] & draw.qwMaskHi);
+
+            rgPayOut[i] = rgWager[i] * lookup.rgPay[rgSpots[i]][dwCatch];
+            fPayOut    += rgPayOut[i];
+        }
+    }
+
+    return fPayOut;
+}
+
+double settleTickets (const KenoTicketStore& store, const KenoPayLookup& lookup, const KenoDraw& draw,
+                      size_t nBegin, size_t nEnd)
+{
+    return settleTicketArrays (store.rgMaskLo.data ( ) + nBegin, store.rgMaskHi.data ( ) + nBegin,
+                               store.rgSpots.data ( ) + nBegin, store.rgWager.data ( ) + nBegin,
+                               nEnd - nBegin, lookup, draw, nullptr);
+}
+
+double settleAggregateWinners (const KenoTicketAggregate& aggregate, const KenoTicketStore& store,
+                               const KenoPayLookup& lookup, const KenoDraw& draw, size_t nBegin, size_t nEnd,
+                               std::vector<KenoTicketPayOut>& rgWinners)
+{
+    const KenoTicketStore& masks   = aggregate.masks;
+    double                 fPayOut = 0.0;
+
+    for ( size_t g = nBegin; g < nEnd; g++ )
+    {
+        const DWORD  dwCatch = countBits (masks.rgMaskLo[g] & draw.qwMaskLo) + countBits (masks.rgMaskHi[g] & draw.qwMaskHi);
+        const double fPay    = lookup.rgPay[masks.rgSpots[g]][dwCatch];
+
+        // most masks pay nothing, and their tickets are never touched
+        if ( fPay == 0.0 )
+            continue;
+
+        fPayOut += masks.rgWager[g] * fPay;
+
+        for ( DWORD k = aggregate.rgFirstTicket[g]; k < aggregate.rgFirstTicket[g + 1]; k++ )
+        {
+            const DWORD dwTicket = aggregate.rgTickets[k];
+
+            rgWinners.push_back ({ dwTicket, store.rgWager[dwTicket] * fPay });
+        }
+    }
+
+    return fPayOut;
+}
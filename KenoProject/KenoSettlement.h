@@ -0,0 +1,166 @@
+/**
+@file       KenoSettlement.h
+@brief      Ticket settlement declarations
+
+  Tickets are kept as a structure of arrays: settling a draw streams through
+  the ball masks, computes each catch with an AND + population count and
+  looks the pay out up in a flat [spots][catch] table, without branches.
+
+  Favourite numbers and repeated quick picks make many tickets of a draw
+  identical.  A KenoTicketAggregate holds the distinct masks of a store
+  with their summed wagers, so a draw counts the catch of each distinct
+  mask once, and only the tickets of the winning masks are visited to pay
+  them out.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_SETTLEMENT_H__
+#define __KENO_SETTLEMENT_H__
+
+#include <vector>
+#include "KenoProbability.h"
+#include "KenoSimulator.h"
+
+/**
+  A wagered ticket; ball 'n' (1..80) maps to bit 'n - 1' of the 80 bit
+  mask, as in KenoDraw
+*/
+struct KenoTicket
+{
+    QWORD  qwMaskLo;            //< balls  1 .. 64
+    QWORD  qwMaskHi;            //< balls 65 .. 80
+    DWORD  dwSpots;             //< 1 .. g_MAX_SPOTS_MARKED, the number of bits set in the mask
+    double fWager;
+};
+
+/**
+  Pay out of a $1 wager indexed by [spots marked][catch size], zero where
+  the pay table pays nothing (including the unused row 0 and catch 0)
+*/
+struct KenoPayLookup
+{
+    double rgPay[g_MAX_SPOTS_MARKED + 1][g_MAX_COLS];
+};
+
+/**
+  @brief fills the pay out lookup of a pay table
+*/
+void buildPayLookup (const KenoPayTable& payTable, KenoPayLookup& lookup);
+
+struct KenoTicketStore
+{
+    std::vector<QWORD>  rgMaskLo;
+    std::vector<QWORD>  rgMaskHi;
+    std::vector<BYTE>   rgSpots;
+    std::vector<double> rgWager;
+
+    size_t size    (void) const { return rgMaskLo.size ( ); }
+    void   reserve (size_t nTickets);
+    void   clear   (void);
+
+    /**
+      @brief appends a ticket
+
+      @retval bool          false, and the ticket is not added, if its spot
+                            count is out of range or does not match its mask
+    */
+    bool   add     (const KenoTicket& ticket);
+};
+
+/// pay out of a single ticket, as fanned out by settleAggregateWinners
+struct KenoTicketPayOut
+{
+    DWORD  dwTicket;            //< index in the KenoTicketStore
+    double fPayOut;
+};
+
+/**
+  The distinct masks of a KenoTicketStore.  'masks' holds every distinct
+  mask once, in the order it was first played, with the sum of the wagers
+  of its tickets; the tickets playing mask 'g' are rgTickets[rgFirstTicket[g]]
+  .. rgTickets[rgFirstTicket[g + 1] - 1], in store order.
+*/
+struct KenoTicketAggregate
+{
+    KenoTicketStore    masks;
+    std::vector<DWORD> rgFirstTicket;   //< one more entry than masks
+    std::vector<DWORD> rgTickets;
+
+    size_t getNumMasks   (void) const { return masks.size ( ); }
+    size_t getNumTickets (void) const { return rgTickets.size ( ); }
+
+    /// tickets per distinct mask, the factor by which aggregation cuts the catch counting
+    double getDuplication (void) const
+    {
+        return masks.size ( ) ? static_cast<double>(rgTickets.size ( )) / masks.size ( ) : 0.0;
+    }
+};
+
+/**
+  @brief aggregateTickets
+
+  Groups the tickets of 'store' by mask in an open addressing hash table.
+
+  @param [in]  store        tickets of one pay table
+  @param [out] aggregate    receives the distinct masks
+
+  @retval bool              false if the store holds 2^32 - 1 tickets or more
+*/
+bool aggregateTickets (const KenoTicketStore& store, KenoTicketAggregate& aggregate);
+
+/**
+  @brief settleTicketArrays
+
+  Settles tickets held in caller owned arrays, laid out like KenoTicketStore.
+
+  @param [in]  rgMaskLo     balls 1 .. 64 of every ticket
+  @param [in]  rgMaskHi     balls 65 .. 80 of every ticket
+  @param [in]  rgSpots      spots marked, 1 .. g_MAX_SPOTS_MARKED
+  @param [in]  rgWager      wager of every ticket
+  @param [in]  nTickets     number of tickets
+  @param [in]  lookup       pay out lookup of the tickets' pay table
+  @param [in]  draw         the game to settle against
+  @param [out] rgPayOut     receives the pay out of every ticket, or nullptr
+
+  @retval double            total pay out
+*/
+double settleTicketArrays (const QWORD* rgMaskLo, const QWORD* rgMaskHi, const BYTE* rgSpots, const double* rgWager,
+                           size_t nTickets, const KenoPayLookup& lookup, const KenoDraw& draw, double* rgPayOut);
+
+/**
+  @brief settleTickets
+
+  @param [in] store         tickets to settle
+  @param [in] lookup        pay out lookup of the tickets' pay table
+  @param [in] draw          the game to settle against
+  @param [in] nBegin        first ticket
+  @param [in] nEnd          one past the last ticket
+
+  @retval double            total pay out of tickets nBegin .. nEnd - 1
+*/
+double settleTickets (const KenoTicketStore& store, const KenoPayLookup& lookup, const KenoDraw& draw,
+                      size_t nBegin, size_t nEnd);
+
+/**
+  @brief settleAggregateWinners
+
+  Counts the catch of the distinct masks nBegin .. nEnd - 1 of 'aggregate'
+  and appends the pay out of every ticket of a winning mask to 'rgWinners'.
+
+  @param [in]  aggregate    distinct masks of 'store'
+  @param [in]  store        the tickets aggregated
+  @param [in]  lookup       pay out lookup of the tickets' pay table
+  @param [in]  draw         the game to settle against
+  @param [in]  nBegin       first distinct mask
+  @param [in]  nEnd         one past the last distinct mask
+  @param [out] rgWinners    receives the winning tickets; not cleared first
+
+  @retval double            total pay out of the tickets of masks nBegin .. nEnd - 1
+*/
+double settleAggregateWinners (const KenoTicketAggregate& aggregate, const KenoTicketStore& store,
+                               const KenoPayLookup& lookup, const KenoDraw& draw, size_t nBegin, size_t nEnd,
+                               std::vector<KenoTicketPayOut>& rgWinners);
+
+#endif
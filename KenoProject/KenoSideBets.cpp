@@ -0,0 +1,316 @@
+/**
+@file       KenoSideBets.cpp
+@brief      Implementation of the side bet distribution engine
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "KenoSideBets.h"
+#include "KenoSimulator.h"
+
+
+KenoPartition g_rgPartitions[KENO_PARTITION_COUNT] =
+{
+    { _T("Top/Bottom"), 2,  { 0 } },
+    { _T("Odd/Even"),   2,  { 0 } },
+    { _T("Rows"),       8,  { 0 } },
+    { _T("Columns"),    10, { 0 } },
+};
+
+const KenoSideBet g_rgSideBets[KENO_SIDE_BET_COUNT] =
+{
+    { _T("Top Half"),  KENO_PARTITION_HALVES,  KENO_STAT_COUNT_IN_GROUPS, 0x001 },
+    { _T("Odd"),       KENO_PARTITION_PARITY,  KENO_STAT_COUNT_IN_GROUPS, 0x001 },
+    { _T("Row 1"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x001 },
+    { _T("Row 2"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x002 },
+    { _T("Row 3"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x004 },
+    { _T("Row 4"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x008 },
+    { _T("Row 5"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x010 },
+    { _T("Row 6"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x020 },
+    { _T("Row 7"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x040 },
+    { _T("Row 8"),     KENO_PARTITION_ROWS,    KENO_STAT_COUNT_IN_GROUPS, 0x080 },
+    { _T("Column 1"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x001 },
+    { _T("Column 2"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x002 },
+    { _T("Column 3"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x004 },
+    { _T("Column 4"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x008 },
+    { _T("Column 5"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x010 },
+    { _T("Column 6"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x020 },
+    { _T("Column 7"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x040 },
+    { _T("Column 8"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x080 },
+    { _T("Column 9"),  KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x100 },
+    { _T("Column 10"), KENO_PARTITION_COLUMNS, KENO_STAT_COUNT_IN_GROUPS, 0x200 },
+    { _T("Max Row"),    KENO_PARTITION_ROWS,    KENO_STAT_MAX_GROUP_COUNT, 0 },
+    { _T("Max Column"), KENO_PARTITION_COLUMNS, KENO_STAT_MAX_GROUP_COUNT, 0 },
+};
+
+double g_rgSideBetProbability[KENO_SIDE_BET_COUNT][g_BALLS_DRAWN + 1] = { { 0.0 } };
+
+
+/// generating polynomial truncated at the number of drawn balls
+typedef double KenoPolynomial[g_BALLS_DRAWN + 1];
+
+/// Pascal's triangle of C (n, k) for n <= 80, k <= 20, as doubles
+static double s_rgBinomial[g_TOTAL_BALLS + 1][g_BALLS_DRAWN + 1] = { { 0.0 } };
+
+static void buildBinomialTable (void)
+{
+    for ( int n = 0; n <= g_TOTAL_BALLS; n++ )
+    {
+        s_rgBinomial[n][0] = 1.0;
+
+        for ( int k = 1; (k <= n) && (k <= g_BALLS_DRAWN); k++ )
+            s_rgBinomial[n][k] = s_rgBinomial[n - 1][k - 1] + ((k < n) ? s_rgBinomial[n - 1][k] : 0.0);
+    }
+}
+
+/**
+  @brief multiplies 'polyAcc' in place by the group polynomial 
+         sum ( C (dwGroupSize, c) * x^c ), for c = 0 .. dwMaxCount
+*/
+static void multiplyGroupPolynomial (KenoPolynomial& polyAcc, DWORD dwGroupSize, DWORD dwMaxCount)
+{
+    KenoPolynomial polyResult = { 0.0 };
+
+    for ( int t = 0; t <= g_BALLS_DRAWN; t++ )
+    {
+        if ( polyAcc[t] == 0.0 )
+            continue;
+
+        for ( DWORD c = 0; (c <= dwGroupSize) && (c <= dwMaxCount) && (t + c <= g_BALLS_DRAWN); c++ )
+            polyResult[t + c] += polyAcc[t] * s_rgBinomial[dwGroupSize][c];
+    }
+
+    for ( int t = 0; t <= g_BALLS_DRAWN; t++ )
+        polyAcc[t] = polyResult[t];
+}
+
+static void calcGroupSizes (const KenoPartition& partition, DWORD (&rgGroupSize)[g_MAX_PARTITION_GROUPS])
+{
+    for ( int k = 0; k < g_MAX_PARTITION_GROUPS; k++ )
+        rgGroupSize[k] = 0;
+
+    for ( int n = 0; n < g_TOTAL_BALLS; n++ )
+        rgGroupSize[partition.rgGroupOfBall[n]]++;
+}
+
+void calcPartitionCountDistribution (const KenoPartition& partition, DWORD dwSelectedGroups,
+                                     double (&rgDistribution)[g_BALLS_DRAWN + 1])
+{
+    DWORD rgGroupSize[g_MAX_PARTITION_GROUPS];
+    calcGroupSizes (partition, rgGroupSize);
+
+    // A(x) collects the selected groups, B(x) the remaining ones
+    KenoPolynomial polySelected = { 1.0 };
+    KenoPolynomial polyOther    = { 1.0 };
+
+    for ( int k = 0; k < partition.nGroups; k++ )
+    {
+        if ( dwSelectedGroups & (1UL << k) )
+            multiplyGroupPolynomial (polySelected, rgGroupSize[k], g_BALLS_DRAWN);
+        else
+            multiplyGroupPolynomial (polyOther,    rgGroupSize[k], g_BALLS_DRAWN);
+    }
+
+    // P(m) = [x^m] A(x) * [x^(20-m)] B(x) / C (80, 20)
+    const double fTotalDraws = s_rgBinomial[g_TOTAL_BALLS][g_BALLS_DRAWN];
+
+    for ( int m = 0; m <= g_BALLS_DRAWN; m++ )
+        rgDistribution[m] = polySelected[m] * polyOther[g_BALLS_DRAWN - m] / fTotalDraws;
+}
+
+void calcPartitionMaxDistribution (const KenoPartition& partition, double (&rgDistribution)[g_BALLS_DRAWN + 1])
+{
+    DWORD rgGroupSize[g_MAX_PARTITION_GROUPS];
+    calcGroupSizes (partition, rgGroupSize);
+
+    const double fTotalDraws = s_rgBinomial[g_TOTAL_BALLS][g_BALLS_DRAWN];
+    double       fPrevCumulative = 0.0;
+
+    for ( int m = 0; m <= g_BALLS_DRAWN; m++ )
+    {
+        // P(max <= m) = [x^20] product of the group polynomials truncated at degree m
+        KenoPolynomial polyAcc = { 1.0 };
+
+        for ( int k = 0; k < partition.nGroups; k++ )
+            multiplyGroupPolynomial (polyAcc, rgGroupSize[k], m);
+
+        const double fCumulative = polyAcc[g_BALLS_DRAWN] / fTotalDraws;
+
+        rgDistribution[m] = fCumulative - fPrevCumulative;
+        fPrevCumulative   = fCumulative;
+    }
+}
+
+void buildSideBetTables (void)
+{
+    buildBinomialTable ( );
+
+    for ( int n = 0; n < g_TOTAL_BALLS; n++ )
+    {
+        g_rgPartitions[KENO_PARTITION_HALVES ].rgGroupOfBall[n] = static_cast<BYTE>(n / (g_TOTAL_BALLS / 2));
+        g_rgPartitions[KENO_PARTITION_PARITY ].rgGroupOfBall[n] = static_cast<BYTE>(n % 2);  // ball n + 1
+        g_rgPartitions[KENO_PARTITION_ROWS   ].rgGroupOfBall[n] = static_cast<BYTE>(n / 10);
+        g_rgPartitions[KENO_PARTITION_COLUMNS].rgGroupOfBall[n] = static_cast<BYTE>(n % 10);
+    }
+
+    for ( int b = 0; b < KENO_SIDE_BET_COUNT; b++ )
+    {
+        const KenoSideBet&   bet       = g_rgSideBets[b];
+        const KenoPartition& partition = g_rgPartitions[bet.ePartition];
+
+        if ( bet.eStatistic == KENO_STAT_COUNT_IN_GROUPS )
+            calcPartitionCountDistribution (partition, bet.dwSelectedGroups, g_rgSideBetProbability[b]);
+        else
+            calcPartitionMaxDistribution   (partition, g_rgSideBetProbability[b]);
+    }
+}
+
+
+/// ball masks of a side bet, prepared once for the simulation
+struct SideBetMasks
+{
+    int   nMasks;                               //< 1 for a count, nGroups for a maximum
+    QWORD rgMaskLo[g_MAX_PARTITION_GROUPS];
+    QWORD rgMaskHi[g_MAX_PARTITION_GROUPS];
+};
+
+/// per thread tallies of every side bet's statistic
+struct SideBetHistogram
+{
+    QWORD rgCount[KENO_SIDE_BET_COUNT][g_BALLS_DRAWN + 1];
+};
+
+static void sideBetWorker (const SideBetMasks* rgMasks, QWORD qwNumDraws, QWORD qwSeed, SideBetHistogram& histogram)
+{
+    KenoRng  rng;
+    KenoDraw draw;
+
+    rng.seed (qwSeed);
+
+    for ( QWORD n = 0; n < qwNumDraws; n++ )
+    {
+        drawKenoBalls (rng, draw);
+
+        for ( int b = 0; b < KENO_SIDE_BET_COUNT; b++ )
+        {
+            DWORD dwValue = 0;
+
+            for ( int k = 0; k < rgMasks[b].nMasks; k++ )
+            {
+                const DWORD dwCount = countCatch (draw, rgMasks[b].rgMaskLo[k], rgMasks[b].rgMaskHi[k]);
+                if ( dwCount > dwValue )
+                    dwValue = dwCount;
+            }
+
+            histogram.rgCount[b][dwValue]++;
+        }
+    }
+}
+
+int crossCheckSideBets (QWORD qwNumDraws, QWORD qwSeed, double fZScore)
+{
+    SideBetMasks rgMasks[KENO_SIDE_BET_COUNT] = { };
+
+    for ( int b = 0; b < KENO_SIDE_BET_COUNT; b++ )
+    {
+        const KenoSideBet&   bet       = g_rgSideBets[b];
+        const KenoPartition& partition = g_rgPartitions[bet.ePartition];
+        SideBetMasks&        masks     = rgMasks[b];
+
+        masks.nMasks = (bet.eStatistic == KENO_STAT_COUNT_IN_GROUPS) ? 1 : partition.nGroups;
+
+        for ( int n = 0; n < g_TOTAL_BALLS; n++ )
+        {
+            const DWORD dwGroup = partition.rgGroupOfBall[n];
+            int         iMask   = static_cast<int>(dwGroup);
+
+            if ( bet.eStatistic == KENO_STAT_COUNT_IN_GROUPS )
+            {
+                if ( (bet.dwSelectedGroups & (1UL << dwGroup)) == 0 )
+                    continue;
+                iMask = 0;
+            }
+
+            if ( n < 64 )
+                masks.rgMaskLo[iMask] |= 1ULL << n;
+            else
+                masks.rgMaskHi[iMask] |= 1ULL << (n - 64);
+        }
+    }
+
+    const DWORD dwNumThreads = getWorkerThreadCount ( );
+
+    std::vector<SideBetHistogram> rgHistograms (dwNumThreads, SideBetHistogram ( ));
+    std::vector<std::thread>      rgThreads;
+
+    QWORD qwStreamSeed = qwSeed;
+
+    for ( DWORD t = 0; t < dwNumThreads; t++ )
+    {
+        const QWORD qwDraws = qwNumDraws / dwNumThreads + ((t < qwNumDraws % dwNumThreads) ? 1 : 0);
+
+        rgThreads.emplace_back (sideBetWorker, rgMasks, qwDraws, splitMix64 (qwStreamSeed), std::ref (rgHistograms[t]));
+    }
+
+    for ( auto& thread : rgThreads )
+        thread.join ( );
+
+    int nOutOfBand = 0;
+
+    const double fN = static_cast<double>(qwNumDraws);
+
+    for ( int b = 0; b < KENO_SIDE_BET_COUNT; b++ )
+    {
+        double fPoolExact  = 0.0;    // the outcomes too rare to be checked on their own
+        QWORD  qwPoolCount = 0;
+
+        for ( int m = 0; m <= g_BALLS_DRAWN; m++ )
+        {
+            QWORD qwCount = 0;
+            for ( const auto& histogram : rgHistograms )
+                qwCount += histogram.rgCount[b][m];
+
+            const double fExact    = g_rgSideBetProbability[b][m];
+            const double fObserved = static_cast<double>(qwCount) / fN;
+            const double fStdError = std::sqrt (fExact * (1.0 - fExact) / fN);
+
+            if ( (fExact == 0.0) && (qwCount != 0) )
+            {
+                _tprintf (_T ("  Side bet '%s' value %d: impossible, simulated %.8f  OUT OF BAND\n"),
+                          g_rgSideBets[b].szName, m, fObserved);
+                nOutOfBand++;
+            }
+            else if ( fExact * fN < g_fMinSideBetExpectedCount )
+            {
+                fPoolExact  += fExact;
+                qwPoolCount += qwCount;
+            }
+            else if ( std::fabs (fObserved - fExact) > fZScore * fStdError )
+            {
+                _tprintf (_T ("  Side bet '%s' value %d: exact %.8f  simulated %.8f  OUT OF BAND\n"),
+                          g_rgSideBets[b].szName, m, fExact, fObserved);
+                nOutOfBand++;
+            }
+        }
+
+        if ( fPoolExact * fN >= g_fMinSideBetExpectedCount )
+        {
+            const double fObserved = static_cast<double>(qwPoolCount) / fN;
+            const double fStdError = std::sqrt (fPoolExact * (1.0 - fPoolExact) / fN);
+
+            if ( std::fabs (fObserved - fPoolExact) > fZScore * fStdError )
+            {
+                _tprintf (_T ("  Side bet '%s' rare values: exact %.8f  simulated %.8f  OUT OF BAND\n"),
+                          g_rgSideBets[b].szName, fPoolExact, fObserved);
+                nOutOfBand++;
+            }
+        }
+    }
+
+    return nOutOfBand;
+}
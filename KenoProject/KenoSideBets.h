@@ -0,0 +1,143 @@
+/**
+@file       KenoSideBets.h
+@brief      Side bet (top/bottom, odd/even, board row and column) declarations
+
+  A side bet pays on how the 20 drawn balls fall across a partition of the
+  80 balls into groups, e.g. the top and bottom half of the board, the odd
+  and even numbers, or the 8 rows and 10 columns of the 8 x 10 board.  The
+  number of drawn balls landing in a set of groups is a (multivariate)
+  hypergeometric variable, the distribution of which is computed exactly by
+  multiplying the generating polynomials of the groups:
+
+      ways (counts c1 .. cK) = C (g1, c1) * C (g2, c2) * ... * C (gK, cK)
+
+  where gk is the size of group k and c1 + ... + cK = 20, normalized by the
+  C (80, 20) possible draws.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_SIDE_BETS_H__
+#define __KENO_SIDE_BETS_H__
+
+#include "KenoProbability.h"
+
+constexpr const int g_MAX_PARTITION_GROUPS = 16;
+
+/// outcomes expected fewer times than this in a cross check are pooled, see crossCheckSideBets
+constexpr const double g_fMinSideBetExpectedCount = 5.0;
+
+/**
+  Assignment of every ball to one of 'nGroups' groups
+*/
+struct KenoPartition
+{
+    const TCHAR* szName;
+    int          nGroups;
+    BYTE         rgGroupOfBall[g_TOTAL_BALLS];     //< group of ball 'n' is at index 'n - 1'
+};
+
+enum KenoPartitionId
+{
+    KENO_PARTITION_HALVES = 0,      //< group 0 = balls 1..40, group 1 = balls 41..80
+    KENO_PARTITION_PARITY,          //< group 0 = odd balls, group 1 = even balls
+    KENO_PARTITION_ROWS,            //< 8 rows of 10 balls,    row    = (n - 1) / 10
+    KENO_PARTITION_COLUMNS,         //< 10 columns of 8 balls, column = (n - 1) % 10
+    KENO_PARTITION_COUNT
+};
+
+extern KenoPartition g_rgPartitions[KENO_PARTITION_COUNT];
+
+enum KenoSideBetStatistic
+{
+    KENO_STAT_COUNT_IN_GROUPS = 0,  //< number of drawn balls in the selected groups
+    KENO_STAT_MAX_GROUP_COUNT       //< largest number of drawn balls in any single group
+};
+
+struct KenoSideBet
+{
+    const TCHAR*         szName;
+    KenoPartitionId      ePartition;
+    KenoSideBetStatistic eStatistic;
+    DWORD                dwSelectedGroups;  //< bit mask of groups, KENO_STAT_COUNT_IN_GROUPS only
+};
+
+enum KenoSideBetId
+{
+    KENO_SIDE_BET_TOP_HALF = 0,
+    KENO_SIDE_BET_ODD,
+    KENO_SIDE_BET_ROW_1,
+    KENO_SIDE_BET_ROW_8      = KENO_SIDE_BET_ROW_1 + 7,
+    KENO_SIDE_BET_COLUMN_1,
+    KENO_SIDE_BET_COLUMN_10  = KENO_SIDE_BET_COLUMN_1 + 9,
+    KENO_SIDE_BET_MAX_ROW,
+    KENO_SIDE_BET_MAX_COLUMN,
+    KENO_SIDE_BET_COUNT
+};
+
+extern const KenoSideBet g_rgSideBets[KENO_SIDE_BET_COUNT];
+
+/// Cached distributions, [bet][statistic value 0 .. 20]
+extern double g_rgSideBetProbability[KENO_SIDE_BET_COUNT][g_BALLS_DRAWN + 1];
+
+/**
+  @brief O(1) lookup of the probability that a side bet's statistic equals 'dwValue'
+
+  @note buildSideBetTables must have been called beforehand
+*/
+inline double getSideBetProbability (KenoSideBetId eBet, DWORD dwValue)
+{
+    return (dwValue <= g_BALLS_DRAWN) ? g_rgSideBetProbability[eBet][dwValue] : 0.0;
+}
+
+/**
+  @brief calcPartitionCountDistribution
+
+  Computes the exact distribution of the number of drawn balls that land in
+  the selected groups of a partition.
+
+  @param [in]  partition            partition of the 80 balls
+  @param [in]  dwSelectedGroups     bit mask of the selected groups
+  @param [out] rgDistribution       receives P(count = m) for m = 0 .. 20
+*/
+void calcPartitionCountDistribution (const KenoPartition& partition, DWORD dwSelectedGroups,
+                                     double (&rgDistribution)[g_BALLS_DRAWN + 1]);
+
+/**
+  @brief calcPartitionMaxDistribution
+
+  Computes the exact distribution of the largest number of drawn balls that
+  land in any one group of a partition, from P(max <= m), i.e. the share of
+  draws in which every group holds at most m balls.
+
+  @param [in]  partition            partition of the 80 balls
+  @param [out] rgDistribution       receives P(max = m) for m = 0 .. 20
+*/
+void calcPartitionMaxDistribution (const KenoPartition& partition, double (&rgDistribution)[g_BALLS_DRAWN + 1]);
+
+/**
+  @brief Fills g_rgPartitions and g_rgSideBetProbability
+*/
+void buildSideBetTables (void);
+
+/**
+  @brief crossCheckSideBets
+
+  Simulates 'qwNumDraws' games and compares the observed frequency of every
+  side bet outcome against g_rgSideBetProbability.  The normal approximation
+  of the band only holds for outcomes expected g_fMinSideBetExpectedCount
+  times or more, so the rarer outcomes of a side bet are pooled into one
+  outcome, checked only once it is expected that often itself.  An outcome
+  of probability 0 that is observed is always out of band.
+
+  @param [in] qwNumDraws    number of simulated games
+  @param [in] qwSeed        seed of the random number stream
+  @param [in] fZScore       half-width of the confidence band in standard errors
+
+  @retval int               number of outcomes, or pools of rare outcomes,
+                            outside of the confidence band
+*/
+int crossCheckSideBets (QWORD qwNumDraws, QWORD qwSeed, double fZScore);
+
+#endif
@@ -0,0 +1,440 @@
+/**
+@file       KenoSimulator.cpp
+@brief      Implementation of the Monte Carlo Keno draw simulator
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "KenoSimulator.h"
+
+
+static inline QWORD rotateLeft (QWORD qwValue, int iBits)
+{
+    return (qwValue << iBits) | (qwValue >> (64 - iBits));
+}
+
+DWORD getWorkerThreadCount (void)
+{
+    const DWORD dwNumThreads = std::thread::hardware_concurrency ( );
+
+    return (dwNumThreads != 0) ? dwNumThreads : 1;
+}
+
+void KenoRng::seed (QWORD qwSeed)
+{
+    for ( int i = 0; i < 4; i++ )
+        rgState[i] = splitMix64 (qwSeed);
+}
+
+QWORD KenoRng::next (void)
+{
+    const QWORD qwResult = rotateLeft (rgState[1] * 5, 7) * 9;
+    const QWORD qwT      = rgState[1] << 17;
+
+    rgState[2] ^= rgState[0];
+    rgState[3] ^= rgState[1];
+    rgState[1] ^= rgState[2];
+    rgState[0] ^= rgState[3];
+    rgState[2] ^= qwT;
+    rgState[3]  = rotateLeft (rgState[3], 45);
+
+    return qwResult;
+}
+
+void drawKenoBalls (KenoRng& rng, KenoDraw& draw)
+{
+    draw.qwMaskLo = 0;
+    draw.qwMaskHi = 0;
+
+    int nDrawn = 0;
+
+    // every 64 bit random value yields two candidate balls; a ball that was
+    // already drawn is simply rejected, which on average costs ~2.7 extra
+    // candidates per game
+    while ( nDrawn < g_BALLS_DRAWN )
+    {
+        QWORD qwRandom = rng.next ( );
+
+        for ( int k = 0; (k < 2) && (nDrawn < g_BALLS_DRAWN); k++ )
+        {
+            // multiply-shift range reduction of a 32 bit value onto 0 .. 79
+            const DWORD dwBall = static_cast<DWORD>(((qwRandom & 0xFFFFFFFFULL) * g_TOTAL_BALLS) >> 32);
+            qwRandom >>= 32;
+
+            QWORD& qwMask = (dwBall < 64) ? draw.qwMaskLo : draw.qwMaskHi;
+            const QWORD qwBit = 1ULL << (dwBall & 63);
+
+            if ( (qwMask & qwBit) == 0 )
+            {
+                qwMask |= qwBit;
+                draw.rgBalls[nDrawn++] = static_cast<BYTE>(dwBall + 1);
+            }
+        }
+    }
+}
+
+/**
+  @brief sets 'dwCount' distinct, previously clear bits in the ball range
+         [dwFirst, dwFirst + dwRange) of a draw mask, appending them to rgBalls
+*/
+static void drawDistinctBalls (KenoRng& rng, DWORD dwFirst, DWORD dwRange, DWORD dwCount, 
+                               KenoDraw& draw, int& nDrawn)
+{
+    for ( DWORD k = 0; k < dwCount; )
+    {
+        const DWORD dwBall = dwFirst + static_cast<DWORD>(((rng.next ( ) >> 32) * dwRange) >> 32);
+
+        QWORD& qwMask = (dwBall < 64) ? draw.qwMaskLo : draw.qwMaskHi;
+        const QWORD qwBit = 1ULL << (dwBall & 63);
+
+        if ( (qwMask & qwBit) == 0 )
+        {
+            qwMask |= qwBit;
+            draw.rgBalls[nDrawn++] = static_cast<BYTE>(dwBall + 1);
+            k++;
+        }
+    }
+}
+
+void drawKenoBallsWithCatch (KenoRng& rng, DWORD dwNumMarked, DWORD dwCaught, KenoDraw& draw)
+{
+    draw.qwMaskLo = 0;
+    draw.qwMaskHi = 0;
+
+    int nDrawn = 0;
+
+    drawDistinctBalls (rng, 0,           dwNumMarked,                 dwCaught,                 draw, nDrawn);
+    drawDistinctBalls (rng, dwNumMarked, g_TOTAL_BALLS - dwNumMarked, g_BALLS_DRAWN - dwCaught, draw, nDrawn);
+
+    // shuffle so the draw order (e.g. the last ball) is uniform as well
+    for ( int i = g_BALLS_DRAWN - 1; i > 0; i-- )
+    {
+        const int  j      = static_cast<int>(((rng.next ( ) >> 32) * (i + 1)) >> 32);
+        const BYTE byBall = draw.rgBalls[i];
+
+        draw.rgBalls[i] = draw.rgBalls[j];
+        draw.rgBalls[j] = byBall;
+    }
+}
+
+
+/// per thread pay out accumulators, padded to avoid false sharing;
+/// slot 0 is the base table, slot v + 1 is variant 'v'
+struct CrossCheckAccumulator
+{
+    double rgSum  [g_MAX_VARIANTS + 1][g_MAX_SPOTS_MARKED];
+    double rgSumSq[g_MAX_VARIANTS + 1][g_MAX_SPOTS_MARKED];
+    BYTE   rgPadding[64];
+};
+
+/// read-only description of a cross-check shared by every worker
+struct CrossCheckPlan
+{
+    double             rgPayByCatch[g_MAX_SPOTS_MARKED][g_MAX_SPOTS_MARKED + 1];
+    const KenoVariant* rgVariants;
+    int                nVariants;
+};
+
+/**
+  @brief samples the multiplier of a multiplier variant
+*/
+static double sampleMultiplier (KenoRng& rng, const KenoVariant& variant)
+{
+    // 53 random bits mapped onto [0, 1)
+    double fUniform = static_cast<double>(rng.next ( ) >> 11) * (1.0 / 9007199254740992.0);
+
+    for ( int k = 0; k < variant.nMultipliers - 1; k++ )
+    {
+        fUniform -= variant.rgMultipliers[k].fProbability;
+        if ( fUniform < 0.0 )
+            return variant.rgMultipliers[k].fMultiplier;
+    }
+
+    return variant.rgMultipliers[variant.nMultipliers - 1].fMultiplier;
+}
+
+static void crossCheckWorker (const CrossCheckPlan& plan, QWORD qwNumDraws, QWORD qwSeed, CrossCheckAccumulator& acc)
+{
+    KenoRng  rng;
+    KenoDraw draw;
+
+    rng.seed (qwSeed);
+
+    for ( int v = 0; v <= plan.nVariants; v++ )
+    {
+        for ( int i = 0; i < g_MAX_SPOTS_MARKED; i++ )
+        {
+            acc.rgSum[v][i]   = 0.0;
+            acc.rgSumSq[v][i] = 0.0;
+        }
+    }
+
+    double rgFactor   [g_MAX_VARIANTS] = { 0.0 };   // multiplier of the current draw
+    DWORD  rgBonusBall[g_MAX_VARIANTS] = { 0 };     // bonus ball of the current draw
+
+    for ( QWORD n = 0; n < qwNumDraws; n++ )
+    {
+        drawKenoBalls (rng, draw);
+
+        // the variant outcomes apply to the whole draw, i.e. to every row alike
+        for ( int v = 0; v < plan.nVariants; v++ )
+        {
+            const KenoVariant& variant = plan.rgVariants[v];
+
+            switch ( variant.eType )
+            {
+            case KENO_VARIANT_MULTIPLIER:
+                rgFactor[v] = sampleMultiplier (rng, variant);
+                break;
+            case KENO_VARIANT_LAST_BALL:
+                rgBonusBall[v] = draw.rgBalls[g_BALLS_DRAWN - 1];
+                break;
+            case KENO_VARIANT_BULLSEYE:
+                rgBonusBall[v] = draw.rgBalls[((rng.next ( ) >> 32) * g_BALLS_DRAWN) >> 32];
+                break;
+            }
+        }
+
+        // row 'i' plays the balls 1 .. i+1, i.e. the lowest i+1 bits
+        for ( int i = 0; i < g_MAX_SPOTS_MARKED; i++ )
+        {
+            const QWORD  qwTicket = (2ULL << i) - 1;
+            const double fPay     = plan.rgPayByCatch[i][countBits (draw.qwMaskLo & qwTicket)];
+
+            acc.rgSum[0][i]   += fPay;
+            acc.rgSumSq[0][i] += fPay * fPay;
+
+            for ( int v = 0; v < plan.nVariants; v++ )
+            {
+                double fVariantPay = fPay;
+
+                if ( plan.rgVariants[v].eType == KENO_VARIANT_MULTIPLIER )
+                    fVariantPay *= rgFactor[v];
+                else if ( rgBonusBall[v] <= static_cast<DWORD>(i + 1) )
+                    fVariantPay *= plan.rgVariants[v].fBoost;
+
+                acc.rgSum[v + 1][i]   += fVariantPay;
+                acc.rgSumSq[v + 1][i] += fVariantPay * fVariantPay;
+            }
+        }
+    }
+}
+
+bool crossCheckVariants (const KenoPayTable& payTable, const KenoVariant* rgVariants, int nVariants,
+                         QWORD qwNumDraws, QWORD qwSeed, double fZScore,
+                         KenoCrossCheckResult (*rgResults)[g_MAX_SPOTS_MARKED])
+{
+    CrossCheckPlan plan = { };
+
+    plan.rgVariants = rgVariants;
+    plan.nVariants  = nVariants;
+
+    // re-index the pay table by catch size so the inner loop is branch free
+    for ( int i = 0; i < g_MAX_SPOTS_MARKED; i++ )
+    {
+        for ( int j = 0; j < g_MAX_PAYOUT_COLS; j++ )
+            plan.rgPayByCatch[i][j + 1] = payTable.rgPayOut[i][j];
+    }
+
+    const DWORD dwNumThreads = getWorkerThreadCount ( );
+
+    std::vector<CrossCheckAccumulator> rgAcc (dwNumThreads);
+    std::vector<std::thread>           rgThreads;
+
+    QWORD qwStreamSeed = qwSeed;
+
+    for ( DWORD t = 0; t < dwNumThreads; t++ )
+    {
+        const QWORD qwDraws = qwNumDraws / dwNumThreads + ((t < qwNumDraws % dwNumThreads) ? 1 : 0);
+
+        rgThreads.emplace_back (crossCheckWorker, std::cref (plan), qwDraws,
+                                splitMix64 (qwStreamSeed), std::ref (rgAcc[t]));
+    }
+
+    for ( auto& thread : rgThreads )
+        thread.join ( );
+
+    bool bAllWithinBand = true;
+
+    for ( int i = 0; i < g_MAX_SPOTS_MARKED; i++ )
+    {
+        double rgExactRTP[g_MAX_VARIANTS + 1] = { 0.0 };
+
+        rgExactRTP[0] = calcVariantExpectedValues (g_rgProbability[i], payTable.rgPayOut[i],
+                                                   rgVariants, nVariants, &rgExactRTP[1]);
+
+        for ( int v = 0; v <= nVariants; v++ )
+        {
+            double fSum   = 0.0;
+            double fSumSq = 0.0;
+
+            for ( const auto& acc : rgAcc )
+            {
+                fSum   += acc.rgSum[v][i];
+                fSumSq += acc.rgSumSq[v][i];
+            }
+
+            const double fN        = static_cast<double>(qwNumDraws);
+            const double fMean     = fSum / fN;
+            const double fVariance = (fSumSq / fN) - (fMean * fMean);
+
+            KenoCrossCheckResult& result = rgResults[v][i];
+
+            result.dwNumMarked   = i + 1;
+            result.fExactRTP     = rgExactRTP[v];
+            result.fSimulatedRTP = fMean;
+            result.fStdError     = (fVariance > 0.0) ? std::sqrt (fVariance / fN) : 0.0;
+            result.bWithinBand   = std::fabs (fMean - result.fExactRTP) <= fZScore * result.fStdError;
+
+            bAllWithinBand = bAllWithinBand && result.bWithinBand;
+        }
+    }
+
+    return bAllWithinBand;
+}
+
+bool crossCheckPayTable (const KenoPayTable& payTable, QWORD qwNumDraws, QWORD qwSeed, double fZScore,
+                         KenoCrossCheckResult (&rgResults)[g_MAX_SPOTS_MARKED])
+{
+    return crossCheckVariants (payTable, nullptr, 0, qwNumDraws, qwSeed, fZScore, &rgResults);
+}
+
+
+/// read-only description of an importance sampling run shared by every worker
+struct RareTierPlan
+{
+    DWORD  dwNumMarked;
+    double rgPayByCatch [g_MAX_SPOTS_MARKED + 1];
+    double rgWeight     [g_MAX_SPOTS_MARKED + 1];  //< likelihood ratio KP(M, C) / q (C)
+    double rgCumulative [g_MAX_SPOTS_MARKED + 1];  //< cumulative proposal distribution
+};
+
+/// per thread sums of the weighted pay outs, padded to avoid false sharing
+struct RareTierAccumulator
+{
+    double rgSum  [g_MAX_SPOTS_MARKED + 1];
+    double rgSumSq[g_MAX_SPOTS_MARKED + 1];
+    BYTE   rgPadding[64];
+};
+
+static void rareTierWorker (const RareTierPlan& plan, QWORD qwNumDraws, QWORD qwSeed, RareTierAccumulator& acc)
+{
+    KenoRng  rng;
+    KenoDraw draw;
+
+    rng.seed (qwSeed);
+
+    for ( DWORD c = 0; c <= plan.dwNumMarked; c++ )
+    {
+        acc.rgSum[c]   = 0.0;
+        acc.rgSumSq[c] = 0.0;
+    }
+
+    for ( QWORD n = 0; n < qwNumDraws; n++ )
+    {
+        // propose a catch size from q
+        const double fUniform = static_cast<double>(rng.next ( ) >> 11) * (1.0 / 9007199254740992.0);
+
+        DWORD dwProposed = 0;
+        while ( (dwProposed < plan.dwNumMarked) && (fUniform >= plan.rgCumulative[dwProposed]) )
+            dwProposed++;
+
+        drawKenoBallsWithCatch (rng, plan.dwNumMarked, dwProposed, draw);
+
+        // settle the generated draw like any other and re-weight its pay out
+        const QWORD  qwTicket = (2ULL << (plan.dwNumMarked - 1)) - 1;
+        const DWORD  dwCaught = countBits (draw.qwMaskLo & qwTicket);
+        const double fValue   = plan.rgWeight[dwCaught] * plan.rgPayByCatch[dwCaught];
+
+        acc.rgSum[dwCaught]   += fValue;
+        acc.rgSumSq[dwCaught] += fValue * fValue;
+    }
+}
+
+int estimateRareTierLiability (const KenoPayTable& payTable, DWORD dwNumMarked, double fBiasMass,
+                               QWORD qwNumDraws, QWORD qwSeed,
+                               KenoRareTierEstimate (&rgEstimates)[g_MAX_SPOTS_MARKED + 1])
+{
+    RareTierPlan plan = { };
+
+    plan.dwNumMarked = dwNumMarked;
+
+    const double (&rgProbability)[g_MAX_COLS] = g_rgProbability[dwNumMarked - 1];
+
+    int nPayingTiers = 0;
+
+    for ( DWORD c = 1; c <= dwNumMarked; c++ )
+    {
+        plan.rgPayByCatch[c] = payTable.rgPayOut[dwNumMarked - 1][c - 1];
+        if ( plan.rgPayByCatch[c] > 0.0 )
+            nPayingTiers++;
+    }
+
+    // defensive mixture proposal and the exact likelihood ratio of every catch size
+    double fCumulative = 0.0;
+
+    for ( DWORD c = 0; c <= dwNumMarked; c++ )
+    {
+        double fProposal = (1.0 - fBiasMass) * rgProbability[c];
+
+        if ( (plan.rgPayByCatch[c] > 0.0) && (nPayingTiers > 0) )
+            fProposal += fBiasMass / nPayingTiers;
+
+        plan.rgWeight[c]     = (fProposal > 0.0) ? rgProbability[c] / fProposal : 0.0;
+        fCumulative         += fProposal;
+        plan.rgCumulative[c] = fCumulative;
+    }
+
+    const DWORD dwNumThreads = getWorkerThreadCount ( );
+
+    std::vector<RareTierAccumulator> rgAcc (dwNumThreads);
+    std::vector<std::thread>         rgThreads;
+
+    QWORD qwStreamSeed = qwSeed;
+
+    for ( DWORD t = 0; t < dwNumThreads; t++ )
+    {
+        const QWORD qwDraws = qwNumDraws / dwNumThreads + ((t < qwNumDraws % dwNumThreads) ? 1 : 0);
+
+        rgThreads.emplace_back (rareTierWorker, std::cref (plan), qwDraws,
+                                splitMix64 (qwStreamSeed), std::ref (rgAcc[t]));
+    }
+
+    for ( auto& thread : rgThreads )
+        thread.join ( );
+
+    const double fN = static_cast<double>(qwNumDraws);
+
+    for ( DWORD c = 0; c <= dwNumMarked; c++ )
+    {
+        double fSum   = 0.0;
+        double fSumSq = 0.0;
+
+        for ( const auto& acc : rgAcc )
+        {
+            fSum   += acc.rgSum[c];
+            fSumSq += acc.rgSumSq[c];
+        }
+
+        const double fMean      = fSum / fN;
+        const double fVariance  = (fSumSq / fN) - (fMean * fMean);
+        const double fExact     = rgProbability[c] * plan.rgPayByCatch[c];
+        const double fPlainVar  = rgProbability[c] * (1.0 - rgProbability[c]) * plan.rgPayByCatch[c] * plan.rgPayByCatch[c];
+
+        KenoRareTierEstimate& estimate = rgEstimates[c];
+
+        estimate.dwNumMarked        = dwNumMarked;
+        estimate.dwCatch            = c;
+        estimate.fExactLiability    = fExact;
+        estimate.fLiability         = fMean;
+        estimate.fStdError          = (fVariance > 0.0) ? std::sqrt (fVariance / fN) : 0.0;
+        estimate.fVarianceReduction = (fVariance > 0.0) ? fPlainVar / fVariance : 0.0;
+    }
+
+    return nPayingTiers;
+}
@@ -0,0 +1,229 @@
+/**
+@file       KenoSimulator.h
+@brief      Monte Carlo Keno draw simulator declarations
+
+  The simulator represents a draw as an 80 bit ball mask, so that the catch
+  of any ticket is a pair of AND + population count operations.  It is used
+  to cross-check the combinatoric results of KenoProbability.cpp.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_SIMULATOR_H__
+#define __KENO_SIMULATOR_H__
+
+#include "KenoProbability.h"
+#include "KenoVariants.h"
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+/**
+  @brief splitMix64 - used to expand a single seed into generator state and
+         to derive independent per thread stream seeds
+
+  @sa http://prng.di.unimi.it/splitmix64.c
+*/
+inline QWORD splitMix64 (QWORD& qwState)
+{
+    QWORD qwZ = (qwState += 0x9E3779B97F4A7C15ULL);
+    qwZ = (qwZ ^ (qwZ >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    qwZ = (qwZ ^ (qwZ >> 27)) * 0x94D049BB133111EBULL;
+    return qwZ ^ (qwZ >> 31);
+}
+
+/**
+  xoshiro256** pseudo random number generator.  Each simulation thread owns
+  its own stream, so no synchronization is required while drawing.
+
+  @sa http://prng.di.unimi.it/
+*/
+struct KenoRng
+{
+    QWORD rgState[4];
+
+    void  seed (QWORD qwSeed);
+    QWORD next (void);
+};
+
+/**
+  @brief number of worker threads used by the simulations, at least 1
+*/
+DWORD getWorkerThreadCount (void);
+
+/**
+  A single game: the 20 drawn balls both in draw order and as a bit mask
+  where ball 'n' (1..80) maps to bit 'n - 1' of the 80 bit mask.
+*/
+struct KenoDraw
+{
+    QWORD qwMaskLo;                     //< balls  1 .. 64
+    QWORD qwMaskHi;                     //< balls 65 .. 80
+    BYTE  rgBalls[g_BALLS_DRAWN];       //< balls in the order they were drawn
+};
+
+/**
+  @brief counts the number of set bits in a 64 bit word
+*/
+inline DWORD countBits (QWORD qwValue)
+{
+#ifdef _MSC_VER
+    return __popcnt (static_cast<unsigned int>(qwValue)) +
+           __popcnt (static_cast<unsigned int>(qwValue >> 32));
+#else
+    return static_cast<DWORD>(__builtin_popcountll (qwValue));
+#endif
+}
+
+/**
+  @brief the index of the lowest set bit of a non-zero 64 bit word
+*/
+inline DWORD countTrailingZeros (QWORD qwValue)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long ulIndex;
+    _BitScanForward64 (&ulIndex, qwValue);
+    return ulIndex;
+#elif defined(_MSC_VER)
+    unsigned long ulIndex;
+    if ( _BitScanForward (&ulIndex, static_cast<unsigned long>(qwValue)) )
+        return ulIndex;
+    _BitScanForward (&ulIndex, static_cast<unsigned long>(qwValue >> 32));
+    return ulIndex + 32;
+#else
+    return static_cast<DWORD>(__builtin_ctzll (qwValue));
+#endif
+}
+
+/**
+  @brief counts the number of balls a ticket mask catches in a draw
+*/
+inline DWORD countCatch (const KenoDraw& draw, QWORD qwTicketLo, QWORD qwTicketHi)
+{
+    return countBits (draw.qwMaskLo & qwTicketLo) + countBits (draw.qwMaskHi & qwTicketHi);
+}
+
+/**
+  @brief drawKenoBalls
+
+  Draws g_BALLS_DRAWN distinct balls out of g_TOTAL_BALLS.
+
+  @param [in,out] rng       random number stream of the calling thread
+  @param [out]    draw      receives the drawn balls
+*/
+void drawKenoBalls (KenoRng& rng, KenoDraw& draw);
+
+/**
+  @brief drawKenoBallsWithCatch
+
+  Draws g_BALLS_DRAWN distinct balls conditioned on exactly 'dwCaught' of 
+  them falling on the ticket 1 .. 'dwNumMarked'.  Given the catch size, every
+  such draw is equally likely, so the draw is uniform within its catch size.
+
+  @param [in,out] rng           random number stream of the calling thread
+  @param [in]     dwNumMarked   spots marked, the ticket plays the balls 1 .. dwNumMarked
+  @param [in]     dwCaught      required catch size
+  @param [out]    draw          receives the drawn balls in a uniformly random order
+*/
+void drawKenoBallsWithCatch (KenoRng& rng, DWORD dwNumMarked, DWORD dwCaught, KenoDraw& draw);
+
+
+/**
+  Result of simulating one row ('spots marked') of a pay out table
+*/
+struct KenoCrossCheckResult
+{
+    DWORD  dwNumMarked;         //< number of spots marked
+    double fExactRTP;           //< expected value from the probability model
+    double fSimulatedRTP;       //< mean simulated return of a $1 bet
+    double fStdError;           //< standard error of fSimulatedRTP
+    bool   bWithinBand;         //< true if |simulated - exact| <= z * standard error
+};
+
+/**
+  @brief crossCheckPayTable
+
+  Simulates 'qwNumDraws' games and compares the simulated return of every
+  row of a pay table against its exact expected value.  Every draw settles
+  all rows at once (row M plays the balls 1..M), and the draws are spread
+  across all hardware threads.
+
+  @note buildProbabilityTable must have been called beforehand
+
+  @param [in]  payTable     pay table to validate
+  @param [in]  qwNumDraws   number of simulated games
+  @param [in]  qwSeed       seed of the random number streams
+  @param [in]  fZScore      half-width of the confidence band in standard errors
+  @param [out] rgResults    per row results
+
+  @retval bool              true if every row is within its confidence band
+*/
+bool crossCheckPayTable (const KenoPayTable& payTable, QWORD qwNumDraws, QWORD qwSeed, double fZScore,
+                         KenoCrossCheckResult (&rgResults)[g_MAX_SPOTS_MARKED]);
+
+/**
+  @brief crossCheckVariants
+
+  Same as crossCheckPayTable, but every draw also settles each variant: a 
+  multiplier is sampled per draw, the last ball is the final ball drawn and 
+  the bullseye is a uniformly chosen drawn ball.
+
+  @param [in]  payTable     base pay table
+  @param [in]  rgVariants   variants to settle alongside the base table
+  @param [in]  nVariants    number of variants (<= g_MAX_VARIANTS)
+  @param [in]  qwNumDraws   number of simulated games
+  @param [in]  qwSeed       seed of the random number streams
+  @param [in]  fZScore      half-width of the confidence band in standard errors
+  @param [out] rgResults    [nVariants + 1] rows of results, the base table first
+
+  @retval bool              true if every row of every variant is within its band
+*/
+bool crossCheckVariants (const KenoPayTable& payTable, const KenoVariant* rgVariants, int nVariants,
+                         QWORD qwNumDraws, QWORD qwSeed, double fZScore,
+                         KenoCrossCheckResult (*rgResults)[g_MAX_SPOTS_MARKED]);
+
+
+/**
+  Importance sampling estimate of the liability of one catch tier
+*/
+struct KenoRareTierEstimate
+{
+    DWORD  dwNumMarked;         //< spots marked
+    DWORD  dwCatch;             //< catch size of the tier
+    double fExactLiability;     //< KP(M, C) * PO(M, C), from the probability model
+    double fLiability;          //< importance sampling estimate of KP(M, C) * PO(M, C)
+    double fStdError;           //< standard error of fLiability
+    double fVarianceReduction;  //< plain Monte Carlo variance / importance sampling variance
+};
+
+/**
+  @brief estimateRareTierLiability
+
+  Estimates the liability of every paying catch tier of one pay table row by
+  importance sampling.  Catch sizes are proposed from the defensive mixture
+
+      q (C) = (1 - fBiasMass) * KP(M, C) + fBiasMass / (number of paying tiers)
+
+  a draw is generated conditioned on the proposed catch, and its pay out is
+  weighted by the exact likelihood ratio KP(M, C) / q (C) of the hypergeometric
+  model.  Rare tiers such as 9 of 9 are hit in a fixed share of the draws,
+  which reduces the variance of their estimate by orders of magnitude.
+
+  @note buildProbabilityTable must have been called beforehand
+
+  @param [in]  payTable     pay table to evaluate
+  @param [in]  dwNumMarked  row of the pay table (spots marked)
+  @param [in]  fBiasMass    share of the draws spread evenly over the paying tiers (0 .. 1)
+  @param [in]  qwNumDraws   number of simulated games
+  @param [in]  qwSeed       seed of the random number streams
+  @param [out] rgEstimates  receives one estimate per catch size, indexed by catch size
+
+  @retval int               number of paying tiers
+*/
+int estimateRareTierLiability (const KenoPayTable& payTable, DWORD dwNumMarked, double fBiasMass,
+                               QWORD qwNumDraws, QWORD qwSeed,
+                               KenoRareTierEstimate (&rgEstimates)[g_MAX_SPOTS_MARKED + 1]);
+
+#endif
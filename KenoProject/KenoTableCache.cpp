@@ -0,0 +1,238 @@
+/**
+@file       KenoTableCache.cpp
+@brief      Implementation of the memory-mapped probability table cache
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <mutex>
+#include <string.h>
+#include "KenoCheckpoint.h"
+#include "KenoTableCache.h"
+#include "KenoTrace.h"
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+
+/// rounds 'qwOffset' up to the table alignment
+static inline QWORD alignTableOffset (QWORD qwOffset)
+{
+    return (qwOffset + g_dwTableCacheAlignment - 1) & ~static_cast<QWORD>(g_dwTableCacheAlignment - 1);
+}
+
+/// computes the complete cache file image of 'geometry'
+static void buildTableCacheImage (const KenoGeometry& geometry, std::vector<BYTE>& rgImage)
+{
+    // a worker that finds its tables cached never needs the log-factorial table
+    static std::once_flag s_logFactorialOnce;
+
+    std::call_once (s_logFactorialOnce, [] ( )
+    {
+        if ( g_rgLogFactorial[g_MAX_LOG_FACTORIAL] == 0.0 )
+            buildLogFactorialTable ( );
+    });
+
+    KenoTableCacheHeader header = { };
+
+    header.dwMagic         = g_dwTableCacheMagic;
+    header.dwVersion       = g_dwTableCacheVersion;
+    header.dwEngineVersion = g_dwLogProbabilityEngineVersion;
+    header.dwHeaderSize    = sizeof (KenoTableCacheHeader);
+    header.dwTotalBalls    = geometry.dwTotalBalls;
+    header.dwBallsDrawn    = geometry.dwBallsDrawn;
+    header.dwNumRows       = g_MAX_ROWS;
+    header.dwNumCols       = g_MAX_COLS;
+    header.qwTableOffset   = alignTableOffset (sizeof (KenoTableCacheHeader));
+    header.qwBoundOffset   = alignTableOffset (header.qwTableOffset + sizeof (double) * g_MAX_ROWS * g_MAX_COLS);
+    header.qwFileSize      = alignTableOffset (header.qwBoundOffset + sizeof (double) * g_MAX_ROWS);
+
+    rgImage.assign (static_cast<size_t>(header.qwFileSize), 0);
+
+    double* rgTable      = reinterpret_cast<double*>(rgImage.data ( ) + header.qwTableOffset);
+    double* rgErrorBound = reinterpret_cast<double*>(rgImage.data ( ) + header.qwBoundOffset);
+
+    for ( DWORD m = 1; m <= g_MAX_ROWS; m++ )
+        calcKenoProbabilityRow (geometry, m, rgTable + (m - 1) * g_MAX_COLS, &rgErrorBound[m - 1]);
+
+    header.qwPayloadHash = hashBytes (rgImage.data ( ) + sizeof (header), rgImage.size ( ) - sizeof (header));
+
+    memcpy (rgImage.data ( ), &header, sizeof (header));
+}
+
+/// checks a mapped or loaded image against the expected geometry and versions
+static bool isValidTableCacheImage (const void* pImage, size_t cbImage, const KenoGeometry& geometry)
+{
+    if ( cbImage < sizeof (KenoTableCacheHeader) )
+        return false;
+
+    const KenoTableCacheHeader& header = *static_cast<const KenoTableCacheHeader*>(pImage);
+    const BYTE*                 pBytes = static_cast<const BYTE*>(pImage);
+
+    return (header.dwMagic         == g_dwTableCacheMagic)              &&
+           (header.dwVersion       == g_dwTableCacheVersion)            &&
+           (header.dwEngineVersion == g_dwLogProbabilityEngineVersion)  &&
+           (header.dwHeaderSize    == sizeof (KenoTableCacheHeader))    &&
+           (header.dwTotalBalls    == geometry.dwTotalBalls)            &&
+           (header.dwBallsDrawn    == geometry.dwBallsDrawn)            &&
+           (header.dwNumRows       == g_MAX_ROWS)                       &&
+           (header.dwNumCols       == g_MAX_COLS)                       &&
+           (header.qwFileSize      == cbImage)                          &&
+           (header.qwTableOffset   == alignTableOffset (sizeof (KenoTableCacheHeader))) &&
+           (header.qwBoundOffset   >= header.qwTableOffset + sizeof (double) * g_MAX_ROWS * g_MAX_COLS) &&
+           (header.qwBoundOffset   == alignTableOffset (header.qwBoundOffset)) &&
+           (header.qwBoundOffset + sizeof (double) * g_MAX_ROWS <= cbImage) &&
+           (hashBytes (pBytes + sizeof (header), cbImage - sizeof (header)) == header.qwPayloadHash);
+}
+
+bool getTableCachePath (const TCHAR* szDirectory, const KenoGeometry& geometry, TCHAR* szPath, size_t cchPath)
+{
+#ifdef _WIN32
+    const TCHAR chSeparator = _T('\\');
+#else
+    const TCHAR chSeparator = _T('/');
+#endif
+
+    const size_t  nLen        = _tcslen (szDirectory);
+    const TCHAR   szSep[2]    = { ((nLen > 0) && (szDirectory[nLen - 1] != chSeparator)) ? chSeparator : _T('\0'), _T('\0') };
+
+    const int nWritten = _sntprintf (szPath, cchPath, _T ("%s%sKenoTables_%u_%u.bin"), szDirectory, szSep,
+                                     geometry.dwTotalBalls, geometry.dwBallsDrawn);
+
+    return (nWritten > 0) && (static_cast<size_t>(nWritten) < cchPath);
+}
+
+bool writeTableCache (const TCHAR* szPath, const KenoGeometry& geometry)
+{
+    if ( !isValidGeometry (geometry, g_MAX_ROWS) )
+        return false;
+
+    std::vector<BYTE> rgImage;
+    buildTableCacheImage (geometry, rgImage);
+
+    // concurrent workers regenerating the same geometry each write their own file
+#ifdef _WIN32
+    const DWORD dwProcessId = ::GetCurrentProcessId ( );
+#else
+    const DWORD dwProcessId = static_cast<DWORD>(getpid ( ));
+#endif
+
+    TCHAR szTempPath[_MAX_PATH] = { 0 };
+    _sntprintf (szTempPath, _countof (szTempPath) - 1, _T ("%s.%u.tmp"), szPath, dwProcessId);
+
+    FILE* pFile = _tfopen (szTempPath, _T ("wb"));
+    if ( pFile == nullptr )
+        return false;
+
+    bool bResult = (fwrite (rgImage.data ( ), rgImage.size ( ), 1, pFile) == 1);
+
+    bResult = (fclose (pFile) == 0) && bResult;
+
+    if ( bResult )
+    {
+#ifdef _WIN32
+        bResult = ::MoveFileEx (szTempPath, szPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+        bResult = _trename (szTempPath, szPath) == 0;
+#endif
+    }
+
+    // e.g. another process still maps the file being replaced on Windows
+    if ( !bResult )
+        _tremove (szTempPath);
+
+    return bResult;
+}
+
+
+KenoTableCache::KenoTableCache ( )
+    : m_geometry     { 0, 0 },
+      m_rgTable      (nullptr),
+      m_rgErrorBound (nullptr),
+      m_bRegenerated (false)
+{
+}
+
+KenoTableCache::~KenoTableCache ( )
+{
+    close ( );
+}
+
+bool KenoTableCache::open (const TCHAR* szDirectory, const KenoGeometry& geometry)
+{
+    close ( );
+
+    if ( !isValidGeometry (geometry, g_MAX_ROWS) )
+        return false;
+
+    m_geometry = geometry;
+
+    TCHAR szPath[_MAX_PATH] = { 0 };
+
+    if ( getTableCachePath (szDirectory, geometry, szPath, _countof (szPath)) )
+    {
+        if ( map (szPath) )
+            return true;
+
+        m_bRegenerated = true;
+
+        // the trace is formatted later, so it cannot refer to the path buffer
+        KENO_TRACE_INFO (_T ("Regenerating the table cache of %u balls, %u drawn"),
+                         geometry.dwTotalBalls, geometry.dwBallsDrawn);
+
+        // if the write failed, another worker may still have replaced the file
+        writeTableCache (szPath, geometry);
+
+        if ( map (szPath) )
+            return true;
+
+        KENO_TRACE_WARNING (_T ("Cannot map the table cache of %u balls, %u drawn, computing it in memory"),
+                            geometry.dwTotalBalls, geometry.dwBallsDrawn);
+    }
+
+    m_bRegenerated = true;
+
+    buildTableCacheImage (geometry, m_rgFallback);
+
+    const KenoTableCacheHeader& header = *reinterpret_cast<const KenoTableCacheHeader*>(m_rgFallback.data ( ));
+
+    m_rgTable      = reinterpret_cast<const double*>(m_rgFallback.data ( ) + header.qwTableOffset);
+    m_rgErrorBound = reinterpret_cast<const double*>(m_rgFallback.data ( ) + header.qwBoundOffset);
+
+    return true;
+}
+
+void KenoTableCache::close (void)
+{
+    m_file.close ( );
+
+    m_rgFallback.clear ( );
+    m_rgFallback.shrink_to_fit ( );
+
+    m_rgTable      = nullptr;
+    m_rgErrorBound = nullptr;
+    m_bRegenerated = false;
+}
+
+bool KenoTableCache::map (const TCHAR* szPath)
+{
+    if ( !m_file.open (szPath) )
+        return false;
+
+    if ( !isValidTableCacheImage (m_file.getData ( ), m_file.getSize ( ), m_geometry) )
+    {
+        m_file.close ( );
+        return false;
+    }
+
+    const KenoTableCacheHeader& header = *static_cast<const KenoTableCacheHeader*>(m_file.getData ( ));
+    const BYTE*                 pBytes = static_cast<const BYTE*>(m_file.getData ( ));
+
+    m_rgTable      = reinterpret_cast<const double*>(pBytes + header.qwTableOffset);
+    m_rgErrorBound = reinterpret_cast<const double*>(pBytes + header.qwBoundOffset);
+
+    return true;
+}
@@ -0,0 +1,127 @@
+/**
+@file       KenoTableCache.h
+@brief      Memory-mapped on-disk cache of the probability tables of a geometry
+
+  Each game geometry has its own cache file, KenoTables_<balls>_<drawn>.bin,
+  holding the g_MAX_ROWS x g_MAX_COLS probability matrix of the log-space
+  kernel (KenoLogProbability.h) and the error bound of each row.  Workers
+  map the file read-only, so every process on the machine shares the same
+  physical pages; the tables are only recomputed when the file is missing,
+  damaged, or was written for another geometry, file format or engine
+  version.
+
+  File layout (little endian):
+
+      KenoTableCacheHeader                      64 bytes
+      double [g_MAX_ROWS][g_MAX_COLS]           at qwTableOffset, 64 byte aligned
+      double [g_MAX_ROWS]                       at qwBoundOffset, 64 byte aligned
+
+  A regenerated file is written under a per process temporary name and then
+  renamed over the old one, so a reader never maps a partial file.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_TABLE_CACHE_H__
+#define __KENO_TABLE_CACHE_H__
+
+#include <vector>
+#include "KenoLogProbability.h"
+#include "KenoMappedFile.h"
+
+constexpr const DWORD g_dwTableCacheMagic     = 0x43544E4B;   //< 'KNTC'
+constexpr const DWORD g_dwTableCacheVersion   = 1;            //< file format version
+constexpr const DWORD g_dwTableCacheAlignment = 64;           //< alignment of each table in the file
+
+struct KenoTableCacheHeader
+{
+    DWORD dwMagic;
+    DWORD dwVersion;
+    DWORD dwEngineVersion;      //< g_dwLogProbabilityEngineVersion of the writer
+    DWORD dwHeaderSize;
+    DWORD dwTotalBalls;
+    DWORD dwBallsDrawn;
+    DWORD dwNumRows;
+    DWORD dwNumCols;
+    QWORD qwTableOffset;
+    QWORD qwBoundOffset;
+    QWORD qwFileSize;
+    QWORD qwPayloadHash;        //< FNV-1a hash of everything after the header
+};
+
+static_assert (sizeof (KenoTableCacheHeader) == g_dwTableCacheAlignment, "the tables must start aligned");
+
+/**
+  @brief getTableCachePath
+
+  @param [in]  szDirectory      cache directory, "" for the working directory
+  @param [in]  geometry         pool and draw size
+  @param [out] szPath           receives the cache file path
+  @param [in]  cchPath          size of 'szPath' in characters
+
+  @retval bool                  false if the path does not fit
+*/
+bool getTableCachePath (const TCHAR* szDirectory, const KenoGeometry& geometry, TCHAR* szPath, size_t cchPath);
+
+/**
+  @brief writeTableCache
+
+  Computes the tables of 'geometry' and replaces the cache file with them.
+
+  @retval bool                  true on success
+*/
+bool writeTableCache (const TCHAR* szPath, const KenoGeometry& geometry);
+
+/**
+  A read-only view of the cached tables of one geometry.  The log-factorial
+  table is only built, once, if a table has to be regenerated.
+*/
+class KenoTableCache
+{
+public:
+    KenoTableCache  ( );
+    ~KenoTableCache ( );
+
+    /**
+      @brief maps the cache file of 'geometry', regenerating it first if it is
+             missing or stale; if the file can be neither written nor mapped
+             the tables are computed into memory instead
+
+      @param [in] szDirectory   cache directory, "" for the working directory
+      @param [in] geometry      pool and draw size, at least g_MAX_ROWS balls
+
+      @retval bool              false only if the geometry is invalid
+    */
+    bool open  (const TCHAR* szDirectory, const KenoGeometry& geometry);
+    void close (void);
+
+    bool isOpen          (void) const { return m_rgTable != nullptr; }
+    bool isMapped        (void) const { return m_file.isOpen ( ); }
+    bool wasRegenerated  (void) const { return m_bRegenerated; }
+
+    const KenoGeometry& getGeometry (void) const { return m_geometry; }
+
+    /**
+      @brief probability row of 'dwNumMarked' (1 .. g_MAX_ROWS) spots marked,
+             indexed by catch size
+    */
+    const double* getRow (DWORD dwNumMarked) const { return m_rgTable + (dwNumMarked - 1) * g_MAX_COLS; }
+
+    /**
+      @brief relative error bound of the row of 'dwNumMarked' spots marked
+    */
+    double getErrorBound (DWORD dwNumMarked) const { return m_rgErrorBound[dwNumMarked - 1]; }
+
+private:
+    bool map   (const TCHAR* szPath);
+
+    KenoGeometry        m_geometry;
+    KenoMappedFile      m_file;
+    std::vector<BYTE>   m_rgFallback;       //< the tables when they could not be mapped
+    const double*       m_rgTable;
+    const double*       m_rgErrorBound;
+    bool                m_bRegenerated;
+};
+
+#endif
@@ -0,0 +1,389 @@
+/**
+@file       KenoTicketWire.cpp
+@brief      Implementation of the ticket text parser
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <string.h>
+#include "KenoSimulator.h"
+#include "KenoTicketWire.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #define KENO_TICKET_HAS_SSE2  1
+    #include <emmintrin.h>
+#else
+    #define KENO_TICKET_HAS_SSE2  0
+#endif
+
+constexpr const int    g_nTicketFields = 4;     //< wager, first draw, draws, ticket id
+constexpr const size_t g_cbWindow      = 64;    //< characters classified at a time
+
+
+/**
+  Bit masks of the characters of a 64 byte window, and the value of the
+  number starting at every position: the digit there, or the two digits
+  there and after it
+*/
+struct KenoCharClasses
+{
+    QWORD qwDigits;
+    QWORD qwZeros;
+    QWORD qwCommas;
+    QWORD qwSemicolons;
+    QWORD qwNewLines;
+    alignas (16) BYTE rgValues[g_cbWindow];
+};
+
+/**
+  Ticket mask bits of every byte value a number may take: ball 'n' for 1 ..
+  g_TOTAL_BALLS, and g_qwInvalidBall in the high word for 0 and anything
+  above, so a range error survives the OR of the masks
+*/
+struct KenoBallBits
+{
+    QWORD qwLo;
+    QWORD qwHi;
+};
+
+constexpr const QWORD g_qwInvalidBall = 1ULL << 63;
+
+struct KenoBallTable
+{
+    KenoBallBits rgBits[256];
+
+    KenoBallTable (void)
+    {
+        for ( DWORD v = 0; v < 256; v++ )
+        {
+            const DWORD dwBit = v - 1;
+
+            rgBits[v].qwLo = (dwBit < 64) ? (1ULL << dwBit) : 0;
+            rgBits[v].qwHi = (dwBit < 64) ? 0 : ((dwBit < static_cast<DWORD>(g_TOTAL_BALLS)) ? (1ULL << (dwBit - 64)) : g_qwInvalidBall);
+        }
+    }
+};
+
+static const KenoBallTable g_ballTable;
+
+/// classifies pWindow[0 .. 63]; pWindow[64] must be readable
+static inline void classifyWindow (const char* pWindow, KenoCharClasses& classes)
+{
+#if KENO_TICKET_HAS_SSE2
+    const __m128i xmmZero      = _mm_set1_epi8 ('0');
+    const __m128i xmmNine      = _mm_set1_epi8 (9);
+    const __m128i xmmComma     = _mm_set1_epi8 (',');
+    const __m128i xmmSemicolon = _mm_set1_epi8 (';');
+    const __m128i xmmNewLine   = _mm_set1_epi8 ('\n');
+
+    QWORD qwDigits     = 0;
+    QWORD qwZeros      = 0;
+    QWORD qwCommas     = 0;
+    QWORD qwSemicolons = 0;
+    QWORD qwNewLines   = 0;
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        const __m128i xmmChars = _mm_loadu_si128 (reinterpret_cast<const __m128i*>(pWindow + 16 * i));
+        const __m128i xmmNext  = _mm_loadu_si128 (reinterpret_cast<const __m128i*>(pWindow + 16 * i + 1));
+
+        // c - '0' <= 9 unsigned: min (c - '0', 9) == c - '0'
+        const __m128i xmmHigh      = _mm_sub_epi8 (xmmChars, xmmZero);
+        const __m128i xmmLow       = _mm_sub_epi8 (xmmNext, xmmZero);
+        const __m128i xmmDigit     = _mm_cmpeq_epi8 (_mm_min_epu8 (xmmHigh, xmmNine), xmmHigh);
+        const __m128i xmmNextDigit = _mm_cmpeq_epi8 (_mm_min_epu8 (xmmLow, xmmNine), xmmLow);
+
+        // high + (9 * high + low) where a digit follows, in byte arithmetic
+        const __m128i xmmHigh2 = _mm_add_epi8 (xmmHigh, xmmHigh);
+        const __m128i xmmHigh8 = _mm_add_epi8 (_mm_add_epi8 (xmmHigh2, xmmHigh2), _mm_add_epi8 (xmmHigh2, xmmHigh2));
+        const __m128i xmmTens  = _mm_add_epi8 (_mm_add_epi8 (xmmHigh8, xmmHigh), xmmLow);
+        const __m128i xmmValue = _mm_add_epi8 (xmmHigh, _mm_and_si128 (xmmNextDigit, xmmTens));
+
+        _mm_store_si128 (reinterpret_cast<__m128i*>(classes.rgValues + 16 * i), xmmValue);
+
+        qwDigits     |= static_cast<QWORD>(static_cast<DWORD>(_mm_movemask_epi8 (xmmDigit))) << (16 * i);
+        qwZeros      |= static_cast<QWORD>(static_cast<DWORD>(_mm_movemask_epi8 (_mm_cmpeq_epi8 (xmmChars, xmmZero)))) << (16 * i);
+        qwCommas     |= static_cast<QWORD>(static_cast<DWORD>(_mm_movemask_epi8 (_mm_cmpeq_epi8 (xmmChars, xmmComma)))) << (16 * i);
+        qwSemicolons |= static_cast<QWORD>(static_cast<DWORD>(_mm_movemask_epi8 (_mm_cmpeq_epi8 (xmmChars, xmmSemicolon)))) << (16 * i);
+        qwNewLines   |= static_cast<QWORD>(static_cast<DWORD>(_mm_movemask_epi8 (_mm_cmpeq_epi8 (xmmChars, xmmNewLine)))) << (16 * i);
+    }
+
+    classes.qwDigits     = qwDigits;
+    classes.qwZeros      = qwZeros;
+    classes.qwCommas     = qwCommas;
+    classes.qwSemicolons = qwSemicolons;
+    classes.qwNewLines   = qwNewLines;
+#else
+    classes.qwDigits     = 0;
+    classes.qwZeros      = 0;
+    classes.qwCommas     = 0;
+    classes.qwSemicolons = 0;
+    classes.qwNewLines   = 0;
+
+    for ( size_t i = 0; i < g_cbWindow; i++ )
+    {
+        const QWORD qwBit  = 1ULL << i;
+        const DWORD dwHigh = static_cast<BYTE>(pWindow[i] - '0');
+        const DWORD dwLow  = static_cast<BYTE>(pWindow[i + 1] - '0');
+
+        classes.rgValues[i]   = static_cast<BYTE>((dwLow <= 9) ? (dwHigh * 10 + dwLow) : dwHigh);
+        classes.qwDigits     |= (dwHigh <= 9)        ? qwBit : 0;
+        classes.qwZeros      |= (pWindow[i] == '0')  ? qwBit : 0;
+        classes.qwCommas     |= (pWindow[i] == ',')  ? qwBit : 0;
+        classes.qwSemicolons |= (pWindow[i] == ';')  ? qwBit : 0;
+        classes.qwNewLines   |= (pWindow[i] == '\n') ? qwBit : 0;
+    }
+#endif
+}
+
+/// parses a decimal field up to the next ';' or 'pEnd', at most qwMax
+static bool parseTicketField (const char*& p, const char* pEnd, QWORD qwMax, QWORD& qwValue)
+{
+    const char* pStart = p;
+
+    qwValue = 0;
+
+    while ( (p < pEnd) && (static_cast<unsigned>(*p - '0') <= 9) )
+    {
+        const QWORD qwDigit = static_cast<QWORD>(*p++ - '0');
+
+        if ( qwValue > (qwMax - qwDigit) / 10 )
+            return false;
+
+        qwValue = qwValue * 10 + qwDigit;
+    }
+
+    return (p > pStart) && ((p == pEnd) || (*p == ';'));
+}
+
+/// parses ";wager;first draw;draws;ticket id" from p to pEnd into the record
+static KenoTicketError parseTicketFields (const char* p, const char* pEnd, KenoTicketRecord& record)
+{
+    // wager;first draw;draws;ticket id
+    const QWORD rgMax[g_nTicketFields] = { 0xFFFFFFFFULL, 0xFFFFFFFFULL, 0xFFFFULL, ~0ULL };
+    QWORD       rgValue[g_nTicketFields];
+
+    for ( int f = 0; f < g_nTicketFields; f++ )
+    {
+        if ( (p == pEnd) || (*p != ';') )
+            return KENO_TICKET_FIELD;
+
+        p++;
+
+        if ( !parseTicketField (p, pEnd, rgMax[f], rgValue[f]) )
+            return KENO_TICKET_FIELD;
+    }
+
+    if ( (p != pEnd) || (rgValue[0] == 0) || (rgValue[2] == 0) )
+        return KENO_TICKET_FIELD;
+
+    record.dwWager     = static_cast<DWORD>(rgValue[0]);
+    record.dwFirstDraw = static_cast<DWORD>(rgValue[1]);
+    record.wNumDraws   = static_cast<WORD>(rgValue[2]);
+    record.qwTicketId  = rgValue[3];
+
+    return KENO_TICKET_VALID;
+}
+
+/**
+  Parses a line starting at position dwStart of a classified window; the
+  first min (cbLine, 64 - dwStart) characters of the line are classified,
+  bits past the line are ignored.
+*/
+static inline KenoTicketError parseClassifiedLine (const char* pLine, size_t cbLine, const KenoCharClasses& classes, DWORD dwStart,
+                                                   const KenoTicketDefaults& defaults, QWORD qwTicketId, KenoTicketRecord& record)
+{
+    const char* pEnd   = pLine + cbLine;
+    const QWORD qwLine = (cbLine >= g_cbWindow) ? ~0ULL : ((1ULL << cbLine) - 1);
+
+    // the spot list ends at the first ';' or the end of the line
+    const QWORD  qwSemicolons = (classes.qwSemicolons >> dwStart) & qwLine;
+    const size_t cchSpots     = (qwSemicolons != 0) ? countTrailingZeros (qwSemicolons) : cbLine;
+
+    if ( cchSpots > g_cchMaxSpotList )
+    {
+        // longer than 20 two digit balls, either too many spots or not a spot list at all
+        return ((classes.qwDigits | classes.qwCommas) == ~0ULL) ? KENO_TICKET_SPOTS : KENO_TICKET_SYNTAX;
+    }
+
+    const QWORD qwField  = (cchSpots == g_cbWindow) ? ~0ULL : ((1ULL << cchSpots) - 1);
+    const QWORD qwDigits = (classes.qwDigits >> dwStart) & qwField;
+    const QWORD qwCommas = (classes.qwCommas >> dwStart) & qwField;
+
+    // only digits and commas, every comma between two digits
+    if ( (cchSpots == 0) || ((qwDigits | qwCommas) != qwField) ||
+         ((qwCommas & ~(qwDigits << 1)) != 0) || ((qwCommas & ~(qwDigits >> 1)) != 0) )
+        return KENO_TICKET_SYNTAX;
+
+    const QWORD qwStarts = qwDigits & ~(qwDigits << 1);
+
+    // a number starting with a zero digit followed by another digit ("03", "003")
+    if ( (qwStarts & ((classes.qwZeros >> dwStart) & qwField) & (qwDigits >> 1)) != 0 )
+        return KENO_TICKET_SYNTAX;
+
+    // three digits without a leading zero is at least 100
+    if ( (qwDigits & (qwDigits << 1) & (qwDigits << 2)) != 0 )
+        return KENO_TICKET_RANGE;
+
+    const BYTE* pValues      = classes.rgValues + dwStart;
+    QWORD       qwMaskLo     = 0;
+    QWORD       qwMaskHi     = 0;
+    QWORD       qwDuplicates = 0;
+    DWORD       dwNumbers    = 0;
+
+    for ( QWORD qwPending = qwStarts; qwPending != 0; qwPending &= qwPending - 1 )
+    {
+        const KenoBallBits& bits = g_ballTable.rgBits[pValues[countTrailingZeros (qwPending)]];
+
+        qwDuplicates |= (qwMaskLo & bits.qwLo) | (qwMaskHi & bits.qwHi);
+        qwMaskLo     |= bits.qwLo;
+        qwMaskHi     |= bits.qwHi;
+        dwNumbers++;
+    }
+
+    if ( (qwMaskHi & g_qwInvalidBall) != 0 )
+        return KENO_TICKET_RANGE;
+
+    if ( dwNumbers > static_cast<DWORD>(g_MAX_SELECTABLE_BALLS) )
+        return KENO_TICKET_SPOTS;
+
+    if ( qwDuplicates != 0 )
+        return KENO_TICKET_DUPLICATE;
+
+    record.qwMaskLo    = qwMaskLo;
+    record.qwMaskHi    = qwMaskHi;
+    record.qwTicketId  = qwTicketId;
+    record.dwFirstDraw = defaults.dwFirstDraw;
+    record.dwWager     = defaults.dwWager;
+    record.wNumDraws   = defaults.wNumDraws;
+    record.bySpots     = static_cast<BYTE>(dwNumbers);
+    record.byReserved  = 0;
+    record.dwReserved  = 0;
+
+    if ( cchSpots == cbLine )
+        return KENO_TICKET_VALID;
+
+    return parseTicketFields (pLine + cchSpots, pEnd, record);
+}
+
+KenoTicketError parseTicketLine (const char* pLine, const char* pEnd, const char* pReadable,
+                                 const KenoTicketDefaults& defaults, QWORD qwTicketId, KenoTicketRecord& record)
+{
+    // the window is loaded in place only if the byte after it is readable too
+    alignas (16) char rgWindow[g_cbWindow + 16];
+
+    const size_t cbLine  = pEnd - pLine;
+    const char*  pWindow = pLine;
+
+    if ( static_cast<size_t>(pReadable - pLine) <= g_cbWindow )
+    {
+        memset (rgWindow, 0, sizeof (rgWindow));
+        memcpy (rgWindow, pLine, cbLine);
+        pWindow = rgWindow;
+    }
+
+    KenoCharClasses classes;
+    classifyWindow (pWindow, classes);
+
+    return parseClassifiedLine (pLine, cbLine, classes, 0, defaults, qwTicketId, record);
+}
+
+
+KenoTicketParser::KenoTicketParser (const KenoTicketDefaults& defaults)
+    : m_defaults       (defaults),
+      m_qwNextTicketId (defaults.qwFirstTicketId),
+      m_qwNumParsed    (0)
+{
+    memset (m_rgRejected, 0, sizeof (m_rgRejected));
+}
+
+void KenoTicketParser::addResult (KenoTicketError eError, size_t& nRecords)
+{
+    if ( eError == KENO_TICKET_VALID )
+    {
+        nRecords++;
+        m_qwNumParsed++;
+        m_qwNextTicketId++;
+    }
+    else
+    {
+        m_rgRejected[eError]++;
+    }
+}
+
+size_t KenoTicketParser::parse (const char* pText, size_t cbText, bool bFinal,
+                                KenoTicketRecord* rgRecords, size_t nMaxRecords, size_t& nRecords)
+{
+    alignas (16) char rgWindow[g_cbWindow + 16];
+    KenoCharClasses   classes;
+
+    const char* p    = pText;
+    const char* pEnd = pText + cbText;
+
+    nRecords = 0;
+
+    while ( (p < pEnd) && (nRecords < nMaxRecords) )
+    {
+        // one classification serves every line that ends inside the window
+        const size_t cbAvailable = pEnd - p;
+        const char*  pWindow     = p;
+
+        if ( cbAvailable <= g_cbWindow )
+        {
+            memset (rgWindow, 0, sizeof (rgWindow));
+            memcpy (rgWindow, p, cbAvailable);
+            pWindow = rgWindow;
+        }
+
+        classifyWindow (pWindow, classes);
+
+        QWORD qwNewLines = classes.qwNewLines;
+
+        if ( qwNewLines == 0 )
+        {
+            // a line of 64 bytes or more, or the last line of the text
+            const char* pNewLine = static_cast<const char*>(memchr (p, '\n', cbAvailable));
+
+            if ( (pNewLine == nullptr) && !bFinal )
+                break;
+
+            const char* pNext = (pNewLine != nullptr) ? pNewLine + 1 : pEnd;
+            const char* pLine = (pNewLine != nullptr) ? pNewLine     : pEnd;
+
+            if ( (pLine > p) && (pLine[-1] == '\r') )
+                pLine--;
+
+            if ( pLine > p )
+                addResult (parseTicketLine (p, pLine, pEnd, m_defaults, m_qwNextTicketId, rgRecords[nRecords]), nRecords);
+
+            p = pNext;
+            continue;
+        }
+
+        DWORD dwStart = 0;
+
+        while ( (qwNewLines != 0) && (nRecords < nMaxRecords) )
+        {
+            const DWORD dwNewLine = countTrailingZeros (qwNewLines);
+            DWORD       dwLineEnd = dwNewLine;
+
+            if ( (dwLineEnd > dwStart) && (pWindow[dwLineEnd - 1] == '\r') )
+                dwLineEnd--;
+
+            if ( dwLineEnd > dwStart )
+            {
+                addResult (parseClassifiedLine (p + dwStart, dwLineEnd - dwStart, classes, dwStart,
+                                                m_defaults, m_qwNextTicketId, rgRecords[nRecords]), nRecords);
+            }
+
+            dwStart     = dwNewLine + 1;
+            qwNewLines &= qwNewLines - 1;
+        }
+
+        p += dwStart;
+    }
+
+    return p - pText;
+}
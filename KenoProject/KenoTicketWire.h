@@ -0,0 +1,143 @@
+/**
+@file       KenoTicketWire.h
+@brief      Binary ticket record and the parser of the terminal text format
+
+  Terminals submit one ticket per line:
+
+      3,17,22,41,80                               spots only
+      3,17,22,41,80;200;1500;5;123456789          spots;wager;first draw;draws;ticket id
+
+  The spots are the distinct balls 1 .. g_TOTAL_BALLS played, 1 ..
+  g_MAX_SELECTABLE_BALLS of them, separated by single commas and written
+  without leading zeros ("03" is a syntax error).  The wager is in cents
+  per draw.  A line of spots only takes the wager, first draw and number
+  of draws of the parser's KenoTicketDefaults, and as its ticket id
+  the default first id plus the number of tickets parsed before it.  Blank
+  lines are skipped, "\r\n" line ends are accepted.
+
+  The text is classified 64 bytes at a time with SSE2: one compare per
+  character class gives a bit mask of digits, commas, semicolons and line
+  ends, and byte arithmetic gives the value of the number starting at every
+  position.  Every line ending inside the window is parsed from the same
+  masks, without a search for its end; the syntax is checked with a few
+  shifts of the masks, and only the numbers themselves are visited, through
+  their start bits, each one a table lookup of its mask bits.  Range errors
+  and duplicates accumulate in the masks, so no spot takes a branch.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_TICKET_WIRE_H__
+#define __KENO_TICKET_WIRE_H__
+
+#include "KenoProbability.h"
+#include "KenoSettlement.h"
+
+constexpr const double g_fWagerCentsPerUnit = 100.0;
+constexpr const size_t g_cchMaxSpotList     = 64;      //< longest spot list accepted, 20 two digit balls take 59
+
+/**
+  Fixed width wire record of a ticket, little endian, 40 bytes
+*/
+struct KenoTicketRecord
+{
+    QWORD qwMaskLo;             //< balls  1 .. 64, ball 'n' is bit 'n - 1'
+    QWORD qwMaskHi;             //< balls 65 .. 80
+    QWORD qwTicketId;
+    DWORD dwFirstDraw;          //< first game played
+    DWORD dwWager;              //< per draw, in cents
+    WORD  wNumDraws;            //< consecutive games played, at least 1
+    BYTE  bySpots;              //< balls in the mask, 1 .. g_MAX_SELECTABLE_BALLS
+    BYTE  byReserved;
+    DWORD dwReserved;           //< 0
+};
+
+static_assert (sizeof (KenoTicketRecord) == 40, "a ticket record is 40 bytes");
+
+/**
+  @brief the settlement ticket of a record
+*/
+inline KenoTicket toKenoTicket (const KenoTicketRecord& record)
+{
+    return { record.qwMaskLo, record.qwMaskHi, record.bySpots, record.dwWager / g_fWagerCentsPerUnit };
+}
+
+enum KenoTicketError
+{
+    KENO_TICKET_VALID = 0,
+    KENO_TICKET_SYNTAX,         //< not a comma separated list of numbers without leading zeros
+    KENO_TICKET_RANGE,          //< a ball outside 1 .. g_TOTAL_BALLS
+    KENO_TICKET_DUPLICATE,      //< a ball played twice
+    KENO_TICKET_SPOTS,          //< more than g_MAX_SELECTABLE_BALLS balls
+    KENO_TICKET_FIELD,          //< a malformed or out of range wager, draw or id
+    KENO_TICKET_ERROR_COUNT
+};
+
+/// what a line of spots only is played with
+struct KenoTicketDefaults
+{
+    DWORD dwWager;              //< cents per draw
+    DWORD dwFirstDraw;
+    WORD  wNumDraws;
+    QWORD qwFirstTicketId;      //< id of the first ticket, incremented per ticket parsed
+};
+
+/**
+  @brief parseTicketLine
+
+  Parses one line, without its line end, into a record.
+
+  @param [in]  pLine        first character of the line
+  @param [in]  pEnd         end of the line
+  @param [in]  pReadable    end of the readable memory, at least pEnd; the
+                            spot list is loaded in place when 65 bytes are
+                            readable, otherwise it is copied first
+  @param [in]  defaults     wager, draws and id of a line of spots only
+  @param [in]  qwTicketId   id of a line of spots only
+  @param [out] record       receives the ticket
+
+  @retval KenoTicketError   KENO_TICKET_VALID, or why the line is rejected
+*/
+KenoTicketError parseTicketLine (const char* pLine, const char* pEnd, const char* pReadable,
+                                 const KenoTicketDefaults& defaults, QWORD qwTicketId, KenoTicketRecord& record);
+
+/**
+  Parses a stream of ticket lines into records, counting the rejected lines
+*/
+class KenoTicketParser
+{
+public:
+    explicit KenoTicketParser (const KenoTicketDefaults& defaults);
+
+    /**
+      @brief parse
+
+      Parses the complete lines of 'pText' while 'rgRecords' has room.
+
+      @param [in]  pText        ticket lines
+      @param [in]  cbText       bytes in pText
+      @param [in]  bFinal       true if pText ends the input, so a last line
+                                without a newline is complete
+      @param [out] rgRecords    receives the valid tickets
+      @param [in]  nMaxRecords  room in rgRecords
+      @param [out] nRecords     number of records written
+
+      @retval size_t            bytes of pText consumed
+    */
+    size_t parse (const char* pText, size_t cbText, bool bFinal,
+                  KenoTicketRecord* rgRecords, size_t nMaxRecords, size_t& nRecords);
+
+    QWORD  getNumParsed   (void) const { return m_qwNumParsed; }
+    QWORD  getNumRejected (KenoTicketError eError) const { return m_rgRejected[eError]; }
+
+private:
+    void addResult (KenoTicketError eError, size_t& nRecords);
+
+    KenoTicketDefaults m_defaults;
+    QWORD              m_qwNextTicketId;
+    QWORD              m_qwNumParsed;
+    QWORD              m_rgRejected[KENO_TICKET_ERROR_COUNT];
+};
+
+#endif
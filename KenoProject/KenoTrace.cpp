@@ -0,0 +1,283 @@
+/**
+@file       KenoTrace.cpp
+@brief      Implementation of the asynchronous trace writer
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "KenoTrace.h"
+
+
+/// interval at which the background writer drains the ring buffers
+constexpr const DWORD g_dwTraceDrainMilliseconds = 10;
+
+/// single producer, single consumer ring buffer of one thread
+struct KenoTraceBuffer
+{
+    std::atomic<DWORD> dwHead;                  //< next record to write, owned by the producer
+    DWORD              dwTailCache;             //< producer's last view of dwTail
+    BYTE               rgPadHead[56];
+    std::atomic<DWORD> dwTail;                  //< next record to read, owned by the writer
+    BYTE               rgPadTail[60];
+    std::atomic<DWORD> dwDropped;               //< records dropped because the buffer was full
+    std::atomic<bool>  bReleased;               //< the owning thread has exited
+    DWORD              dwThreadIndex;
+    DWORD              dwDroppedReported;
+    KenoTraceRecord    rgRecords[g_dwTraceBufferRecords];
+};
+
+/// releases the calling thread's buffer for reuse when the thread exits
+struct KenoTraceThreadSlot
+{
+    KenoTraceBuffer* pBuffer = nullptr;
+
+    ~KenoTraceThreadSlot ( )
+    {
+        if ( pBuffer != nullptr )
+            pBuffer->bReleased.store (true, std::memory_order_release);
+    }
+};
+
+/// a drained record and the thread that traced it
+struct KenoTraceEntry
+{
+    KenoTraceRecord record;
+    DWORD           dwThreadIndex;
+};
+
+struct KenoTraceContext
+{
+    std::mutex                            lockRegistry;     //< guards rgBuffers
+    std::vector<KenoTraceBuffer*>         rgBuffers;
+    std::mutex                            lockDrain;        //< serializes draining and writing
+    std::vector<KenoTraceEntry>           rgDrained;
+    FILE*                                 pFile = nullptr;
+    std::mutex                            lockWriter;       //< guards bStop
+    std::condition_variable               cvWriter;
+    bool                                  bStop = false;
+    std::thread                           threadWriter;
+    std::chrono::steady_clock::time_point tpStart;
+
+    ~KenoTraceContext ( )
+    {
+        for ( auto pBuffer : rgBuffers )
+            delete pBuffer;
+    }
+};
+
+std::atomic<bool> g_bTraceActive (false);
+
+static KenoTraceContext                 g_traceContext;
+static thread_local KenoTraceThreadSlot t_traceSlot;
+
+static const TCHAR* const g_rgszTraceLevel[] =
+{
+    _T("NONE"), _T("ERROR"), _T("WARNING"), _T("INFO"), _T("DEBUG"), _T("VERBOSE")
+};
+
+
+/**
+  @brief assigns the calling thread a ring buffer, reusing the buffer of a
+         thread that has exited where possible; the exited thread can no
+         longer write to it, so the buffer keeps a single producer
+*/
+static KenoTraceBuffer* acquireTraceBuffer (void)
+{
+    std::lock_guard<std::mutex> guard (g_traceContext.lockRegistry);
+
+    for ( auto pBuffer : g_traceContext.rgBuffers )
+    {
+        if ( pBuffer->bReleased.load (std::memory_order_acquire) )
+        {
+            pBuffer->bReleased.store (false, std::memory_order_relaxed);
+            return pBuffer;
+        }
+    }
+
+    KenoTraceBuffer* pBuffer = new KenoTraceBuffer;
+
+    pBuffer->dwHead            = 0;
+    pBuffer->dwTailCache       = 0;
+    pBuffer->dwTail            = 0;
+    pBuffer->dwDropped         = 0;
+    pBuffer->bReleased         = false;
+    pBuffer->dwThreadIndex     = static_cast<DWORD>(g_traceContext.rgBuffers.size ( ));
+    pBuffer->dwDroppedReported = 0;
+
+    g_traceContext.rgBuffers.push_back (pBuffer);
+
+    return pBuffer;
+}
+
+KenoTraceRecord* beginTraceRecord (void)
+{
+    KenoTraceBuffer* pBuffer = t_traceSlot.pBuffer;
+
+    if ( pBuffer == nullptr )
+        pBuffer = t_traceSlot.pBuffer = acquireTraceBuffer ( );
+
+    const DWORD dwHead = pBuffer->dwHead.load (std::memory_order_relaxed);
+
+    // only look at the writer's position when the cached one says the buffer is full
+    if ( dwHead - pBuffer->dwTailCache >= g_dwTraceBufferRecords )
+    {
+        pBuffer->dwTailCache = pBuffer->dwTail.load (std::memory_order_acquire);
+
+        if ( dwHead - pBuffer->dwTailCache >= g_dwTraceBufferRecords )
+        {
+            pBuffer->dwDropped.fetch_add (1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+
+    KenoTraceRecord* pRecord = &pBuffer->rgRecords[dwHead & (g_dwTraceBufferRecords - 1)];
+
+    pRecord->qwTimestamp = static_cast<QWORD>(std::chrono::steady_clock::now ( ).time_since_epoch ( ).count ( ));
+
+    return pRecord;
+}
+
+void commitTraceRecord (void)
+{
+    KenoTraceBuffer* pBuffer = t_traceSlot.pBuffer;
+
+    pBuffer->dwHead.store (pBuffer->dwHead.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+  @brief moves every published record to the writer, formats the records
+         in time order and writes them to the trace file
+*/
+static void drainTraceBuffers (void)
+{
+    std::lock_guard<std::mutex> guardDrain (g_traceContext.lockDrain);
+
+    std::vector<KenoTraceBuffer*> rgBuffers;
+    {
+        std::lock_guard<std::mutex> guard (g_traceContext.lockRegistry);
+        rgBuffers = g_traceContext.rgBuffers;
+    }
+
+    std::vector<KenoTraceEntry>& rgDrained = g_traceContext.rgDrained;
+
+    rgDrained.clear ( );
+
+    for ( auto pBuffer : rgBuffers )
+    {
+        const DWORD dwHead = pBuffer->dwHead.load (std::memory_order_acquire);
+        DWORD       dwTail = pBuffer->dwTail.load (std::memory_order_relaxed);
+
+        for ( ; dwTail != dwHead; dwTail++ )
+        {
+            rgDrained.push_back ({ pBuffer->rgRecords[dwTail & (g_dwTraceBufferRecords - 1)], pBuffer->dwThreadIndex });
+        }
+
+        pBuffer->dwTail.store (dwTail, std::memory_order_release);
+
+        const DWORD dwDropped = pBuffer->dwDropped.load (std::memory_order_relaxed);
+        if ( (dwDropped != pBuffer->dwDroppedReported) && (g_traceContext.pFile != nullptr) )
+        {
+            _ftprintf (g_traceContext.pFile, _T("T%02u: %u trace records dropped\n"),
+                       pBuffer->dwThreadIndex, dwDropped - pBuffer->dwDroppedReported);
+            pBuffer->dwDroppedReported = dwDropped;
+        }
+    }
+
+    if ( (g_traceContext.pFile == nullptr) || rgDrained.empty ( ) )
+        return;
+
+    std::stable_sort (rgDrained.begin ( ), rgDrained.end ( ),
+                      [] (const KenoTraceEntry& a, const KenoTraceEntry& b)
+                      {
+                          return a.record.qwTimestamp < b.record.qwTimestamp;
+                      });
+
+    const QWORD qwStart = static_cast<QWORD>(g_traceContext.tpStart.time_since_epoch ( ).count ( ));
+    const double fTickSeconds = static_cast<double>(std::chrono::steady_clock::period::num) /
+                                std::chrono::steady_clock::period::den;
+
+    TCHAR szMessage[512] = { 0 };
+
+    for ( const auto& entry : rgDrained )
+    {
+        const KenoTraceRecord& record = entry.record;
+
+        const DWORD  dwLevel  = (record.dwLevel < _countof (g_rgszTraceLevel)) ? record.dwLevel : 0;
+        const double fSeconds = (record.qwTimestamp > qwStart) ? (record.qwTimestamp - qwStart) * fTickSeconds : 0.0;
+
+        record.pfnFormat (szMessage, _countof (szMessage) - 1, record.szFmt, record.rgArgs);
+        szMessage[_countof (szMessage) - 1] = _T('\0');
+
+        _ftprintf (g_traceContext.pFile, _T("%12.6f T%02u %-7s %s\n"), fSeconds, entry.dwThreadIndex,
+                   g_rgszTraceLevel[dwLevel], szMessage);
+    }
+
+    fflush (g_traceContext.pFile);
+}
+
+static void runTraceWriter (void)
+{
+    std::unique_lock<std::mutex> guard (g_traceContext.lockWriter);
+
+    while ( !g_traceContext.bStop )
+    {
+        g_traceContext.cvWriter.wait_for (guard, std::chrono::milliseconds (g_dwTraceDrainMilliseconds));
+
+        guard.unlock ( );
+        drainTraceBuffers ( );
+        guard.lock ( );
+    }
+}
+
+bool startTrace (const TCHAR* szPath)
+{
+    if ( g_bTraceActive.load ( ) )
+        return false;
+
+    g_traceContext.pFile = _tfopen (szPath, _T ("w"));
+    if ( g_traceContext.pFile == nullptr )
+        return false;
+
+    // a large buffer turns every drain into a few writes
+    setvbuf (g_traceContext.pFile, nullptr, _IOFBF, 1 << 16);
+
+    g_traceContext.tpStart      = std::chrono::steady_clock::now ( );
+    g_traceContext.bStop        = false;
+    g_traceContext.threadWriter = std::thread (runTraceWriter);
+
+    g_bTraceActive.store (true);
+
+    return true;
+}
+
+void flushTrace (void)
+{
+    drainTraceBuffers ( );
+}
+
+void stopTrace (void)
+{
+    if ( !g_bTraceActive.exchange (false) )
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard (g_traceContext.lockWriter);
+        g_traceContext.bStop = true;
+    }
+
+    g_traceContext.cvWriter.notify_one ( );
+    g_traceContext.threadWriter.join ( );
+
+    drainTraceBuffers ( );
+
+    fclose (g_traceContext.pFile);
+    g_traceContext.pFile = nullptr;
+}
@@ -0,0 +1,181 @@
+/**
+@file       KenoTrace.h
+@brief      Asynchronous, low overhead tracing
+
+  Every thread writes its trace records into its own lock-free ring buffer;
+  a record holds only the time stamp, the (static) format string and a
+  binary copy of the arguments.  A background thread drains the buffers,
+  orders the records by time, formats them and writes them to the trace
+  file, so a trace costs the calling thread a clock read and a few stores.
+
+  Trace levels above KENO_TRACE_LEVEL are compiled out entirely.  When a
+  ring buffer is full the record is dropped and counted rather than making
+  the simulation wait for the writer.
+
+  Format arguments are copied by value, so they must be numbers or pointers
+  to strings that outlive the trace, i.e. literals or static tables.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_TRACE_H__
+#define __KENO_TRACE_H__
+
+#include <atomic>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "KenoProbability.h"
+
+#define KENO_TRACE_LEVEL_ERROR      1
+#define KENO_TRACE_LEVEL_WARNING    2
+#define KENO_TRACE_LEVEL_INFO       3
+#define KENO_TRACE_LEVEL_DEBUG      4
+#define KENO_TRACE_LEVEL_VERBOSE    5
+
+#ifndef KENO_TRACE_LEVEL
+    #ifdef _DEBUG
+        #define KENO_TRACE_LEVEL    KENO_TRACE_LEVEL_VERBOSE
+    #else
+        #define KENO_TRACE_LEVEL    KENO_TRACE_LEVEL_INFO
+    #endif
+#endif
+
+#define KENO_TRACE_ERROR(szFmt, ...)    writeTrace (KENO_TRACE_LEVEL_ERROR, szFmt, ##__VA_ARGS__)
+
+#if KENO_TRACE_LEVEL >= KENO_TRACE_LEVEL_WARNING
+    #define KENO_TRACE_WARNING(szFmt, ...)  writeTrace (KENO_TRACE_LEVEL_WARNING, szFmt, ##__VA_ARGS__)
+#else
+    #define KENO_TRACE_WARNING(szFmt, ...)  ((void) 0)
+#endif
+
+#if KENO_TRACE_LEVEL >= KENO_TRACE_LEVEL_INFO
+    #define KENO_TRACE_INFO(szFmt, ...)     writeTrace (KENO_TRACE_LEVEL_INFO, szFmt, ##__VA_ARGS__)
+#else
+    #define KENO_TRACE_INFO(szFmt, ...)     ((void) 0)
+#endif
+
+#if KENO_TRACE_LEVEL >= KENO_TRACE_LEVEL_DEBUG
+    #define KENO_TRACE_DEBUG(szFmt, ...)    writeTrace (KENO_TRACE_LEVEL_DEBUG, szFmt, ##__VA_ARGS__)
+#else
+    #define KENO_TRACE_DEBUG(szFmt, ...)    ((void) 0)
+#endif
+
+#if KENO_TRACE_LEVEL >= KENO_TRACE_LEVEL_VERBOSE
+    #define KENO_TRACE_VERBOSE(szFmt, ...)  writeTrace (KENO_TRACE_LEVEL_VERBOSE, szFmt, ##__VA_ARGS__)
+#else
+    #define KENO_TRACE_VERBOSE(szFmt, ...)  ((void) 0)
+#endif
+
+constexpr const size_t g_cbTraceArgs          = 48;     //< argument bytes per record
+constexpr const DWORD  g_dwTraceBufferRecords = 4096;   //< records per thread, a power of 2
+
+typedef int (*KenoTraceFormatFn) (TCHAR* szBuffer, size_t cchBuffer, const TCHAR* szFmt, const void* pArgs);
+
+struct KenoTraceRecord
+{
+    QWORD             qwTimestamp;      //< steady clock ticks
+    KenoTraceFormatFn pfnFormat;        //< formats rgArgs, instantiated per argument list
+    const TCHAR*      szFmt;
+    DWORD             dwLevel;
+    QWORD             rgArgs[g_cbTraceArgs / sizeof (QWORD)];
+};
+
+extern std::atomic<bool> g_bTraceActive;
+
+/**
+  @brief startTrace
+
+  Opens the trace file and starts the background writer.
+
+  @param [in] szPath        trace file path
+
+  @retval bool              true on success
+*/
+bool startTrace (const TCHAR* szPath);
+
+/**
+  @brief writes every record traced so far to the trace file
+*/
+void flushTrace (void);
+
+/**
+  @brief flushes the trace, stops the background writer and closes the file
+*/
+void stopTrace (void);
+
+/**
+  @brief reserves the next record of the calling thread's ring buffer
+
+  @retval KenoTraceRecord*  time stamped record, or nullptr if tracing is
+                            stopped or the buffer is full
+*/
+KenoTraceRecord* beginTraceRecord (void);
+
+/**
+  @brief publishes the record reserved by beginTraceRecord to the writer
+*/
+void commitTraceRecord (void);
+
+
+template <typename... TArgs>
+struct KenoTraceArgsValid : std::true_type { };
+
+template <typename TArg, typename... TArgs>
+struct KenoTraceArgsValid<TArg, TArgs...>
+    : std::integral_constant<bool, (std::is_arithmetic<TArg>::value || std::is_pointer<TArg>::value ||
+                                    std::is_enum<TArg>::value) && KenoTraceArgsValid<TArgs...>::value>
+{
+};
+
+template <typename TPack, size_t... nIndex>
+inline int formatTracePack (TCHAR* szBuffer, size_t cchBuffer, const TCHAR* szFmt, const TPack& pack,
+                            std::index_sequence<nIndex...>)
+{
+    return _sntprintf (szBuffer, cchBuffer, szFmt, std::get<nIndex> (pack)...);
+}
+
+template <typename... TArgs>
+int formatTraceArgs (TCHAR* szBuffer, size_t cchBuffer, const TCHAR* szFmt, const void* pArgs)
+{
+    return formatTracePack (szBuffer, cchBuffer, szFmt, *static_cast<const std::tuple<TArgs...>*>(pArgs),
+                            std::index_sequence_for<TArgs...> ( ));
+}
+
+/**
+  @brief writeTrace
+
+  Use through the KENO_TRACE_xxx macros, which compile out the levels above
+  KENO_TRACE_LEVEL.
+
+  @param [in] dwLevel       KENO_TRACE_LEVEL_xxx
+  @param [in] szFmt         printf style format string, must be static
+  @param [in] args          format arguments, copied into the record
+*/
+template <typename... TArgs>
+inline void writeTrace (DWORD dwLevel, const TCHAR* szFmt, const TArgs&... args)
+{
+    typedef std::tuple<typename std::decay<TArgs>::type...> KenoTracePack;
+
+    static_assert (KenoTraceArgsValid<typename std::decay<TArgs>::type...>::value,
+                   "trace arguments must be numbers or pointers");
+    static_assert (sizeof (KenoTracePack) <= g_cbTraceArgs, "too many trace arguments");
+
+    if ( !g_bTraceActive.load (std::memory_order_relaxed) )
+        return;
+
+    KenoTraceRecord* pRecord = beginTraceRecord ( );
+    if ( pRecord == nullptr )
+        return;
+
+    pRecord->pfnFormat = &formatTraceArgs<typename std::decay<TArgs>::type...>;
+    pRecord->szFmt     = szFmt;
+    pRecord->dwLevel   = dwLevel;
+    new (pRecord->rgArgs) KenoTracePack (args...);
+
+    commitTraceRecord ( );
+}
+
+#endif
@@ -0,0 +1,77 @@
+/**
+@file       KenoVariants.cpp
+@brief      Implementation of the multiplier and bonus ball game variants
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+#include "KenoVariants.h"
+
+
+/// The variants currently offered, settled alongside the base pay table
+const KenoVariant g_rgVariantCatalog[] =
+{
+    { _T("Multiplier"), KENO_VARIANT_MULTIPLIER, 1.0, 5, { { 1.0, 0.50 }, { 2.0, 0.30 }, { 3.0, 0.12 }, { 5.0, 0.06 }, { 10.0, 0.02 } } },
+    { _T("Power Ball"), KENO_VARIANT_LAST_BALL,  4.0, 0, { } },
+    { _T("Bullseye"),   KENO_VARIANT_BULLSEYE,   3.0, 0, { } },
+};
+
+const int g_nVariantCatalogSize = _countof (g_rgVariantCatalog);
+
+static_assert (_countof (g_rgVariantCatalog) <= g_MAX_VARIANTS, "variant catalog exceeds g_MAX_VARIANTS");
+
+double g_rgVariantExpectedValue[g_MAX_VARIANTS][g_MAX_SPOTS_MARKED] = { 0.0 };
+
+
+double calcExpectedMultiplier (const KenoVariant& variant)
+{
+    if ( variant.eType != KENO_VARIANT_MULTIPLIER )
+        return 1.0;
+
+    double fResult = 0.0;
+
+    for ( int k = 0; k < variant.nMultipliers; k++ )
+    {
+        fResult += variant.rgMultipliers[k].fMultiplier * variant.rgMultipliers[k].fProbability;
+    }
+
+    return fResult;
+}
+
+double calcVariantExpectedValues (const double (&rgProbability)[g_MAX_COLS], const KenoPayOutRow& rgPayOut,
+                                  const KenoVariant* rgVariants, int nVariants, double* rgVariantEV)
+{
+    double rgMultiplier[g_MAX_VARIANTS] = { 0.0 };
+
+    for ( int v = 0; v < nVariants; v++ )
+    {
+        rgMultiplier[v] = calcExpectedMultiplier (rgVariants[v]);
+        rgVariantEV[v]  = 0.0;
+    }
+
+    double fBaseEV = 0.0;
+
+    for ( int j = 0; j < g_MAX_PAYOUT_COLS; j++ )    // j + 1 = 'number of balls caught'
+    {
+        const double fTerm = rgProbability[j + 1] * rgPayOut[j];     // KP(M, C) * PO(M, C)
+
+        if ( fTerm == 0.0 )
+            continue;
+
+        // P(bonus ball caught | C caught) = C / 20
+        const double fBonusShare = static_cast<double>(j + 1) / g_BALLS_DRAWN;
+
+        fBaseEV += fTerm;
+
+        for ( int v = 0; v < nVariants; v++ )
+        {
+            if ( rgVariants[v].eType == KENO_VARIANT_MULTIPLIER )
+                rgVariantEV[v] += fTerm * rgMultiplier[v];
+            else
+                rgVariantEV[v] += fTerm * (1.0 + fBonusShare * (rgVariants[v].fBoost - 1.0));
+        }
+    }
+
+    return fBaseEV;
+}
@@ -0,0 +1,85 @@
+/**
+@file       KenoVariants.h
+@brief      Multiplier and bonus ball game variant declarations
+
+  Variants modify the base pay out of a ticket without changing which balls
+  are drawn:
+
+    - Multiplier : a random multiplier, drawn independently of the balls,
+                   applies to every prize of the game, so
+                   EV = E[multiplier] * EV(base)
+    - Last Ball  : the prize is boosted when the last (20th) drawn ball is
+                   one of the player's caught spots ("Power Keno")
+    - Bullseye   : the prize is boosted when a designated ball, chosen
+                   uniformly from the 20 drawn balls, is caught
+
+  Given the set of drawn balls, both the last ball and the bullseye ball are
+  equally likely to be any of the 20 drawn balls, so a catch of C spots
+  contains the bonus ball with probability C / 20.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#ifndef __KENO_VARIANTS_H__
+#define __KENO_VARIANTS_H__
+
+#include "KenoProbability.h"
+
+constexpr const int g_MAX_VARIANTS    = 4;  //< maximum number of variants settled in one pass
+constexpr const int g_MAX_MULTIPLIERS = 8;  //< maximum number of outcomes of a multiplier wheel
+
+enum KenoVariantType
+{
+    KENO_VARIANT_MULTIPLIER = 0,
+    KENO_VARIANT_LAST_BALL,
+    KENO_VARIANT_BULLSEYE
+};
+
+/// One outcome of a multiplier wheel
+struct KenoMultiplierOutcome
+{
+    double fMultiplier;
+    double fProbability;
+};
+
+struct KenoVariant
+{
+    const TCHAR*          szName;
+    KenoVariantType       eType;
+    double                fBoost;                           //< prize factor when the bonus ball is caught
+    int                   nMultipliers;                     //< number of valid entries in rgMultipliers
+    KenoMultiplierOutcome rgMultipliers[g_MAX_MULTIPLIERS]; //< multiplier wheel, probabilities sum to 1
+};
+
+extern const KenoVariant g_rgVariantCatalog[];
+extern const int         g_nVariantCatalogSize;
+
+/// Expected value of a $1 bet for each variant, indexed like g_rgExpectedValue
+extern double g_rgVariantExpectedValue[g_MAX_VARIANTS][g_MAX_SPOTS_MARKED];
+
+/**
+  @brief calcExpectedMultiplier
+
+  @retval double    the mean of the variant's multiplier wheel, 1.0 for bonus ball variants
+*/
+double calcExpectedMultiplier (const KenoVariant& variant);
+
+/**
+  @brief calcVariantExpectedValues
+
+  Evaluates the base expected value and every variant's expected value of a
+  $1 bet in a single pass over the catch sizes of one pay out row.
+
+  @param [in]  rgProbability    probability row for M spots marked, indexed by catch size
+  @param [in]  rgPayOut         base pay out row for M spots marked
+  @param [in]  rgVariants       variants to evaluate
+  @param [in]  nVariants        number of variants (<= g_MAX_VARIANTS)
+  @param [out] rgVariantEV      receives the expected value of every variant
+
+  @retval double                containing the base expected value
+*/
+double calcVariantExpectedValues (const double (&rgProbability)[g_MAX_COLS], const KenoPayOutRow& rgPayOut,
+                                  const KenoVariant* rgVariants, int nVariants, double* rgVariantEV);
+
+#endif
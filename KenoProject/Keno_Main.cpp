@@ -34,197 +34,60 @@
 */
 
 #include "stdafx.h"
-#include <iostream>
-#include <iomanip>
 #include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "DebugUtility.h"
+#include "KenoProbability.h"
+#include "KenoLogProbability.h"
+#include "KenoTableCache.h"
+#include "KenoBatch.h"
+#include "KenoColumnar.h"
+#include "KenoDelimited.h"
+#include "KenoService.h"
+#include "KenoSimulator.h"
+#include "KenoSideBets.h"
+#include "KenoJackpot.h"
+#include "KenoAdaptive.h"
+#include "KenoCheckpoint.h"
+#include "KenoTrace.h"
 
 
-typedef unsigned __int64 QWORD;    //< 64 bit unsigned integer  (0 to 18,446,744,073,709,551,615)
-
-
-
-QWORD    calcFactorial       (WORD wN);
-double   calcPartialFactorial(WORD wN, WORD wNumTerms);
-DWORD    calcCombinations    (DWORD dwN, DWORD dwR);
-double   calcKenoProbability (DWORD dwNumMarked, DWORD dwCatch);
-
-
-constexpr const int g_MAX_ROWS             = 20;   //< used to set array bounds where the index = '(number of player 'marked' balls) - 1'
-constexpr const int g_MAX_COLS             = 21;   //< used to set array bounds where the index = to catch size
-constexpr const int g_TOTAL_BALLS          = 80;   //< This is the total of balls (1..80) in the simulation
-constexpr const int g_MAX_SELECTABLE_BALLS = 20;   //< This is the maximum number of player selectable balls allowed.
 
 /// Relative output path
 constexpr const TCHAR g_szOutputDataPath[] = _T("\\Data\\");
 /// Save the values in "Keno.xlsx"
 constexpr const TCHAR g_szFileName[] = _T("Keno.xlsx");
-
-/// The entries in the [ith] row assumes that the player has 'marked' i numbers
-/// The entry in the [jth] column is the probability that the player catches j spots out of i possible
-double g_rgProbability[g_MAX_ROWS][g_MAX_COLS] = { 0.0 }; //< array for calculated probability matrix
-
-constexpr const int g_MAX_PAYOUT_ROWS  = 9; //< corresponds to 'spot(s) marked + 1'
-constexpr const int g_MAX_PAYOUT_COLS  = 9; //< corresponds to 'number of balls caught + 1'
-constexpr const int g_MAX_SPOTS_MARKED = 9;
-                               
-constexpr const double g_rgCatchPayOut[g_MAX_PAYOUT_ROWS][g_MAX_PAYOUT_COLS] = 
-//Catch  1     2     3     4       5       6       7        8        9
-    { { 3.0,  0.0,  0.0,  0.0,    0.0,    0.0,    0.0,     0.0,     0.0 },   // 1 Spot marked
-      { 0.0, 12.0,  0.0,  0.0,    0.0,    0.0,    0.0,     0.0,     0.0 },   // 2 Spots marked
-      { 0.0,  1.0, 42.0,  0.0,    0.0,    0.0,    0.0,     0.0,     0.0 },   // 3 Spots marked
-      { 0.0,  1.0,  3.0, 120.0,   0.0,    0.0,    0.0,     0.0,     0.0 },   // 4 Spots marked
-      { 0.0,  0.0,  1.0,   9.0, 800.0,    0.0,    0.0,     0.0,     0.0 },   // 5 Spots marked
-      { 0.0,  0.0,  1.0,   4.0,  88.0, 1500.0,    0.0,     0.0,     0.0 },   // 6 Spots marked
-      { 0.0,  0.0,  0.0,   2.0,  20.0,  350.0,  700.0,     0.0,     0.0 },   // 7 Spots marked
-      { 0.0,  0.0,  0.0,   0.0,   9.0,   90.0, 1500.0, 20000.0,     0.0 },   // 8 Spots marked
-      { 0.0,  0.0,  0.0,   0.0,   4.0,   43.0, 3000.0,  4000.0, 25000.0 } }; // 9 Spots marked
-
-/**
-@sa http://en.wikipedia.org/wiki/Expected_value
-*/
-double g_rgExpectedValue[g_MAX_SPOTS_MARKED] = { 0.0 };
-
-
-/**
-  @brief calcFactorial
-
-  A recursive factorial implimentation
-
-  @param [in] wN       value used for factorial operation
-
-  @retval QWORD         containing computed results
-
-  @note the return result can get very big and possibly overflow, 
-        there are not checks for this
-*/
-QWORD calcFactorial (WORD wN)
-{
-    if ( wN > 1 )
-        return wN * calcFactorial ( wN - 1 );
-    else
-        return 1;
-}
-
-/**
-  @brief calcPartialFactorial 
- 
-  This performs a factorial computation of 'wN' utilizing only a 
-  'wNumTerms' number of the highest valued terms of in traditional 
-  factorial computation.
-
-  For example, calcPartialFactorial(10, 4) would initiate a factorial
-  computation, but would stop after evaluating the top 4 terms as follows:
-    ( 10 * 9 * 7 * 6 )
-
-  If 'wNumTerms' == 0, then a '1' is immediately returned.
-
-  @param [in] wN                initial term
-  @param [in] wNumTerms         number of terms used in partial factorial
-
-  @retval double                containing the calculated partial factorial
-*/
-double calcPartialFactorial (WORD wN, WORD wNumTerms)
-{
-#ifdef _DEBUG
-    DebugTrace (_T ("   %s: N[%d] NumTerms[%3d]"), __FUNCTIONW__, wN, wNumTerms);
-#endif _DEBUG
-
-    double fResult = 1.0;
-
-    for ( WORD i = 0; i < wNumTerms; i++ )
-    {
-        fResult = fResult * (wN - i);
-    }
-
-#ifdef _DEBUG
-    DebugTrace (_T ("= %f \n"), fResult);
-#endif _DEBUG
-
-    return fResult;
-}
-
-/**
-  @brief calcCombinations - "N things taken R at a time, without repetition"
-
-  Combination is the quantity of subgroups of a size 'R' that can be formed 
-  out of a group of a size 'N' in which the order is NOT important.  For example
-  given 3 fruits (an apple, an orange and a pear), there are 3 combinations of 2
-  that can be drawn from this set: {apple, pear}, {apple, orange}, {pear, orange}.
-  This expression is often written mathematically as C (N, R) where R is less than 
-  or equal to N, calculated as N! / R!(N-R)! and which is 0 when R > N.
- 
-  @param [in] dwN           Group Size - number of things to choose from
-  @param [in] dwR           Subgroup Size - number of things chosen
-
-  @retval DWORD  containing the number of 'dwR' sized subgroups that can be 
-                 formed from a set containing 'dwN' number of elements.
-
-  @sa http://en.wikipedia.org/wiki/Combination
-*/
-DWORD calcCombinations (DWORD dwN, DWORD dwR)
-{ 
-#ifdef _DEBUG
-    DebugTrace (_T ("   %s: N[%d] R[%d]"), __FUNCTIONW__, dwN, dwR);
-#endif
-
-    DWORD dwResult = 0;
-
-    if ( dwR <= dwN )
-    {
-        const QWORD qwNFactorial   = calcFactorial ( static_cast<WORD>(dwN) );
-        const QWORD qwRFactorial   = calcFactorial ( static_cast<WORD>(dwR) );
-
-        const QWORD qwDifFactorial = calcFactorial ( static_cast<WORD>(dwN - dwR) );
-
-        dwResult = static_cast<DWORD>(qwNFactorial / (qwRFactorial * qwDifFactorial));
-    }
-
-#if _DEBUG
-    DebugTrace (_T ("= %u \n"), dwResult);
-#endif
-
-    return dwResult;
-}
-
-/**
-  @brief calcKenoProbability
-
-  Calulates the probability of a 'dwCaught' sized catch from any set of 
-  'dwNumMarked' number of player picked balls, based on a total of 80 KENO balls
-  with the maximum number of balls selectable being 20.
-
-  @param [in] dwNumMarked       The number of KENO ball spots a player has 'marked' or 
-                                selected 
-  @param [in] dwCaught          The catch size of interest which probability is calculated 
-                                against
-
-  @retval double         containing the calculated probability of a matching a subset of 
-                         potential 'dwCaught' sized number of balls from a set consisting 
-                         of 'dwNumMarked' number of spots from the possible 20 selectable balls.
-*/
-double  calcKenoProbability ( DWORD dwNumMarked, DWORD dwCaught )
-{
-#ifdef _DEBUG
-    DebugTrace (_T ("%s: NumMarked[%d] Caught[%d] \n"), __FUNCTIONW__, dwNumMarked, dwCaught);
-#endif _DEBUG
-
-    double fResult = 0.0;
-
-    const DWORD dwNumCombinations = calcCombinations (dwNumMarked, dwCaught);
-    const double qwP1 = calcPartialFactorial ( static_cast<WORD>(g_MAX_SELECTABLE_BALLS), static_cast<WORD>(dwCaught) );
-    const double qwP2 = calcPartialFactorial ( static_cast<WORD>(g_TOTAL_BALLS - g_MAX_SELECTABLE_BALLS), static_cast<WORD>(dwNumMarked - dwCaught) );
-    const double qwP3 = calcPartialFactorial ( static_cast<WORD>(g_TOTAL_BALLS), static_cast<WORD>(dwNumMarked) );
-
-// the actual formula given was C(N, R) * P1 * P2 / P3
-    fResult = static_cast<double>(dwNumCombinations) * qwP1 * qwP2 / qwP3;
-
-#ifdef _DEBUG
-    DebugTrace (_T ("= %.20f \n"), fResult);
-#endif _DEBUG
-
-    return fResult;
-}
+/// Trace output file
+constexpr const TCHAR g_szTraceFileName[] = _T("KenoProject_dbg.txt");
+
+/// Default number of simulated games used by '-verify'
+constexpr const QWORD g_qwDefaultVerifyDraws = 10000000;
+/// Half-width, in standard errors, of the '-verify' confidence band
+constexpr const double g_fVerifyZScore = 4.5;
+/// Default number of importance sampled games per pay table row used by '-rare'
+constexpr const QWORD g_qwDefaultRareDraws = 1000000;
+/// Share of the '-rare' draws spread evenly over the paying tiers
+constexpr const double g_fRareBiasMass = 0.5;
+/// Default relative standard error requested by '-adaptive'
+constexpr const double g_fDefaultAdaptiveError = 0.005;
+/// Draw limit of every '-adaptive' scenario
+constexpr const QWORD g_qwAdaptiveMaxDraws = 1000000000;
+/// Seconds between '-adaptive' checkpoints
+constexpr const DWORD g_dwCheckpointSeconds = 60;
+/// Default Unix domain socket of '-serve', in the working directory
+constexpr const char g_szDefaultServiceSocket[] = "keno.sock";
+/// Files of '-export', without the extension of the format
+constexpr const TCHAR g_szProbabilityExportFile[]   = _T("KenoProbability");
+constexpr const TCHAR g_szExpectedValueExportFile[] = _T("KenoExpectedValue");
+/// Pay table file of '-serve', in the working directory, reloaded when it changes
+constexpr const TCHAR g_szServicePayTableFile[] = _T("KenoPayTables.txt");
+/// Seconds between the '-serve' query rate reports
+constexpr const DWORD g_dwServiceReportSeconds = 10;
 
 
 #pragma region import_block
@@ -390,9 +253,7 @@ int ExportDataToExcel(void)
 
     if ( FAILED (pXL.CreateInstance ("Excel.Application")) )
     {
-#ifdef _DEBUG
-        dbg << "Failed to initialize Excel::_Application!" << std::endl;
-#endif
+        KENO_TRACE_ERROR (_T ("Failed to initialize Excel::_Application!"));
         return 0;
     }
 
@@ -457,118 +318,641 @@ int ExportDataToExcel(void)
 
 
 
-int _tmain(int argc, _TCHAR* argv[])
+/**
+  @brief VerifyPayTableCatalog
+
+  Cross-checks the expected value of every pay table in the catalog, and of
+  every variant played on it, against a Monte Carlo simulation, and reports
+  any row whose simulated return falls outside of the confidence band.  The
+  side bet distributions are cross-checked the same way.
+
+  @param [in] qwNumDraws      number of simulated games per pay table
+
+  @retval int                 0 if every check passed, 1 otherwise
+*/
+int VerifyPayTableCatalog (QWORD qwNumDraws)
 {
+    int iResult = 0;
 
-#ifdef _DEBUG
+    for ( int t = 0; t < g_nPayTableCatalogSize; t++ )
+    {
+        // slot 0 holds the base table, slot v + 1 holds variant 'v'
+        KenoCrossCheckResult rgResults[g_MAX_VARIANTS + 1][g_MAX_SPOTS_MARKED];
 
-    dbg.open(_T("KenoProject_dbg.txt"));
+        const bool bPassed = crossCheckVariants (g_rgPayTableCatalog[t], g_rgVariantCatalog, g_nVariantCatalogSize,
+                                                 qwNumDraws, 0x4B454E4FULL + t, g_fVerifyZScore, rgResults);
 
-    dbg << std::setprecision (10);
+        _tprintf (_T ("Pay table '%s': %llu draws %s\n"), g_rgPayTableCatalog[t].szName, 
+                  qwNumDraws, bPassed ? _T ("PASSED") : _T ("FAILED"));
 
-    dbg << "Calculating Keno Probabilites Value(s)"        << std::endl;
-    dbg << "---------------------------------------------" << std::endl;
+        for ( int v = 0; v <= g_nVariantCatalogSize; v++ )
+        {
+            _tprintf (_T (" %s\n"), (v == 0) ? _T ("Base") : g_rgVariantCatalog[v - 1].szName);
 
-#endif
+            for ( const auto& result : rgResults[v] )
+            {
+                _tprintf (_T ("  %d Spot(s) Marked  exact RTP %.6f  simulated %.6f +/- %.6f  %s\n"),
+                          result.dwNumMarked, result.fExactRTP, result.fSimulatedRTP, result.fStdError,
+                          result.bWithinBand ? _T ("ok") : _T ("OUT OF BAND"));
+            }
+        }
 
-    // Calculate the array of Keno probabilities
+        if ( !bPassed )
+            iResult = 1;
+    }
+
+    const int nOutOfBand = crossCheckSideBets (qwNumDraws, 0x53494445ULL, g_fVerifyZScore);
+
+    _tprintf (_T ("Side bets: %llu draws %s\n"), qwNumDraws, (nOutOfBand == 0) ? _T ("PASSED") : _T ("FAILED"));
+
+    if ( nOutOfBand != 0 )
+        iResult = 1;
+
+    return iResult;
+}
+
+/**
+  @brief ProjectJackpotLiability
 
-    for ( int i = 0; i < g_MAX_ROWS; i++ )      // i + 1 = '(number of spots 'marked')'
+  Simulates every progressive jackpot scenario and prints the projected
+  jackpot size and time to hit.
+
+  @retval int                 0
+*/
+int ProjectJackpotLiability (void)
+{
+    std::vector<KenoJackpotResult> rgResults;
+
+    simulateJackpotScenarios (g_rgJackpotScenarios, g_nJackpotScenarioCount, 0x4A41434BULL, rgResults);
+
+    for ( int s = 0; s < g_nJackpotScenarioCount; s++ )
     {
-        const int iNumSpotsMarked = i + 1;  // this is for readability
-        for ( int j = 0; j < g_MAX_COLS; j++ )  // j = balls caught 
+        const KenoJackpotScenario& scenario = g_rgJackpotScenarios[s];
+        const KenoJackpotResult&   result   = rgResults[s];
+
+        _tprintf (_T ("Jackpot '%s': %u runs of %u years, %llu hits, %llu winners\n"), scenario.szName,
+                  scenario.dwNumRuns, scenario.dwYears, result.qwNumHits, result.qwNumWinners);
+        _tprintf (_T ("  jackpot when hit    mean %.2f  p50 %.2f  p99 %.2f  max %.2f\n"),
+                  result.fMeanJackpot, result.fJackpotP50, result.fJackpotP99, result.fMaxJackpot);
+        _tprintf (_T ("  days to hit         mean %.2f  p50 %.2f  p99 %.2f\n"),
+                  result.fMeanDaysToHit, result.fDaysToHitP50, result.fDaysToHitP99);
+        _tprintf (_T ("  open liability %.2f  paid per $1 wagered %.6f\n"),
+                  result.fMeanOpenLiability, result.fPaidPerWager);
+    }
+
+    return 0;
+}
+
+/**
+  @brief EstimateRareTierLiability
+
+  Estimates the liability of every paying tier of the pay table catalog by
+  importance sampling, and prints the 95% confidence interval of each tier
+  along with the variance reduction over plain Monte Carlo.
+
+  @param [in] qwNumDraws      number of simulated games per pay table row
+
+  @retval int                 0
+*/
+int EstimateRareTierLiability (QWORD qwNumDraws)
+{
+    for ( int t = 0; t < g_nPayTableCatalogSize; t++ )
+    {
+        _tprintf (_T ("Pay table '%s': %llu importance sampled draws per row\n"), 
+                  g_rgPayTableCatalog[t].szName, qwNumDraws);
+
+        for ( DWORD m = 1; m <= g_MAX_SPOTS_MARKED; m++ )
         {
-            if ( iNumSpotsMarked >= j )
-            { 
-#ifdef _DEBUG
-                dbg << "Calculating probability of a catch of [" << j << "] balls out of [" << iNumSpotsMarked << "] 'marked' numbers = ";
-#endif
-                // Probability of 'j' Ball(s) caught from set of 'i+1' player 'marked' spots or numbers
-                g_rgProbability[i][j] = calcKenoProbability ( iNumSpotsMarked, j );
-#ifdef _DEBUG
-                dbg << g_rgProbability[i][j] << std::endl;
-#endif
-            }
-            else
+            KenoRareTierEstimate rgEstimates[g_MAX_SPOTS_MARKED + 1];
+
+            estimateRareTierLiability (g_rgPayTableCatalog[t], m, g_fRareBiasMass, qwNumDraws, 
+                                       0x52415245ULL + m, rgEstimates);
+
+            for ( DWORD c = 1; c <= m; c++ )
             {
-                // probability is zero
+                const KenoRareTierEstimate& estimate = rgEstimates[c];
+
+                if ( estimate.fExactLiability == 0.0 )
+                    continue;
+
+                _tprintf (_T ("  %u of %u  exact %.8e  estimate %.8e +/- %.2e  variance reduction %.1fx\n"),
+                          c, m, estimate.fExactLiability, estimate.fLiability, 1.96 * estimate.fStdError,
+                          estimate.fVarianceReduction);
             }
         }
     }
 
-#ifdef _DEBUG
+    return 0;
+}
+
+/**
+  @brief WriteExportTable
+
+  Writes 'table' as CSV for a ".csv" path, TSV for a ".tsv" path
+  (KenoDelimited.h) and as a columnar file with delta coded integer
+  columns otherwise (KenoColumnar.h).
+
+  @param [in] szPath          output file
+  @param [in] table           table to write
+  @param [in] pWriter         text writer whose buffer is reused, or nullptr
+
+  @retval bool                false if the file cannot be written
+*/
+bool WriteExportTable (const TCHAR* szPath, const KenoExportTable& table, KenoDelimitedWriter* pWriter)
+{
+    const TCHAR* szExtension = _tcsrchr (szPath, _T('.'));
+
+    const bool bCsv = (szExtension != nullptr) && (_tcsicmp (szExtension, _T (".csv")) == 0);
+    const bool bTsv = (szExtension != nullptr) && (_tcsicmp (szExtension, _T (".tsv")) == 0);
+
+    if ( bCsv || bTsv )
+    {
+        const KenoDelimitedFormat eFormat = bTsv ? KENO_DELIMITED_TSV : KENO_DELIMITED_CSV;
+
+        return (pWriter != nullptr) ? pWriter->write (szPath, table, eFormat)
+                                    : writeDelimitedTable (szPath, table, eFormat);
+    }
+
+    return writeColumnarTable (szPath, table, KENO_CODEC_DELTA_VARINT);
+}
+
+/**
+  @brief RunAdaptiveSimulation
+
+  Simulates every row of the pay table catalog until its RTP, and separately
+  every cell of its probability row that can within the draw limit
+  (isAdaptiveCellReachable), reaches the requested relative error.
+
+  If a checkpoint path is given, the simulation resumes from the checkpoint
+  when it exists and matches, checkpoints itself periodically and reports
+  the number of checkpoints written.  If an
+  export path is given, the catch histograms of every scenario are written
+  to it, in the format of its extension (WriteExportTable).
+
+  @param [in] fRelativeError  requested relative standard error
+  @param [in] szCheckpoint    checkpoint file path, or nullptr
+  @param [in] szExport        histogram export path, or nullptr
+
+  @retval int                 0 if every scenario converged, 1 otherwise
+*/
+int RunAdaptiveSimulation (double fRelativeError, const TCHAR* szCheckpoint, const TCHAR* szExport)
+{
+    std::vector<KenoAdaptiveScenario> rgScenarios;
+
+    for ( int t = 0; t < g_nPayTableCatalogSize; t++ )
+    {
+        for ( DWORD m = 1; m <= g_MAX_SPOTS_MARKED; m++ )
+        {
+            rgScenarios.push_back ({ &g_rgPayTableCatalog[t], m, KENO_TARGET_RTP,         fRelativeError, g_qwAdaptiveMaxDraws });
+            rgScenarios.push_back ({ &g_rgPayTableCatalog[t], m, KENO_TARGET_PROBABILITY, fRelativeError, g_qwAdaptiveMaxDraws });
+        }
+    }
+
+    const QWORD qwSeed = 0x41444150ULL;
+    const int   nScenarios = static_cast<int>(rgScenarios.size ( ));
+
+    std::vector<KenoAdaptiveState>  rgStates;
+    std::vector<KenoAdaptiveResult> rgResults;
+
+    if ( szCheckpoint != nullptr )
+    {
+        const QWORD qwScenarioHash = hashAdaptiveScenarios (rgScenarios.data ( ), nScenarios);
+
+        if ( readAdaptiveCheckpoint (szCheckpoint, qwSeed, qwScenarioHash, nScenarios, rgStates) )
+            _tprintf (_T ("Resuming from checkpoint '%s'\n"), szCheckpoint);
+
+        KenoCheckpointWriter checkpoint (szCheckpoint, qwSeed, qwScenarioHash);
+
+        runAdaptiveSimulation (rgScenarios.data ( ), nScenarios, qwSeed, rgStates, rgResults,
+                               &checkpoint, g_dwCheckpointSeconds);
+
+        _tprintf (_T ("Wrote %u checkpoint(s) to '%s', every %u seconds\n"),
+                  checkpoint.getNumWritten ( ), szCheckpoint, g_dwCheckpointSeconds);
+    }
+    else
+    {
+        runAdaptiveSimulation (rgScenarios.data ( ), nScenarios, qwSeed, rgStates, rgResults);
+    }
+
+    int iResult = 0;
+
+    if ( szExport != nullptr )
+    {
+        KenoExportTable histogram;
+        buildAdaptiveExport (rgScenarios.data ( ), rgStates.data ( ), nScenarios, histogram);
+
+        if ( !WriteExportTable (szExport, histogram, nullptr) )
+        {
+            _ftprintf (stderr, _T ("Cannot write '%s'\n"), szExport);
+            iResult = 1;
+        }
+    }
+
+    for ( size_t s = 0; s < rgScenarios.size ( ); s++ )
+    {
+        const KenoAdaptiveScenario& scenario = rgScenarios[s];
+        const KenoAdaptiveResult&   result   = rgResults[s];
+
+        TCHAR szTarget[32] = { 0 };
+
+        if ( scenario.eTarget == KENO_TARGET_RTP )
+            _sntprintf (szTarget, _countof (szTarget) - 1, _T ("RTP"));
+        else
+            _sntprintf (szTarget, _countof (szTarget) - 1, _T ("probability (%u of %u cells)"),
+                        result.dwTargetCells, scenario.dwNumMarked + 1);
+
+        _tprintf (_T ("'%s' %u Spot(s) Marked, %s target: %llu draws, relative error %.5f %s  RTP %.6f +/- %.6f\n"),
+                  scenario.pPayTable->szName, scenario.dwNumMarked, szTarget,
+                  result.qwNumDraws, result.fAchievedRelativeError,
+                  result.bConverged ? _T ("converged") : _T ("NOT CONVERGED"),
+                  result.fRTP, result.fRTPStdError);
+
+        if ( !result.bConverged )
+            iResult = 1;
+    }
+
+    return iResult;
+}
+
+
+/**
+  @brief ExportTables
+
+  Writes the probability matrix and the expected value vector for
+  downstream tools, as columnar ("kcol"), CSV ("csv") or TSV ("tsv") files.
+
+  @param [in] szDirectory     output directory, "" for the working directory
+  @param [in] szExtension     file extension selecting the format
+
+  @retval int                 1 if a file cannot be written
+*/
+int ExportTables (const TCHAR* szDirectory, const TCHAR* szExtension)
+{
+    KenoExportTable     probability;
+    KenoExportTable     expectedValue;
+    KenoDelimitedWriter writer;
+
+    buildProbabilityExport   (probability);
+    buildExpectedValueExport (expectedValue);
+
+    const struct
+    {
+        const TCHAR*           szFileName;
+        const KenoExportTable* pTable;
+    } rgExports[] =
+    {
+        { g_szProbabilityExportFile,   &probability   },
+        { g_szExpectedValueExportFile, &expectedValue },
+    };
+
+    for ( const auto& item : rgExports )
+    {
+        TCHAR szFileName[_MAX_PATH] = { 0 };
+        TCHAR szPath[_MAX_PATH]     = { 0 };
+
+        _sntprintf (szFileName, _countof (szFileName) - 1, _T ("%s.%s"), item.szFileName, szExtension);
+
+        if ( !makeExportPath (szDirectory, szFileName, szPath, _countof (szPath)) ||
+             !WriteExportTable (szPath, *item.pTable, &writer) )
+        {
+            _ftprintf (stderr, _T ("Cannot write '%s'\n"), szFileName);
+            return 1;
+        }
+
+        _tprintf (_T ("Wrote %llu rows to '%s'\n"), item.pTable->qwNumRows, szPath);
+    }
+
+    return 0;
+}
+
+
+/**
+  @brief PrintPoolProbabilityTable
+
+  Prints the probability matrix of a pool of any size up to
+  g_MAX_LOG_FACTORIAL balls from the log-space kernel, together with the
+  relative error bound of each row.  The matrix is read from the table
+  cache next to the executable, which is regenerated when it is stale.
+
+  @param [in] geometry        pool and draw size
+
+  @retval int                 0, or 1 if the geometry is invalid
+*/
+int PrintPoolProbabilityTable (const KenoGeometry& geometry)
+{
+    if ( (geometry.dwBallsDrawn == 0) || !isValidGeometry (geometry, g_MAX_ROWS) )
+    {
+        _ftprintf (stderr, _T ("The pool must hold %d .. %u balls, and at least as many as are drawn\n"),
+                   g_MAX_ROWS, g_MAX_LOG_FACTORIAL);
+        return 1;
+    }
+
+    TCHAR szDir[_MAX_PATH] = { 0 };
+
+    if ( GetModulePath (szDir, _countof (szDir) - 1) == nullptr )
+        szDir[0] = _T('\0');
+
+    KenoTableCache cache;
+    cache.open (szDir, geometry);
+
+    _tprintf (_T ("%u balls, %u drawn%s\n"), geometry.dwTotalBalls, geometry.dwBallsDrawn,
+              cache.wasRegenerated ( ) ? _T (" (table cache regenerated)") : _T (""));
+
+    for ( DWORD m = 1; m <= g_MAX_ROWS; m++ )
+    {
+        const double* rgRow = cache.getRow (m);
+
+        _tprintf (_T ("%2u Spot(s) Marked  (relative error <= %.1e)\n "), m, cache.getErrorBound (m));
+
+        for ( DWORD c = 0; c <= m; c++ )
+            _tprintf (_T (" %.10e"), rgRow[c]);
+
+        _tprintf (_T ("\n"));
+    }
+
+    return 0;
+}
 
-    dbg << "Calculating Expected Value(s)" << std::endl;
-    dbg << "---------------------------------------------" << std::endl;
 
-#endif
+/**
+  @brief LoadPayTableModel
+
+  Builds a model from the pay table file if its contents differ from the
+  last loaded ones.
+
+  @param [in]     szPath      pay table file
+  @param [in]     dwVersion   version of the new model
+  @param [in,out] qwHash      hash of the pay tables last loaded, 0 if none
+
+  @retval KenoModel*          the new model, or nullptr if the file is
+                              missing, malformed or unchanged
+*/
+std::unique_ptr<KenoModel> LoadPayTableModel (const TCHAR* szPath, DWORD dwVersion, QWORD& qwHash)
+{
+    std::vector<double> rgPayOuts;
+
+    const int nPayTables = readPayTableFile (szPath, rgPayOuts);
+    if ( nPayTables == 0 )
+        return nullptr;
+
+    const QWORD qwNewHash = hashBytes (rgPayOuts.data ( ), rgPayOuts.size ( ) * sizeof (double));
+    if ( qwNewHash == qwHash )
+        return nullptr;
+
+    std::vector<KenoPayTable> rgPayTables (nPayTables);
+
+    for ( int t = 0; t < nPayTables; t++ )
+    {
+        rgPayTables[t].szName   = szPath;
+        rgPayTables[t].rgPayOut = reinterpret_cast<const KenoPayOutRow*>(&rgPayOuts[t * g_MAX_PAYOUT_ROWS * g_MAX_PAYOUT_COLS]);
+    }
+
+    std::unique_ptr<KenoModel> pModel (new KenoModel);
+    buildKenoModel (rgPayTables.data ( ), nPayTables, dwVersion, *pModel);
+
+    qwHash = qwNewHash;
+    return pModel;
+}
+
+/**
+  @brief LoadInitialModel
+
+  @retval KenoModel*          version 1 of the model, from g_szServicePayTableFile
+                              when it exists, otherwise from the pay table catalog
+*/
+std::unique_ptr<KenoModel> LoadInitialModel (QWORD& qwHash)
+{
+    std::unique_ptr<KenoModel> pModel = LoadPayTableModel (g_szServicePayTableFile, 1, qwHash);
+
+    if ( pModel == nullptr )
+    {
+        pModel.reset (new KenoModel);
+        buildKenoModel (g_rgPayTableCatalog, g_nPayTableCatalogSize, 1, *pModel);
+    }
+
+    return pModel;
+}
+
+/**
+  @brief RunQueryService
+
+  Serves probability, pay out and pay table metric queries (KenoService.h)
+  until the process is terminated, reporting the query rate periodically.
+  The pay tables come from g_szServicePayTableFile in the working directory
+  when it exists, otherwise from the pay table catalog; the file is polled
+  and every change is published to the running service as a new model.
+
+  @param [in] szSocketPath    Unix domain socket path, or nullptr for TCP
+  @param [in] wPort           loopback TCP port when szSocketPath is nullptr
+
+  @retval int                 1 if the service cannot be started
+*/
+int RunQueryService (const char* szSocketPath, WORD wPort)
+{
+    KenoModelRegistry registry;
+    DWORD             dwVersion = 1;
+    QWORD             qwHash    = 0;
+
+    std::unique_ptr<KenoModel> pModel = LoadInitialModel (qwHash);
+
+    registry.publish (std::move (pModel));
+
+    KenoService service;
+
+    if ( !service.start (szSocketPath, wPort, &registry) )
+    {
+        KENO_TRACE_ERROR (_T ("Cannot start the query service"));
+        _ftprintf (stderr, _T ("Cannot start the query service\n"));
+        return 1;
+    }
+
+    if ( szSocketPath != nullptr )
+        printf ("Serving queries on %s\n", szSocketPath);
+    else
+        printf ("Serving queries on 127.0.0.1:%u\n", service.getPort ( ));
+
+    QWORD qwLast = 0;
+
+    for ( DWORD dwSeconds = 1; ; dwSeconds++ )
+    {
+        std::this_thread::sleep_for (std::chrono::seconds (1));
+
+        pModel = LoadPayTableModel (g_szServicePayTableFile, dwVersion + 1, qwHash);
+
+        if ( pModel != nullptr )
+        {
+            registry.publish (std::move (pModel));
+            dwVersion++;
+
+            _tprintf (_T ("Published model version %u from %s, swap %.1f us\n"), dwVersion,
+                      g_szServicePayTableFile, registry.getLastSwapUs ( ));
+            fflush (stdout);
+        }
+
+        if ( dwSeconds % g_dwServiceReportSeconds != 0 )
+            continue;
+
+        const QWORD qwNumQueries = service.getNumQueries ( );
+
+        printf ("%llu queries, %.0f queries/s, model version %u, %u swaps, max swap %.1f us\n", qwNumQueries,
+                static_cast<double>(qwNumQueries - qwLast) / g_dwServiceReportSeconds,
+                dwVersion, registry.getNumSwaps ( ), registry.getMaxSwapUs ( ));
+        fflush (stdout);
+
+        qwLast = qwNumQueries;
+    }
+}
+
+
+/**
+  @brief RunBatchQueries
+
+  Answers the text or binary query records of stdin on stdout (KenoBatch.h)
+  from the same pay tables as '-serve', and reports the record rate on
+  stderr.
+
+  @param [in] eFormat         KenoBatchFormat of the records
+
+  @retval int                 1 on a read or write error
+*/
+int RunBatchQueries (KenoBatchFormat eFormat)
+{
+    QWORD                      qwHash = 0;
+    std::unique_ptr<KenoModel> pModel = LoadInitialModel (qwHash);
+
+    // both formats are byte exact, so no newline translation
+    _setmode (_fileno (stdin),  _O_BINARY);
+    _setmode (_fileno (stdout), _O_BINARY);
+
+    const auto   tpStart   = std::chrono::steady_clock::now ( );
+    QWORD        qwRecords = 0;
+    const bool   bResult   = runBatchQueries (*pModel, eFormat, stdin, stdout, qwRecords);
+    const double fSeconds  = std::chrono::duration<double> (std::chrono::steady_clock::now ( ) - tpStart).count ( );
+
+    fprintf (stderr, "%llu records in %.3f s, %.0f records/s\n", qwRecords, fSeconds,
+             (fSeconds > 0.0) ? qwRecords / fSeconds : 0.0);
+
+    if ( !bResult )
+    {
+        KENO_TRACE_ERROR (_T ("Batch queries failed after %llu records"), qwRecords);
+        fprintf (stderr, "Batch queries failed\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/**
+  @brief RunCommand
+
+  Builds the probability tables and runs the mode selected on the command
+  line, exporting to Excel when none is given.
+
+  @retval int               process exit code
+*/
+int RunCommand (int argc, _TCHAR* argv[])
+{
+    // Calculate the array of Keno probabilities
+    buildProbabilityTable ( );
 
     // Calculate the array of expected values for a $1 bet
+    buildExpectedValueTable ( );
+
+    // Calculate the side bet distributions
+    buildSideBetTables ( );
+
+    // '-verify [draws]' validates the pay table catalog and skips the export
+    if ( (argc > 1) && (_tcscmp (argv[1], _T ("-verify")) == 0) )
+    {
+        const QWORD qwNumDraws = (argc > 2) ? _tcstoui64 (argv[2], nullptr, 10) : g_qwDefaultVerifyDraws;
 
-    /*************************************************************************
-
-    The expected value of a discrete random variable is the probability-weighted 
-    average of all possible values. In other words, each possible value the random 
-    variable can assume is multiplied by its probability of occurring, and the resulting 
-    products are summed to produce the expected value. The same works for continuous random 
-    variables, except the sum is replaced by an integral and the probabilities by probability 
-    densities. The formal definition subsumes both of these and also works for distributions 
-    which are neither discrete nor continuous: the expected value of a random variable is the 
-    integral of the random variable with respect to its probability measure.
-
-    @cite http://en.wikipedia.org/wiki/Expected_value
-
-    GIVEN: "Together with this program specification there is a sheet of payoffs 
-            for between 1 & 9 spots marked.  Calculate for each number of spots 
-            marked the 'expected value' of a $1 bet."
-
-            - The KENO probability of "C" ball(s) getting caught out of "M" spots
-              marked will be denoted as 'KP(M, C)'.
-            - The payout of "C" ball(s) getting caught out of "M" spots marked will
-              be denoted as 'PO(M, C)'.
-
-            The expected $1 value of 9 spots marked should be equal to:
-                KP(9, 9) * PO(9, 9) * 1/10 + 
-                KP(9, 8) * PO(9, 8) * 1/10 +
-                KP(9, 7) * PO(9, 7) * 1/10 +
-                       ...          * 1/10 +
-                KP(9, 0) * PO(9, 0) * 1/10
-    */
-    for ( int i = 0; i < g_MAX_SPOTS_MARKED; i++ )        // i + 1 = 'number of spots marked'
-    {
-        for ( int j = 0; j < g_MAX_SPOTS_MARKED; j++ )    // j + 1 = 'number of balls caught'
+        return VerifyPayTableCatalog (qwNumDraws);
+    }
+
+    // '-jackpot' projects the progressive jackpot liability and skips the export
+    if ( (argc > 1) && (_tcscmp (argv[1], _T ("-jackpot")) == 0) )
+    {
+        return ProjectJackpotLiability ( );
+    }
+
+    // '-rare [draws]' estimates the rare tier liability by importance sampling
+    if ( (argc > 1) && (_tcscmp (argv[1], _T ("-rare")) == 0) )
+    {
+        const QWORD qwNumDraws = (argc > 2) ? _tcstoui64 (argv[2], nullptr, 10) : g_qwDefaultRareDraws;
+
+        return EstimateRareTierLiability (qwNumDraws);
+    }
+
+    // '-adaptive [relative error] [checkpoint] [histogram export]' simulates every row until it reaches the requested error
+    if ( (argc > 1) && (_tcscmp (argv[1], _T ("-adaptive")) == 0) )
+    {
+        const double fRelativeError = (argc > 2) ? _tcstod (argv[2], nullptr) : g_fDefaultAdaptiveError;
+
+        return RunAdaptiveSimulation (fRelativeError, (argc > 3) ? argv[3] : nullptr, (argc > 4) ? argv[4] : nullptr);
+    }
+
+    // '-pool balls drawn' prints the probability matrix of another pool and skips the export
+    if ( (argc > 3) && (_tcscmp (argv[1], _T ("-pool")) == 0) )
+    {
+        const KenoGeometry geometry = { static_cast<DWORD>(_tcstoul (argv[2], nullptr, 10)),
+                                        static_cast<DWORD>(_tcstoul (argv[3], nullptr, 10)) };
+
+        return PrintPoolProbabilityTable (geometry);
+    }
+
+    // '-export columnar|csv|tsv [directory]' writes the tables for downstream tools and skips the Excel export
+    if ( (argc > 2) && (_tcscmp (argv[1], _T ("-export")) == 0) )
+    {
+        const TCHAR* szDirectory = (argc > 3) ? argv[3] : _T ("");
+
+        if ( _tcscmp (argv[2], _T ("columnar")) == 0 )
+            return ExportTables (szDirectory, _T ("kcol"));
+
+        if ( (_tcscmp (argv[2], _T ("csv")) == 0) || (_tcscmp (argv[2], _T ("tsv")) == 0) )
+            return ExportTables (szDirectory, argv[2]);
+    }
+
+    // '-serve [socket path]' or '-serve tcp [port]' runs the query service and never returns
+    if ( (argc > 1) && (_tcscmp (argv[1], _T ("-serve")) == 0) )
+    {
+        if ( (argc > 2) && (_tcscmp (argv[2], _T ("tcp")) == 0) )
         {
-            double dPayout = g_rgCatchPayOut[i][j];       // PO(M, C)
-            if ( dPayout > 0 )
-            {
-                // lets lookup the associated probability -  KP(M, C)
-                const double dKenoProb     = g_rgProbability[i][j+1];
-
-                g_rgExpectedValue[i] += (dKenoProb * dPayout / (i+2));   // we have to divide by i+2 here because we need to 
-                                                                         // account for i is zero-based and we need to account
-                                                                         // for the number of terms to be averaged is actually,
-                                                                         // M+1.
-#ifdef _DEBUG                
-                dbg << "KP(" << i+1 << "," << j+1 << ") =" << dKenoProb << std::endl;
-                dbg << "PO(" << i+1 << "," << j+1 << ") =" << dPayout   << std::endl;
-
-                dbg << "Expected Value of [" << i + 1 << "] spots marked " << g_rgExpectedValue[i] << std::endl;
-#endif
-            }
+            const WORD wPort = (argc > 3) ? static_cast<WORD>(_tcstoul (argv[3], nullptr, 10)) : g_wDefaultServicePort;
+
+            return RunQueryService (nullptr, wPort);
+        }
+
+        // socket paths are narrow strings
+        char szSocketPath[108] = { 0 };
+
+        if ( argc > 2 )
+        {
+            for ( size_t i = 0; (argv[2][i] != 0) && (i + 1 < _countof (szSocketPath)); i++ )
+                szSocketPath[i] = static_cast<char>(argv[2][i]);
+        }
+        else
+        {
+            strcpy (szSocketPath, g_szDefaultServiceSocket);
         }
+
+        return RunQueryService (szSocketPath, 0);
     }
 
+    // '-batch [binary]' answers query records from stdin until its end
+    if ( (argc > 1) && (_tcscmp (argv[1], _T ("-batch")) == 0) )
+    {
+        const bool bBinary = (argc > 2) && (_tcscmp (argv[2], _T ("binary")) == 0);
 
+        return RunBatchQueries (bBinary ? KENO_BATCH_BINARY : KENO_BATCH_TEXT);
+    }
 
     // Initialize the COM libraries needed to interface with Excel
     HRESULT hr = ::CoInitializeEx (nullptr, COINIT_MULTITHREADED);
 
     if ( FAILED (hr) )
     {
-#ifdef _DEBUG
-        dbg << "Failed to initialize COM library. Error code = 0x"
-            << std::hex << hr << std::endl;
-#endif
+        KENO_TRACE_ERROR (_T ("Failed to initialize COM library. Error code = 0x%08X"), hr);
         return hr;
     }
 
@@ -581,3 +965,15 @@ int _tmain(int argc, _TCHAR* argv[])
     return 0;
 }
 
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+    // the trace is written by a background thread, see KenoTrace.h
+    startTrace (g_szTraceFileName);
+
+    const int iResult = RunCommand (argc, argv);
+
+    stopTrace ( );
+
+    return iResult;
+}
@@ -13,10 +13,17 @@
 
 #pragma once
 
-#include "targetver.h"
+#ifdef _WIN32
+    #include "targetver.h"
+#endif
 
 #define _CRT_SECURE_NO_WARNINGS // turn off silly warnings from using string methods
 
 #include <stdio.h>
-#include <tchar.h>
+
+#ifdef _WIN32
+    #include <tchar.h>
+#else
+    #include "KenoPortable.h"
+#endif
 
@@ -0,0 +1,412 @@
+/**
+@file       KenoPython.cpp
+@brief      Python bindings of the probability model, the pay table evaluator
+            and the simulator
+
+  Builds the extension module 'keno' (see setup.py in the repository root):
+
+      keno.probability_matrix ()        (20, 21) read-only view of g_rgProbability,
+                                        [spots - 1][catch]
+      keno.pay_table_catalog ()         list of (name, (9, 9) read-only view of the
+                                        pay outs [spots - 1][catch - 1])
+      keno.evaluate (pay_tables)        (n, 9, 3) rtp, hit rate and standard deviation
+                                        of n pay tables laid out like the catalog
+      keno.simulate (pay_table, draws, seed = 0)
+                                        (9, 3) exact rtp, simulated rtp and its
+                                        standard error of every row of a pay table
+
+  Every result is a keno.Array, which exports its memory through the buffer
+  protocol, so numpy.asarray () or memoryview () view it without a copy.
+  The engines write straight into the memory of the array.  Pay tables are
+  taken from any C contiguous, 8 byte aligned float64 buffer, e.g. a numpy
+  array.
+
+  evaluate and simulate release the GIL while they compute, so Python
+  threads run them in parallel; the simulator also spreads the draws of one
+  call across all hardware threads.
+
+@author     Mark L. Short
+@date       October 16, 2026
+*/
+
+#include "stdafx.h"
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <string.h>
+#include "KenoModel.h"
+#include "KenoProbability.h"
+#include "KenoSimulator.h"
+
+constexpr const int    g_MAX_ARRAY_DIMS      = 3;
+constexpr const int    g_nPayTableMetrics    = 3;      //< rtp, hit rate, standard deviation
+constexpr const int    g_nSimulationMetrics  = 3;      //< exact rtp, simulated rtp, standard error
+constexpr const double g_fSimulationZScore   = 4.5;
+constexpr const size_t g_nPayTableValues     = g_MAX_PAYOUT_ROWS * g_MAX_PAYOUT_COLS;
+
+
+/**
+  keno.Array: an n-dimensional C contiguous array of doubles, either owned
+  (a result) or a read-only view of a table of the engine.
+*/
+struct KenoArrayObject
+{
+    PyObject_HEAD
+    double*     pData;
+    bool        bOwned;                         //< pData was allocated by the array
+    int         nDims;
+    Py_ssize_t  rgShape  [g_MAX_ARRAY_DIMS];
+    Py_ssize_t  rgStrides[g_MAX_ARRAY_DIMS];
+};
+
+static PyTypeObject g_KenoArrayType = { PyVarObject_HEAD_INIT (nullptr, 0) };
+
+static Py_ssize_t getArrayCount (const KenoArrayObject* pArray)
+{
+    Py_ssize_t nCount = 1;
+
+    for ( int d = 0; d < pArray->nDims; d++ )
+        nCount *= pArray->rgShape[d];
+
+    return nCount;
+}
+
+/**
+  @brief creates an array of the given shape, a view of 'pView' or, if it
+         is nullptr, owning zeroed memory
+
+  @retval KenoArrayObject*      new reference, nullptr with an exception set
+*/
+static KenoArrayObject* createArray (int nDims, const Py_ssize_t* rgShape, const double* pView)
+{
+    KenoArrayObject* pArray = PyObject_New (KenoArrayObject, &g_KenoArrayType);
+    if ( pArray == nullptr )
+        return nullptr;
+
+    pArray->pData  = const_cast<double*>(pView);
+    pArray->bOwned = (pView == nullptr);
+    pArray->nDims  = nDims;
+
+    Py_ssize_t nStride = sizeof (double);
+
+    for ( int d = nDims - 1; d >= 0; d-- )
+    {
+        pArray->rgShape[d]   = rgShape[d];
+        pArray->rgStrides[d] = nStride;
+        nStride             *= rgShape[d];
+    }
+
+    if ( pArray->bOwned )
+    {
+        // raw allocator, as the engines fill the memory without the GIL
+        const size_t cbData = static_cast<size_t>(getArrayCount (pArray)) * sizeof (double);
+
+        pArray->pData = static_cast<double*>(PyMem_RawCalloc (1, (cbData > 0) ? cbData : 1));
+
+        if ( pArray->pData == nullptr )
+        {
+            pArray->bOwned = false;
+            Py_DECREF (pArray);
+            PyErr_NoMemory ( );
+            return nullptr;
+        }
+    }
+
+    return pArray;
+}
+
+static void KenoArray_dealloc (PyObject* pSelf)
+{
+    KenoArrayObject* pArray = reinterpret_cast<KenoArrayObject*>(pSelf);
+
+    if ( pArray->bOwned )
+        PyMem_RawFree (pArray->pData);
+
+    PyObject_Del (pSelf);
+}
+
+static int KenoArray_getbuffer (PyObject* pSelf, Py_buffer* pView, int iFlags)
+{
+    KenoArrayObject* pArray = reinterpret_cast<KenoArrayObject*>(pSelf);
+
+    if ( ((iFlags & PyBUF_WRITABLE) == PyBUF_WRITABLE) && !pArray->bOwned )
+    {
+        PyErr_SetString (PyExc_BufferError, "keno.Array is a read-only view of an engine table");
+        pView->obj = nullptr;
+        return -1;
+    }
+
+    Py_INCREF (pSelf);
+
+    pView->obj        = pSelf;
+    pView->buf        = pArray->pData;
+    pView->len        = getArrayCount (pArray) * static_cast<Py_ssize_t>(sizeof (double));
+    pView->readonly   = pArray->bOwned ? 0 : 1;
+    pView->itemsize   = sizeof (double);
+    pView->format     = ((iFlags & PyBUF_FORMAT) == PyBUF_FORMAT) ? const_cast<char*>("d") : nullptr;
+    pView->ndim       = pArray->nDims;
+    pView->shape      = ((iFlags & PyBUF_ND)      == PyBUF_ND)      ? pArray->rgShape   : nullptr;
+    pView->strides    = ((iFlags & PyBUF_STRIDES) == PyBUF_STRIDES) ? pArray->rgStrides : nullptr;
+    pView->suboffsets = nullptr;
+    pView->internal   = nullptr;
+
+    return 0;
+}
+
+static PyObject* KenoArray_getShape (PyObject* pSelf, void*)
+{
+    const KenoArrayObject* pArray = reinterpret_cast<KenoArrayObject*>(pSelf);
+
+    PyObject* pShape = PyTuple_New (pArray->nDims);
+    if ( pShape == nullptr )
+        return nullptr;
+
+    for ( int d = 0; d < pArray->nDims; d++ )
+        PyTuple_SET_ITEM (pShape, d, PyLong_FromSsize_t (pArray->rgShape[d]));
+
+    return pShape;
+}
+
+static PyBufferProcs g_KenoArrayBuffer = { KenoArray_getbuffer, nullptr };
+
+static PyGetSetDef g_rgKenoArrayGetSet[] =
+{
+    { const_cast<char*>("shape"), KenoArray_getShape, nullptr, const_cast<char*>("dimensions of the array"), nullptr },
+    { nullptr }
+};
+
+
+/**
+  @brief gets a C contiguous, aligned float64 buffer of 'pObject' holding a
+         multiple of 'nMultiple' values
+
+  @retval bool          false with an exception set
+*/
+static bool getDoubleBuffer (PyObject* pObject, size_t nMultiple, const char* szArgument, Py_buffer& view)
+{
+    if ( PyObject_GetBuffer (pObject, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0 )
+        return false;
+
+    // native or little endian doubles, e.g. "d", "<d", "=d"
+    const char* szFormat = (view.format != nullptr) ? view.format : "B";
+    const bool  bDouble  = (view.itemsize == sizeof (double)) && (szFormat[strlen (szFormat) - 1] == 'd') &&
+                           (szFormat[0] != '>') && (szFormat[0] != '!');
+
+    const size_t nValues = bDouble ? static_cast<size_t>(view.len) / sizeof (double) : 0;
+
+    if ( !bDouble || (nValues == 0) || ((nValues % nMultiple) != 0) )
+    {
+        PyErr_Format (PyExc_ValueError, "%s must be a float64 buffer of a multiple of %zu values", szArgument, nMultiple);
+        PyBuffer_Release (&view);
+        return false;
+    }
+
+    // the engines read the buffer as doubles in place, which a view at an odd
+    // byte offset (e.g. numpy.frombuffer of a slice) does not allow
+    if ( (reinterpret_cast<uintptr_t>(view.buf) % alignof (double)) != 0 )
+    {
+        PyErr_Format (PyExc_ValueError, "%s must be aligned to %zu bytes", szArgument, alignof (double));
+        PyBuffer_Release (&view);
+        return false;
+    }
+
+    return true;
+}
+
+static PyObject* Keno_probabilityMatrix (PyObject*, PyObject*)
+{
+    const Py_ssize_t rgShape[] = { g_MAX_ROWS, g_MAX_COLS };
+
+    return reinterpret_cast<PyObject*>(createArray (2, rgShape, &g_rgProbability[0][0]));
+}
+
+static PyObject* Keno_payTableCatalog (PyObject*, PyObject*)
+{
+    const Py_ssize_t rgShape[] = { g_MAX_PAYOUT_ROWS, g_MAX_PAYOUT_COLS };
+
+    PyObject* pList = PyList_New (g_nPayTableCatalogSize);
+    if ( pList == nullptr )
+        return nullptr;
+
+    for ( int t = 0; t < g_nPayTableCatalogSize; t++ )
+    {
+        const KenoPayTable& payTable = g_rgPayTableCatalog[t];
+
+#ifdef _UNICODE
+        PyObject* pName  = PyUnicode_FromWideChar (payTable.szName, -1);
+#else
+        PyObject* pName  = PyUnicode_FromString (payTable.szName);
+#endif
+        PyObject* pTable = reinterpret_cast<PyObject*>(createArray (2, rgShape, &payTable.rgPayOut[0][0]));
+        PyObject* pItem  = ((pName != nullptr) && (pTable != nullptr)) ? PyTuple_Pack (2, pName, pTable) : nullptr;
+
+        Py_XDECREF (pName);
+        Py_XDECREF (pTable);
+
+        if ( pItem == nullptr )
+        {
+            Py_DECREF (pList);
+            return nullptr;
+        }
+
+        PyList_SET_ITEM (pList, t, pItem);
+    }
+
+    return pList;
+}
+
+static PyObject* Keno_evaluate (PyObject*, PyObject* pArgs)
+{
+    PyObject* pPayTables = nullptr;
+
+    if ( !PyArg_ParseTuple (pArgs, "O:evaluate", &pPayTables) )
+        return nullptr;
+
+    Py_buffer view;
+
+    if ( !getDoubleBuffer (pPayTables, g_nPayTableValues, "pay_tables", view) )
+        return nullptr;
+
+    const Py_ssize_t nPayTables = static_cast<Py_ssize_t>(view.len / (g_nPayTableValues * sizeof (double)));
+    const Py_ssize_t rgShape[]  = { nPayTables, g_MAX_SPOTS_MARKED, g_nPayTableMetrics };
+
+    KenoArrayObject* pResult = createArray (3, rgShape, nullptr);
+
+    if ( pResult != nullptr )
+    {
+        const KenoPayOutRow* rgPayOuts = static_cast<const KenoPayOutRow*>(view.buf);
+        double*              pOut      = pResult->pData;
+
+        Py_BEGIN_ALLOW_THREADS
+
+        KenoModelPayTable payTable;
+
+        for ( Py_ssize_t t = 0; t < nPayTables; t++ )
+        {
+            evaluatePayTable (g_rgProbability, rgPayOuts + t * g_MAX_PAYOUT_ROWS, payTable);
+
+            for ( int m = 0; m < g_MAX_SPOTS_MARKED; m++ )
+            {
+                *pOut++ = payTable.rgRTP[m];
+                *pOut++ = payTable.rgHitRate[m];
+                *pOut++ = payTable.rgStdDev[m];
+            }
+        }
+
+        Py_END_ALLOW_THREADS
+    }
+
+    PyBuffer_Release (&view);
+
+    return reinterpret_cast<PyObject*>(pResult);
+}
+
+static PyObject* Keno_simulate (PyObject*, PyObject* pArgs, PyObject* pKeywords)
+{
+    static const char* s_rgKeywords[] = { "pay_table", "draws", "seed", nullptr };
+
+    PyObject*          pPayTable  = nullptr;
+    long long          llNumDraws = 0;
+    unsigned long long qwSeed     = 0;
+
+    // "L" raises OverflowError where "K" would silently wrap e.g. -1 into 2^64 - 1
+    if ( !PyArg_ParseTupleAndKeywords (pArgs, pKeywords, "OL|K:simulate", const_cast<char**>(s_rgKeywords),
+                                       &pPayTable, &llNumDraws, &qwSeed) )
+        return nullptr;
+
+    if ( llNumDraws <= 0 )
+    {
+        PyErr_SetString (PyExc_ValueError, "draws must be positive");
+        return nullptr;
+    }
+
+    Py_buffer view;
+
+    if ( !getDoubleBuffer (pPayTable, g_nPayTableValues, "pay_table", view) )
+        return nullptr;
+
+    if ( view.len != static_cast<Py_ssize_t>(g_nPayTableValues * sizeof (double)) )
+    {
+        PyErr_Format (PyExc_ValueError, "pay_table must hold %zu values", g_nPayTableValues);
+        PyBuffer_Release (&view);
+        return nullptr;
+    }
+
+    KenoPayOutRow rgPayOut[g_MAX_PAYOUT_ROWS];
+    memcpy (rgPayOut, view.buf, sizeof (rgPayOut));
+    PyBuffer_Release (&view);
+
+    const Py_ssize_t rgShape[] = { g_MAX_SPOTS_MARKED, g_nSimulationMetrics };
+
+    KenoArrayObject* pResult = createArray (2, rgShape, nullptr);
+    if ( pResult == nullptr )
+        return nullptr;
+
+    const KenoPayTable payTable = { _T ("Python"), rgPayOut };
+    double*            pOut     = pResult->pData;
+
+    Py_BEGIN_ALLOW_THREADS
+
+    KenoCrossCheckResult rgResults[g_MAX_SPOTS_MARKED];
+    crossCheckPayTable (payTable, static_cast<QWORD>(llNumDraws), qwSeed, g_fSimulationZScore, rgResults);
+
+    for ( int m = 0; m < g_MAX_SPOTS_MARKED; m++ )
+    {
+        *pOut++ = rgResults[m].fExactRTP;
+        *pOut++ = rgResults[m].fSimulatedRTP;
+        *pOut++ = rgResults[m].fStdError;
+    }
+
+    Py_END_ALLOW_THREADS
+
+    return reinterpret_cast<PyObject*>(pResult);
+}
+
+static PyMethodDef g_rgKenoMethods[] =
+{
+    { "probability_matrix", Keno_probabilityMatrix, METH_NOARGS,
+      "probability_matrix() -> (20, 21) read-only view, [spots - 1][catch]" },
+    { "pay_table_catalog",  Keno_payTableCatalog,   METH_NOARGS,
+      "pay_table_catalog() -> [(name, (9, 9) read-only view of the pay outs)]" },
+    { "evaluate",           Keno_evaluate,          METH_VARARGS,
+      "evaluate(pay_tables) -> (n, 9, 3) rtp, hit rate, standard deviation" },
+    { "simulate",           reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Keno_simulate)),
+      METH_VARARGS | METH_KEYWORDS,
+      "simulate(pay_table, draws, seed=0) -> (9, 3) exact rtp, simulated rtp, standard error" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
+static PyModuleDef g_KenoModule = { PyModuleDef_HEAD_INIT, "keno", "Keno probability and simulation engines", -1, g_rgKenoMethods };
+
+PyMODINIT_FUNC PyInit_keno (void)
+{
+    buildProbabilityTable   ( );
+    buildExpectedValueTable ( );
+
+    g_KenoArrayType.tp_name      = "keno.Array";
+    g_KenoArrayType.tp_doc       = "float64 array exported through the buffer protocol";
+    g_KenoArrayType.tp_basicsize = sizeof (KenoArrayObject);
+    g_KenoArrayType.tp_flags     = Py_TPFLAGS_DEFAULT;
+    g_KenoArrayType.tp_dealloc   = KenoArray_dealloc;
+    g_KenoArrayType.tp_as_buffer = &g_KenoArrayBuffer;
+    g_KenoArrayType.tp_getset    = g_rgKenoArrayGetSet;
+
+    if ( PyType_Ready (&g_KenoArrayType) < 0 )
+        return nullptr;
+
+    PyObject* pModule = PyModule_Create (&g_KenoModule);
+    if ( pModule == nullptr )
+        return nullptr;
+
+    Py_INCREF (&g_KenoArrayType);
+
+    if ( PyModule_AddObject (pModule, "Array", reinterpret_cast<PyObject*>(&g_KenoArrayType)) < 0 )
+    {
+        Py_DECREF (&g_KenoArrayType);
+        Py_DECREF (pModule);
+        return nullptr;
+    }
+
+    return pModule;
+}
@@ -0,0 +1,44 @@
+"""Builds the 'keno' Python extension of KenoPython/KenoPython.cpp.
+
+    pip install .                           # or
+    python setup.py build_ext --inplace
+
+The probability model, pay table evaluator and simulator of KenoProject are
+compiled into the module; no other package is required.
+"""
+
+import sys
+
+from setuptools import Extension, setup
+
+ENGINE_SOURCES = [
+    "KenoProbability",
+    "KenoVariants",
+    "KenoSimulator",
+    "KenoModel",
+    "KenoTrace",
+]
+
+if sys.platform == "win32":
+    COMPILE_ARGS = ["/O2", "/EHsc", "/DUNICODE", "/D_UNICODE"]
+    LIBRARIES = []
+else:
+    COMPILE_ARGS = ["-std=c++14", "-O2"]
+    LIBRARIES = ["pthread"]
+
+keno = Extension(
+    "keno",
+    sources=["KenoPython/KenoPython.cpp"] + ["KenoProject/%s.cpp" % name for name in ENGINE_SOURCES],
+    include_dirs=["KenoProject"],
+    extra_compile_args=COMPILE_ARGS,
+    libraries=LIBRARIES,
+    language="c++",
+)
+
+setup(
+    name="keno",
+    version="1.0",
+    description="Keno probability, pay table and simulation engines",
+    author="Mark L. Short",
+    ext_modules=[keno],
+)